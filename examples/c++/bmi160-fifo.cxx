@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atomic>
+#include <iostream>
+#include <signal.h>
+
+#include "bmi160.hpp"
+#include "upm_utilities.h"
+
+using namespace std;
+
+// The GPIO pin the BMI160 INT1 pin is connected to
+#define INT1_GPIO 2
+
+int shouldRun = true;
+atomic<bool> fifoReady(false);
+
+void
+sig_handler(int signo)
+{
+    if (signo == SIGINT)
+        shouldRun = false;
+}
+
+void
+fifo_isr(void* arg)
+{
+    fifoReady = true;
+}
+
+int
+main(int argc, char** argv)
+{
+    signal(SIGINT, sig_handler);
+    //! [Interesting]
+
+    // Instantiate a BMI160 instance using default i2c bus and address
+    upm::BMI160 sensor;
+
+    // Stream the accelerometer, gyroscope and magnetometer through the
+    // FIFO, and raise INT1 once it is 3/4 full.  At the default 200Hz
+    // that is about 60 samples, or a wake up every 300ms.
+    sensor.enableFIFO(true);
+    sensor.setFIFOWatermark(768);
+    sensor.enableFIFOInterrupt(BMI160_INTERRUPT_INT1, true);
+    sensor.installISR(BMI160_INTERRUPT_INT1, INT1_GPIO, mraa::EDGE_RISING, fifo_isr, NULL);
+
+    BMI160_FIFO_SAMPLE_T samples[BMI160_FIFO_MAX_SAMPLES];
+
+    while (shouldRun) {
+        if (!fifoReady) {
+            upm_delay_us(10000);
+            continue;
+        }
+        fifoReady = false;
+
+        int num;
+        while ((num = sensor.readFIFO(samples, BMI160_FIFO_MAX_SAMPLES)) > 0) {
+            const BMI160_FIFO_SAMPLE_T& s = samples[num - 1];
+
+            cout << "Read " << num << " samples, latest at sensor time " << s.sensorTime
+                 << endl;
+            cout << "Accelerometer: ";
+            cout << "AX: " << s.accel[0] << " AY: " << s.accel[1] << " AZ: " << s.accel[2]
+                 << endl;
+            cout << "Gryoscope:     ";
+            cout << "GX: " << s.gyro[0] << " GY: " << s.gyro[1] << " GZ: " << s.gyro[2] << endl;
+            cout << "Magnetometer:  ";
+            cout << "MX: " << s.mag[0] << " MY: " << s.mag[1] << " MZ: " << s.mag[2] << endl;
+            cout << endl;
+        }
+
+        if (sensor.getFIFOSkipped())
+            cout << "Frames dropped so far: " << sensor.getFIFOSkipped() << endl;
+    }
+
+    sensor.uninstallISR(BMI160_INTERRUPT_INT1);
+    sensor.enableFIFOInterrupt(BMI160_INTERRUPT_INT1, false);
+    sensor.enableFIFO(false);
+    //! [Interesting]
+
+    cout << "Exiting..." << endl;
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <iostream>
+#include <signal.h>
+
+#include "bmx055.hpp"
+#include "upm_utilities.h"
+
+using namespace std;
+
+int shouldRun = true;
+
+void
+sig_handler(int signo)
+{
+    if (signo == SIGINT)
+        shouldRun = false;
+}
+
+int
+main(int argc, char** argv)
+{
+    signal(SIGINT, sig_handler);
+    //! [Interesting]
+
+    // Instantiate an BMX055 using default I2C parameters
+    upm::BMX055 sensor;
+
+    // Buffer samples in the accelerometer and gyroscope FIFOs
+    sensor.enableFIFOStream(true);
+
+    upm::BMX055::FIFO_SAMPLE_T samples[BMG160_FIFO_FRAMES];
+
+    // now read a batch of samples every 50 milliseconds.  The default
+    // data rates are 500Hz for the accelerometer and 400Hz for the
+    // gyroscope, so their FIFOs don't fill up in that time.
+    while (shouldRun) {
+        int num = sensor.readFIFO(samples, BMG160_FIFO_FRAMES);
+
+        cout << "Read " << num << " samples" << endl;
+
+        if (num > 0) {
+            const upm::BMX055::FIFO_SAMPLE_T& s = samples[num - 1];
+
+            cout << "Latest at " << s.timestamp << " us" << endl;
+            cout << "Accelerometer x: " << s.accel[0] << " y: " << s.accel[1]
+                 << " z: " << s.accel[2] << " g" << endl;
+            cout << "Gyroscope x: " << s.gyro[0] << " y: " << s.gyro[1]
+                 << " z: " << s.gyro[2] << " degrees/s" << endl;
+            cout << "Magnetometer x: " << s.mag[0] << " y: " << s.mag[1]
+                 << " z: " << s.mag[2] << " uT" << endl;
+        }
+
+        cout << endl;
+
+        upm_delay_us(50000);
+    }
+
+    sensor.enableFIFOStream(false);
+
+    //! [Interesting]
+
+    cout << "Exiting..." << endl;
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <iostream>
+#include <signal.h>
+#include <stdio.h>
+#include <string>
+
+#include "ssd1306.hpp"
+#include "upm_utilities.h"
+
+using namespace std;
+
+int shouldRun = true;
+
+void
+sig_handler(int signo)
+{
+    if (signo == SIGINT)
+        shouldRun = false;
+}
+
+int
+main(int argc, char** argv)
+{
+    signal(SIGINT, sig_handler);
+    //! [Interesting]
+
+    // Instantiate an SSD1306 on I2C bus 0, address 0x3C
+    upm::SSD1306 lcd(0x0, 0x3C);
+
+    // Draw the static parts of the screen once
+    lcd.drawRectangle(0, 0, 128, 64);
+    lcd.drawString(8, 8, "Uptime");
+    lcd.drawLineHorizontal(8, 18, 112);
+    lcd.refresh();
+
+    int seconds = 0;
+    char buffer[17];
+
+    while (shouldRun) {
+        // Only the digits that changed are sent by refresh()
+        snprintf(buffer, sizeof(buffer), "%6d s", seconds++);
+        lcd.drawString(8, 32, buffer);
+
+        // A bar moving along the bottom of the screen
+        lcd.drawRectangleFilled(8, 48, 112, 8, upm::COLOR_BLACK);
+        lcd.drawRectangleFilled(8 + (seconds % 14) * 8, 48, 8, 8);
+
+        lcd.refresh();
+        cout << "Refresh sent " << lcd.getRefreshBytes() << " bytes" << endl;
+
+        upm_delay(1);
+    }
+
+    //! [Interesting]
+
+    cout << "Exiting..." << endl;
+
+    return 0;
+}
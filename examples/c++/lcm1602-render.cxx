@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <iostream>
+#include <signal.h>
+#include <stdio.h>
+#include <string>
+
+#include "lcm1602.hpp"
+#include "upm_utilities.h"
+
+using namespace std;
+
+bool shouldRun = true;
+
+void
+sig_handler(int signo)
+{
+    if (signo == SIGINT)
+        shouldRun = false;
+}
+
+int
+main(int argc, char** argv)
+{
+    signal(SIGINT, sig_handler);
+
+    //! [Interesting]
+    // 20x4 display on an I2C expander at 0x27, on bus 0
+    upm::Lcm1602 lcd(0, 0x27, true, 20, 4);
+
+    unsigned int seconds = 0;
+    char frame[4 * 20 + 1];
+
+    while (shouldRun) {
+        // build the whole screen each time, render() only sends what
+        // changed
+        snprintf(frame,
+                 sizeof(frame),
+                 "%-20s%-20s%-20s%02u:%02u:%02u            ",
+                 "Status display",
+                 "Render example",
+                 "Uptime",
+                 (seconds / 3600) % 100,
+                 (seconds / 60) % 60,
+                 seconds % 60);
+
+        lcd.render(frame);
+
+        cout << "Bus bytes sent: " << lcd.getRenderBytes()
+             << " saved: " << lcd.getRenderBytesSaved() << endl;
+
+        upm_delay(1);
+        seconds++;
+    }
+    //! [Interesting]
+
+    cout << "Exiting..." << endl;
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <iostream>
+#include <signal.h>
+
+#include "lpd8806.hpp"
+#include "upm_utilities.h"
+
+using namespace std;
+
+bool shouldRun = true;
+
+void
+sig_handler(int signo)
+{
+    if (signo == SIGINT)
+        shouldRun = false;
+}
+
+int
+main(int argc, char** argv)
+{
+    signal(SIGINT, sig_handler);
+
+    //! [Interesting]
+    // 32 pixel strip on SPI bus 0, chip select on GPIO 7
+    upm::LPD8806 strip(0, 7, 32);
+
+    // even looking fades, at half brightness
+    strip.setGamma(2.5);
+    strip.setBrightness(128);
+
+    // send frames in the background, so the animation timing doesn't
+    // depend on the bus
+    strip.startPushThread();
+
+    int count = strip.getLedCount();
+    uint16_t hue = 0;
+
+    while (shouldRun) {
+        // a rainbow moving along the strip
+        for (int i = 0; i < count; i++)
+            strip.setPixelHSV(i, (hue + i * 360 / count) % 360, 255, 255);
+
+        strip.show();
+
+        hue = (hue + 3) % 360;
+        upm_delay_ms(20);
+    }
+
+    strip.setPixels(0, count - 1, 0, 0, 0);
+    strip.show();
+    strip.stopPushThread();
+
+    cout << "Frames dropped: " << strip.getFramesDropped() << endl;
+    //! [Interesting]
+
+    cout << "Exiting..." << endl;
+
+    return 0;
+}
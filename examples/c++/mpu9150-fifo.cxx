@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <iostream>
+#include <signal.h>
+
+#include "mpu9150.hpp"
+#include "upm_utilities.h"
+
+using namespace std;
+
+int shouldRun = true;
+
+void
+sig_handler(int signo)
+{
+    if (signo == SIGINT)
+        shouldRun = false;
+}
+
+int
+main(int argc, char** argv)
+{
+    signal(SIGINT, sig_handler);
+    //! [Interesting]
+
+    upm::MPU9150 sensor;
+
+    sensor.init();
+
+    // 1Khz sample rate (the DLPF is enabled by init()), with the
+    // accelerometer, gyroscope and magnetometer stored in the FIFO
+    sensor.setSampleRateDivider(0);
+    sensor.enableFIFO(upm::MPU60X0::ACCEL_FIFO_EN | upm::MPU60X0::XG_FIFO_EN |
+                      upm::MPU60X0::YG_FIFO_EN | upm::MPU60X0::ZG_FIFO_EN |
+                      upm::MPU60X0::SLV0_FIFO_EN);
+
+    upm::MPU60X0::FIFO_SAMPLE_T samples[64];
+
+    while (shouldRun) {
+        // about 50 samples accumulate between reads
+        upm_delay_ms(50);
+
+        int count = sensor.readFIFO(samples, 64);
+        if (!count)
+            continue;
+
+        upm::MPU60X0::FIFO_SAMPLE_T* s = &samples[count - 1];
+
+        cout << "Read " << count << " samples, the latest at " << s->timestamp << "us:"
+             << endl;
+        cout << "Accelerometer: AX: " << s->accel[0] << " AY: " << s->accel[1]
+             << " AZ: " << s->accel[2] << endl;
+        cout << "Gyroscope:     GX: " << s->gyro[0] << " GY: " << s->gyro[1]
+             << " GZ: " << s->gyro[2] << endl;
+        cout << "Magnetometer:  MX: " << s->mag[0] << " MY: " << s->mag[1]
+             << " MZ: " << s->mag[2] << endl;
+        cout << "FIFO overflows: " << sensor.getFIFOOverflows() << endl;
+        cout << endl;
+    }
+
+    sensor.enableFIFO(0);
+
+    //! [Interesting]
+
+    cout << "Exiting..." << endl;
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <iostream>
+#include <math.h>
+#include <signal.h>
+
+#include "pca9685.hpp"
+#include "upm_utilities.h"
+
+using namespace std;
+
+bool shouldRun = true;
+
+void
+sig_handler(int signo)
+{
+    if (signo == SIGINT)
+        shouldRun = false;
+}
+
+int
+main(int argc, char** argv)
+{
+    signal(SIGINT, sig_handler);
+
+    //! [Interesting]
+    // Instantiate an PCA9685 on I2C bus 0, driving 16 servos
+    upm::PCA9685 servos(PCA9685_I2C_BUS, PCA9685_DEFAULT_I2C_ADDR);
+
+    // servos expect a 50Hz period
+    servos.setModeSleep(true);
+    servos.setPrescaleFromHz(50);
+    servos.setModeSleep(false);
+
+    // at 50Hz, a count is about 4.9us: 1ms (205) to 2ms (410) pulses
+    const int minPulse = 205;
+    const int maxPulse = 410;
+
+    float phase = 0;
+
+    while (shouldRun) {
+        // a wave along the servos: stage every channel, then move them
+        // all in one transfer
+        for (int i = 0; i < 16; i++) {
+            float pos = (sin(phase + i * 0.4) + 1) / 2;
+            servos.stageLedTimes(i, 0, minPulse + pos * (maxPulse - minPulse));
+        }
+
+        servos.writeStagedLeds();
+
+        phase += 0.1;
+        upm_delay_ms(20);
+    }
+
+    // center them all
+    servos.writeAllLeds(0, (minPulse + maxPulse) / 2);
+    //! [Interesting]
+
+    cout << "Exiting..." << endl;
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cmath>
+#include <iostream>
+#include <signal.h>
+#include <stdio.h>
+
+#include "ssd1351.hpp"
+#include "upm_utilities.h"
+
+#define BLACK 0x0000
+#define WHITE 0xFFFF
+#define RED 0xF800
+
+using namespace std;
+
+int shouldRun = true;
+
+void
+sig_handler(int signo)
+{
+    if (signo == SIGINT)
+        shouldRun = false;
+}
+
+int
+main(int argc, char** argv)
+{
+    signal(SIGINT, sig_handler);
+    //! [Interesting]
+    // Initialize display with pins
+    // oc = 0, dc = 1, r  = 2, si = 11, cl = 13
+    upm::SSD1351 display(0, 1, 2);
+
+    // Dial, sent once as a whole
+    display.fillScreen(BLACK);
+    display.drawCircle(64, 64, 60, WHITE);
+    display.setTextColor(WHITE, BLACK);
+    display.setTextSize(2);
+    display.refresh();
+
+    const float pi = 3.14159265f;
+    float angle = 0.0f;
+    char value[8];
+
+    while (shouldRun) {
+        // Redraw the needle and the reading.  Only the pixels that
+        // changed are sent, and while they are, the next frame is
+        // drawn.
+        display.fillCircle(64, 64, 55, BLACK);
+        display.drawLine(64, 64, 64 + 50 * cos(angle), 64 + 50 * sin(angle), RED);
+
+        snprintf(value, sizeof(value), "%3d", (int)(angle * 180 / pi) % 360);
+        display.setCursor(46, 90);
+        display.print(value);
+
+        display.refreshAsync();
+
+        angle += pi / 60;
+        upm_delay_ms(20);
+    }
+
+    display.waitRefresh();
+    //! [Interesting]
+
+    cout << "Exiting..." << endl;
+
+    return 0;
+}
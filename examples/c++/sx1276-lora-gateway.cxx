@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <iostream>
+#include <signal.h>
+#include <stdio.h>
+#include <string>
+
+#include "sx1276.hpp"
+
+using namespace std;
+
+int shouldRun = true;
+
+void
+sig_handler(int signo)
+{
+    if (signo == SIGINT)
+        shouldRun = false;
+}
+
+int
+main(int argc, char** argv)
+{
+    signal(SIGINT, sig_handler);
+    //! [Interesting]
+
+    // Instantiate an SX1276 using default parameters
+    upm::SX1276 sensor;
+
+    // 915Mhz
+    sensor.setChannel(915000000);
+
+    // Same LORA configuration as the sx1276-lora example, so that it
+    // can be used as a node talking to this gateway.
+    sensor.setTxConfig(sensor.MODEM_LORA, 14, 0, 125000, 7, 1, 8, false, true, false, 0, false);
+
+    sensor.setRxConfig(
+    sensor.MODEM_LORA, 125000, 7, 1, 0, 8, 5, false, 0, true, false, 0, false, true);
+
+    // Listen continuously, and answer every packet received.  Replies
+    // are queued and sent as soon as the radio is free, after which
+    // it goes back to listening.
+    sensor.startEngine();
+
+    int count = 0;
+    char buffer[64];
+
+    while (shouldRun) {
+        if (!sensor.waitRxPacket(1000))
+            continue;
+
+        while (sensor.readRxPacket()) {
+            cout << "Received Buffer: " << sensor.getRxBufferStr()
+                 << " RSSI: " << sensor.getRxRSSI()
+                 << " SNR: " << sensor.getRxSNR() << endl;
+
+            snprintf(buffer, sizeof(buffer), "Ack %d", count++);
+            if (!sensor.queueSendStr(string(buffer)))
+                cout << "TX queue full, reply dropped" << endl;
+        }
+
+        if (sensor.getRxDropped())
+            cout << "Packets dropped so far: " << sensor.getRxDropped() << endl;
+    }
+
+    sensor.flushTx(3000);
+    sensor.stopEngine();
+
+    //! [Interesting]
+
+    cout << "Exiting..." << endl;
+
+    return 0;
+}
@@ -80,7 +80,12 @@ ADS1015::ADS1015(std::string initStr) : ADS1X15(initStr)
 }
 
 
-ADS1015::~ADS1015(){};
+ADS1015::~ADS1015(){
+    // Stopped here as the scan engine uses the subclass overrides.
+    try {
+        scanStop();
+    } catch (std::exception&) {}
+};
 
 const char*
 ADS1015::getModuleName() {
@@ -27,7 +27,12 @@ ADS1115::ADS1115(std::string initStr) : ADS1X15(initStr) {
     ADS1X15::getCurrentConfig();
 }
 
-ADS1115::~ADS1115(){};
+ADS1115::~ADS1115(){
+    // Stopped here as the scan engine uses the subclass overrides.
+    try {
+        scanStop();
+    } catch (std::exception&) {}
+};
 
 void
 ADS1115::setSPS(ADSDATARATE rate){
@@ -11,6 +11,7 @@
 
 
 #include "ads1x15.hpp"
+#include "mraa/gpio.hpp"
 #include "mraa/i2c.hpp"
 #include "upm_string_parser.hpp"
 
@@ -43,6 +44,7 @@ ADS1X15::ADS1X15(int bus, uint8_t address) {
     m_bitShift = 0;
     m_conversionDelay = .001;
     m_config_reg = 0x0000;
+    scanInit();
 
 }
 
@@ -62,6 +64,7 @@ ADS1X15::ADS1X15(std::string initStr) : mraaIo(initStr)
     m_bitShift = 0;
     m_conversionDelay = .001;
     m_config_reg = 0x0000;
+    scanInit();
 
     std::vector<std::string> upmTokens;
 
@@ -205,9 +208,185 @@ ADS1X15::setThresh(ADSTHRESH reg, float value){
      }
 }
 
+unsigned int
+ADS1X15::addScanChannel(ADSMUXMODE mode, ADSGAIN gain){
+     if(m_scanRunning)
+          throw std::runtime_error(std::string(__FUNCTION__) + ": scan engine is running");
+     m_scanConfig.push_back(mode | gain);
+     return m_scanConfig.size() - 1;
+}
+
+void
+ADS1X15::clearScanChannels(){
+     if(m_scanRunning)
+          throw std::runtime_error(std::string(__FUNCTION__) + ": scan engine is running");
+     m_scanConfig.clear();
+}
+
+void
+ADS1X15::scanStart(int readyPin, unsigned int depth){
+     if(m_scanConfig.empty())
+          throw std::invalid_argument(std::string(__FUNCTION__) + ": no scan channels");
+     if(!depth)
+          throw std::invalid_argument(std::string(__FUNCTION__) + ": depth must be > 0");
+
+     scanStop();
+
+     m_scanRing.assign(depth, ads1x15_sample());
+     m_scanHead = 0;
+     m_scanSize = 0;
+     m_scanOverruns = 0;
+     m_scanCount = 0;
+     m_scanIndex = 0;
+     m_scanSavedConfig = m_config_reg;
+
+     // Pulse ALERT/RDY after every conversion
+     setThresh(CONVERSION_RDY);
+
+     m_scanBegin = std::chrono::steady_clock::now();
+     // Kept in step without reading it back, so getLastSample() scales
+     // with the gain of the entry being converted.
+     m_config_reg = writeScanConfig(m_scanConfig[0]);
+     m_scanRunning = true;
+
+     if(readyPin >= 0){
+          m_gpioReady = new mraa::Gpio(readyPin);
+          mraa::Edge edge = getCompPol() ? mraa::EDGE_RISING : mraa::EDGE_FALLING;
+          if(m_gpioReady->dir(mraa::DIR_IN) != mraa::SUCCESS ||
+             m_gpioReady->isr(edge, scanISR, this) != mraa::SUCCESS){
+               scanStop();
+               throw std::runtime_error(std::string(__FUNCTION__) + ": Gpio.isr() failed");
+          }
+     }
+     else{
+          m_scanThread = std::thread([this]{
+               // The internal oscillator may run up to 10% slow, and the
+               // OS bit can't be polled in continuous mode, so wait a
+               // little longer than the nominal conversion time.
+               while(m_scanRunning){
+                    usleep(m_conversionDelay + m_conversionDelay / 8);
+                    scanNext();
+               }
+          });
+     }
+}
+
+void
+ADS1X15::scanStop(){
+     if(!m_scanRunning) return;
+     m_scanRunning = false;
+
+     if(m_gpioReady){
+          m_gpioReady->isrExit();
+          delete m_gpioReady;
+          m_gpioReady = NULL;
+     }
+     if(m_scanThread.joinable()) m_scanThread.join();
+
+     updateConfigRegister(m_scanSavedConfig);
+     setThresh(THRESH_DEFAULT);
+}
+
+unsigned int
+ADS1X15::scanAvailable(){
+     std::lock_guard<std::mutex> lock(m_scanMutex);
+     return m_scanSize;
+}
+
+bool
+ADS1X15::getScanSample(ads1x15_sample &sample){
+     std::lock_guard<std::mutex> lock(m_scanMutex);
+     if(!m_scanSize) return false;
+     unsigned int tail = (m_scanHead + m_scanRing.size() - m_scanSize) % m_scanRing.size();
+     sample = m_scanRing[tail];
+     m_scanSize--;
+     return true;
+}
+
+float
+ADS1X15::getScanSamplesPerSecond(){
+     std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - m_scanBegin;
+     if(elapsed.count() <= 0) return 0.0;
+     return m_scanCount / elapsed.count();
+}
+
 
 //Private functions
 void
+ADS1X15::scanInit(){
+     m_scanIndex = 0;
+     m_scanSavedConfig = 0x0000;
+     m_scanRunning = false;
+     m_scanOverruns = 0;
+     m_scanCount = 0;
+     m_scanHead = 0;
+     m_scanSize = 0;
+     m_gpioReady = NULL;
+}
+
+void
+ADS1X15::scanISR(void *ctx){
+     static_cast<ADS1X15 *>(ctx)->scanNext();
+}
+
+void
+ADS1X15::scanNext(){
+     if(!m_scanRunning) return;
+
+     ads1x15_sample sample;
+     std::chrono::steady_clock::time_point ready = std::chrono::steady_clock::now();
+     uint16_t next = m_config_reg;
+     try{
+          // Writing the next entry first restarts the conversion with the
+          // new mux and gain right away. The conversion register keeps the
+          // finished result until the new conversion completes, and
+          // m_config_reg still holds the gain it was converted with.
+          sample.channel = m_scanIndex;
+          sample.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+                    ready - m_scanBegin).count();
+          if(m_scanConfig.size() > 1){
+               m_scanIndex = (m_scanIndex + 1) % m_scanConfig.size();
+               next = writeScanConfig(m_scanConfig[m_scanIndex]);
+          }
+          sample.value = getLastSample();
+          m_config_reg = next;
+
+          // If we were held up long enough for the next conversion to
+          // finish, the result may belong to the next entry; drop it.
+          if(m_scanConfig.size() > 1 &&
+             std::chrono::steady_clock::now() - ready >
+             std::chrono::microseconds((int)(m_conversionDelay * 2 / 3))){
+               m_scanOverruns++;
+               return;
+          }
+     }
+     catch(std::exception &e){
+          m_config_reg = next;
+          syslog(LOG_WARNING, "%s: %s", std::string(__FUNCTION__).c_str(), e.what());
+          return;
+     }
+
+     std::lock_guard<std::mutex> lock(m_scanMutex);
+     m_scanRing[m_scanHead] = sample;
+     m_scanHead = (m_scanHead + 1) % m_scanRing.size();
+     if(m_scanSize < m_scanRing.size()) m_scanSize++;
+      else m_scanOverruns++;
+     m_scanCount++;
+}
+
+uint16_t
+ADS1X15::writeScanConfig(uint16_t config){
+     uint16_t update = (m_config_reg & ~(ADS1X15_OS_MASK | ADS1X15_MUX_MASK |
+                                         ADS1X15_PGA_MASK | ADS1X15_MODE_MASK |
+                                         ADS1X15_CLAT_MASK | ADS1X15_CQUE_MASK))
+                       | config | ADS1X15_MODE_CONTIN | ADS1X15_CLAT_NONLAT
+                       | CQUE_1CONV;
+     if(i2c->writeWordReg(ADS1X15_REG_POINTER_CONFIG, swapWord(update)) != mraa::SUCCESS){
+            throw std::runtime_error(std::string(__FUNCTION__) + ": I2c.write() failed");
+     }
+     return update;
+}
+void
 ADS1X15::getCurrentConfig(){
      m_config_reg = i2c->readWordReg(ADS1X15_REG_POINTER_CONFIG);
      m_config_reg = swapWord(m_config_reg);
@@ -11,11 +11,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include <mraa/initio.hpp>
 
-namespace mraa {class I2c;}
+namespace mraa {class I2c; class Gpio;}
 
 /*=========================================================================
     I2C ADDRESS/BITS
@@ -89,6 +94,18 @@ namespace mraa {class I2c;}
 /*=========================================================================*/
 
 namespace upm {
+  /**
+   * @brief A timestamped conversion result produced by the ADS1X15 scan engine
+   */
+  struct ads1x15_sample {
+      /** Index of the scan channel the result belongs to */
+      unsigned int channel;
+      /** Converted value in volts */
+      float value;
+      /** Microseconds between scanStart() and reading the result */
+      uint64_t timestamp;
+  };
+
   /**
    * @brief ADS1X15 Family ADC Library
    *
@@ -401,6 +418,96 @@ namespace upm {
              */
             void setThresh(ADSTHRESH reg = THRESH_DEFAULT , float value = 0.0);
 
+            /**
+             * Adds an entry to the list of mux/gain settings cycled through
+             * by the scan engine. Entries are converted round-robin in the
+             * order they were added; the entry index is reported as the
+             * channel of each sample.
+             *
+             * @param mode ADSMUXMODE enum, the input(s) to convert
+             * @param gain ADSGAIN enum, the PGA setting for this entry
+             * @return Index of the new entry
+             */
+            unsigned int addScanChannel(ADSMUXMODE mode = ADS1X15::DIFF_0_1,
+                                        ADSGAIN gain = ADS1X15::GAIN_TWO);
+
+            /**
+             * Removes all entries from the scan list. The scan engine must
+             * be stopped.
+             */
+            void clearScanChannels();
+
+            /**
+             * Returns the number of entries in the scan list.
+             */
+            unsigned int getScanChannelCount() {
+                return m_scanConfig.size();
+            }
+
+            /**
+             * Starts the scan engine. The device is put in continuous
+             * conversion mode with the ALERT/RDY pin configured as a
+             * conversion ready output. On each conversion the result is
+             * read, the mux and gain for the next entry are written and
+             * the timestamped result is stored in a ring of depth
+             * samples. When the ring is full the oldest sample is
+             * overwritten.
+             *
+             * If readyPin is a valid GPIO connected to ALERT/RDY, the
+             * result is fetched from its interrupt. Otherwise a thread
+             * fetches it after the nominal conversion time plus a margin
+             * for the oscillator tolerance, which gives a lower rate.
+             *
+             * The device configuration must not be changed while the scan
+             * engine is running.
+             *
+             * @param readyPin GPIO connected to ALERT/RDY, -1 for none
+             * @param depth Number of samples held in the ring
+             */
+            void scanStart(int readyPin = -1, unsigned int depth = 1024);
+
+            /**
+             * Stops the scan engine and restores the configuration from
+             * before scanStart(). Samples left in the ring can still be
+             * read.
+             */
+            void scanStop();
+
+            /**
+             * Returns true while the scan engine is running.
+             */
+            bool scanRunning() {
+                return m_scanRunning;
+            }
+
+            /**
+             * Returns the number of samples waiting in the ring.
+             */
+            unsigned int scanAvailable();
+
+            /**
+             * Removes the oldest sample from the ring.
+             *
+             * @param sample Filled in with the oldest sample
+             * @return true if a sample was available, false otherwise
+             */
+            bool getScanSample(ads1x15_sample &sample);
+
+            /**
+             * Returns the number of samples lost since scanStart(), either
+             * overwritten in the ring before being read or dropped because
+             * the result could not be fetched before the next conversion.
+             */
+            unsigned int getScanOverruns() {
+                return m_scanOverruns;
+            }
+
+            /**
+             * Returns the number of conversions per second, over all scan
+             * channels, achieved since scanStart().
+             */
+            float getScanSamplesPerSecond();
+
             /**
              * Get upm parameters for converter initialization
              */
@@ -422,4 +529,26 @@ namespace upm {
             mraa::MraaIo mraaIo;
             mraa::I2c* i2c;
 
+        private:
+            // Scan engine state. The ring is protected by m_scanMutex, the
+            // rest is only touched by the thread fetching the results.
+            std::vector<uint16_t> m_scanConfig;
+            unsigned int m_scanIndex;
+            uint16_t m_scanSavedConfig;
+            std::atomic<bool> m_scanRunning;
+            std::atomic<unsigned int> m_scanOverruns;
+            std::atomic<unsigned int> m_scanCount;
+            std::chrono::steady_clock::time_point m_scanBegin;
+            std::vector<ads1x15_sample> m_scanRing;
+            unsigned int m_scanHead;
+            unsigned int m_scanSize;
+            std::mutex m_scanMutex;
+            std::thread m_scanThread;
+            mraa::Gpio* m_gpioReady;
+
+            void scanInit();
+            void scanNext();
+            uint16_t writeScanConfig(uint16_t config);
+            static void scanISR(void *ctx);
+
     };}
@@ -26,10 +26,9 @@ static bool operator!(mraa::MraaIo &mraaIo)
 }
 
 APA102::APA102(uint16_t ledCount, uint8_t spiBus, bool batchMode, int8_t csn)
-        : m_ledCount(ledCount), m_batchMode(batchMode)
+        : m_batchMode(batchMode)
 {
     mraa::Result res = mraa::SUCCESS;
-    m_leds = NULL;
 
     // Optional chip select pin
     m_csnPinCtx = NULL;
@@ -46,28 +45,13 @@ APA102::APA102(uint16_t ledCount, uint8_t spiBus, bool batchMode, int8_t csn)
     // Initialize SPI
     m_spi = new mraa::Spi(spiBus);
 
-    // Initialize LED array
-    uint16_t endFrameLength = (m_ledCount + 15) / 16; // End frame should be (leds/2) bits
-    m_frameLength = endFrameLength + (m_ledCount + 1) * 4;
-    if ((m_leds = (uint8_t*) malloc(m_frameLength))) {
-        memset(m_leds, 0x00, m_frameLength - 4);                               // Clear state
-        memset(&m_leds[m_frameLength - endFrameLength], 0xFF, endFrameLength); // Frame End
-
-        // Need to set the brightness to "0" for each Led
-        for (int i = 1; i <= m_ledCount; i++) {
-            m_leds[i * 4] = 224;
-        }
-
-    } else {
-        throw std::runtime_error(std::string(__FUNCTION__) +
-                                 ": Failed to allocate memory for LED Strip");
-    }
+    initLeds(ledCount);
 }
 
 APA102::APA102(std::string initStr) : mraaIo(initStr)
 {
     mraa::Result res = mraa::SUCCESS;
-    m_leds = NULL;
+    uint16_t ledCount = 0;
     m_batchMode = false;
 
     std::vector<std::string> upmTokens;
@@ -79,7 +63,7 @@ APA102::APA102(std::string initStr) : mraaIo(initStr)
     std::string::size_type sz, prev_sz;;
     for (std::string tok : upmTokens) {
         if(tok.substr(0, 9) == "ledCount:") {
-            m_ledCount = (uint16_t)std::stoi(tok.substr(9), nullptr, 0);
+            ledCount = (uint16_t)std::stoi(tok.substr(9), nullptr, 0);
         }
         if(tok.substr(0, 10) == "batchMode:") {
             m_batchMode = std::stoi(tok.substr(10), nullptr, 0);
@@ -106,21 +90,7 @@ APA102::APA102(std::string initStr) : mraaIo(initStr)
                                     ": mraa_spi_init failed");
     }
 
-    // Initialize LED array
-    uint16_t endFrameLength = (m_ledCount + 15) / 16; // End frame should be (leds/2) bits
-    m_frameLength = endFrameLength + (m_ledCount + 1) * 4;
-    if ((m_leds = (uint8_t*) malloc(m_frameLength))) {
-        memset(m_leds, 0x00, m_frameLength - 4);                               // Clear state
-        memset(&m_leds[m_frameLength - endFrameLength], 0xFF, endFrameLength); // Frame End
-
-        // Need to set the brightness to "0" for each Led
-        for (int i = 1; i <= m_ledCount; i++) {
-            m_leds[i * 4] = 224;
-        }
-    } else {
-        throw std::runtime_error(std::string(__FUNCTION__) +
-                                 ": Failed to allocate memory for LED Strip");
-    }
+    initLeds(ledCount);
 
 
     for (std::string tok : upmTokens) {
@@ -198,10 +168,8 @@ APA102::APA102(std::string initStr) : mraaIo(initStr)
 
 APA102::~APA102()
 {
-    // Clear leds
-    if (m_leds) {
-        free(m_leds);
-    }
+    stopPushThread();
+
     if(!mraaIo) {
         // Clear SPI
         if (m_spi) {
@@ -237,29 +205,15 @@ APA102::setAllLeds(uint8_t brightness, uint8_t r, uint8_t g, uint8_t b)
 void
 APA102::setLeds(uint16_t startIdx, uint16_t endIdx, uint8_t brightness, uint8_t r, uint8_t g, uint8_t b)
 {
-    uint16_t s_idx = (startIdx + 1) * 4;
-    uint16_t e_idx = (endIdx + 1) * 4;
-
-    for (uint16_t i = s_idx; i <= e_idx; i += 4) {
-        m_leds[i] = brightness | 224;
-        m_leds[i + 1] = b;
-        m_leds[i + 2] = g;
-        m_leds[i + 3] = r;
-    }
-
-    if (!m_batchMode) {
-        pushState();
-    }
+    setPixels(startIdx, endIdx, r, g, b);
+    setLedsBrightness(startIdx, endIdx, brightness);
 }
 
 void
 APA102::setLedsBrightness(uint16_t startIdx, uint16_t endIdx, uint8_t brightness)
 {
-    uint16_t s_idx = (startIdx + 1) * 4;
-    uint16_t e_idx = (endIdx + 1) * 4;
-
-    for (uint16_t i = s_idx; i <= e_idx; i += 4) {
-        m_leds[i] = brightness | 224;
+    for (uint16_t i = startIdx; i <= endIdx && i < m_ledCount; i++) {
+        m_ledBrightness[i] = brightness & 0x1F;
     }
 
     if (!m_batchMode) {
@@ -270,8 +224,10 @@ APA102::setLedsBrightness(uint16_t startIdx, uint16_t endIdx, uint8_t brightness
 void
 APA102::setLeds(uint16_t startIdx, uint16_t endIdx, uint8_t* colors)
 {
-    uint16_t s_idx = (startIdx + 1) * 4;
-    memcpy(&m_leds[s_idx], colors, (endIdx - startIdx + 1) * 4);
+    for (uint16_t i = startIdx; i <= endIdx; i++, colors += 4) {
+        m_ledBrightness[i] = colors[0] & 0x1F;
+        setPixel(i, colors[3], colors[2], colors[1]);
+    }
 
     if (!m_batchMode) {
         pushState();
@@ -289,10 +245,39 @@ APA102::setBusSpeed(int hz)
 
 void
 APA102::pushState(void)
+{
+    show();
+}
+
+/*
+ * ****************
+ *  protected area
+ * ****************
+ */
+
+void
+APA102::encodeFrame(uint8_t *frame)
+{
+    // Start frame
+    memset(frame, 0x00, 4);
+
+    uint8_t *led = frame + 4;
+    for (int i = 0; i < m_ledCount; i++, led += 4) {
+        led[0] = m_ledBrightness[i] | 224;
+        led[1] = m_wire[m_rgb[i * 3 + 2]];
+        led[2] = m_wire[m_rgb[i * 3 + 1]];
+        led[3] = m_wire[m_rgb[i * 3]];
+    }
+
+    // End frame should be (leds/2) bits
+    memset(led, 0xFF, (m_ledCount + 15) / 16);
+}
+
+void
+APA102::writeFrame(const uint8_t *frame, int len)
 {
     CSOn();
-    uint8_t* recv = m_spi->write(m_leds, m_frameLength);
-    if (recv != NULL) free(recv);
+    spiWrite(*m_spi, frame, len);
     CSOff();
 }
 
@@ -302,6 +287,14 @@ APA102::pushState(void)
  * **************
  */
 
+void
+APA102::initLeds(uint16_t ledCount)
+{
+    // Brightness starts at "0" for each Led
+    m_ledBrightness.assign(ledCount, 0);
+    initStrip(ledCount, 4 + ledCount * 4 + (ledCount + 15) / 16);
+}
+
 mraa::Result
 APA102::CSOn()
 {
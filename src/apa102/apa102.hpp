@@ -14,6 +14,9 @@
 #include <mraa/spi.hpp>
 #include <mraa/initio.hpp>
 #include <string>
+#include <vector>
+
+#include "ledstrip.hpp"
 
 #define HIGH 1
 #define LOW 0
@@ -40,10 +43,14 @@ namespace upm
  * APA102 LED Strips provide individually controllable LEDs through a SPI interface.
  * For each LED, brightness (0-31) and RGB (0-255) values can be set.
  *
+ * The pixel functions, gamma, global brightness and background push
+ * thread of LEDStrip are available as well; see the LPD8806 for an
+ * example.
+ *
  * @image html apa102.jpg
  * @snippet apa102.cxx Interesting
  */
-class APA102
+class APA102 : public LEDStrip
 {
   public:
     /**
@@ -150,6 +157,10 @@ class APA102
      */
     void pushState();
 
+  protected:
+    void encodeFrame(uint8_t *frame);
+    void writeFrame(const uint8_t *frame, int len);
+
   private:
     /* Disable implicit copy and assignment operators */
     APA102(const APA102&) = delete;
@@ -159,12 +170,13 @@ class APA102
     mraa::Spi* m_spi;
     mraa::Gpio* m_csnPinCtx;
 
-    uint16_t m_ledCount;
-    uint8_t* m_leds;
-    uint16_t m_frameLength;
+    // 5 bit brightness of each LED
+    std::vector<uint8_t> m_ledBrightness;
 
     bool m_batchMode;
 
+    void initLeds(uint16_t ledCount);
+
     mraa::Result CSOn();
     mraa::Result CSOff();
 };
@@ -46,7 +46,9 @@ JAVA_JNI_LOADLIBRARY(javaupm_apa102)
 
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
 %{
+#include "ledstrip.hpp"
 #include "apa102.hpp"
 %}
+%include "ledstrip.hpp"
 %include "apa102.hpp"
 /* END Common SWIG syntax */
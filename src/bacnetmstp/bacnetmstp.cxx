@@ -10,7 +10,11 @@
  */
 
 #include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <iostream>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <sstream>
@@ -21,10 +25,21 @@
 #include "client.h"
 #include "txbuf.h"
 #include "mstpdef.h"
+#include "rpm.h"
 
 using namespace upm;
 using namespace std;
 
+// Estimated encoded sizes, in bytes, of the parts of a
+// ReadPropertyMultiple-ACK, used to fit requests into the target
+// device's maximum APDU.  Values are assumed to take at most 10
+// bytes.  Longer ones, like strings, can overflow the estimate, in
+// which case the device aborts and the request is split.
+static const size_t RPM_ACK_HEADER_LEN = 3;
+static const size_t RPM_OBJECT_LEN = 7;
+static const size_t RPM_PROPERTY_LEN = 15;
+static const size_t RPM_ARRAY_INDEX_LEN = 5;
+
 // our singleton instance
 BACNETMSTP* BACNETMSTP::m_instance = 0;
 
@@ -46,9 +61,10 @@ BACNETMSTP::BACNETMSTP()
   memset(m_rxBuffer, 0, MAX_MPDU);
 
   m_returnedValue.clear();
-  m_targetAddress = {0};
-  m_invokeID = 0;
-  m_errorDetected = false;
+
+  m_nextRequestID = 1;
+  m_maxOutstanding = 8;
+  m_lastTimerMS = monotonicMS();
 
   setDebug(false);
 }
@@ -90,17 +106,17 @@ void BACNETMSTP::handlerError(BACNET_ADDRESS* src,
   if (instance()->m_debugging)
     cerr << __FUNCTION__ << ": entered" << endl;
 
-  if (address_match(&(instance()->m_targetAddress), src) &&
-      (invoke_id == instance()->m_invokeID))
+  BACREQ_T* req = instance()->findRequest(src, invoke_id);
+  if (req)
     {
-      instance()->m_errorType = BACERR_TYPE_ERROR;
-      instance()->m_errorClass = error_class;
-      instance()->m_errorCode = error_code;
-      instance()->m_errorString =
+      req->result.errorType = BACERR_TYPE_ERROR;
+      req->result.errorClass = error_class;
+      req->result.errorCode = error_code;
+      req->result.errorString =
         bactext_error_class_name((int)error_class)
         + string(": ") + bactext_error_code_name((int)error_code);
 
-      instance()->m_errorDetected = true;
+      req->done = true;
   }
 }
 
@@ -114,15 +130,15 @@ void BACNETMSTP::handlerAbort(BACNET_ADDRESS* src,
   if (instance()->m_debugging)
     cerr << __FUNCTION__ << ": entered" << endl;
 
-  if (address_match(&(instance()->m_targetAddress), src) &&
-      (invoke_id == instance()->m_invokeID))
+  BACREQ_T* req = instance()->findRequest(src, invoke_id);
+  if (req)
     {
-      instance()->m_errorType = BACERR_TYPE_ABORT;
-      instance()->m_abortReason = abort_reason;
-      instance()->m_abortString =
+      req->result.errorType = BACERR_TYPE_ABORT;
+      req->result.abortReason = abort_reason;
+      req->result.abortString =
         bactext_abort_reason_name((int)abort_reason);
 
-      instance()->m_errorDetected = true;
+      req->done = true;
     }
 }
 
@@ -133,15 +149,15 @@ void BACNETMSTP::handlerReject(BACNET_ADDRESS* src,
   if (instance()->m_debugging)
     cerr << __FUNCTION__ << ": entered" << endl;
 
-  if (address_match(&(instance()->m_targetAddress), src) &&
-      (invoke_id == instance()->m_invokeID))
+  BACREQ_T* req = instance()->findRequest(src, invoke_id);
+  if (req)
     {
-      instance()->m_errorType = BACERR_TYPE_REJECT;
-      instance()->m_rejectReason = reject_reason;
-      instance()->m_rejectString =
+      req->result.errorType = BACERR_TYPE_REJECT;
+      req->result.rejectReason = reject_reason;
+      req->result.rejectString =
         bactext_reject_reason_name((int)reject_reason);
 
-      instance()->m_errorDetected = true;
+      req->done = true;
     }
 }
 
@@ -153,73 +169,195 @@ void BACNETMSTP::handlerReadPropertyAck(uint8_t* service_request,
   int len = 0;
   BACNET_READ_PROPERTY_DATA data;
 
-  // clear our stored data
-  instance()->m_returnedValue.clear();
-
   BACNET_APPLICATION_DATA_VALUE value;
   memset((void *)&value, 0, sizeof(value));
 
   uint8_t *application_data = 0;
   int application_data_len = 0;
 
-  if (address_match(&(instance()->m_targetAddress), src) &&
-      (service_data->invoke_id == instance()->m_invokeID))
-    {
-      if (instance()->m_debugging)
-        cerr << __FUNCTION__ << ": got readProp ack" << endl;
+  BACREQ_T* req = instance()->findRequest(src, service_data->invoke_id);
+  if (!req)
+    return;
+
+  if (instance()->m_debugging)
+    cerr << __FUNCTION__ << ": got readProp ack" << endl;
+
+  // readPropertyMultiple requests to devices without
+  // ReadPropertyMultiple read one property at a time
+  vector<BACNET_APPLICATION_DATA_VALUE>& values =
+    (req->cmd == BACCMD_READ_PROPERTY_MULTIPLE)
+    ? req->props.at(req->propsNext).values : req->result.values;
+
+  // clear our stored data
+  values.clear();
+
+  len = rp_ack_decode_service_request(service_request, service_len,
+                                      &data);
 
-      len = rp_ack_decode_service_request(service_request, service_len,
-                                          &data);
+  // store any delivered data elements
+  if (len > 0)
+    {
+      application_data_len = data.application_data_len;
+      application_data = data.application_data;
 
-      // store any delivered data elements
-      if (len > 0)
+      while (true)
         {
-          application_data_len = data.application_data_len;
-          application_data = data.application_data;
+          len = bacapp_decode_application_data(application_data,
+                                               application_data_len,
+                                               &value);
+          if (len > 0)
+            {
+              // store a copy
+              values.push_back(value);
+
+              if (len < application_data_len)
+                {
+                  // there is more data
+                  application_data += len;
+                  application_data_len -= len;
+                }
+              else
+                {
+                  // we are done
+                  break;
+                }
+            }
+          else
+            {
+              // shouldn't happen?
+              cerr << __FUNCTION__ << ": decode app data failed" << endl;
+              break;
+            }
+        }
+    }
+
+  // a property without any value can't be used, report it as failed
+  if (req->cmd == BACCMD_READ_PROPERTY_MULTIPLE && values.empty())
+    {
+      BACPROP_T& prop = req->props.at(req->propsNext);
+
+      prop.error = true;
+      prop.errorClass = ERROR_CLASS_DEVICE;
+      prop.errorCode = ERROR_CODE_OTHER;
+    }
+
+  if (instance()->m_debugging)
+    cerr << __FUNCTION__ << ": STORED "
+         << values.size()
+         << " data elements." << endl;
+}
+
+void BACNETMSTP::handlerReadPropertyMultipleAck(uint8_t* service_request,
+                                                uint16_t service_len,
+                                                BACNET_ADDRESS* src,
+                                                BACNET_CONFIRMED_SERVICE_ACK_DATA* service_data)
+{
+  BACREQ_T* req = instance()->findRequest(src, service_data->invoke_id);
+  if (!req || req->cmd != BACCMD_READ_PROPERTY_MULTIPLE)
+    return;
+
+  if (instance()->m_debugging)
+    cerr << __FUNCTION__ << ": got readPropMultiple ack" << endl;
+
+  // the decoder allocates every element of the list, as in the
+  // bacnet-stack demo client.
+  BACNET_READ_ACCESS_DATA* rpmData =
+    (BACNET_READ_ACCESS_DATA *)calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+  if (!rpmData)
+    return;
+
+  int len = rpm_ack_decode_service_request(service_request, service_len,
+                                           rpmData);
+  if (len <= 0)
+    cerr << __FUNCTION__ << ": decode service request failed" << endl;
+
+  // the device returns the properties in the order they were
+  // requested.
+  size_t next = req->propsNext;
+  size_t end = req->propsNext + req->propsCount;
+
+  while (rpmData)
+    {
+      BACNET_PROPERTY_REFERENCE* rpmProperty = rpmData->listOfProperties;
 
-          while (true)
+      while (rpmProperty)
+        {
+          if (next < end
+              && req->props[next].objType == rpmData->object_type
+              && req->props[next].objInstance == rpmData->object_instance
+              && req->props[next].objProperty
+                 == rpmProperty->propertyIdentifier)
             {
-              len = bacapp_decode_application_data(application_data,
-                                                   application_data_len,
-                                                   &value);
-              if (len > 0)
+              BACPROP_T& prop = req->props[next++];
+
+              prop.values.clear();
+
+              if (rpmProperty->value)
                 {
-                  // store a copy
-                  instance()->m_returnedValue.push_back(value);
+                  prop.error = false;
 
-                  if (len < application_data_len)
+                  for (BACNET_APPLICATION_DATA_VALUE* value =
+                         rpmProperty->value; value; value = value->next)
                     {
-                      // there is more data
-                      application_data += len;
-                      application_data_len -= len;
-                    }
-                  else
-                    {
-                      // we are done
-                      break;
+                      // store a copy
+                      prop.values.push_back(*value);
+                      prop.values.back().next = 0;
                     }
                 }
               else
                 {
-                  // shouldn't happen?
-                  cerr << __FUNCTION__ << ": decode app data failed" << endl;
-                  break;
+                  prop.error = true;
+                  prop.errorClass = rpmProperty->error.error_class;
+                  prop.errorCode = rpmProperty->error.error_code;
                 }
             }
+
+          BACNET_APPLICATION_DATA_VALUE* value = rpmProperty->value;
+          while (value)
+            {
+              BACNET_APPLICATION_DATA_VALUE* oldValue = value;
+              value = value->next;
+              free(oldValue);
+            }
+
+          BACNET_PROPERTY_REFERENCE* oldProperty = rpmProperty;
+          rpmProperty = rpmProperty->next;
+          free(oldProperty);
         }
+
+      BACNET_READ_ACCESS_DATA* oldData = rpmData;
+      rpmData = rpmData->next;
+      free(oldData);
     }
 
   if (instance()->m_debugging)
-    cerr << __FUNCTION__ << ": STORED "
-         << instance()->m_returnedValue.size()
-         << " data elements." << endl;
+    cerr << __FUNCTION__ << ": STORED " << (next - req->propsNext)
+         << " of " << req->propsCount << " properties." << endl;
+
+  // a device may return fewer properties than were asked for.  Only
+  // the ones returned count as read, so that the next transaction
+  // starts again at the first missing one.  If none came back, give
+  // up on that one, so that the request still moves on.
+  if (next < end)
+    {
+      if (next == req->propsNext)
+        {
+          BACPROP_T& prop = req->props[next++];
+
+          prop.error = true;
+          prop.errorClass = ERROR_CLASS_PROPERTY;
+          prop.errorCode = ERROR_CODE_UNKNOWN_PROPERTY;
+          prop.values.clear();
+        }
+
+      req->propsCount = next - req->propsNext;
+    }
 }
 
 void BACNETMSTP::handlerWritePropertyAck(BACNET_ADDRESS* src,
                                          uint8_t invoke_id)
 {
-  if (address_match(&(instance()->m_targetAddress), src) &&
-      (invoke_id == instance()->m_invokeID))
+  if (instance()->findRequest(src, invoke_id))
     {
       if (instance()->m_debugging)
         cerr << __FUNCTION__ << ": got writeProp ack" << endl;
@@ -254,12 +392,18 @@ void BACNETMSTP::initServiceHandlers()
   apdu_set_confirmed_ack_handler(SERVICE_CONFIRMED_READ_PROPERTY,
                                  handlerReadPropertyAck);
 
+  // handle the data coming back from confirmed readPropMultiple
+  // requests
+  apdu_set_confirmed_ack_handler(SERVICE_CONFIRMED_READ_PROP_MULTIPLE,
+                                 handlerReadPropertyMultipleAck);
+
   // handle the simple ack for confirmed writeProp requests
   apdu_set_confirmed_simple_ack_handler(SERVICE_CONFIRMED_WRITE_PROPERTY,
                                         handlerWritePropertyAck);
 
   // handle any errors coming back
   apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROPERTY, handlerError);
+  apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROP_MULTIPLE, handlerError);
   apdu_set_abort_handler(handlerAbort);
   apdu_set_reject_handler(handlerReject);
 }
@@ -357,216 +501,506 @@ void BACNETMSTP::initMaster(string port, int baudRate,
   m_initialized = true;
 }
 
-bool BACNETMSTP::dispatchRequest()
+uint32_t BACNETMSTP::monotonicMS()
 {
-  uint16_t pdu_len = 0;
-  unsigned timeout = 100;     // milliseconds
-  unsigned max_apdu = 0;
-  time_t elapsed_seconds = 0;
-  time_t last_seconds = 0;
-  time_t current_seconds = 0;
-  time_t timeout_seconds = 0;
-  bool found = false;
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
 
-  // address where message came from
-  BACNET_ADDRESS src = {0};
+  return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
 
-  clearErrors();
-  m_errorDetected = false;
+void BACNETMSTP::updateTimers()
+{
+  uint32_t now = monotonicMS();
+  uint32_t elapsed = now - m_lastTimerMS;
 
-  uint32_t targetDeviceInstanceID = BACNET_MAX_INSTANCE;
+  m_lastTimerMS = now;
 
-  switch (m_command.cmd)
+  // the TSM takes at most 65535ms at a time
+  while (elapsed)
     {
-    case BACCMD_READ_PROPERTY:
-      targetDeviceInstanceID = m_command.readPropArgs.targetDeviceInstanceID;
-      break;
+      uint16_t step = (elapsed > 0xffff) ? 0xffff : elapsed;
+      tsm_timer_milliseconds(step);
+      elapsed -= step;
+    }
+}
 
-    case BACCMD_WRITE_PROPERTY:
-      targetDeviceInstanceID = m_command.writePropArgs.targetDeviceInstanceID;
-      break;
+BACNETMSTP::BACREQ_T* BACNETMSTP::findRequest(BACNET_ADDRESS* src,
+                                              uint8_t invoke_id)
+{
+  for (auto& req : m_requests)
+    {
+      if (req.invokeID && !req.done && req.invokeID == invoke_id
+          && address_match(&req.targetAddress, src))
+        return &req;
+    }
 
-    case BACCMD_NONE:
-      {
-        m_errorType = BACERR_TYPE_UPM;
-        m_upmErrorString = string(__FUNCTION__) +
-          ": called with BACCMD_NONE, ignoring";
+  return 0;
+}
 
-        return true; // error
-      }
+int BACNETMSTP::queueRequest(BACREQ_T& req, BACREQ_CALLBACK_T callback)
+{
+  req.targetAddress = {0};
+  req.bound = false;
+  req.queuedMS = monotonicMS();
+  req.invokeID = 0;
+  req.done = false;
 
-      break;
+  req.propsNext = 0;
+  req.propsCount = 0;
+  req.propsLimit = req.props.size();
+  req.maxAPDU = MAX_APDU;
 
-    default:
-      {
-        // should this throw?
-        m_errorType = BACERR_TYPE_UPM;
-        m_upmErrorString = string(__FUNCTION__) +
-          ": internal error, called with unknown command, ignoring";
+  req.result.requestID = m_nextRequestID;
+  req.result.errorType = BACERR_TYPE_NONE;
+  req.result.rejectReason = REJECT_REASON_OTHER;
+  req.result.abortReason = ABORT_REASON_OTHER;
+  req.result.errorClass = ERROR_CLASS_DEVICE;
+  req.result.errorCode = ERROR_CODE_OTHER;
 
-        return true; // error
-      }
+  req.callback = callback;
 
-      break;
-    }
+  // IDs are positive
+  if (++m_nextRequestID <= 0)
+    m_nextRequestID = 1;
 
-  // timeouts
-  last_seconds = time(NULL);
-  timeout_seconds = (apdu_timeout() / 1000) * apdu_retries();
+  m_requests.push_back(req);
 
-  // we use 0 to indicate that request hasn't been made yet, so that
-  // it will be made once the address is bound.
-  m_invokeID = 0;
+  return req.result.requestID;
+}
 
-  // bind to the device first.
-  found = address_bind_request(targetDeviceInstanceID, &max_apdu,
-                               &(instance()->m_targetAddress));
+void BACNETMSTP::startRequests()
+{
+  uint32_t now = monotonicMS();
+  uint32_t bindTimeoutMS = apdu_timeout() * apdu_retries();
 
-  if (!found)
-    {
-      if (m_debugging)
-        cerr << __FUNCTION__ << ": Address not found, Sending WhoIs..." << endl;
+  // devices with a transaction in flight
+  set<uint32_t> busy;
+  for (auto& req : m_requests)
+    if (req.invokeID && !req.done)
+      busy.insert(req.targetDeviceInstanceID());
 
-      Send_WhoIs(targetDeviceInstanceID, targetDeviceInstanceID);
-    }
-  else
-    {
-      if (m_debugging)
-        cerr << __FUNCTION__ << ": Address was found" << endl;
-    }
+  int inFlight = busy.size();
 
-  // loop until either we get our data, an error occurs, or we timeout
-  while (true)
+  for (auto& req : m_requests)
     {
-      current_seconds = time(NULL);
+      if (req.invokeID || req.done)
+        continue;
 
-      // at least one second has passed
-      if (current_seconds != last_seconds)
-        tsm_timer_milliseconds((uint16_t) ((current_seconds -
-                                            last_seconds) * 1000));
-      if (m_errorDetected)
-        break;
+      uint32_t targetDeviceInstanceID = req.targetDeviceInstanceID();
 
-      // we have to wait until the address is bound before proceeding
-      if (!found)
+      // bind to the device first.
+      if (!req.bound)
         {
-          found =
-            address_bind_request(targetDeviceInstanceID, &max_apdu,
-                                 &(instance()->m_targetAddress));
+          unsigned max_apdu = 0;
+          req.bound = address_bind_request(targetDeviceInstanceID, &max_apdu,
+                                           &req.targetAddress);
+          if (req.bound)
+            req.maxAPDU = max_apdu;
         }
 
-      if (found)
+      if (!req.bound)
         {
-          // address is bound, and we have not sent our request yet.  Make it so.
-          if (m_invokeID == 0)
+          // only one WhoIs per device per APDU timeout, however many
+          // requests are waiting for it
+          auto sent = m_whoIsSentMS.find(targetDeviceInstanceID);
+          if (sent == m_whoIsSentMS.end()
+              || (now - sent->second) >= apdu_timeout())
             {
-              switch (m_command.cmd)
-                {
-                case BACCMD_READ_PROPERTY:
-                  m_invokeID =
-                    Send_Read_Property_Request(targetDeviceInstanceID,
-                                               m_command.readPropArgs.objType,
-                                               m_command.readPropArgs.objInstance,
-                                               m_command.readPropArgs.objProperty,
-                                               m_command.readPropArgs.arrayIndex);
-                  if (m_debugging)
-                    cerr << __FUNCTION__
-                         << ": Called Send_Read_Property_Request(), m_invokeID = "
-                         << (int)m_invokeID << endl;
+              if (m_debugging)
+                cerr << __FUNCTION__
+                     << ": Address not found, Sending WhoIs..." << endl;
 
-                  break;
+              Send_WhoIs(targetDeviceInstanceID, targetDeviceInstanceID);
+              m_whoIsSentMS[targetDeviceInstanceID] = now;
+            }
 
-                case BACCMD_WRITE_PROPERTY:
-                  m_invokeID =
-                    Send_Write_Property_Request(targetDeviceInstanceID,
-                                                m_command.writePropArgs.objType,
-                                                m_command.writePropArgs.objInstance,
-                                                m_command.writePropArgs.objProperty,
-                                                m_command.writePropArgs.propValue,
-                                                m_command.writePropArgs.propPriority,
-                                                m_command.writePropArgs.arrayIndex);
-                  if (m_debugging)
-                    cerr << __FUNCTION__
-                         << ": Called Send_Write_Property_Request(), m_invokeID = "
-                         << (int)m_invokeID << endl;
+          // timeout if we've waited too long.
+          if ((now - req.queuedMS) > bindTimeoutMS)
+            {
+              req.result.errorType = BACERR_TYPE_UPM;
+              req.result.upmErrorString = string(__FUNCTION__) +
+                ": Timed out waiting to bind address.";
 
-                  break;
-                default:
-                  syslog(LOG_WARNING, "%s: switch case not defined",
-                          string(__FUNCTION__).c_str());
-                }
+              // We output this error unconditionally as this is an
+              // error you will get if you supply a non-existant
+              // Device Obeject Instance ID.
+
+              cerr << req.result.upmErrorString << endl;
+              cerr << __FUNCTION__
+                   << ": Did you supply the correct Device Object Instance ID "
+                   << "for your device?"
+                   << endl;
+
+              req.done = true;
             }
-          else if (tsm_invoke_id_free(m_invokeID))
+
+          continue;
+        }
+
+      // one transaction per device, and no more than m_maxOutstanding
+      if (inFlight >= m_maxOutstanding || busy.count(targetDeviceInstanceID))
+        continue;
+
+      switch (req.cmd)
+        {
+        case BACCMD_READ_PROPERTY:
+          req.invokeID =
+            Send_Read_Property_Request(targetDeviceInstanceID,
+                                       req.readPropArgs.objType,
+                                       req.readPropArgs.objInstance,
+                                       req.readPropArgs.objProperty,
+                                       req.readPropArgs.arrayIndex);
+          if (m_debugging)
+            cerr << __FUNCTION__
+                 << ": Called Send_Read_Property_Request(), invokeID = "
+                 << (int)req.invokeID << endl;
+
+          break;
+
+        case BACCMD_WRITE_PROPERTY:
+          req.invokeID =
+            Send_Write_Property_Request(targetDeviceInstanceID,
+                                        req.writePropArgs.objType,
+                                        req.writePropArgs.objInstance,
+                                        req.writePropArgs.objProperty,
+                                        &req.writePropArgs.propValue,
+                                        req.writePropArgs.propPriority,
+                                        req.writePropArgs.arrayIndex);
+          if (m_debugging)
+            cerr << __FUNCTION__
+                 << ": Called Send_Write_Property_Request(), invokeID = "
+                 << (int)req.invokeID << endl;
+
+          break;
+
+        case BACCMD_READ_PROPERTY_MULTIPLE:
+          req.invokeID = sendProperties(req);
+          if (m_debugging)
+            cerr << __FUNCTION__
+                 << ": Sent " << req.propsCount
+                 << " properties, invokeID = "
+                 << (int)req.invokeID << endl;
+
+          break;
+
+        default:
+          syslog(LOG_WARNING, "%s: switch case not defined",
+                 string(__FUNCTION__).c_str());
+          req.result.errorType = BACERR_TYPE_UPM;
+          req.result.upmErrorString = string(__FUNCTION__) +
+            ": internal error, called with unknown command, ignoring";
+          req.done = true;
+        }
+
+      // 0 means no TSM slot was free; try again next time
+      if (req.invokeID)
+        {
+          busy.insert(targetDeviceInstanceID);
+          inFlight++;
+        }
+    }
+}
+
+void BACNETMSTP::completeRequests()
+{
+  list<BACREQ_T> finished;
+
+  for (auto it = m_requests.begin(); it != m_requests.end(); )
+    {
+      BACREQ_T& req = *it;
+
+      if (req.invokeID && !req.done)
+        {
+          if (tsm_invoke_id_free(req.invokeID))
             {
               // transaction completed successfully
 
               if (m_debugging)
-                cerr << __FUNCTION__ << ": Success, m_invokeID = "
-                     << (int)m_invokeID << endl;
+                cerr << __FUNCTION__ << ": Success, invokeID = "
+                     << (int)req.invokeID << endl;
 
-              break;
+              req.done = true;
             }
-          else if (tsm_invoke_id_failed(m_invokeID))
+          else if (tsm_invoke_id_failed(req.invokeID))
             {
               // transaction state machine failed, most likely timeout
-              tsm_free_invoke_id(m_invokeID);
+              tsm_free_invoke_id(req.invokeID);
 
-              m_errorType = BACERR_TYPE_UPM;
-              m_upmErrorString = string(__FUNCTION__) +
+              req.result.errorType = BACERR_TYPE_UPM;
+              req.result.upmErrorString = string(__FUNCTION__) +
                 ": TSM Timed Out.";
 
               if (m_debugging)
-                cerr << m_upmErrorString << endl;
+                cerr << req.result.upmErrorString << endl;
 
-              m_errorDetected = true;
-
-              break;
+              req.done = true;
             }
         }
+
+      // readPropertyMultiple requests may need more transactions
+      if (req.done && req.cmd == BACCMD_READ_PROPERTY_MULTIPLE)
+        nextProperties(req);
+
+      if (req.done)
+        finished.splice(finished.end(), m_requests, it++);
       else
+        ++it;
+    }
+
+  // callbacks may queue new requests
+  for (auto& req : finished)
+    if (req.callback)
+      req.callback(req.result);
+}
+
+uint8_t BACNETMSTP::sendProperties(BACREQ_T& req)
+{
+  uint32_t targetDeviceInstanceID = req.readPropArgs.targetDeviceInstanceID;
+
+  // devices without ReadPropertyMultiple get one readProperty at a
+  // time.  The readProperty ack handler stores it with the request.
+  if (m_rpmUnsupported.count(targetDeviceInstanceID))
+    {
+      BACPROP_T& prop = req.props[req.propsNext];
+
+      req.propsCount = 1;
+      return Send_Read_Property_Request(targetDeviceInstanceID,
+                                        prop.objType,
+                                        prop.objInstance,
+                                        prop.objProperty,
+                                        prop.arrayIndex);
+    }
+
+  size_t limit = req.propsLimit;
+  auto learned = m_rpmLimit.find(targetDeviceInstanceID);
+  if (learned != m_rpmLimit.end() && learned->second < limit)
+    limit = learned->second;
+
+  // the response has to fit into both the device's and our APDU
+  size_t maxAPDU = (req.maxAPDU < MAX_APDU) ? req.maxAPDU : MAX_APDU;
+
+  size_t len = RPM_ACK_HEADER_LEN;
+  size_t count = 0;
+  for (size_t i = req.propsNext; i < req.props.size() && count < limit; i++)
+    {
+      const BACPROP_T& prop = req.props[i];
+      size_t propLen = RPM_PROPERTY_LEN;
+
+      if (prop.arrayIndex != BACNET_ARRAY_ALL)
+        propLen += RPM_ARRAY_INDEX_LEN;
+
+      if (!count || prop.objType != req.props[i - 1].objType
+          || prop.objInstance != req.props[i - 1].objInstance)
+        propLen += RPM_OBJECT_LEN;
+
+      // always send at least one
+      if (count && (len + propLen) > maxAPDU)
+        break;
+
+      len += propLen;
+      count++;
+    }
+
+  // build the request, one read access specification for each run
+  // of properties of the same object
+  vector<BACNET_READ_ACCESS_DATA> objects(count);
+  vector<BACNET_PROPERTY_REFERENCE> properties(count);
+  size_t numObjects = 0;
+
+  memset(objects.data(), 0, count * sizeof(BACNET_READ_ACCESS_DATA));
+  memset(properties.data(), 0, count * sizeof(BACNET_PROPERTY_REFERENCE));
+
+  for (size_t i = 0; i < count; i++)
+    {
+      const BACPROP_T& prop = req.props[req.propsNext + i];
+
+      properties[i].propertyIdentifier = prop.objProperty;
+      properties[i].propertyArrayIndex = prop.arrayIndex;
+
+      if (numObjects
+          && objects[numObjects - 1].object_type == prop.objType
+          && objects[numObjects - 1].object_instance == prop.objInstance)
         {
-          // still waiting to bind.  timeout if we've waited too long.
-          elapsed_seconds += (current_seconds - last_seconds);
-          if (elapsed_seconds > timeout_seconds)
-            {
-              m_errorType = BACERR_TYPE_UPM;
-              m_upmErrorString = string(__FUNCTION__) +
-                ": Timed out waiting to bind address.";
+          properties[i - 1].next = &properties[i];
+          continue;
+        }
 
-              // We output this error unconditionally as this is an
-              // error you will get if you supply a non-existant
-              // Device Obeject Instance ID.
+      if (numObjects)
+        objects[numObjects - 1].next = &objects[numObjects];
 
-              cerr << m_upmErrorString << endl;
-              cerr << __FUNCTION__
-                   << ": Did you supply the correct Device Object Instance ID "
-                   << "for your device?"
-                   << endl;
+      objects[numObjects].object_type = prop.objType;
+      objects[numObjects].object_instance = prop.objInstance;
+      objects[numObjects].listOfProperties = &properties[i];
+      numObjects++;
+    }
 
-              m_errorDetected = true;
-              break;
-            }
+  uint8_t pdu[MAX_PDU];
+
+  req.propsCount = count;
+  return Send_Read_Property_Multiple_Request(pdu, sizeof(pdu),
+                                             targetDeviceInstanceID,
+                                             objects.data());
+}
+
+void BACNETMSTP::nextProperties(BACREQ_T& req)
+{
+  // failed before anything was sent, like a bind timeout
+  if (!req.invokeID)
+    return;
+
+  uint32_t targetDeviceInstanceID = req.readPropArgs.targetDeviceInstanceID;
+  bool rpm = !m_rpmUnsupported.count(targetDeviceInstanceID);
+
+  switch (req.result.errorType)
+    {
+    case BACERR_TYPE_NONE:
+      req.propsNext += req.propsCount;
+      break;
+
+    case BACERR_TYPE_REJECT:
+      if (rpm
+          && req.result.rejectReason == REJECT_REASON_UNRECOGNIZED_SERVICE)
+        {
+          // read the same properties one at a time
+          if (m_debugging)
+            cerr << __FUNCTION__ << ": device "
+                 << targetDeviceInstanceID
+                 << " does not support ReadPropertyMultiple" << endl;
+
+          m_rpmUnsupported.insert(targetDeviceInstanceID);
+          break;
         }
 
-      // returns 0 bytes on timeout
-      pdu_len = datalink_receive(&src, m_rxBuffer, MAX_MPDU, timeout);
+      if (req.propsCount > 1
+          && req.result.rejectReason == REJECT_REASON_BUFFER_OVERFLOW)
+        {
+          req.propsLimit = req.propsCount / 2;
+          break;
+        }
+
+      return;
+
+    case BACERR_TYPE_ABORT:
+      // the response didn't fit, remember to send fewer properties
+      if (req.propsCount > 1
+          && (req.result.abortReason == ABORT_REASON_SEGMENTATION_NOT_SUPPORTED
+              || req.result.abortReason == ABORT_REASON_BUFFER_OVERFLOW))
+        {
+          m_rpmLimit[targetDeviceInstanceID] = req.propsCount / 2;
+          break;
+        }
+
+      return;
+
+    case BACERR_TYPE_ERROR:
+      // some devices return an error for the whole request if one of
+      // the properties can't be read.  Narrow it down to that one.
+      if (req.propsCount > 1)
+        {
+          req.propsLimit = req.propsCount / 2;
+          break;
+        }
+
+      // a single property failed, report it and carry on
+      {
+        BACPROP_T& prop = req.props[req.propsNext];
+
+        prop.error = true;
+        prop.errorClass = req.result.errorClass;
+        prop.errorCode = req.result.errorCode;
+        prop.values.clear();
 
-      // process the packet if valid.  This will call our handlers as needed.
-      if (pdu_len)
-        npdu_handler(&src, m_rxBuffer, pdu_len);
+        // and go back to full sized requests for the rest
+        req.propsNext++;
+        req.propsLimit = req.props.size();
+      }
 
-      // keep track of time for next check
-      last_seconds = current_seconds;
+      break;
+
+    default:
+      return;
     }
 
-  return m_errorDetected;
+  req.result.errorType = BACERR_TYPE_NONE;
+  req.result.rejectString.clear();
+  req.result.abortString.clear();
+  req.result.errorString.clear();
+  req.invokeID = 0;
+
+  if (req.propsNext < req.props.size())
+    req.done = false;
+  else
+    req.result.properties = req.props;
 }
 
-bool BACNETMSTP::readProperty(uint32_t targetDeviceInstanceID,
-                              BACNET_OBJECT_TYPE objType,
-                              uint32_t objInstance,
-                              BACNET_PROPERTY_ID objProperty,
-                              uint32_t arrayIndex)
+int BACNETMSTP::processRequests(unsigned int timeoutMS)
+{
+  // address where message came from
+  BACNET_ADDRESS src = {0};
+
+  updateTimers();
+  startRequests();
+
+  // returns 0 bytes on timeout
+  uint16_t pdu_len = datalink_receive(&src, m_rxBuffer, MAX_MPDU, timeoutMS);
+
+  // process the packet if valid.  This will call our handlers as needed.
+  if (pdu_len)
+    npdu_handler(&src, m_rxBuffer, pdu_len);
+
+  updateTimers();
+  completeRequests();
+
+  return m_requests.size();
+}
+
+void BACNETMSTP::waitRequests()
+{
+  while (!m_requests.empty())
+    processRequests();
+}
+
+void BACNETMSTP::setMaxOutstanding(int max)
+{
+  if (max < 1)
+    {
+      throw out_of_range(string(__FUNCTION__)
+                         + ": max must be at least 1");
+    }
+
+  m_maxOutstanding = max;
+}
+
+bool BACNETMSTP::waitResult(const bool& finished,
+                            const BACREQ_RESULT_T& result)
+{
+  clearErrors();
+  m_returnedValue.clear();
+
+  while (!finished)
+    processRequests();
+
+  m_errorType = result.errorType;
+  m_rejectReason = result.rejectReason;
+  m_rejectString = result.rejectString;
+  m_abortReason = result.abortReason;
+  m_abortString = result.abortString;
+  m_errorClass = result.errorClass;
+  m_errorCode = result.errorCode;
+  m_errorString = result.errorString;
+  m_upmErrorString = result.upmErrorString;
+  m_returnedValue = result.values;
+
+  return (m_errorType != BACERR_TYPE_NONE);
+}
+
+int BACNETMSTP::readPropertyAsync(uint32_t targetDeviceInstanceID,
+                                  BACNET_OBJECT_TYPE objType,
+                                  uint32_t objInstance,
+                                  BACNET_PROPERTY_ID objProperty,
+                                  uint32_t arrayIndex,
+                                  BACREQ_CALLBACK_T callback)
 {
   // some sanity checking...
   if (objInstance >= BACNET_MAX_INSTANCE)
@@ -576,24 +1010,107 @@ bool BACNETMSTP::readProperty(uint32_t targetDeviceInstanceID,
                               + to_string(BACNET_MAX_INSTANCE));
     }
 
-  // fill in the command structure and dispatch
-  m_command.cmd = BACCMD_READ_PROPERTY;
-  m_command.readPropArgs.targetDeviceInstanceID = targetDeviceInstanceID;
-  m_command.readPropArgs.objType = objType;
-  m_command.readPropArgs.objInstance = objInstance;
-  m_command.readPropArgs.objProperty = objProperty;
-  m_command.readPropArgs.arrayIndex = arrayIndex;
+  // fill in the command structure and queue it
+  BACREQ_T req;
+  req.cmd = BACCMD_READ_PROPERTY;
+  req.readPropArgs.targetDeviceInstanceID = targetDeviceInstanceID;
+  req.readPropArgs.objType = objType;
+  req.readPropArgs.objInstance = objInstance;
+  req.readPropArgs.objProperty = objProperty;
+  req.readPropArgs.arrayIndex = arrayIndex;
 
-  if (m_debugging)
-    cerr << __FUNCTION__  << ": calling dispatchRequest()..." << endl;
+  return queueRequest(req, callback);
+}
+
+int BACNETMSTP::writePropertyAsync(uint32_t targetDeviceInstanceID,
+                                   BACNET_OBJECT_TYPE objType,
+                                   uint32_t objInstance,
+                                   BACNET_PROPERTY_ID objProperty,
+                                   BACNET_APPLICATION_DATA_VALUE propValue,
+                                   uint8_t propPriority,
+                                   int32_t arrayIndex,
+                                   BACREQ_CALLBACK_T callback)
+{
+  // some sanity checking...
+  if (objInstance >= BACNET_MAX_INSTANCE)
+    {
+      throw out_of_range(string(__FUNCTION__)
+                              + ": objInstance must be less than "
+                              + to_string(BACNET_MAX_INSTANCE));
+    }
 
-  // send it off
-  bool error = dispatchRequest();
+  // fill in the command structure and queue it
+  BACREQ_T req;
+  req.cmd = BACCMD_WRITE_PROPERTY;
+  req.writePropArgs.targetDeviceInstanceID = targetDeviceInstanceID;
+  req.writePropArgs.objType = objType;
+  req.writePropArgs.objInstance = objInstance;
+  req.writePropArgs.objProperty = objProperty;
+  req.writePropArgs.propValue = propValue;
+  req.writePropArgs.propPriority = propPriority;
+  req.writePropArgs.arrayIndex = arrayIndex;
+
+  return queueRequest(req, callback);
+}
 
-  // clear the command to avoid accidental re-calls
-  m_command.cmd = BACCMD_NONE;
+int BACNETMSTP::readPropertyMultipleAsync(uint32_t targetDeviceInstanceID,
+                                          const vector<BACPROP_T>& properties,
+                                          BACREQ_CALLBACK_T callback)
+{
+  // some sanity checking...
+  if (properties.empty())
+    {
+      throw invalid_argument(string(__FUNCTION__)
+                             + ": no properties to read");
+    }
 
-  return error;
+  for (auto& prop : properties)
+    {
+      if (prop.objInstance >= BACNET_MAX_INSTANCE)
+        {
+          throw out_of_range(string(__FUNCTION__)
+                             + ": objInstance must be less than "
+                             + to_string(BACNET_MAX_INSTANCE));
+        }
+    }
+
+  // fill in the command structure and queue it
+  BACREQ_T req;
+  req.cmd = BACCMD_READ_PROPERTY_MULTIPLE;
+  req.readPropArgs.targetDeviceInstanceID = targetDeviceInstanceID;
+  req.props = properties;
+
+  for (auto& prop : req.props)
+    {
+      prop.error = false;
+      prop.errorClass = ERROR_CLASS_DEVICE;
+      prop.errorCode = ERROR_CODE_OTHER;
+      prop.values.clear();
+    }
+
+  return queueRequest(req, callback);
+}
+
+bool BACNETMSTP::readProperty(uint32_t targetDeviceInstanceID,
+                              BACNET_OBJECT_TYPE objType,
+                              uint32_t objInstance,
+                              BACNET_PROPERTY_ID objProperty,
+                              uint32_t arrayIndex)
+{
+  BACREQ_RESULT_T result;
+  bool finished = false;
+
+  readPropertyAsync(targetDeviceInstanceID, objType, objInstance,
+                    objProperty, arrayIndex,
+                    [&](const BACREQ_RESULT_T& r) {
+                      result = r;
+                      finished = true;
+                    });
+
+  if (m_debugging)
+    cerr << __FUNCTION__  << ": waiting for result..." << endl;
+
+  return waitResult(finished, result);
 }
 
 bool BACNETMSTP::writeProperty(uint32_t targetDeviceInstanceID,
@@ -604,32 +1121,41 @@ bool BACNETMSTP::writeProperty(uint32_t targetDeviceInstanceID,
                                uint8_t propPriority,
                                int32_t arrayIndex)
 {
-  // some sanity checking...
-  if (objInstance >= BACNET_MAX_INSTANCE)
-    {
-      throw out_of_range(string(__FUNCTION__)
-                              + ": objInstance must be less than "
-                              + to_string(BACNET_MAX_INSTANCE));
-    }
+  BACREQ_RESULT_T result;
+  bool finished = false;
 
-  // fill in the command structure and dispatch
-  m_command.cmd = BACCMD_WRITE_PROPERTY;
-  m_command.writePropArgs.targetDeviceInstanceID = targetDeviceInstanceID;
-  m_command.writePropArgs.objType = objType;
-  m_command.writePropArgs.objInstance = objInstance;
-  m_command.writePropArgs.objProperty = objProperty;
-  m_command.writePropArgs.propValue = propValue;
-  m_command.writePropArgs.propPriority = propPriority;
-  m_command.writePropArgs.arrayIndex = arrayIndex;
+  writePropertyAsync(targetDeviceInstanceID, objType, objInstance,
+                     objProperty, *propValue, propPriority, arrayIndex,
+                     [&](const BACREQ_RESULT_T& r) {
+                       result = r;
+                       finished = true;
+                     });
 
   if (m_debugging)
-    cerr << __FUNCTION__  << ": calling dispatchRequest()..." << endl;
+    cerr << __FUNCTION__  << ": waiting for result..." << endl;
 
-  // send it off
-  bool error = dispatchRequest();
+  return waitResult(finished, result);
+}
+
+bool BACNETMSTP::readPropertyMultiple(uint32_t targetDeviceInstanceID,
+                                      vector<BACPROP_T>& properties)
+{
+  BACREQ_RESULT_T result;
+  bool finished = false;
 
-  // clear the command to avoid accidental re-calls
-  m_command.cmd = BACCMD_NONE;
+  readPropertyMultipleAsync(targetDeviceInstanceID, properties,
+                            [&](const BACREQ_RESULT_T& r) {
+                              result = r;
+                              finished = true;
+                            });
+
+  if (m_debugging)
+    cerr << __FUNCTION__  << ": waiting for result..." << endl;
+
+  bool error = waitResult(finished, result);
+
+  if (!error)
+    properties = result.properties;
 
   return error;
 }
@@ -651,26 +1177,31 @@ uint8_t BACNETMSTP::getDataType(int index)
 
 float BACNETMSTP::getDataTypeReal(int index)
 {
-  if (getDataType(index) == BACNET_APPLICATION_TAG_REAL)
-    return m_returnedValue.at(index).type.Real;
+  return getDataTypeReal(m_returnedValue.at(index));
+}
+
+float BACNETMSTP::getDataTypeReal(const BACNET_APPLICATION_DATA_VALUE& value)
+{
+  if (value.tag == BACNET_APPLICATION_TAG_REAL)
+    return value.type.Real;
   else
     {
       if (m_debugging)
         cerr << __FUNCTION__ << ": Not of Real type, trying to convert..." << endl;
 
       // try to convert or throw
-      switch (getDataType(index))
+      switch (value.tag)
         {
         case BACNET_APPLICATION_TAG_BOOLEAN:
-          return (getDataTypeBoolean(index) ? 1.0 : 0.0);
+          return (getDataTypeBoolean(value) ? 1.0 : 0.0);
         case BACNET_APPLICATION_TAG_UNSIGNED_INT:
-          return float(getDataTypeUnsignedInt(index));
+          return float(getDataTypeUnsignedInt(value));
         case BACNET_APPLICATION_TAG_SIGNED_INT:
-          return float(getDataTypeSignedInt(index));
+          return float(getDataTypeSignedInt(value));
         default:
           throw invalid_argument(string(__FUNCTION__)
                                       + ": data type ("
-                                      + to_string(int(getDataType(index)))
+                                      + to_string(int(value.tag))
                                       + ") is not convertible to Real");
         }
     }
@@ -678,62 +1209,82 @@ float BACNETMSTP::getDataTypeReal(int index)
 
 bool BACNETMSTP::getDataTypeBoolean(int index)
 {
-  if (getDataType(index) == BACNET_APPLICATION_TAG_BOOLEAN)
-    return ((m_returnedValue.at(index).type.Boolean) ? true : false);
+  return getDataTypeBoolean(m_returnedValue.at(index));
+}
+
+bool BACNETMSTP::getDataTypeBoolean(const BACNET_APPLICATION_DATA_VALUE& value)
+{
+  if (value.tag == BACNET_APPLICATION_TAG_BOOLEAN)
+    return ((value.type.Boolean) ? true : false);
   else
     throw invalid_argument(string(__FUNCTION__)
                                 + ": data type ("
-                                + to_string(int(getDataType(index)))
+                                + to_string(int(value.tag))
                                 + ") is not convertible to Bool");
 }
 
 unsigned int BACNETMSTP::getDataTypeUnsignedInt(int index)
 {
-  if (getDataType(index) == BACNET_APPLICATION_TAG_UNSIGNED_INT)
-    return m_returnedValue.at(index).type.Unsigned_Int;
+  return getDataTypeUnsignedInt(m_returnedValue.at(index));
+}
+
+unsigned int BACNETMSTP::getDataTypeUnsignedInt(const BACNET_APPLICATION_DATA_VALUE& value)
+{
+  if (value.tag == BACNET_APPLICATION_TAG_UNSIGNED_INT)
+    return value.type.Unsigned_Int;
   else
     throw invalid_argument(string(__FUNCTION__)
                                 + ": data type ("
-                                + to_string(int(getDataType(index)))
+                                + to_string(int(value.tag))
                                 + ") is not convertible to UnsignedInt");
 }
 
 int BACNETMSTP::getDataTypeSignedInt(int index)
 {
-  if (getDataType(index) == BACNET_APPLICATION_TAG_SIGNED_INT)
-    return m_returnedValue.at(index).type.Signed_Int;
+  return getDataTypeSignedInt(m_returnedValue.at(index));
+}
+
+int BACNETMSTP::getDataTypeSignedInt(const BACNET_APPLICATION_DATA_VALUE& value)
+{
+  if (value.tag == BACNET_APPLICATION_TAG_SIGNED_INT)
+    return value.type.Signed_Int;
   else
     throw invalid_argument(string(__FUNCTION__)
                                 + ": data type ("
-                                + to_string(int(getDataType(index)))
+                                + to_string(int(value.tag))
                                 + ") is not convertible to SignedInt");
 }
 
 #if defined(BACAPP_DOUBLE)
 double BACNETMSTP::getDataTypeDouble(int index)
 {
-  if (getDataType() == BACNET_APPLICATION_TAG_DOUBLE)
-    return m_returnedValue.at(index).type.Double;
+  return getDataTypeDouble(m_returnedValue.at(index));
+}
+
+double BACNETMSTP::getDataTypeDouble(const BACNET_APPLICATION_DATA_VALUE& value)
+{
+  if (value.tag == BACNET_APPLICATION_TAG_DOUBLE)
+    return value.type.Double;
   else
     {
       if (m_debugging)
         cerr << __FUNCTION__ << ": Not of Double type, trying to convert..." << endl;
 
       // try to convert or throw
-      switch (getDataType(index))
+      switch (value.tag)
         {
         case BACNET_APPLICATION_TAG_REAL:
-          return double(getDataTypeReal(index));
+          return double(getDataTypeReal(value));
         case BACNET_APPLICATION_TAG_BOOLEAN:
-          return (getDataTypeBoolean(index) ? 1.0 : 0.0);
+          return (getDataTypeBoolean(value) ? 1.0 : 0.0);
         case BACNET_APPLICATION_TAG_UNSIGNED_INT:
-          return double(getDataTypeUnsignedInt(index));
+          return double(getDataTypeUnsignedInt(value));
         case BACNET_APPLICATION_TAG_SIGNED_INT:
-          return double(getDataTypeSignedInt(index));
+          return double(getDataTypeSignedInt(value));
         default:
           throw invalid_argument(string(__FUNCTION__)
                                       + ": data type ("
-                                      + to_string(int(getDataType(index)))
+                                      + to_string(int(value.tag))
                                       + ") is not convertible to Double");
         }
     }
@@ -742,55 +1293,71 @@ double BACNETMSTP::getDataTypeDouble(int index)
 
 unsigned int BACNETMSTP::getDataTypeEnum(int index)
 {
-  if (getDataType(index) == BACNET_APPLICATION_TAG_ENUMERATED)
-    return m_returnedValue.at(index).type.Enumerated;
+  return getDataTypeEnum(m_returnedValue.at(index));
+}
+
+unsigned int BACNETMSTP::getDataTypeEnum(const BACNET_APPLICATION_DATA_VALUE& value)
+{
+  if (value.tag == BACNET_APPLICATION_TAG_ENUMERATED)
+    return value.type.Enumerated;
   else
     throw invalid_argument(string(__FUNCTION__)
                                 + ": data type ("
-                                + to_string(int(getDataType(index)))
+                                + to_string(int(value.tag))
                                 + ") is not convertible to Enum");
 }
 
 string BACNETMSTP::getDataTypeString(int index)
+{
+  return getDataTypeString(m_returnedValue.at(index));
+}
+
+string BACNETMSTP::getDataTypeString(const BACNET_APPLICATION_DATA_VALUE& value)
 {
     string retval;
 
   // Here, we can try to accomodate all the types
-  switch(getDataType(index))
+  switch(value.tag)
     {
     case BACNET_APPLICATION_TAG_REAL:
-      retval = to_string(getDataTypeReal(index));
+      retval = to_string(getDataTypeReal(value));
       break;
 
 #if defined(BACAPP_DOUBLE)
     case BACNET_APPLICATION_TAG_DOUBLE:
-      retval = to_string(getDataTypeDouble(index));
+      retval = to_string(getDataTypeDouble(value));
       break;
 #endif // BACAPP_DOUBLE
 
     case BACNET_APPLICATION_TAG_UNSIGNED_INT:
-      retval = to_string(getDataTypeUnsignedInt(index));
+      retval = to_string(getDataTypeUnsignedInt(value));
       break;
 
     case BACNET_APPLICATION_TAG_SIGNED_INT:
-      retval = to_string(getDataTypeSignedInt(index));
+      retval = to_string(getDataTypeSignedInt(value));
       break;
 
     case BACNET_APPLICATION_TAG_BOOLEAN:
-      retval = (getDataTypeBoolean(index) ? string("true") : string("false"));
+      retval = (getDataTypeBoolean(value) ? string("true") : string("false"));
       break;
 
     case BACNET_APPLICATION_TAG_CHARACTER_STRING:
-      retval = string(characterstring_value(&m_returnedValue.at(index).type.Character_String),
+      {
+        // the bacnet-stack accessors do not take const pointers
+        BACNET_CHARACTER_STRING cs = value.type.Character_String;
+
+        retval = string(characterstring_value(&cs),
+                        characterstring_length(&cs));
+      }
 
-                      characterstring_length(&m_returnedValue.at(index).type.Character_String));
       break;
 
     case BACNET_APPLICATION_TAG_OCTET_STRING:
       {
-          string tmpstr((char *)octetstring_value(&m_returnedValue.at(index).type.Octet_String),
+        BACNET_OCTET_STRING os = value.type.Octet_String;
 
-                      octetstring_length(&m_returnedValue.at(index).type.Octet_String));
+        string tmpstr((char *)octetstring_value(&os),
+                      octetstring_length(&os));
         retval = string2HexString(tmpstr);
       }
 
@@ -798,12 +1365,12 @@ string BACNETMSTP::getDataTypeString(int index)
 
     case BACNET_APPLICATION_TAG_BIT_STRING:
       {
-        int len = bitstring_bits_used(&m_returnedValue.at(index).type.Bit_String);
+        BACNET_BIT_STRING bs = value.type.Bit_String;
+        int len = bitstring_bits_used(&bs);
 
         for (int i=0; i<len; i++)
           {
-            if (bitstring_bit(&m_returnedValue.at(index).type.Bit_String,
-                              uint8_t(i)))
+            if (bitstring_bit(&bs, uint8_t(i)))
               retval += "1";
             else
               retval += "0";
@@ -818,7 +1385,7 @@ string BACNETMSTP::getDataTypeString(int index)
     default:
       throw invalid_argument(string(__FUNCTION__)
                                   + ": data type ("
-                                  + to_string(int(getDataType(index)))
+                                  + to_string(int(value.tag))
                                   + ") is not convertible to String");
       break;
     }
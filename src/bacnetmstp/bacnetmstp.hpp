@@ -10,6 +10,10 @@
  */
 #pragma once
 
+#include <functional>
+#include <list>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -106,9 +110,47 @@ namespace upm {
     typedef enum {
       BACCMD_NONE                     = 0,
       BACCMD_READ_PROPERTY,
-      BACCMD_WRITE_PROPERTY
+      BACCMD_WRITE_PROPERTY,
+      BACCMD_READ_PROPERTY_MULTIPLE
     } BACCMD_TYPE_T;
 
+    // one property to read with readPropertyMultiple().  error and
+    // values are filled in once the request has completed.
+    typedef struct {
+      BACNET_OBJECT_TYPE objType;
+      uint32_t objInstance;
+      BACNET_PROPERTY_ID objProperty;
+      uint32_t arrayIndex;
+      // true if the device could not return this property
+      bool error;
+      BACNET_ERROR_CLASS errorClass;
+      BACNET_ERROR_CODE errorCode;
+      std::vector<BACNET_APPLICATION_DATA_VALUE> values;
+    } BACPROP_T;
+
+    // the outcome of an asynchronous request.  errorType is
+    // BACERR_TYPE_NONE on success, otherwise the matching error
+    // fields are filled in, as they are for the get*() error methods.
+    typedef struct {
+      int requestID;
+      BACERR_TYPE_T errorType;
+      uint8_t rejectReason;
+      std::string rejectString;
+      uint8_t abortReason;
+      std::string abortString;
+      BACNET_ERROR_CLASS errorClass;
+      BACNET_ERROR_CODE errorCode;
+      std::string errorString;
+      std::string upmErrorString;
+      // data returned by a readProperty request
+      std::vector<BACNET_APPLICATION_DATA_VALUE> values;
+      // properties of a readPropertyMultiple request
+      std::vector<BACPROP_T> properties;
+    } BACREQ_RESULT_T;
+
+    // completion callback for asynchronous requests
+    typedef std::function<void(const BACREQ_RESULT_T&)> BACREQ_CALLBACK_T;
+
     /**
      * Get our singleton instance, initializing it if neccessary.  All
      * requests to this class should be done through this instance
@@ -223,6 +265,147 @@ namespace upm {
                        uint8_t propPriority=BACNET_NO_PRIORITY,
                        int32_t arrayIndex=BACNET_ARRAY_ALL);
 
+    /**
+     * Read several properties of objects on one device.  The
+     * properties are requested with as few ReadPropertyMultiple
+     * transactions as the device's maximum APDU allows, or with one
+     * readProperty transaction each for devices that do not support
+     * ReadPropertyMultiple.  This function will return when every
+     * property has been read, or an error has occurred.
+     *
+     * A property the device could not return does not fail the
+     * request; its error, errorClass and errorCode fields are set
+     * instead.  Otherwise its values field holds the returned data.
+     *
+     * @param targetDeviceInstanceID The Device Object Instance ID of
+     * the device to send the request to.
+     * @param properties The properties to read.  The results are
+     * stored here.
+     * @return true if an error occurred, false otherwise.
+     */
+    bool readPropertyMultiple(uint32_t targetDeviceInstanceID,
+                              std::vector<BACPROP_T>& properties);
+
+    /**
+     * Queue a BACnet readProperty transaction and return immediately.
+     * Requests are sent as soon as the target device address is
+     * bound, with up to getMaxOutstanding() transactions in flight at
+     * once, one per device.  The transactions only progress while
+     * processRequests() or waitRequests() is being called, which is
+     * also where the callback is invoked.  The arguments are the same
+     * as for readProperty().
+     *
+     * @param targetDeviceInstanceID The Device Object Instance ID of
+     * the device to send the request to.
+     * @param objType The BACnet object type of the object to query.
+     * @param objInstance The instance number of the Object to query.
+     * @param objProperty The property of the Object to read.
+     * @param arrayIndex The index number of an array property. The
+     * default is BACNET_ARRAY_ALL.
+     * @param callback Called with the outcome when the transaction
+     * completes, may be empty.
+     * @return an ID identifying the request in its result.
+     */
+    int readPropertyAsync(uint32_t targetDeviceInstanceID,
+                          BACNET_OBJECT_TYPE objType,
+                          uint32_t objInstance,
+                          BACNET_PROPERTY_ID objProperty,
+                          uint32_t arrayIndex=BACNET_ARRAY_ALL,
+                          BACREQ_CALLBACK_T callback=nullptr);
+
+    /**
+     * Queue a BACnet writeProperty transaction and return
+     * immediately.  See readPropertyAsync() for how requests are
+     * processed.  The arguments are the same as for writeProperty(),
+     * except that the value is copied.
+     *
+     * @param targetDeviceInstanceID The Device Object Instance ID of
+     * the device to send the request to.
+     * @param objType The BACnet object type of the object to write.
+     * @param objInstance The instance number of the Object to write.
+     * @param objProperty The property of the Object to write.
+     * @param propValue The value to write.
+     * @param propPriority The priority of a commandable property.
+     * @param arrayIndex The index number of an array property. The
+     * default is BACNET_ARRAY_ALL.
+     * @param callback Called with the outcome when the transaction
+     * completes, may be empty.
+     * @return an ID identifying the request in its result.
+     */
+    int writePropertyAsync(uint32_t targetDeviceInstanceID,
+                           BACNET_OBJECT_TYPE objType,
+                           uint32_t objInstance,
+                           BACNET_PROPERTY_ID objProperty,
+                           BACNET_APPLICATION_DATA_VALUE propValue,
+                           uint8_t propPriority=BACNET_NO_PRIORITY,
+                           int32_t arrayIndex=BACNET_ARRAY_ALL,
+                           BACREQ_CALLBACK_T callback=nullptr);
+
+    /**
+     * Queue the reads of several properties of objects on one device
+     * and return immediately.  See readPropertyMultiple() for how
+     * the properties are read and readPropertyAsync() for how
+     * requests are processed.  The properties are reported in the
+     * properties field of the result.
+     *
+     * @param targetDeviceInstanceID The Device Object Instance ID of
+     * the device to send the request to.
+     * @param properties The properties to read, at least one.
+     * @param callback Called with the outcome when every property
+     * has been read, may be empty.
+     * @return an ID identifying the request in its result.
+     */
+    int readPropertyMultipleAsync(uint32_t targetDeviceInstanceID,
+                                  const std::vector<BACPROP_T>& properties,
+                                  BACREQ_CALLBACK_T callback=nullptr);
+
+    /**
+     * Make progress on queued requests: advance the transaction
+     * timers, send requests whose target is bound, wait up to
+     * timeoutMS for a packet and process it, and complete finished
+     * transactions, invoking their callbacks.
+     *
+     * @param timeoutMS The maximum time to wait for a packet, in
+     * milliseconds.
+     * @return the number of requests still queued or in flight.
+     */
+    int processRequests(unsigned int timeoutMS=100);
+
+    /**
+     * Call processRequests() until every queued request has
+     * completed.
+     */
+    void waitRequests();
+
+    /**
+     * Return the number of requests queued or in flight.
+     *
+     * @return the number of requests not yet completed.
+     */
+    int getPendingRequests()
+    {
+      return m_requests.size();
+    };
+
+    /**
+     * Set the maximum number of transactions in flight at once.  Only
+     * one transaction is ever in flight to a given device.  The
+     * default is 8.
+     *
+     * @param max The maximum number of transactions, at least 1.
+     */
+    void setMaxOutstanding(int max);
+
+    /**
+     * Return the maximum number of transactions in flight at once.
+     *
+     * @return the maximum number of transactions.
+     */
+    int getMaxOutstanding()
+    {
+      return m_maxOutstanding;
+    };
+
     /**
      * After a successful readProperty request, this method can be used
      * to return a BACNET_APPLICATION_DATA_VALUE structure containing
@@ -268,6 +451,15 @@ namespace upm {
      */
     float getDataTypeReal(int index=0);
 
+    /**
+     * Convert a data value, such as one returned by
+     * readPropertyMultiple(), to a Real in the same way.
+     *
+     * @param value The data value to convert.
+     * @return The converted value
+     */
+    float getDataTypeReal(const BACNET_APPLICATION_DATA_VALUE& value);
+
     /**
      * After a successful readProperty request, this method can be
      * used to return the BACnet dataype of the returned data as a
@@ -281,6 +473,15 @@ namespace upm {
      */
     bool getDataTypeBoolean(int index=0);
 
+    /**
+     * Convert a data value, such as one returned by
+     * readPropertyMultiple(), to a Boolean in the same way.
+     *
+     * @param value The data value to convert.
+     * @return The converted value
+     */
+    bool getDataTypeBoolean(const BACNET_APPLICATION_DATA_VALUE& value);
+
     /**
      * After a successful readProperty request, this method can be
      * used to return the BACnet dataype of the returned data as a
@@ -294,6 +495,15 @@ namespace upm {
      */
     unsigned int getDataTypeUnsignedInt(int index=0);
 
+    /**
+     * Convert a data value, such as one returned by
+     * readPropertyMultiple(), to an unsigned int in the same way.
+     *
+     * @param value The data value to convert.
+     * @return The converted value
+     */
+    unsigned int getDataTypeUnsignedInt(const BACNET_APPLICATION_DATA_VALUE& value);
+
     /**
      * After a successful readProperty request, this method can be
      * used to return the BACnet dataype of the returned data as a
@@ -307,6 +517,15 @@ namespace upm {
      */
     int getDataTypeSignedInt(int index=0);
 
+    /**
+     * Convert a data value, such as one returned by
+     * readPropertyMultiple(), to a signed int in the same way.
+     *
+     * @param value The data value to convert.
+     * @return The converted value
+     */
+    int getDataTypeSignedInt(const BACNET_APPLICATION_DATA_VALUE& value);
+
     /**
      * After a successful readProperty request, this method can be
      * used to return the BACnet dataype of the returned data as a
@@ -321,6 +540,15 @@ namespace upm {
      */
     std::string getDataTypeString(int index=0);
 
+    /**
+     * Convert a data value, such as one returned by
+     * readPropertyMultiple(), to a string in the same way.
+     *
+     * @param value The data value to convert.
+     * @return The converted value
+     */
+    std::string getDataTypeString(const BACNET_APPLICATION_DATA_VALUE& value);
+
     /**
      * After a successful readProperty request, this method can be
      * used to return the BACnet dataype of the returned data as an
@@ -333,6 +561,15 @@ namespace upm {
      */
     unsigned int getDataTypeEnum(int index=0);
 
+    /**
+     * Convert a data value, such as one returned by
+     * readPropertyMultiple(), to an enumeration in the same way.
+     *
+     * @param value The data value to convert.
+     * @return The converted value
+     */
+    unsigned int getDataTypeEnum(const BACNET_APPLICATION_DATA_VALUE& value);
+
 #if defined(BACAPP_DOUBLE)
     /**
      * After a successful readProperty request, this method can be
@@ -346,6 +583,15 @@ namespace upm {
      * @return A double floating point value representing the returned data
      */
     double getDataTypeDouble(int index=0);
+
+    /**
+     * Convert a data value, such as one returned by
+     * readPropertyMultiple(), to a double in the same way.
+     *
+     * @param value The data value to convert.
+     * @return The converted value
+     */
+    double getDataTypeDouble(const BACNET_APPLICATION_DATA_VALUE& value);
 #endif // BACAPP_DOUBLE
 
     /**
@@ -628,6 +874,13 @@ namespace upm {
                                        BACNET_ADDRESS* src,
                                        BACNET_CONFIRMED_SERVICE_ACK_DATA* service_data);
 
+    // our handler for dealing with return data from a
+    // ReadPropertyMultiple call
+    static void handlerReadPropertyMultipleAck(uint8_t* service_request,
+                                               uint16_t service_len,
+                                               BACNET_ADDRESS* src,
+                                               BACNET_CONFIRMED_SERVICE_ACK_DATA* service_data);
+
     // our handler for writeProp acks
     static void handlerWritePropertyAck(BACNET_ADDRESS* src,
                                         uint8_t invoke_id);
@@ -638,9 +891,6 @@ namespace upm {
     // utility function
     std::string string2HexString(std::string input);
 
-    // responsible for dispatching a request to the BACnet network
-    bool dispatchRequest();
-
   private:
     // prevent copying and assignment
     BACNETMSTP(BACNETMSTP const &) = delete;
@@ -691,21 +941,10 @@ namespace upm {
     // our returned data from readProperty()
     std::vector<BACNET_APPLICATION_DATA_VALUE> m_returnedValue;
 
-    // current bound target address of dispatched service request
-    // (read/write prop, etc)
-    BACNET_ADDRESS m_targetAddress;
-
-    // current invokeID (for transaction handling)
-    uint8_t m_invokeID;
-
-    // error detected flag
-    bool m_errorDetected;
-
     // Commands - we create a struct to hold the arguments for each
-    // command type we support.  Then, we create a command struct
-    // which contains the command type and a union containing the
-    // relevant arguments.  This is used by dispatchRequest() to issue
-    // the correct request.
+    // command type we support.  Then, each request contains the
+    // command type and a union containing the relevant arguments.
+    // This is used by startRequests() to issue the correct request.
 
     // these may generate SWIG warnings, but they can be ignored as we
     // do not expose these outside the class
@@ -722,19 +961,106 @@ namespace upm {
       BACNET_OBJECT_TYPE objType;
       uint32_t objInstance;
       BACNET_PROPERTY_ID objProperty;
-      BACNET_APPLICATION_DATA_VALUE* propValue;
+      BACNET_APPLICATION_DATA_VALUE propValue;
       uint8_t propPriority;
       int32_t arrayIndex;
     } WRITE_PROPERTY_ARGS_T;
 
-    struct {
+    struct BACREQ_T {
       BACCMD_TYPE_T cmd;
 
       union {
         READ_PROPERTY_ARGS_T readPropArgs;
         WRITE_PROPERTY_ARGS_T writePropArgs;
       };
-    } m_command;
+
+      // bound target address
+      BACNET_ADDRESS targetAddress;
+      bool bound;
+      // when we started waiting for the address to be bound
+      uint32_t queuedMS;
+
+      // invokeID once sent, 0 until then
+      uint8_t invokeID;
+
+      // set once the transaction has finished
+      bool done;
+
+      BACREQ_RESULT_T result;
+      BACREQ_CALLBACK_T callback;
+
+      // readPropertyMultiple properties, the first one and the number
+      // of them in the transaction in flight, and the most to put in
+      // one transaction
+      std::vector<BACPROP_T> props;
+      size_t propsNext;
+      size_t propsCount;
+      size_t propsLimit;
+
+      // maximum APDU the target device accepts
+      unsigned int maxAPDU;
+
+      uint32_t targetDeviceInstanceID() const
+      {
+        return (cmd == BACCMD_WRITE_PROPERTY)
+          ? writePropArgs.targetDeviceInstanceID
+          : readPropArgs.targetDeviceInstanceID;
+      }
+    };
+
+    // queued and in flight requests, oldest first
+    std::list<BACREQ_T> m_requests;
+
+    // ID of the next request
+    int m_nextRequestID;
+
+    // maximum number of transactions in flight
+    int m_maxOutstanding;
+
+    // when a WhoIs was last sent to a device, to send only one while
+    // several requests wait for its address
+    std::map<uint32_t, uint32_t> m_whoIsSentMS;
+
+    // last time fed to the transaction state machine
+    uint32_t m_lastTimerMS;
+
+    // devices that rejected ReadPropertyMultiple, read one property
+    // at a time instead
+    std::set<uint32_t> m_rpmUnsupported;
+
+    // the most properties a device managed to return in one
+    // ReadPropertyMultiple transaction without segmentation
+    std::map<uint32_t, size_t> m_rpmLimit;
+
+    // queue a request, returning its ID
+    int queueRequest(BACREQ_T& req, BACREQ_CALLBACK_T callback);
+
+    // process requests until finished is set by a request callback,
+    // then store its result for the getData*() and error methods
+    bool waitResult(const bool& finished, const BACREQ_RESULT_T& result);
+
+    // bind and send queued requests, fail those that can't be bound
+    void startRequests();
+
+    // remove finished requests and invoke their callbacks
+    void completeRequests();
+
+    // send the next readPropertyMultiple transaction, returning its
+    // invokeID
+    uint8_t sendProperties(BACREQ_T& req);
+
+    // account for a finished readPropertyMultiple transaction,
+    // requeueing the request if there are properties left to read
+    void nextProperties(BACREQ_T& req);
+
+    // feed elapsed monotonic time to the transaction state machine
+    void updateTimers();
+
+    // milliseconds from a monotonic clock
+    static uint32_t monotonicMS();
+
+    // find the in flight request matching a received response
+    BACREQ_T* findRequest(BACNET_ADDRESS* src, uint8_t invoke_id);
 
     bool m_debugging;
   };
@@ -9,6 +9,9 @@ JAVA_JNI_LOADLIBRARY(javaupm_bacnetmstp)
 
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
 %pointer_functions(float, floatp);
+
+%include "bacnetmstp_ignores.i"
+
 %{
 #include "bacnetmstp.hpp"
 %}
@@ -0,0 +1,10 @@
+/* BACNETMSTP methods which are not wrapped, included by the bacnetmstp
+ * interface and the drivers built on it.
+ *
+ * The asynchronous and ReadPropertyMultiple requests take
+ * std::function and std::vector arguments which are not wrapped; use
+ * the blocking readProperty() and writeProperty() instead. */
+%ignore readPropertyAsync;
+%ignore writePropertyAsync;
+%ignore readPropertyMultipleAsync;
+%ignore readPropertyMultiple;
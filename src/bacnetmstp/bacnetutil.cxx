@@ -12,6 +12,7 @@
 #include <unistd.h>
 #include <assert.h>
 #include <errno.h>
+#include <chrono>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -21,6 +22,38 @@
 using namespace upm;
 using namespace std;
 
+// milliseconds from a monotonic clock, for the point cache
+static uint32_t monotonicMS()
+{
+  return uint32_t(chrono::duration_cast<chrono::milliseconds>(
+                    chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static BACNETMSTP::BACPROP_T makeProperty(BACNET_OBJECT_TYPE objType,
+                                          uint32_t objInstance,
+                                          BACNET_PROPERTY_ID property)
+{
+  BACNETMSTP::BACPROP_T prop;
+
+  prop.objType = objType;
+  prop.objInstance = objInstance;
+  prop.objProperty = property;
+  prop.arrayIndex = BACNET_ARRAY_ALL;
+  prop.error = false;
+  prop.errorClass = ERROR_CLASS_DEVICE;
+  prop.errorCode = ERROR_CODE_OTHER;
+
+  return prop;
+}
+
+// the same format as getAllErrorString() for a BACnet error
+static string propertyErrorString(const BACNETMSTP::BACPROP_T& prop)
+{
+  return string("Error: ")
+    + bactext_error_class_name((int)prop.errorClass)
+    + string(": ") + bactext_error_code_name((int)prop.errorCode);
+}
+
 
 BACNETUTIL::BACNETUTIL(uint32_t targetDeviceObjectID) :
   m_instance(0)
@@ -51,6 +84,9 @@ BACNETUTIL::BACNETUTIL(uint32_t targetDeviceObjectID) :
   // empty our binary info stores
   m_bvInfo.clear();
   m_biInfo.clear();
+
+  // values read by poll() are used until the next poll()
+  m_cacheTTL = 0;
 }
 
 BACNETUTIL::~BACNETUTIL()
@@ -86,47 +122,9 @@ void BACNETUTIL::setDebug(bool enable)
 
 float BACNETUTIL::getAnalogValue(uint32_t objInstance)
 {
-  // check reliability first, if enabled
-  if (m_checkReliability)
-    {
-      if (m_instance->readProperty(m_targetDeviceObjectID, OBJECT_ANALOG_VALUE,
-                                   objInstance, PROP_RELIABILITY))
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": (reliability): " << getAllErrorString()
-                 << endl;
-
-          throw runtime_error(string(__FUNCTION__)
-                                   + getAllErrorString());
-        }
-
-      BACNET_RELIABILITY reliable =
-        static_cast<BACNET_RELIABILITY>(m_instance->getDataTypeEnum());
-
-      if (reliable != RELIABILITY_NO_FAULT_DETECTED)
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": Reliability check failed" << endl;
-
-          throw runtime_error(string(__FUNCTION__)
-                                   + ": Reliability check failed");
-        }
-    }
-
-  // now get the value
-  if (m_instance->readProperty(m_targetDeviceObjectID, OBJECT_ANALOG_VALUE,
-                               objInstance, PROP_PRESENT_VALUE))
-    {
-      if (m_debugging)
-        cerr << __FUNCTION__ << ": (value): " << getAllErrorString()
-             << endl;
-
-      throw runtime_error(string(__FUNCTION__)
-                               + ": "
-                               + getAllErrorString());
-    }
-
-  return m_instance->getDataTypeReal();
+  return m_instance->getDataTypeReal(getPresentValue(OBJECT_ANALOG_VALUE,
+                                                     objInstance,
+                                                     __FUNCTION__));
 }
 
 void BACNETUTIL::setAnalogValue(uint32_t objInstance,
@@ -136,6 +134,9 @@ void BACNETUTIL::setAnalogValue(uint32_t objInstance,
   BACNET_APPLICATION_DATA_VALUE myData =
     m_instance->createDataReal(value);
 
+  // the cached value is stale either way
+  expireCached(OBJECT_ANALOG_VALUE, objInstance, PROP_PRESENT_VALUE);
+
   // write it
   if (m_instance->writeProperty(m_targetDeviceObjectID, OBJECT_ANALOG_VALUE,
                                 objInstance, PROP_PRESENT_VALUE,
@@ -178,46 +179,9 @@ string BACNETUTIL::getAnalogValueUnits(uint32_t objInstance)
 
 float BACNETUTIL::getAnalogInput(uint32_t objInstance)
 {
-  // check reliability first, if enabled
-  if (m_checkReliability)
-    {
-      if (m_instance->readProperty(m_targetDeviceObjectID, OBJECT_ANALOG_INPUT,
-                                   objInstance, PROP_RELIABILITY))
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": (reliability): "
-                 << getAllErrorString() << endl;
-
-          throw runtime_error(string(__FUNCTION__)
-                                   + getAllErrorString());
-        }
-
-      BACNET_RELIABILITY reliable =
-        static_cast<BACNET_RELIABILITY>(m_instance->getDataTypeEnum());
-
-      if (reliable != RELIABILITY_NO_FAULT_DETECTED)
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": Reliability check failed" << endl;
-
-          throw runtime_error(string(__FUNCTION__)
-                                   + ": Reliability check failed");
-        }
-    }
-
-  // now get the value
-  if (m_instance->readProperty(m_targetDeviceObjectID, OBJECT_ANALOG_INPUT,
-                               objInstance, PROP_PRESENT_VALUE))
-    {
-      if (m_debugging)
-        cerr << __FUNCTION__ << ": (value): " << getAllErrorString() << endl;
-
-      throw runtime_error(string(__FUNCTION__)
-                               + ": "
-                               + getAllErrorString());
-    }
-
-  return m_instance->getDataTypeReal();
+  return m_instance->getDataTypeReal(getPresentValue(OBJECT_ANALOG_INPUT,
+                                                     objInstance,
+                                                     __FUNCTION__));
 }
 
 bool BACNETUTIL::getBinaryInput(uint32_t objInstance)
@@ -225,47 +189,9 @@ bool BACNETUTIL::getBinaryInput(uint32_t objInstance)
   // check the BV info, and update/cache the data if needed
   updateBinaryInputInfo(objInstance);
 
-  // check reliability first, if enabled
-  if (m_checkReliability)
-    {
-      if (m_instance->readProperty(m_targetDeviceObjectID, OBJECT_BINARY_INPUT,
-                                   objInstance, PROP_RELIABILITY))
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": (reliability): "
-                 << getAllErrorString() << endl;
-
-          throw runtime_error(string(__FUNCTION__)
-                                   + getAllErrorString());
-        }
-
-      BACNET_RELIABILITY reliable =
-        static_cast<BACNET_RELIABILITY>(m_instance->getDataTypeEnum());
-
-      if (reliable != RELIABILITY_NO_FAULT_DETECTED)
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": Reliability check failed" << endl;
-
-          throw runtime_error(string(__FUNCTION__)
-                                   + ": Reliability check failed");
-        }
-    }
-
-  // now get the value
-  if (m_instance->readProperty(m_targetDeviceObjectID, OBJECT_BINARY_INPUT,
-                               objInstance, PROP_PRESENT_VALUE))
-    {
-      if (m_debugging)
-        cerr << __FUNCTION__ << ": (value): " << getAllErrorString() << endl;
-
-      throw runtime_error(string(__FUNCTION__)
-                               + ": "
-                               + getAllErrorString());
-    }
-
   BACNET_BINARY_PV bpv =
-    static_cast<BACNET_BINARY_PV>(m_instance->getDataTypeEnum());
+    static_cast<BACNET_BINARY_PV>(m_instance->getDataTypeEnum(
+      getPresentValue(OBJECT_BINARY_INPUT, objInstance, __FUNCTION__)));
 
   return (bpv == BINARY_INACTIVE) ? false : true;
 }
@@ -275,47 +201,9 @@ bool BACNETUTIL::getBinaryValue(uint32_t objInstance)
   // check the BV info, and update/cache the data if needed
   updateBinaryValueInfo(objInstance);
 
-  // check reliability first, if enabled
-  if (m_checkReliability)
-    {
-      if (m_instance->readProperty(m_targetDeviceObjectID, OBJECT_BINARY_VALUE,
-                                   objInstance, PROP_RELIABILITY))
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": (reliability): "
-                 << getAllErrorString() << endl;
-
-          throw runtime_error(string(__FUNCTION__)
-                                   + getAllErrorString());
-        }
-
-      BACNET_RELIABILITY reliable =
-        static_cast<BACNET_RELIABILITY>(m_instance->getDataTypeEnum());
-
-      if (reliable != RELIABILITY_NO_FAULT_DETECTED)
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": Reliability check failed" << endl;
-
-          throw runtime_error(string(__FUNCTION__)
-                                   + ": Reliability check failed");
-        }
-    }
-
-  // now get the value
-  if (m_instance->readProperty(m_targetDeviceObjectID, OBJECT_BINARY_VALUE,
-                               objInstance, PROP_PRESENT_VALUE))
-    {
-      if (m_debugging)
-        cerr << __FUNCTION__ << ": (value): " << getAllErrorString() << endl;
-
-      throw runtime_error(string(__FUNCTION__)
-                               + ": "
-                               + getAllErrorString());
-    }
-
   BACNET_BINARY_PV bpv =
-    static_cast<BACNET_BINARY_PV>(m_instance->getDataTypeEnum());
+    static_cast<BACNET_BINARY_PV>(m_instance->getDataTypeEnum(
+      getPresentValue(OBJECT_BINARY_VALUE, objInstance, __FUNCTION__)));
 
   return (bpv == BINARY_INACTIVE) ? false : true;
 }
@@ -329,6 +217,9 @@ void BACNETUTIL::setBinaryValue(uint32_t objInstance,
   BACNET_APPLICATION_DATA_VALUE myData =
     m_instance->createDataEnum(bpv);
 
+  // the cached value is stale either way
+  expireCached(OBJECT_BINARY_VALUE, objInstance, PROP_PRESENT_VALUE);
+
   // write it
   if (m_instance->writeProperty(m_targetDeviceObjectID, OBJECT_BINARY_VALUE,
                                 objInstance, PROP_PRESENT_VALUE,
@@ -374,77 +265,56 @@ unsigned int BACNETUTIL::getMultiStateValue(uint32_t objInstance)
   // check the MSV info, and update/cache the data if needed
   updateMultiStateValueInfo(objInstance);
 
-  // check reliability first, if enabled
-  if (m_checkReliability)
-    {
-      if (m_instance->readProperty(m_targetDeviceObjectID,
-                                   OBJECT_MULTI_STATE_VALUE,
-                                   objInstance, PROP_RELIABILITY))
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": (reliability): "
-                 << getAllErrorString() << endl;
-
-          throw runtime_error(string(__FUNCTION__)
-                                   + getAllErrorString());
-        }
-
-      BACNET_RELIABILITY reliable =
-        static_cast<BACNET_RELIABILITY>(m_instance->getDataTypeEnum());
+  return m_instance->getDataTypeUnsignedInt(
+    getPresentValue(OBJECT_MULTI_STATE_VALUE, objInstance, __FUNCTION__));
+}
 
-      if (reliable != RELIABILITY_NO_FAULT_DETECTED)
-        {
-          if (m_debugging)
-            cerr << __FUNCTION__ << ": Reliability check failed" << endl;
+void BACNETUTIL::updateMultiStateValueInfo(uint32_t objInstance)
+{
+  // bail if we already have information on this msv
+  if (m_msvInfo.count(objInstance) != 0)
+    return;
 
-          throw runtime_error(string(__FUNCTION__)
-                                   + ": Reliability check failed");
-        }
-    }
+  // we need to fetch information on MSV's - number of states, and
+  // possibly the state-text, if present.  Both are read with one
+  // request.
+  vector<BACNETMSTP::BACPROP_T> props = {
+    makeProperty(OBJECT_MULTI_STATE_VALUE, objInstance,
+                 PROP_NUMBER_OF_STATES),
+    makeProperty(OBJECT_MULTI_STATE_VALUE, objInstance, PROP_STATE_TEXT)
+  };
 
-  // now get the value
-  if (m_instance->readProperty(m_targetDeviceObjectID,
-                               OBJECT_MULTI_STATE_VALUE,
-                               objInstance, PROP_PRESENT_VALUE))
+  if (readProperties(props))
     {
       if (m_debugging)
-        cerr << __FUNCTION__ << ": (value): " << getAllErrorString() << endl;
+        cerr << __FUNCTION__
+             << ": "
+             << getAllErrorString()
+             << endl;
 
       throw runtime_error(string(__FUNCTION__)
                                + ": "
                                + getAllErrorString());
     }
 
-  return m_instance->getDataTypeUnsignedInt();
-}
-
-void BACNETUTIL::updateMultiStateValueInfo(uint32_t objInstance)
-{
-  // bail if we already have information on this msv
-  if (m_msvInfo.count(objInstance) != 0)
-    return;
-
-  // we need to fetch information on MSV's - number of states, and
-  // possibly the state-text, if present
-
   // get the number of values possible (required)
-  if (m_instance->readProperty(m_targetDeviceObjectID,
-                               OBJECT_MULTI_STATE_VALUE,
-                               objInstance, PROP_NUMBER_OF_STATES))
+  const BACNETMSTP::BACPROP_T& numStates = props[0];
+  if (numStates.error)
     {
       if (m_debugging)
         cerr << __FUNCTION__
              << ": (number of states): "
-             << getAllErrorString()
+             << propertyErrorString(numStates)
              << endl;
 
       throw runtime_error(string(__FUNCTION__)
                                + ": "
-                               + getAllErrorString());
+                               + propertyErrorString(numStates));
     }
 
   // Add the entry...
-  m_msvInfo[objInstance].numStates = m_instance->getDataTypeUnsignedInt();
+  m_msvInfo[objInstance].numStates =
+    m_instance->getDataTypeUnsignedInt(numStates.values.at(0));
 
   if (m_debugging)
     cerr << __FUNCTION__
@@ -452,21 +322,20 @@ void BACNETUTIL::updateMultiStateValueInfo(uint32_t objInstance)
          << m_msvInfo[objInstance].numStates
          << endl;
 
-  // now get the state-text.  This is optional, so we will not throw
+  // now the state-text.  This is optional, so we will not throw
   // here.
-  if (m_instance->readProperty(m_targetDeviceObjectID,
-                               OBJECT_MULTI_STATE_VALUE,
-                               objInstance, PROP_STATE_TEXT))
+  const BACNETMSTP::BACPROP_T& stateText = props[1];
+  if (stateText.error)
     {
       if (m_debugging)
         cerr << __FUNCTION__
              << ": (state-text): "
-             << getAllErrorString()
+             << propertyErrorString(stateText)
              << endl;
     }
 
   // store them
-  int numElements = m_instance->getDataNumElements();
+  int numElements = stateText.values.size();
 
   if (m_debugging)
     cerr << __FUNCTION__ << ": numElements: " << numElements << endl;
@@ -475,7 +344,7 @@ void BACNETUTIL::updateMultiStateValueInfo(uint32_t objInstance)
     {
       for (int i=0; i<numElements; i++)
         {
-          m_msvInfo[objInstance].stateList.push_back(m_instance->getDataTypeString(i));
+          m_msvInfo[objInstance].stateList.push_back(m_instance->getDataTypeString(stateText.values[i]));
 
           if (m_debugging)
             cerr << __FUNCTION__ << ": " << int(objInstance) << ", "
@@ -573,6 +442,9 @@ void BACNETUTIL::setMultiStateValue(uint32_t objInstance,
   BACNET_APPLICATION_DATA_VALUE myData =
     m_instance->createDataUnsignedInt(value);
 
+  // the cached value is stale either way
+  expireCached(OBJECT_MULTI_STATE_VALUE, objInstance, PROP_PRESENT_VALUE);
+
   // write it
   if (m_instance->writeProperty(m_targetDeviceObjectID,
                                 OBJECT_MULTI_STATE_VALUE,
@@ -595,43 +467,53 @@ void BACNETUTIL::updateBinaryValueInfo(uint32_t objInstance)
   if (m_bvInfo.count(objInstance) != 0)
     return;
 
-  // fetch inactive/active text.  These are optional accordingto the
-  // spec, so we will not throw if they do not exist.
+  // fetch inactive/active text with one request.  These are optional
+  // accordingto the spec, so we will not throw if they do not exist.
+  vector<BACNETMSTP::BACPROP_T> props = {
+    makeProperty(OBJECT_BINARY_VALUE, objInstance, PROP_INACTIVE_TEXT),
+    makeProperty(OBJECT_BINARY_VALUE, objInstance, PROP_ACTIVE_TEXT)
+  };
+
+  bool failed = readProperties(props);
+
+  if (failed && m_debugging)
+    cerr << __FUNCTION__
+         << ": "
+         << getAllErrorString()
+         << endl;
 
   // get inactive text
-  if (m_instance->readProperty(m_targetDeviceObjectID,
-                               OBJECT_BINARY_VALUE,
-                               objInstance, PROP_INACTIVE_TEXT))
+  if (failed || props[0].error || props[0].values.empty())
     {
-      if (m_debugging)
+      if (m_debugging && props[0].error)
         cerr << __FUNCTION__
              << ": (inactive text): "
-             << getAllErrorString()
+             << propertyErrorString(props[0])
              << endl;
 
       m_bvInfo[objInstance].inactiveText = "inactive";
     }
   else
     {
-      m_bvInfo[objInstance].inactiveText = m_instance->getDataTypeString();
+      m_bvInfo[objInstance].inactiveText =
+        m_instance->getDataTypeString(props[0].values[0]);
     }
 
   // get active text
-  if (m_instance->readProperty(m_targetDeviceObjectID,
-                               OBJECT_BINARY_VALUE,
-                               objInstance, PROP_ACTIVE_TEXT))
+  if (failed || props[1].error || props[1].values.empty())
     {
-      if (m_debugging)
+      if (m_debugging && props[1].error)
         cerr << __FUNCTION__
              << ": (active text): "
-             << getAllErrorString()
+             << propertyErrorString(props[1])
              << endl;
 
       m_bvInfo[objInstance].activeText = "active";
     }
   else
     {
-      m_bvInfo[objInstance].activeText = m_instance->getDataTypeString();
+      m_bvInfo[objInstance].activeText =
+        m_instance->getDataTypeString(props[1].values[0]);
     }
 
   return;
@@ -657,43 +539,53 @@ void BACNETUTIL::updateBinaryInputInfo(uint32_t objInstance)
   if (m_biInfo.count(objInstance) != 0)
     return;
 
-  // fetch inactive/active text.  These are optional accordingto the
-  // spec, so we will not throw if they do not exist.
+  // fetch inactive/active text with one request.  These are optional
+  // accordingto the spec, so we will not throw if they do not exist.
+  vector<BACNETMSTP::BACPROP_T> props = {
+    makeProperty(OBJECT_BINARY_INPUT, objInstance, PROP_INACTIVE_TEXT),
+    makeProperty(OBJECT_BINARY_INPUT, objInstance, PROP_ACTIVE_TEXT)
+  };
+
+  bool failed = readProperties(props);
+
+  if (failed && m_debugging)
+    cerr << __FUNCTION__
+         << ": "
+         << getAllErrorString()
+         << endl;
 
   // get inactive text
-  if (m_instance->readProperty(m_targetDeviceObjectID,
-                               OBJECT_BINARY_INPUT,
-                               objInstance, PROP_INACTIVE_TEXT))
+  if (failed || props[0].error || props[0].values.empty())
     {
-      if (m_debugging)
+      if (m_debugging && props[0].error)
         cerr << __FUNCTION__
              << ": (inactive text): "
-             << getAllErrorString()
+             << propertyErrorString(props[0])
              << endl;
 
       m_biInfo[objInstance].inactiveText = "inactive";
     }
   else
     {
-      m_biInfo[objInstance].inactiveText = m_instance->getDataTypeString();
+      m_biInfo[objInstance].inactiveText =
+        m_instance->getDataTypeString(props[0].values[0]);
     }
 
   // get active text
-  if (m_instance->readProperty(m_targetDeviceObjectID,
-                               OBJECT_BINARY_INPUT,
-                               objInstance, PROP_ACTIVE_TEXT))
+  if (failed || props[1].error || props[1].values.empty())
     {
-      if (m_debugging)
+      if (m_debugging && props[1].error)
         cerr << __FUNCTION__
              << ": (active text): "
-             << getAllErrorString()
+             << propertyErrorString(props[1])
              << endl;
 
       m_biInfo[objInstance].activeText = "active";
     }
   else
     {
-      m_biInfo[objInstance].activeText = m_instance->getDataTypeString();
+      m_biInfo[objInstance].activeText =
+        m_instance->getDataTypeString(props[1].values[0]);
     }
 
   return;
@@ -749,6 +641,222 @@ string BACNETUTIL::getBinaryValueText(uint32_t objInstance)
   return lookupBinaryValueText(objInstance, value);
 }
 
+void BACNETUTIL::addPollObject(BACNET_OBJECT_TYPE objType,
+                               uint32_t objInstance)
+{
+  if (objInstance >= BACNET_MAX_INSTANCE)
+    {
+      throw out_of_range(string(__FUNCTION__)
+                         + ": objInstance must be less than "
+                         + to_string(BACNET_MAX_INSTANCE));
+    }
+
+  m_pollObjects.push_back({objType, objInstance});
+}
+
+void BACNETUTIL::clearPollObjects()
+{
+  m_pollObjects.clear();
+}
+
+void BACNETUTIL::poll()
+{
+  if (m_pollObjects.empty())
+    return;
+
+  vector<BACNETMSTP::BACPROP_T> props;
+
+  for (auto& obj : m_pollObjects)
+    {
+      if (m_checkReliability)
+        props.push_back(makeProperty(obj.objType, obj.objInstance,
+                                     PROP_RELIABILITY));
+
+      props.push_back(makeProperty(obj.objType, obj.objInstance,
+                                   PROP_PRESENT_VALUE));
+    }
+
+  if (readProperties(props))
+    {
+      if (m_debugging)
+        cerr << __FUNCTION__ << ": " << getAllErrorString() << endl;
+
+      throw runtime_error(string(__FUNCTION__)
+                               + ": "
+                               + getAllErrorString());
+    }
+
+  // replace the values of the previous poll
+  for (auto it = m_pointCache.begin(); it != m_pointCache.end(); )
+    {
+      if (it->second.polled)
+        it = m_pointCache.erase(it);
+      else
+        ++it;
+    }
+
+  cacheProperties(props, true);
+}
+
+void BACNETUTIL::setCacheTTL(unsigned int ttlMS)
+{
+  m_cacheTTL = ttlMS;
+}
+
+void BACNETUTIL::setPropertyCacheTTL(BACNET_PROPERTY_ID property,
+                                     unsigned int ttlMS)
+{
+  m_propertyCacheTTL[property] = ttlMS;
+}
+
+unsigned int BACNETUTIL::getPropertyCacheTTL(BACNET_PROPERTY_ID property)
+{
+  auto it = m_propertyCacheTTL.find(property);
+
+  return (it != m_propertyCacheTTL.end()) ? it->second : m_cacheTTL;
+}
+
+void BACNETUTIL::clearCache()
+{
+  m_pointCache.clear();
+}
+
+bool BACNETUTIL::readProperties(vector<BACNETMSTP::BACPROP_T>& props)
+{
+  if (props.size() > 1)
+    return m_instance->readPropertyMultiple(m_targetDeviceObjectID, props);
+
+  // a single property is read with a plain readProperty request
+  BACNETMSTP::BACPROP_T& prop = props.at(0);
+
+  prop.values.clear();
+  prop.error = false;
+
+  if (m_instance->readProperty(m_targetDeviceObjectID, prop.objType,
+                               prop.objInstance, prop.objProperty,
+                               prop.arrayIndex))
+    {
+      // report BACnet errors for the property, as readPropertyMultiple
+      // does
+      if (m_instance->getErrorType() != BACNETMSTP::BACERR_TYPE_ERROR)
+        return true;
+
+      prop.error = true;
+      prop.errorClass = m_instance->getErrorClass();
+      prop.errorCode = m_instance->getErrorCode();
+
+      return false;
+    }
+
+  for (int i=0; i<m_instance->getDataNumElements(); i++)
+    prop.values.push_back(m_instance->getData(i));
+
+  return false;
+}
+
+void BACNETUTIL::cacheProperties(const vector<BACNETMSTP::BACPROP_T>& props,
+                                 bool polled)
+{
+  uint32_t now = monotonicMS();
+
+  for (auto& prop : props)
+    {
+      cacheEntry_t& entry =
+        m_pointCache[cacheKey_t(prop.objType, prop.objInstance,
+                                prop.objProperty)];
+
+      entry.timeMS = now;
+      entry.polled = polled;
+      entry.prop = prop;
+    }
+}
+
+bool BACNETUTIL::isCached(BACNET_OBJECT_TYPE objType, uint32_t objInstance,
+                          BACNET_PROPERTY_ID property)
+{
+  auto it = m_pointCache.find(cacheKey_t(objType, objInstance, property));
+
+  // errors are not reused
+  if (it == m_pointCache.end() || it->second.prop.error)
+    return false;
+
+  unsigned int ttlMS = getPropertyCacheTTL(property);
+
+  if (!ttlMS)
+    return it->second.polled;
+
+  return (monotonicMS() - it->second.timeMS) < ttlMS;
+}
+
+BACNET_APPLICATION_DATA_VALUE
+BACNETUTIL::getCachedValue(BACNET_OBJECT_TYPE objType, uint32_t objInstance,
+                           BACNET_PROPERTY_ID property, string caller)
+{
+  const BACNETMSTP::BACPROP_T& prop =
+    m_pointCache.at(cacheKey_t(objType, objInstance, property)).prop;
+
+  if (prop.error)
+    {
+      if (m_debugging)
+        cerr << caller << ": " << propertyErrorString(prop) << endl;
+
+      throw runtime_error(caller + ": " + propertyErrorString(prop));
+    }
+
+  return prop.values.at(0);
+}
+
+void BACNETUTIL::expireCached(BACNET_OBJECT_TYPE objType,
+                              uint32_t objInstance,
+                              BACNET_PROPERTY_ID property)
+{
+  m_pointCache.erase(cacheKey_t(objType, objInstance, property));
+}
+
+BACNET_APPLICATION_DATA_VALUE
+BACNETUTIL::getPresentValue(BACNET_OBJECT_TYPE objType, uint32_t objInstance,
+                            string caller)
+{
+  // read whatever isn't cached, reliability first, if enabled
+  vector<BACNETMSTP::BACPROP_T> props;
+
+  if (m_checkReliability && !isCached(objType, objInstance, PROP_RELIABILITY))
+    props.push_back(makeProperty(objType, objInstance, PROP_RELIABILITY));
+
+  if (!isCached(objType, objInstance, PROP_PRESENT_VALUE))
+    props.push_back(makeProperty(objType, objInstance, PROP_PRESENT_VALUE));
+
+  if (!props.empty())
+    {
+      if (readProperties(props))
+        {
+          if (m_debugging)
+            cerr << caller << ": " << getAllErrorString() << endl;
+
+          throw runtime_error(caller + ": " + getAllErrorString());
+        }
+
+      cacheProperties(props, false);
+    }
+
+  if (m_checkReliability)
+    {
+      BACNET_RELIABILITY reliable =
+        static_cast<BACNET_RELIABILITY>(m_instance->getDataTypeEnum(
+          getCachedValue(objType, objInstance, PROP_RELIABILITY, caller)));
+
+      if (reliable != RELIABILITY_NO_FAULT_DETECTED)
+        {
+          if (m_debugging)
+            cerr << caller << ": Reliability check failed" << endl;
+
+          throw runtime_error(caller + ": Reliability check failed");
+        }
+    }
+
+  return getCachedValue(objType, objInstance, PROP_PRESENT_VALUE, caller);
+}
+
 BACNETMSTP::BACERR_TYPE_T BACNETUTIL::getErrorType()
 {
   return m_instance->getErrorType();
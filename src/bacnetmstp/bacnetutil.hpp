@@ -12,6 +12,7 @@
 
 #include <string>
 #include <map>
+#include <tuple>
 #include <vector>
 
 #include "bacnetmstp.hpp"
@@ -32,6 +33,12 @@ namespace upm {
    * proprty (with and without relability checking) as well as access
    * to error conditions.  It is intended to be inherited by your
    * driver class.
+   *
+   * Property values read from the device are kept in a point cache.
+   * Drivers can list the objects they read regularly with
+   * addPollObject() and read them all with a single request using
+   * poll(), see setCacheTTL() for how long the cached values are
+   * used.
    */
 
   class BACNETUTIL {
@@ -349,6 +356,79 @@ namespace upm {
       m_checkReliability = enable;
     };
 
+    /**
+     * Add an object to the list of objects read by poll().
+     *
+     * @param objType The BACnet object type of the object.
+     * @param objInstance The Object Instance number of the object.
+     */
+    virtual void addPollObject(BACNET_OBJECT_TYPE objType,
+                               uint32_t objInstance);
+
+    /**
+     * Empty the list of objects read by poll().
+     */
+    virtual void clearPollObjects();
+
+    /**
+     * Read the Present_Value property of every object added with
+     * addPollObject(), and its Reliability property if
+     * checkReliability() has been enabled, into the point cache.
+     * The properties are read with as few ReadPropertyMultiple
+     * requests as the device allows, usually one.  The get*()
+     * methods then return the polled values while they are fresh,
+     * see setCacheTTL().  This method will throw if the request
+     * fails.  Errors reading individual properties are reported by
+     * the get*() methods instead.
+     */
+    virtual void poll();
+
+    /**
+     * Set how long the get*() methods reuse a property value read
+     * from the device, in milliseconds.  This applies to every
+     * property without its own TTL set with setPropertyCacheTTL().
+     *
+     * With the default TTL of 0, values read by poll() are returned
+     * until the next poll(), and the get*() methods query the device
+     * for everything else.  With a non-zero TTL, every value read
+     * from the device is reused until it is older than the TTL.
+     * Writing a value always removes it from the cache.
+     *
+     * @param ttlMS The time to live of cached values, in
+     * milliseconds.
+     */
+    virtual void setCacheTTL(unsigned int ttlMS);
+
+    /**
+     * Set how long the get*() methods reuse the value of one
+     * property, overriding setCacheTTL().  For example, Reliability
+     * usually changes far less often than Present_Value.
+     *
+     * @param property The property, one of the BACNET_PROPERTY_ID
+     * values.
+     * @param ttlMS The time to live of cached values of the
+     * property, in milliseconds.
+     */
+    virtual void setPropertyCacheTTL(BACNET_PROPERTY_ID property,
+                                     unsigned int ttlMS);
+
+    /**
+     * Return how long the get*() methods reuse the value of a
+     * property.
+     *
+     * @param property The property, one of the BACNET_PROPERTY_ID
+     * values.
+     * @return The time to live of cached values of the property, in
+     * milliseconds.
+     */
+    virtual unsigned int getPropertyCacheTTL(BACNET_PROPERTY_ID property);
+
+    /**
+     * Empty the point cache, so that the get*() methods query the
+     * device until the next poll().
+     */
+    virtual void clearCache();
+
     /**
      * Query the Device Object of the device and return it's
      * Description property.  This typically contains information like
@@ -476,6 +556,40 @@ namespace upm {
     virtual std::string getUPMErrorString();
 
   protected:
+    // read several properties of our device, returning true if the
+    // request failed.  Properties the device could not return have
+    // their error flag set.
+    virtual bool readProperties(std::vector<BACNETMSTP::BACPROP_T>& props);
+
+    // store properties in the point cache.  polled marks values read
+    // by poll().
+    virtual void cacheProperties(const std::vector<BACNETMSTP::BACPROP_T>& props,
+                                 bool polled);
+
+    // is there a fresh cached value for a property?
+    virtual bool isCached(BACNET_OBJECT_TYPE objType, uint32_t objInstance,
+                          BACNET_PROPERTY_ID property);
+
+    // return the cached value of a property, throwing if the device
+    // returned an error for it
+    virtual BACNET_APPLICATION_DATA_VALUE
+    getCachedValue(BACNET_OBJECT_TYPE objType, uint32_t objInstance,
+                   BACNET_PROPERTY_ID property, std::string caller);
+
+    // remove a property from the point cache
+    virtual void expireCached(BACNET_OBJECT_TYPE objType,
+                              uint32_t objInstance,
+                              BACNET_PROPERTY_ID property);
+
+    // return the Present_Value property of an object, from the point
+    // cache if fresh.  If checkReliability() is enabled the
+    // Reliability property is checked first, both being read with a
+    // single request.  Throws on errors, reported with the caller's
+    // name.
+    virtual BACNET_APPLICATION_DATA_VALUE
+    getPresentValue(BACNET_OBJECT_TYPE objType, uint32_t objInstance,
+                    std::string caller);
+
     // update our stored info for an MSV
     virtual void updateMultiStateValueInfo(uint32_t objInstance);
     // delete our stored info for an MSV
@@ -541,6 +655,31 @@ namespace upm {
     typedef std::map<uint32_t, std::string> aiCacheMap_t;
     aiCacheMap_t m_aiUnitCache;
 
+    // objects read by poll()
+    typedef struct {
+      BACNET_OBJECT_TYPE objType;
+      uint32_t objInstance;
+    } pollObject_t;
+    std::vector<pollObject_t> m_pollObjects;
+
+    // the point cache, property values of our device keyed by
+    // object type, instance and property
+    typedef struct {
+      // monotonic time when it was read, in milliseconds
+      uint32_t timeMS;
+      // read by poll()
+      bool polled;
+      BACNETMSTP::BACPROP_T prop;
+    } cacheEntry_t;
+    typedef std::tuple<BACNET_OBJECT_TYPE, uint32_t,
+                       BACNET_PROPERTY_ID> cacheKey_t;
+    typedef std::map<cacheKey_t, cacheEntry_t> pointCache_t;
+    pointCache_t m_pointCache;
+
+    // cache TTLs in milliseconds, default and per property
+    unsigned int m_cacheTTL;
+    std::map<BACNET_PROPERTY_ID, unsigned int> m_propertyCacheTTL;
+
   private:
   };
 }
@@ -21,6 +21,45 @@
 #define INT16_TO_FLOAT(h, l) \
     (float)( (int16_t)( (l) | ((h) << 8) ) )
 
+// size of an XYZ FIFO frame.  The FIFO data register doesn't
+// auto-increment, so any number of frames can be read in one burst.
+#define BMA250E_FIFO_FRAME_LEN 6
+
+// current time in microseconds on the monotonic clock
+static uint64_t _now_us(void)
+{
+    upm_clock_t epoch;
+
+    memset((void *)&epoch, 0, sizeof(upm_clock_t));
+    return upm_elapsed_us(&epoch);
+}
+
+// convert a low/high register pair into a raw acceleration value
+static float _acc_value(const bma250e_context dev, uint8_t lsb, uint8_t msb)
+{
+    uint8_t mask = 0, shift = 0;
+    float divisor = 1;
+
+    switch (dev->resolution)
+    {
+    case BMA250E_RESOLUTION_10BITS:
+        mask = _BMA250E_ACCD10_LSB_MASK;
+        shift = _BMA250E_ACCD10_LSB_SHIFT;
+        divisor = 64.0;
+
+        break;
+
+    case BMA250E_RESOLUTION_12BITS:
+        mask = _BMA250E_ACCD12_LSB_MASK;
+        shift = _BMA250E_ACCD12_LSB_SHIFT;
+        divisor = 16.0;
+
+        break;
+    }
+
+    return INT16_TO_FLOAT(msb, (lsb & (mask << shift))) / divisor;
+}
+
 // SPI CS on and off functions
 static void _csOn(const bma250e_context dev)
 {
@@ -238,34 +277,14 @@ upm_result_t bma250e_update(const bma250e_context dev)
         return UPM_ERROR_OPERATION_FAILED;
     }
 
-    uint8_t mask = 0, shift = 0;
-    float divisor = 1;
-
-    switch (dev->resolution)
-    {
-    case BMA250E_RESOLUTION_10BITS:
-        mask = _BMA250E_ACCD10_LSB_MASK;
-        shift = _BMA250E_ACCD10_LSB_SHIFT;
-        divisor = 64.0;
-
-        break;
-
-    case BMA250E_RESOLUTION_12BITS:
-        mask = _BMA250E_ACCD12_LSB_MASK;
-        shift = _BMA250E_ACCD12_LSB_SHIFT;
-        divisor = 16.0;
-
-        break;
-    }
-
-    // x                       msb     lsb
-    dev->accX = INT16_TO_FLOAT(buf[1], (buf[0] & (mask << shift))) / divisor;
+    // x                      lsb     msb
+    dev->accX = _acc_value(dev, buf[0], buf[1]);
 
     // y
-    dev->accY = INT16_TO_FLOAT(buf[3], (buf[2] & (mask << shift))) / divisor;
+    dev->accY = _acc_value(dev, buf[2], buf[3]);
 
     // z
-    dev->accZ = INT16_TO_FLOAT(buf[5], (buf[4] & (mask << shift))) / divisor;
+    dev->accZ = _acc_value(dev, buf[4], buf[5]);
 
     // get the temperature...
 
@@ -495,6 +514,11 @@ upm_result_t bma250e_set_bandwidth(const bma250e_context dev,
     if (bma250e_write_reg(dev, BMA250E_REG_PMU_BW, bw))
         return UPM_ERROR_OPERATION_FAILED;
 
+    // The data rate is twice the bandwidth, which doubles from
+    // 7.81Hz at BMA250E_BW_7_81 (and below) on up.
+    int steps = (bw > BMA250E_BW_7_81) ? bw - BMA250E_BW_7_81 : 0;
+    dev->odrPeriod = 64000 >> steps;
+
     return UPM_SUCCESS;
 }
 
@@ -549,9 +573,105 @@ upm_result_t bma250e_fifo_config(const bma250e_context dev,
     if (bma250e_write_reg(dev, BMA250E_REG_FIFO_CONFIG_1, reg))
         return UPM_ERROR_OPERATION_FAILED;
 
+    dev->fifoMode = mode;
+    dev->fifoAxes = axes;
+
     return UPM_SUCCESS;
 }
 
+int bma250e_read_fifo(const bma250e_context dev,
+                      BMA250E_FIFO_FRAME_T *frames, int max_frames)
+{
+    assert(dev != NULL);
+    assert(frames != NULL);
+
+    if (!dev->fifoAvailable)
+        return -1;
+
+    uint8_t status = bma250e_read_reg(dev, BMA250E_REG_FIFO_STATUS);
+    uint64_t now = _now_us();
+
+    int count = (status >> _BMA250E_FIFO_STATUS_FRAME_COUNTER_SHIFT)
+        & _BMA250E_FIFO_STATUS_FRAME_COUNTER_MASK;
+
+    if (count > BMA250E_FIFO_FRAMES)
+        count = BMA250E_FIFO_FRAMES;
+
+    int num = (count < max_frames) ? count : max_frames;
+
+    // a frame holds all 3 axes, or just the one selected
+    int frameLen = (dev->fifoAxes == BMA250E_FIFO_DATA_SEL_XYZ)
+        ? BMA250E_FIFO_FRAME_LEN : 2;
+
+    if (num > 0)
+    {
+        int bufLen = num * frameLen;
+        uint8_t buf[bufLen];
+
+        if (bma250e_read_regs(dev, BMA250E_REG_FIFO_DATA, buf, bufLen)
+            != bufLen)
+        {
+            printf("%s: bma250e_read_regs() failed to read %d bytes\n",
+                   __FUNCTION__, bufLen);
+            return -1;
+        }
+
+        float scale = dev->accScale / 1000.0;
+
+        for (int i=0; i<num; i++)
+        {
+            const uint8_t *ptr = &buf[i * frameLen];
+            BMA250E_FIFO_FRAME_T *frame = &frames[i];
+
+            memset((void *)frame, 0, sizeof(BMA250E_FIFO_FRAME_T));
+
+            // the newest frame in the FIFO was sampled last
+            uint64_t age = (uint64_t)(count - 1 - i) * dev->odrPeriod;
+            frame->timestamp = (age < now) ? now - age : 0;
+
+            switch (dev->fifoAxes)
+            {
+            case BMA250E_FIFO_DATA_SEL_XYZ:
+                frame->x = _acc_value(dev, ptr[0], ptr[1]) * scale;
+                frame->y = _acc_value(dev, ptr[2], ptr[3]) * scale;
+                frame->z = _acc_value(dev, ptr[4], ptr[5]) * scale;
+                break;
+
+            case BMA250E_FIFO_DATA_SEL_X:
+                frame->x = _acc_value(dev, ptr[0], ptr[1]) * scale;
+                break;
+
+            case BMA250E_FIFO_DATA_SEL_Y:
+                frame->y = _acc_value(dev, ptr[0], ptr[1]) * scale;
+                break;
+
+            case BMA250E_FIFO_DATA_SEL_Z:
+                frame->z = _acc_value(dev, ptr[0], ptr[1]) * scale;
+                break;
+            }
+        }
+    }
+
+    // the overrun flag is only cleared by rewriting the FIFO
+    // configuration, which also empties the FIFO
+    if (status & BMA250E_FIFO_STATUS_FIFO_OVERRUN)
+    {
+        dev->fifoOverruns++;
+
+        if (bma250e_fifo_config(dev, dev->fifoMode, dev->fifoAxes))
+            return -1;
+    }
+
+    return num;
+}
+
+unsigned int bma250e_get_fifo_overruns(const bma250e_context dev)
+{
+    assert(dev != NULL);
+
+    return dev->fifoOverruns;
+}
+
 upm_result_t bma250e_set_self_test(const bma250e_context dev,
                                    bool sign, bool amp,
                                    BMA250E_SELFTTEST_AXIS_T axis)
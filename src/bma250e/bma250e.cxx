@@ -353,6 +353,21 @@ void BMA250E::fifoConfig(BMA250E_FIFO_MODE_T mode,
                                  + ": bma250e_fifo_config() failed");
 }
 
+int BMA250E::readFIFO(BMA250E_FIFO_FRAME_T *frames, int maxFrames)
+{
+    int rv = bma250e_read_fifo(m_bma250e, frames, maxFrames);
+    if (rv < 0)
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": bma250e_read_fifo() failed");
+
+    return rv;
+}
+
+unsigned int BMA250E::getFIFOOverruns()
+{
+    return bma250e_get_fifo_overruns(m_bma250e);
+}
+
 void BMA250E::setSelfTest(bool sign, bool amp, BMA250E_SELFTTEST_AXIS_T axis)
 {
     if (bma250e_set_self_test(m_bma250e, sign, amp, axis))
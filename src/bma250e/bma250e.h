@@ -66,6 +66,15 @@ extern "C" {
 
         // acceleration scaling
         float accScale;
+
+        // FIFO configuration, and the output data rate in
+        // microseconds per frame
+        BMA250E_FIFO_MODE_T fifoMode;
+        BMA250E_FIFO_DATA_SEL_T fifoAxes;
+        uint32_t odrPeriod;
+
+        // number of times frames were lost
+        unsigned int fifoOverruns;
     } *bma250e_context;
 
     /**
@@ -248,6 +257,39 @@ extern "C" {
                                      BMA250E_FIFO_MODE_T mode,
                                      BMA250E_FIFO_DATA_SEL_T axes);
 
+    /**
+     * Read every frame available in the FIFO, oldest first, in a
+     * single burst.  Select BMA250E_FIFO_MODE_STREAM (or
+     * BMA250E_FIFO_MODE_FIFO) with bma250e_fifo_config() first,
+     * since in bypass mode the FIFO only holds the latest frame.
+     *
+     * Frame timestamps are reconstructed from the output data rate
+     * (twice the bandwidth), with the newest frame in the FIFO taken
+     * to have been sampled at the time of the read.
+     *
+     * If frames were lost because the FIFO was full, the FIFO is
+     * reset after reading, and the count returned by
+     * bma250e_get_fifo_overruns() is incremented.
+     *
+     * @param dev The device context.
+     * @param frames The array to store the frames in.
+     * @param max_frames The maximum number of frames to read.  The
+     * FIFO holds up to BMA250E_FIFO_FRAMES frames.
+     * @return The number of frames read, or -1 on error or if the
+     * device has no FIFO.
+     */
+    int bma250e_read_fifo(const bma250e_context dev,
+                          BMA250E_FIFO_FRAME_T *frames, int max_frames);
+
+    /**
+     * Return the number of FIFO overruns (frames lost because the
+     * FIFO was full) seen by bma250e_read_fifo().
+     *
+     * @param dev The device context.
+     * @return The number of overruns.
+     */
+    unsigned int bma250e_get_fifo_overruns(const bma250e_context dev);
+
     /**
      * Enable, disable, and configure the built in self test on a per
      * axis basis.  See the datasheet for details.
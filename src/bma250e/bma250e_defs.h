@@ -12,6 +12,8 @@
  */
 #pragma once
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -879,7 +881,7 @@ extern "C" {
         BMA250E_FIFO_CONFIG_1_FIFO_MODE0         = 0x40,
         BMA250E_FIFO_CONFIG_1_FIFO_MODE1         = 0x80,
         _BMA250E_FIFO_CONFIG_1_FIFO_MODE_MASK    = 3,
-        _BMA250E_FIFO_CONFIG_1_FIFO_MODE_SHIFT   = 5
+        _BMA250E_FIFO_CONFIG_1_FIFO_MODE_SHIFT   = 6
     } BMA250E_FIFO_CONFIG_1_BITS_T;
 
     /**
@@ -917,6 +919,21 @@ extern "C" {
         BMA250E_RESOLUTION_12BITS
     } BMA250E_RESOLUTION_T;
 
+    // maximum number of frames the FIFO can hold
+#define BMA250E_FIFO_FRAMES 32
+
+    // a frame read from the FIFO by bma250e_read_fifo()
+    typedef struct {
+        // estimated sampling time in microseconds, on the same
+        // monotonic clock for all devices
+        uint64_t timestamp;
+
+        // acceleration in gravities, 0 for axes not in the FIFO
+        float x;
+        float y;
+        float z;
+    } BMA250E_FIFO_FRAME_T;
+
 #ifdef __cplusplus
 }
 #endif
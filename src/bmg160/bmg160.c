@@ -21,6 +21,31 @@
 #define INT16_TO_FLOAT(h, l) \
     (float)( (int16_t)( (l) | ((h) << 8) ) )
 
+// size of an XYZ FIFO frame.  The FIFO data register doesn't
+// auto-increment, so any number of frames can be read in one burst.
+#define BMG160_FIFO_FRAME_LEN 6
+
+// output data rates in microseconds per frame, indexed by BMG160_BW_T
+static const uint32_t _odr_periods[] = {
+    500,                        // BMG160_BW_2000_UNFILTERED
+    500,                        // BMG160_BW_2000_230
+    1000,                       // BMG160_BW_1000_116
+    2500,                       // BMG160_BW_400_47
+    5000,                       // BMG160_BW_200_23
+    10000,                      // BMG160_BW_100_12
+    5000,                       // BMG160_BW_200_64
+    10000                       // BMG160_BW_100_32
+};
+
+// current time in microseconds on the monotonic clock
+static uint64_t _now_us(void)
+{
+    upm_clock_t epoch;
+
+    memset((void *)&epoch, 0, sizeof(upm_clock_t));
+    return upm_elapsed_us(&epoch);
+}
+
 // SPI CS on and off functions
 static void _csOn(const bmg160_context dev)
 {
@@ -431,6 +456,9 @@ upm_result_t bmg160_set_bandwidth(const bmg160_context dev,
     if (bmg160_write_reg(dev, BMG160_REG_GYR_BW, bw))
         return UPM_ERROR_OPERATION_FAILED;
 
+    if (bw <= BMG160_BW_100_32)
+        dev->odrPeriod = _odr_periods[bw];
+
     return UPM_SUCCESS;
 }
 
@@ -477,9 +505,105 @@ upm_result_t bmg160_fifo_config(const bmg160_context dev,
     if (bmg160_write_reg(dev, BMG160_REG_FIFO_CONFIG_1, reg))
         return UPM_ERROR_OPERATION_FAILED;
 
+    dev->fifoMode = mode;
+    dev->fifoAxes = axes;
+
     return UPM_SUCCESS;
 }
 
+int bmg160_read_fifo(const bmg160_context dev,
+                     BMG160_FIFO_FRAME_T *frames, int max_frames)
+{
+    assert(dev != NULL);
+    assert(frames != NULL);
+
+    uint8_t status = bmg160_read_reg(dev, BMG160_REG_FIFO_STATUS);
+    uint64_t now = _now_us();
+
+    int count = (status >> _BMG160_FIFO_STATUS_FRAME_COUNTER_SHIFT)
+        & _BMG160_FIFO_STATUS_FRAME_COUNTER_MASK;
+
+    if (count > BMG160_FIFO_FRAMES)
+        count = BMG160_FIFO_FRAMES;
+
+    int num = (count < max_frames) ? count : max_frames;
+
+    // a frame holds all 3 axes, or just the one selected
+    int frameLen = (dev->fifoAxes == BMG160_FIFO_DATA_SEL_XYZ)
+        ? BMG160_FIFO_FRAME_LEN : 2;
+
+    if (num > 0)
+    {
+        int bufLen = num * frameLen;
+        uint8_t buf[bufLen];
+
+        if (bmg160_read_regs(dev, BMG160_REG_FIFO_DATA, buf, bufLen)
+            != bufLen)
+        {
+            printf("%s: bmg160_read_regs() failed to read %d bytes\n",
+                   __FUNCTION__, bufLen);
+            return -1;
+        }
+
+        float scale = dev->gyrScale / 1000.0;
+
+        for (int i=0; i<num; i++)
+        {
+            const uint8_t *ptr = &buf[i * frameLen];
+            BMG160_FIFO_FRAME_T *frame = &frames[i];
+
+            memset((void *)frame, 0, sizeof(BMG160_FIFO_FRAME_T));
+
+            // the newest frame in the FIFO was sampled last
+            uint64_t age = (uint64_t)(count - 1 - i) * dev->odrPeriod;
+            frame->timestamp = (age < now) ? now - age : 0;
+
+            //                                msb     lsb
+            float value = INT16_TO_FLOAT(ptr[1], ptr[0]) * scale;
+
+            switch (dev->fifoAxes)
+            {
+            case BMG160_FIFO_DATA_SEL_XYZ:
+                frame->x = value;
+                frame->y = INT16_TO_FLOAT(ptr[3], ptr[2]) * scale;
+                frame->z = INT16_TO_FLOAT(ptr[5], ptr[4]) * scale;
+                break;
+
+            case BMG160_FIFO_DATA_SEL_X:
+                frame->x = value;
+                break;
+
+            case BMG160_FIFO_DATA_SEL_Y:
+                frame->y = value;
+                break;
+
+            case BMG160_FIFO_DATA_SEL_Z:
+                frame->z = value;
+                break;
+            }
+        }
+    }
+
+    // the overrun flag is only cleared by rewriting the FIFO
+    // configuration, which also empties the FIFO
+    if (status & BMG160_FIFO_STATUS_FIFO_OVERRUN)
+    {
+        dev->fifoOverruns++;
+
+        if (bmg160_fifo_config(dev, dev->fifoMode, dev->fifoAxes))
+            return -1;
+    }
+
+    return num;
+}
+
+unsigned int bmg160_get_fifo_overruns(const bmg160_context dev)
+{
+    assert(dev != NULL);
+
+    return dev->fifoOverruns;
+}
+
 uint8_t bmg160_get_interrupt_enable0(const bmg160_context dev)
 {
     assert(dev != NULL);
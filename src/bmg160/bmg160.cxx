@@ -311,6 +311,21 @@ void BMG160::fifoConfig(BMG160_FIFO_MODE_T mode, BMG160_FIFO_DATA_SEL_T axes)
                                  + ": bmg160_fifo_config() failed");
 }
 
+int BMG160::readFIFO(BMG160_FIFO_FRAME_T *frames, int maxFrames)
+{
+    int rv = bmg160_read_fifo(m_bmg160, frames, maxFrames);
+    if (rv < 0)
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": bmg160_read_fifo() failed");
+
+    return rv;
+}
+
+unsigned int BMG160::getFIFOOverruns()
+{
+    return bmg160_get_fifo_overruns(m_bmg160);
+}
+
 uint8_t BMG160::getInterruptEnable0()
 {
     return bmg160_get_interrupt_enable0(m_bmg160);
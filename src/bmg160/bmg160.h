@@ -60,6 +60,15 @@ extern "C" {
 
         // gyr scaling
         float gyrScale;
+
+        // FIFO configuration, and the output data rate in
+        // microseconds per frame
+        BMG160_FIFO_MODE_T fifoMode;
+        BMG160_FIFO_DATA_SEL_T fifoAxes;
+        uint32_t odrPeriod;
+
+        // number of times frames were lost
+        unsigned int fifoOverruns;
     } *bmg160_context;
 
     /**
@@ -234,6 +243,38 @@ extern "C" {
                                     BMG160_FIFO_MODE_T mode,
                                     BMG160_FIFO_DATA_SEL_T axes);
 
+    /**
+     * Read every frame available in the FIFO, oldest first, in a
+     * single burst.  Select BMG160_FIFO_MODE_STREAM (or
+     * BMG160_FIFO_MODE_FIFO) with bmg160_fifo_config() first,
+     * since in bypass mode the FIFO only holds the latest frame.
+     *
+     * Frame timestamps are reconstructed from the output data rate
+     * selected with bmg160_set_bandwidth(), with the newest frame in
+     * the FIFO taken to have been sampled at the time of the read.
+     *
+     * If frames were lost because the FIFO was full, the FIFO is
+     * reset after reading, and the count returned by
+     * bmg160_get_fifo_overruns() is incremented.
+     *
+     * @param dev The device context.
+     * @param frames The array to store the frames in.
+     * @param max_frames The maximum number of frames to read.  The
+     * FIFO holds up to BMG160_FIFO_FRAMES frames.
+     * @return The number of frames read, or -1 on error.
+     */
+    int bmg160_read_fifo(const bmg160_context dev,
+                         BMG160_FIFO_FRAME_T *frames, int max_frames);
+
+    /**
+     * Return the number of FIFO overruns (frames lost because the
+     * FIFO was full) seen by bmg160_read_fifo().
+     *
+     * @param dev The device context.
+     * @return The number of overruns.
+     */
+    unsigned int bmg160_get_fifo_overruns(const bmg160_context dev);
+
     /**
      * Return the Interrupt Enables 0 register.  These registers
      * allow you to enable various interrupt conditions.  See the
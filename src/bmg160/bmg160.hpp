@@ -234,6 +234,34 @@ namespace upm {
          */
         void fifoConfig(BMG160_FIFO_MODE_T mode, BMG160_FIFO_DATA_SEL_T axes);
 
+        /**
+         * Read every frame available in the FIFO, oldest first, in a
+         * single burst.  Select FIFO_MODE_STREAM (or FIFO_MODE_FIFO)
+         * with fifoConfig() first.  Frame timestamps (in
+         * microseconds, on a monotonic clock shared by all devices)
+         * are reconstructed from the output data rate, and angular
+         * velocity is in degrees per second.
+         *
+         * If frames were lost because the FIFO was full, the FIFO is
+         * reset after reading, and the count returned by
+         * getFIFOOverruns() is incremented.
+         *
+         * @param frames The array to store the frames in.
+         * @param maxFrames The maximum number of frames to read.  The
+         * FIFO holds up to BMG160_FIFO_FRAMES frames.
+         * @return The number of frames read.
+         * @throws std::runtime_error on failure.
+         */
+        int readFIFO(BMG160_FIFO_FRAME_T *frames, int maxFrames);
+
+        /**
+         * Return the number of FIFO overruns (frames lost because the
+         * FIFO was full) seen by readFIFO().
+         *
+         * @return The number of overruns.
+         */
+        unsigned int getFIFOOverruns();
+
         /**
          * Return the Interrupt Enables 0 register.  These registers
          * allow you to enable various interrupt conditions.  See the
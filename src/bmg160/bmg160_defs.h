@@ -12,6 +12,8 @@
  */
 #pragma once
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -775,6 +777,22 @@ extern "C" {
         BMG160_INTERRUPT_INT2
     } BMG160_INTERRUPT_PINS_T;
 
+    // maximum number of frames the FIFO can hold
+#define BMG160_FIFO_FRAMES 100
+
+    // a frame read from the FIFO by bmg160_read_fifo()
+    typedef struct {
+        // estimated sampling time in microseconds, on the same
+        // monotonic clock for all devices
+        uint64_t timestamp;
+
+        // angular velocity in degrees per second, 0 for axes not in
+        // the FIFO
+        float x;
+        float y;
+        float z;
+    } BMG160_FIFO_FRAME_T;
+
 #ifdef __cplusplus
 }
 #endif
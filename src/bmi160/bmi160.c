@@ -46,8 +46,24 @@ static void bmi160_cs_off()
         mraa_gpio_write(gpioContext, 1);
 }
 
-// i2c bus read and write functions for use with the bmi driver code
-s8 bmi160_bus_read(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
+// FIFO flush command for bmi160_set_command_register()
+#define BMI160_CMD_FIFO_FLUSH 0xb0
+
+// FIFO frame header fields.  Regular frames have the sensors whose
+// data follows in the parameter bits.
+#define BMI160_FIFO_HEAD_MODE_MASK 0xc0
+#define BMI160_FIFO_HEAD_REGULAR   0x80
+#define BMI160_FIFO_HEAD_MAG       0x10
+#define BMI160_FIFO_HEAD_GYRO      0x08
+#define BMI160_FIFO_HEAD_ACCEL     0x04
+#define BMI160_FIFO_HEAD_SENSORS   (BMI160_FIFO_HEAD_MAG \
+                                    | BMI160_FIFO_HEAD_GYRO \
+                                    | BMI160_FIFO_HEAD_ACCEL)
+
+// bus read of any length, for bmi160_bus_read() and the bosch FIFO
+// burst reads
+static s8 bmi160_bus_burst_read(u8 dev_addr, u8 reg_addr, u8 *reg_data,
+                                u32 cnt)
 {
     if (isSPI)
     {
@@ -74,7 +90,7 @@ s8 bmi160_bus_read(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
         bmi160_cs_off();
 
       // now copy it into user buffer
-        int i;
+        u32 i;
         for (i=0; i<cnt; i++)
             reg_data[i] = sbuf[i + 1];
 
@@ -98,6 +114,12 @@ s8 bmi160_bus_read(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
     return 0;
 }
 
+// i2c bus read and write functions for use with the bmi driver code
+s8 bmi160_bus_read(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
+{
+    return bmi160_bus_burst_read(dev_addr, reg_addr, reg_data, cnt);
+}
+
 s8 bmi160_bus_write(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt)
 {
     if (isSPI)
@@ -249,6 +271,7 @@ bmi160_context bmi160_init(unsigned int bus, int address, int cs_pin,
     // init the driver interface functions
     s_bmi160.bus_write = bmi160_bus_write;
     s_bmi160.bus_read = bmi160_bus_read;
+    s_bmi160.burst_read = bmi160_bus_burst_read;
     s_bmi160.delay_msec = bmi160_delay_ms;
     if (isSPI)
         s_bmi160.dev_addr = 0;
@@ -321,6 +344,9 @@ void bmi160_close(bmi160_context dev)
 {
     assert(dev != NULL);
 
+    bmi160_uninstall_isr(dev, BMI160_INTERRUPT_INT1);
+    bmi160_uninstall_isr(dev, BMI160_INTERRUPT_INT2);
+
     if (i2cContext)
         mraa_i2c_stop(i2cContext);
     i2cContext = NULL;
@@ -573,3 +599,379 @@ unsigned int bmi160_get_time(const bmi160_context dev)
 
     return dev->sensorTime;
 }
+
+// time between frames, in sensor time ticks, for an output data rate
+// setting.  The rate is 100Hz at setting 8 (256 ticks), doubling with
+// each setting above that.
+static unsigned int _odr_ticks(u8 odr)
+{
+    if (odr < 1 || odr > 13)
+        return 0;
+
+    return 1 << (16 - odr);
+}
+
+upm_result_t bmi160_enable_fifo(const bmi160_context dev, bool enable)
+{
+    assert(dev != NULL);
+
+    u8 v_enable = (enable) ? BMI160_ENABLE : BMI160_DISABLE;
+    u8 v_mag = (enable && dev->magEnabled) ? BMI160_ENABLE : BMI160_DISABLE;
+
+    if (bmi160_set_fifo_header_enable(v_enable)
+        || bmi160_set_fifo_time_enable(v_enable)
+        || bmi160_set_fifo_accel_enable(v_enable)
+        || bmi160_set_fifo_gyro_enable(v_enable)
+        || bmi160_set_fifo_mag_enable(v_mag))
+    {
+        printf("%s: failed to set the FIFO configuration.\n", __FUNCTION__);
+        return UPM_ERROR_OPERATION_FAILED;
+    }
+    bmi160_delay_ms(BMI160_GEN_READ_WRITE_DELAY);
+
+    dev->fifoEnabled = enable;
+    dev->fifoSampleCount = 0;
+    dev->fifoSampleIndex = 0;
+    memset((void *)&dev->fifoLast, 0, sizeof(BMI160_FIFO_SAMPLE_T));
+
+    if (!enable)
+        return UPM_SUCCESS;
+
+    // frames are stored at the fastest output data rate
+    u8 odr = 0;
+    unsigned int ticks;
+
+    dev->fifoPeriod = 0;
+
+    if (bmi160_get_accel_output_data_rate(&odr))
+        return UPM_ERROR_OPERATION_FAILED;
+    dev->fifoPeriod = _odr_ticks(odr);
+
+    if (bmi160_get_gyro_output_data_rate(&odr))
+        return UPM_ERROR_OPERATION_FAILED;
+    ticks = _odr_ticks(odr);
+    if (ticks && (!dev->fifoPeriod || ticks < dev->fifoPeriod))
+        dev->fifoPeriod = ticks;
+
+    if (dev->magEnabled)
+    {
+        if (bmi160_get_mag_output_data_rate(&odr))
+            return UPM_ERROR_OPERATION_FAILED;
+        ticks = _odr_ticks(odr);
+        if (ticks && (!dev->fifoPeriod || ticks < dev->fifoPeriod))
+            dev->fifoPeriod = ticks;
+    }
+
+    // start with an empty FIFO
+    if (bmi160_set_command_register(BMI160_CMD_FIFO_FLUSH))
+        return UPM_ERROR_OPERATION_FAILED;
+    bmi160_delay_ms(BMI160_GEN_READ_WRITE_DELAY);
+
+    return UPM_SUCCESS;
+}
+
+upm_result_t bmi160_set_fifo_watermark(const bmi160_context dev, int bytes)
+{
+    assert(dev != NULL);
+
+    // the watermark is in units of 4 bytes
+    if (bytes < 0)
+        bytes = 0;
+    if (bytes > 1020)
+        bytes = 1020;
+
+    if (bmi160_set_fifo_wm((u8)(bytes / 4)))
+        return UPM_ERROR_OPERATION_FAILED;
+    bmi160_delay_ms(BMI160_GEN_READ_WRITE_DELAY);
+
+    return UPM_SUCCESS;
+}
+
+upm_result_t bmi160_enable_fifo_interrupt(const bmi160_context dev,
+                                          BMI160_INTERRUPT_PINS_T intr,
+                                          bool enable)
+{
+    assert(dev != NULL);
+
+    u8 v_enable = (enable) ? BMI160_ENABLE : BMI160_DISABLE;
+    u8 channel = (intr == BMI160_INTERRUPT_INT1)
+        ? BMI160_INTR1_MAP_FIFO_WM : BMI160_INTR2_MAP_FIFO_WM;
+
+    if (bmi160_set_intr_fifo_wm(channel, v_enable)
+        || bmi160_set_intr_enable_1(BMI160_FIFO_WM_ENABLE, v_enable))
+        return UPM_ERROR_OPERATION_FAILED;
+
+    if (enable)
+    {
+        // active high push-pull output, level triggered.  The
+        // BMI160_INTRn_* channel numbers all match.
+        if (bmi160_set_intr_output_type(channel, BMI160_DISABLE)
+            || bmi160_set_intr_level(channel, BMI160_ENABLE)
+            || bmi160_set_intr_edge_ctrl(channel, BMI160_DISABLE)
+            || bmi160_set_output_enable(channel, BMI160_ENABLE))
+            return UPM_ERROR_OPERATION_FAILED;
+    }
+    bmi160_delay_ms(BMI160_GEN_READ_WRITE_DELAY);
+
+    return UPM_SUCCESS;
+}
+
+// store a new sample decoded from a regular FIFO frame
+static void _fifo_decode_frame(const bmi160_context dev, u8 head,
+                               const u8 *data)
+{
+    BMI160_FIFO_SAMPLE_T *sample = &dev->fifoLast;
+
+    sample->sensors = 0;
+
+    // the payload holds the mag, gyro and then the accel data of
+    // the sensors present in the header
+    if (head & BMI160_FIFO_HEAD_MAG)
+    {
+        // the raw BMM150 data, as bmi160_read_mag_xyzr() decodes it
+        s16 x = (s16)((((s32)((s8)data[1])) << 5)
+                      | BMI160_GET_BITSLICE(data[0],
+                                            BMI160_USER_DATA_MAG_X_LSB));
+        s16 y = (s16)((((s32)((s8)data[3])) << 5)
+                      | BMI160_GET_BITSLICE(data[2],
+                                            BMI160_USER_DATA_MAG_Y_LSB));
+        s16 z = (s16)((((s32)((s8)data[5])) << 7)
+                      | BMI160_GET_BITSLICE(data[4],
+                                            BMI160_USER_DATA_MAG_Z_LSB));
+        u16 r = (u16)((((s32)((s8)data[7])) << 6)
+                      | BMI160_GET_BITSLICE(data[6],
+                                            BMI160_USER_DATA_MAG_R_LSB));
+
+        sample->mag[0] = (float)bmi160_bmm150_mag_compensate_X(x, r);
+        sample->mag[1] = (float)bmi160_bmm150_mag_compensate_Y(y, r);
+        sample->mag[2] = (float)bmi160_bmm150_mag_compensate_Z(z, r);
+
+        sample->sensors |= BMI160_FIFO_SENSOR_MAG;
+        data += BMI160_FIFO_M_LENGTH;
+    }
+
+    if (head & BMI160_FIFO_HEAD_GYRO)
+    {
+        for (int i=0; i<3; i++)
+            sample->gyro[i] =
+                (float)(s16)(data[i * 2] | (data[i * 2 + 1] << 8))
+                / dev->gyroScale;
+
+        sample->sensors |= BMI160_FIFO_SENSOR_GYRO;
+        data += BMI160_FIFO_G_LENGTH;
+    }
+
+    if (head & BMI160_FIFO_HEAD_ACCEL)
+    {
+        for (int i=0; i<3; i++)
+            sample->accel[i] =
+                (float)(s16)(data[i * 2] | (data[i * 2 + 1] << 8))
+                / dev->accelScale;
+
+        sample->sensors |= BMI160_FIFO_SENSOR_ACCEL;
+    }
+
+    if (dev->fifoSampleCount < BMI160_FIFO_MAX_SAMPLES)
+        dev->fifoSamples[dev->fifoSampleCount++] = *sample;
+}
+
+// read the whole FIFO, and decode it into dev->fifoSamples
+static upm_result_t _fifo_fetch(const bmi160_context dev)
+{
+    u32 fifoLen = 0;
+
+    dev->fifoSampleCount = 0;
+    dev->fifoSampleIndex = 0;
+
+    if (bmi160_fifo_length(&fifoLen))
+        return UPM_ERROR_OPERATION_FAILED;
+
+    if (!fifoLen)
+        return UPM_SUCCESS;
+
+    if (fifoLen > BMI160_FIFO_SIZE)
+        fifoLen = BMI160_FIFO_SIZE;
+
+    // read past the last frame, to get the sensor time frame that
+    // follows it
+    u16 len = fifoLen + BMI160_FIFO_INDEX_LENGTH
+        + BMI160_FIFO_SENSOR_TIME_LENGTH;
+    u8 buf[BMI160_FIFO_SIZE + BMI160_FIFO_INDEX_LENGTH
+           + BMI160_FIFO_SENSOR_TIME_LENGTH];
+
+    if (bmi160_fifo_data(buf, len))
+    {
+        printf("%s: bmi160_fifo_data() failed.\n", __FUNCTION__);
+        return UPM_ERROR_OPERATION_FAILED;
+    }
+
+    bool haveTime = false;
+    u32 sensorTime = 0;
+    u16 index = 0;
+
+    while (index < len)
+    {
+        // mask off the interrupt tags
+        u8 head = buf[index] & BMI160_FIFO_TAG_INTR_MASK;
+        u16 payload = 0;
+        bool regular = false;
+
+        if ((head & BMI160_FIFO_HEAD_MODE_MASK) == BMI160_FIFO_HEAD_REGULAR
+            && (head & BMI160_FIFO_HEAD_SENSORS))
+        {
+            regular = true;
+            if (head & BMI160_FIFO_HEAD_MAG)
+                payload += BMI160_FIFO_M_LENGTH;
+            if (head & BMI160_FIFO_HEAD_GYRO)
+                payload += BMI160_FIFO_G_LENGTH;
+            if (head & BMI160_FIFO_HEAD_ACCEL)
+                payload += BMI160_FIFO_A_LENGTH;
+        }
+        else if (head == FIFO_HEAD_SKIP_FRAME
+                 || head == FIFO_HEAD_INPUT_CONFIG)
+            payload = BMI160_FIFO_INDEX_LENGTH;
+        else if (head == FIFO_HEAD_SENSOR_TIME)
+            payload = BMI160_FIFO_SENSOR_TIME_LENGTH;
+        else
+            break;              // over read, the FIFO is empty
+
+        // a frame that was only partly read is read again next time
+        if (index + BMI160_FIFO_INDEX_LENGTH + payload > len)
+            break;
+
+        const u8 *data = &buf[index + BMI160_FIFO_INDEX_LENGTH];
+
+        if (regular)
+            _fifo_decode_frame(dev, head, data);
+        else if (head == FIFO_HEAD_SKIP_FRAME)
+            dev->fifoSkipped += data[0];
+        else if (head == FIFO_HEAD_SENSOR_TIME)
+        {
+            sensorTime = (u32)data[BMI160_FIFO_SENSOR_TIME_LSB]
+                | ((u32)data[BMI160_FIFO_SENSOR_TIME_XLSB] << 8)
+                | ((u32)data[BMI160_FIFO_SENSOR_TIME_MSB] << 16);
+            haveTime = true;
+        }
+
+        index += BMI160_FIFO_INDEX_LENGTH + payload;
+    }
+
+    // without a sensor time frame (a frame arrived while reading),
+    // fall back to the current sensor time
+    if (!haveTime && bmi160_get_sensor_time(&sensorTime))
+        return UPM_ERROR_OPERATION_FAILED;
+
+    // the newest frame was taken at the sensor time
+    int count = dev->fifoSampleCount;
+    for (int i=0; i<count; i++)
+        dev->fifoSamples[i].sensorTime =
+            (sensorTime - (count - 1 - i) * dev->fifoPeriod) & 0xffffff;
+
+    return UPM_SUCCESS;
+}
+
+int bmi160_read_fifo(const bmi160_context dev,
+                     BMI160_FIFO_SAMPLE_T *samples, int max_samples)
+{
+    assert(dev != NULL);
+    assert(samples != NULL);
+
+    if (!dev->fifoEnabled)
+        return -1;
+
+    // read the FIFO again once every sample decoded has been returned
+    if (dev->fifoSampleIndex >= dev->fifoSampleCount)
+    {
+        if (_fifo_fetch(dev))
+            return -1;
+    }
+
+    int num = dev->fifoSampleCount - dev->fifoSampleIndex;
+    if (num > max_samples)
+        num = max_samples;
+    if (num < 0)
+        num = 0;
+
+    memcpy((void *)samples,
+           (void *)&dev->fifoSamples[dev->fifoSampleIndex],
+           num * sizeof(BMI160_FIFO_SAMPLE_T));
+    dev->fifoSampleIndex += num;
+
+    return num;
+}
+
+unsigned int bmi160_get_fifo_skipped(const bmi160_context dev)
+{
+    assert(dev != NULL);
+
+    return dev->fifoSkipped;
+}
+
+upm_result_t bmi160_install_isr(const bmi160_context dev,
+                                BMI160_INTERRUPT_PINS_T intr, int gpio,
+                                mraa_gpio_edge_t level,
+                                void (*isr)(void *), void *arg)
+{
+    assert(dev != NULL);
+
+    // delete any existing ISR and GPIO context for this interrupt
+    bmi160_uninstall_isr(dev, intr);
+
+    mraa_gpio_context gpio_isr = NULL;
+
+    // create gpio context
+    if (!(gpio_isr = mraa_gpio_init(gpio)))
+    {
+        printf("%s: mraa_gpio_init() failed.\n", __FUNCTION__);
+        return UPM_ERROR_OPERATION_FAILED;
+    }
+
+    mraa_gpio_dir(gpio_isr, MRAA_GPIO_IN);
+
+    if (mraa_gpio_isr(gpio_isr, level, isr, arg))
+    {
+        mraa_gpio_close(gpio_isr);
+        printf("%s: mraa_gpio_isr() failed.\n", __FUNCTION__);
+        return UPM_ERROR_OPERATION_FAILED;
+    }
+
+    switch (intr)
+    {
+    case BMI160_INTERRUPT_INT1:
+        dev->gpio1 = gpio_isr;
+        break;
+
+    case BMI160_INTERRUPT_INT2:
+        dev->gpio2 = gpio_isr;
+        break;
+    }
+
+    return UPM_SUCCESS;
+}
+
+void bmi160_uninstall_isr(const bmi160_context dev,
+                          BMI160_INTERRUPT_PINS_T intr)
+{
+    assert(dev != NULL);
+
+    switch (intr)
+    {
+    case BMI160_INTERRUPT_INT1:
+        if (dev->gpio1)
+        {
+            mraa_gpio_isr_exit(dev->gpio1);
+            mraa_gpio_close(dev->gpio1);
+            dev->gpio1 = NULL;
+        }
+        break;
+
+    case BMI160_INTERRUPT_INT2:
+        if (dev->gpio2)
+        {
+            mraa_gpio_isr_exit(dev->gpio2);
+            mraa_gpio_close(dev->gpio2);
+            dev->gpio2 = NULL;
+        }
+        break;
+    }
+}
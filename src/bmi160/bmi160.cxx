@@ -107,6 +107,57 @@ unsigned int BMI160::getSensorTime()
     return bmi160_get_time(m_bmi160);
 }
 
+void BMI160::enableFIFO(bool enable)
+{
+    if (bmi160_enable_fifo(m_bmi160, enable))
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": bmi160_enable_fifo() failed");
+}
+
+void BMI160::setFIFOWatermark(int bytes)
+{
+    if (bmi160_set_fifo_watermark(m_bmi160, bytes))
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": bmi160_set_fifo_watermark() failed");
+}
+
+void BMI160::enableFIFOInterrupt(BMI160_INTERRUPT_PINS_T intr, bool enable)
+{
+    if (bmi160_enable_fifo_interrupt(m_bmi160, intr, enable))
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": bmi160_enable_fifo_interrupt() failed");
+}
+
+int BMI160::readFIFO(BMI160_FIFO_SAMPLE_T *samples, int maxSamples)
+{
+    int rv = bmi160_read_fifo(m_bmi160, samples, maxSamples);
+    if (rv < 0)
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": bmi160_read_fifo() failed");
+
+    return rv;
+}
+
+unsigned int BMI160::getFIFOSkipped()
+{
+    return bmi160_get_fifo_skipped(m_bmi160);
+}
+
+void BMI160::installISR(BMI160_INTERRUPT_PINS_T intr, int gpio,
+                        mraa::Edge level,
+                        void (*isr)(void *), void *arg)
+{
+    if (bmi160_install_isr(m_bmi160, intr, gpio,
+                           (mraa_gpio_edge_t)level, isr, arg))
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": bmi160_install_isr() failed");
+}
+
+void BMI160::uninstallISR(BMI160_INTERRUPT_PINS_T intr)
+{
+    bmi160_uninstall_isr(m_bmi160, intr);
+}
+
 string BMI160::busRead(int addr, int reg, int len)
 {
     u8 dev_addr = (u8)(addr & 0xff);
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <upm.h>
+#include <mraa/gpio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -73,6 +74,24 @@ extern "C" {
         // is the magnetometer enabled?
         bool magEnabled;
 
+        // interrupt pins
+        mraa_gpio_context gpio1;
+        mraa_gpio_context gpio2;
+
+        // is FIFO streaming enabled?
+        bool fifoEnabled;
+        // time between FIFO frames, in sensor time ticks
+        unsigned int fifoPeriod;
+        // number of frames the device dropped because the FIFO was full
+        unsigned int fifoSkipped;
+
+        // samples decoded from the FIFO, but not returned yet
+        BMI160_FIFO_SAMPLE_T fifoSamples[BMI160_FIFO_MAX_SAMPLES];
+        int fifoSampleCount;
+        int fifoSampleIndex;
+        // the latest sample decoded, for holding values
+        BMI160_FIFO_SAMPLE_T fifoLast;
+
     } *bmi160_context;
 
     /**
@@ -184,6 +203,110 @@ extern "C" {
      */
     unsigned int bmi160_get_time(const bmi160_context dev);
 
+    /**
+     * Enable or disable FIFO streaming.  When enabled, the FIFO is
+     * set to header mode, storing the accelerometer, the gyroscope,
+     * the magnetometer (if enabled) and the sensor time, and then
+     * flushed.  Samples are then read with bmi160_read_fifo().
+     *
+     * The output data rates are read when the FIFO is enabled, to
+     * compute sample times, so call this again if they are changed.
+     *
+     * @param dev Device context.
+     * @param enable true to enable FIFO streaming, false to disable.
+     * @return UPM result.
+     */
+    upm_result_t bmi160_enable_fifo(const bmi160_context dev, bool enable);
+
+    /**
+     * Set the FIFO watermark.  When the FIFO holds at least this many
+     * bytes, the FIFO watermark interrupt (if enabled with
+     * bmi160_enable_fifo_interrupt()) is raised.  The watermark is
+     * set in multiples of 4 bytes.
+     *
+     * With the accelerometer and gyroscope stored, a FIFO frame is
+     * 13 bytes, 21 when the magnetometer has new data.
+     *
+     * @param dev Device context.
+     * @param bytes The watermark, from 0 to 1020 bytes.
+     * @return UPM result.
+     */
+    upm_result_t bmi160_set_fifo_watermark(const bmi160_context dev,
+                                           int bytes);
+
+    /**
+     * Enable or disable the FIFO watermark interrupt, and route it to
+     * an interrupt pin.  The pin is configured as an active high,
+     * push-pull output, so install the ISR with
+     * MRAA_GPIO_EDGE_RISING.
+     *
+     * @param dev Device context.
+     * @param intr One of the BMI160_INTERRUPT_PINS_T values.
+     * @param enable true to enable the interrupt, false to disable.
+     * @return UPM result.
+     */
+    upm_result_t bmi160_enable_fifo_interrupt(const bmi160_context dev,
+                                              BMI160_INTERRUPT_PINS_T intr,
+                                              bool enable);
+
+    /**
+     * Read samples from the FIFO, oldest first.  The whole FIFO is
+     * read in a single burst and decoded, including the skip and
+     * sensor time frames, and the decoded samples are returned over
+     * as many calls as needed before the FIFO is read again.
+     * bmi160_enable_fifo() must have been called first.
+     *
+     * Sample times are reconstructed from the sensor time frame
+     * following the newest frame, and the fastest output data rate of
+     * the sensors stored.
+     *
+     * @param dev Device context.
+     * @param samples The array to store the samples in.
+     * @param max_samples The maximum number of samples to return.
+     * BMI160_FIFO_MAX_SAMPLES samples always hold all of a full FIFO.
+     * @return The number of samples returned, or -1 on error.
+     */
+    int bmi160_read_fifo(const bmi160_context dev,
+                         BMI160_FIFO_SAMPLE_T *samples, int max_samples);
+
+    /**
+     * Return the number of frames the device dropped because the FIFO
+     * was full, as reported by skip frames.
+     *
+     * @param dev Device context.
+     * @return The number of frames dropped.
+     */
+    unsigned int bmi160_get_fifo_skipped(const bmi160_context dev);
+
+    /**
+     * Install an interrupt handler.
+     *
+     * @param dev Device context.
+     * @param intr One of the BMI160_INTERRUPT_PINS_T values
+     * specifying which interrupt pin you are installing.
+     * @param gpio GPIO pin to use as interrupt pin.
+     * @param level The interrupt trigger level (one of the
+     * mraa_gpio_edge_t values).  Make sure that you have configured
+     * the interrupt pin properly for whatever level you choose.
+     * @param isr The interrupt handler, accepting a void * argument.
+     * @param arg The argument to pass the the interrupt handler.
+     * @return UPM result.
+     */
+    upm_result_t bmi160_install_isr(const bmi160_context dev,
+                                    BMI160_INTERRUPT_PINS_T intr, int gpio,
+                                    mraa_gpio_edge_t level,
+                                    void (*isr)(void *), void *arg);
+
+    /**
+     * Uninstall a previously installed interrupt handler.
+     *
+     * @param dev Device context.
+     * @param intr One of the BMI160_INTERRUPT_PINS_T values,
+     * specifying which interrupt pin you are removing.
+     */
+    void bmi160_uninstall_isr(const bmi160_context dev,
+                              BMI160_INTERRUPT_PINS_T intr);
+
     /**
      * Perform a bus read.  This function is bus agnostic, and is used
      * by the bosch code to perform bus reads.  It is exposed here for
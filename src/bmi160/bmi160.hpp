@@ -10,6 +10,7 @@
  */
 #pragma once
 #include <string>
+#include <mraa/gpio.hpp>
 #include "bmi160.h"
 
 #include <interfaces/iAcceleration.hpp>
@@ -61,7 +62,12 @@ namespace upm {
      * makes it possible to support whatever features are required that
      * the driver can support.
      *
+     * Samples can also be streamed through the FIFO in header mode,
+     * see enableFIFO() and readFIFO(), optionally driven by the FIFO
+     * watermark interrupt.
+     *
      * @snippet bmi160.cxx Interesting
+     * @snippet bmi160-fifo.cxx Interesting
      */
     class BMI160: virtual public iAcceleration, virtual public iGyroscope, public virtual iMagnetometer {
     public:
@@ -207,6 +213,89 @@ namespace upm {
          */
         unsigned int getSensorTime();
 
+        /**
+         * Enable or disable FIFO streaming.  When enabled, the FIFO is
+         * set to header mode, storing the accelerometer, the
+         * gyroscope, the magnetometer (if enabled) and the sensor
+         * time, and then flushed.  Samples are then read with
+         * readFIFO().  Call this again if the output data rates are
+         * changed.
+         *
+         * @param enable true to enable FIFO streaming, false to disable.
+         * @throws std::runtime_error on failure.
+         */
+        void enableFIFO(bool enable);
+
+        /**
+         * Set the FIFO watermark, in bytes (multiples of 4, up to
+         * 1020).  A FIFO frame is 13 bytes with the accelerometer and
+         * gyroscope stored, 21 when the magnetometer has new data.
+         *
+         * @param bytes The watermark.
+         * @throws std::runtime_error on failure.
+         */
+        void setFIFOWatermark(int bytes);
+
+        /**
+         * Enable or disable the FIFO watermark interrupt on an
+         * interrupt pin, configured as an active high push-pull
+         * output.  Install the ISR with mraa::EDGE_RISING.
+         *
+         * @param intr One of the BMI160_INTERRUPT_PINS_T values.
+         * @param enable true to enable the interrupt, false to disable.
+         * @throws std::runtime_error on failure.
+         */
+        void enableFIFOInterrupt(BMI160_INTERRUPT_PINS_T intr, bool enable);
+
+        /**
+         * Read samples from the FIFO, oldest first.  The whole FIFO is
+         * read in a single burst and decoded, and the samples are
+         * returned over as many calls as needed before the FIFO is
+         * read again.  Sample times are in sensor time ticks.
+         *
+         * @param samples The array to store the samples in.
+         * @param maxSamples The maximum number of samples to return.
+         * BMI160_FIFO_MAX_SAMPLES samples always hold all of a full
+         * FIFO.
+         * @return The number of samples returned.
+         * @throws std::runtime_error on failure, or if FIFO streaming
+         * is not enabled.
+         */
+        int readFIFO(BMI160_FIFO_SAMPLE_T *samples, int maxSamples);
+
+        /**
+         * Return the number of frames the device dropped because the
+         * FIFO was full.
+         *
+         * @return The number of frames dropped.
+         */
+        unsigned int getFIFOSkipped();
+
+        /**
+         * install an interrupt handler.
+         *
+         * @param intr One of the BMI160_INTERRUPT_PINS_T values
+         * specifying which interrupt pin you are installing.
+         * @param gpio GPIO pin to use as interrupt pin.
+         * @param level The interrupt trigger level (one of mraa::Edge
+         * values).  Make sure that you have configured the interrupt pin
+         * properly for whatever level you choose.
+         * @param isr The interrupt handler, accepting a void * argument.
+         * @param arg The argument to pass the the interrupt handler.
+         * @throws std::runtime_error on failure.
+         */
+        void installISR(BMI160_INTERRUPT_PINS_T intr, int gpio,
+                        mraa::Edge level,
+                        void (*isr)(void *), void *arg);
+
+        /**
+         * uninstall a previously installed interrupt handler
+         *
+         * @param intr One of the BMI160_INTERRUPT_PINS_T values
+         * specifying which interrupt pin you are removing.
+         */
+        void uninstallISR(BMI160_INTERRUPT_PINS_T intr);
+
     protected:
         bmi160_context m_bmi160;
 
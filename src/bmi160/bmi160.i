@@ -27,6 +27,7 @@
 %ignore getAccelerometer(float *, float *, float *);
 %ignore getGyroscope(float *, float *, float *);
 %ignore getMagnetometer(float *, float *, float *);
+%ignore installISR (BMI160_INTERRUPT_PINS_T, int, mraa::Edge , void *, void *);
 
 %typemap(javaimports) SWIGTYPE %{
 import upm_interfaces.*;
@@ -35,6 +36,10 @@ import java.util.AbstractList;
 import java.lang.Float;
 %}
 
+%define INTERRUPT BMI160_INTERRUPT_PINS_T
+%enddef
+
+JAVA_ADD_INSTALLISR_INTERRUPT(upm::BMI160)
 JAVA_JNI_LOADLIBRARY(javaupm_bmi160)
 #endif
 /* END Java syntax */
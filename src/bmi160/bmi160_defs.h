@@ -12,6 +12,8 @@
  */
 #pragma once
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -33,6 +35,44 @@ extern "C" {
         BMI160_GYRO_RANGE_2000
     } BMI160_GYRO_RANGE_T;
 
+    // interrupt selection for install_isr() and uninstall_isr()
+    typedef enum {
+        BMI160_INTERRUPT_INT1,
+        BMI160_INTERRUPT_INT2
+    } BMI160_INTERRUPT_PINS_T;
+
+    // FIFO size in bytes
+#define BMI160_FIFO_SIZE 1024
+
+    // maximum number of samples in a full FIFO, when only the
+    // accelerometer or the gyroscope is stored (7 byte frames)
+#define BMI160_FIFO_MAX_SAMPLES (BMI160_FIFO_SIZE / 7)
+
+    // sensors with new data in a FIFO sample
+    typedef enum {
+        BMI160_FIFO_SENSOR_ACCEL                   = 0x01,
+        BMI160_FIFO_SENSOR_GYRO                    = 0x02,
+        BMI160_FIFO_SENSOR_MAG                     = 0x04
+    } BMI160_FIFO_SENSOR_T;
+
+    // a sample read from the FIFO by bmi160_read_fifo()
+    typedef struct {
+        // sensor time at which the sample was taken (24 bits, 39.0625us
+        // per tick)
+        unsigned int sensorTime;
+
+        // bitmask of BMI160_FIFO_SENSOR_T values.  Sensors without new
+        // data in this sample hold their previous values.
+        uint8_t sensors;
+
+        // gravities
+        float accel[3];
+        // degrees per second
+        float gyro[3];
+        // micro Teslas, 0 if the magnetometer is disabled
+        float mag[3];
+    } BMI160_FIFO_SAMPLE_T;
+
 #ifdef __cplusplus
 }
 #endif
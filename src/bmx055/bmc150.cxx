@@ -176,3 +176,45 @@ std::vector<float> BMC150::getMagnetometer()
     else
         return {0, 0, 0};
 }
+
+int BMC150::readFIFO(FIFO_SAMPLE_T *samples, int maxSamples)
+{
+    if (!m_accel || maxSamples <= 0)
+        return 0;
+
+    int len = (maxSamples < BMA250E_FIFO_FRAMES)
+        ? maxSamples : BMA250E_FIFO_FRAMES;
+    BMA250E_FIFO_FRAME_T frames[BMA250E_FIFO_FRAMES];
+
+    int num = m_accel->readFIFO(frames, len);
+
+    float x = 0, y = 0, z = 0;
+    if (m_mag && num > 0)
+    {
+        m_mag->update();
+        m_mag->getMagnetometer(&x, &y, &z);
+    }
+
+    for (int i=0; i<num; i++)
+    {
+        samples[i].timestamp = frames[i].timestamp;
+
+        samples[i].accel[0] = frames[i].x;
+        samples[i].accel[1] = frames[i].y;
+        samples[i].accel[2] = frames[i].z;
+
+        samples[i].mag[0] = x;
+        samples[i].mag[1] = y;
+        samples[i].mag[2] = z;
+    }
+
+    return num;
+}
+
+void BMC150::enableFIFOStream(bool enable)
+{
+    if (m_accel)
+        m_accel->fifoConfig((enable) ? BMA250E_FIFO_MODE_STREAM
+                            : BMA250E_FIFO_MODE_BYPASS,
+                            BMA250E_FIFO_DATA_SEL_XYZ);
+}
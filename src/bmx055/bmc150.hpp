@@ -62,6 +62,18 @@ namespace upm {
 
     class BMC150: virtual public iAcceleration, virtual public iMagnetometer {
     public:
+        /**
+         * A sample returned by readFIFO()
+         */
+        typedef struct {
+            // microseconds, on the monotonic clock
+            uint64_t timestamp;
+            // gravities
+            float accel[3];
+            // micro-Teslas
+            float mag[3];
+        } FIFO_SAMPLE_T;
+
         /**
          * BMC150 constructor.
          *
@@ -191,6 +203,31 @@ namespace upm {
          */
         std::vector<float> getMagnetometer();
 
+        /**
+         * Drain the accelerometer FIFO, and return a sample for each
+         * frame, oldest first.  Call enableFIFOStream() first.  The
+         * magnetometer has no FIFO, so it is read once per call, and
+         * that reading is used for every sample.
+         *
+         * @param samples The array to store the samples in.
+         * @param maxSamples The maximum number of samples to return.
+         * The accelerometer FIFO holds up to BMA250E_FIFO_FRAMES
+         * frames.
+         * @return The number of samples returned.
+         * @throws std::runtime_error on failure.
+         */
+        int readFIFO(FIFO_SAMPLE_T *samples, int maxSamples);
+
+        /**
+         * Switch the accelerometer FIFO between stream mode, for
+         * readFIFO(), and the bypass mode set by initAccelerometer().
+         * All three axes are stored.
+         *
+         * @param enable True to select stream mode, false for bypass
+         * mode.
+         * @throws std::runtime_error on failure.
+         */
+        void enableFIFOStream(bool enable);
 
     protected:
         BMA250E *m_accel;
@@ -17,6 +17,7 @@
 #include <string>
 
 #include "bmi055.hpp"
+#include "bmx055_fifo.hpp"
 #include "upm_string_parser.hpp"
 
 using namespace upm;
@@ -24,7 +25,7 @@ using namespace std;
 
 BMI055::BMI055(int accelBus, int accelAddr, int accelCS,
                int gyroBus, int gyroAddr, int gyroCS) :
-    m_accel(0), m_gyro(0)
+    m_accel(0), m_gyro(0), m_accelHeld(), m_gyroHeld()
 {
     // if -1 is supplied as a bus for any of these, we will not
     // instantiate them
@@ -43,7 +44,8 @@ BMI055::BMI055(int accelBus, int accelAddr, int accelCS,
         m_gyro->init();
 }
 
-BMI055::BMI055(std::string initStr) : m_accel(0), m_gyro(0)
+BMI055::BMI055(std::string initStr) : m_accel(0), m_gyro(0),
+                                      m_accelHeld(), m_gyroHeld()
 {
     int accelBus = BMA250E_DEFAULT_I2C_BUS;
     int accelAddr = BMA250E_DEFAULT_ADDR;
@@ -183,3 +185,31 @@ std::vector<float> BMI055::getGyroscope()
     else
         return {0, 0, 0};
 }
+
+int BMI055::readFIFO(FIFO_SAMPLE_T *samples, int maxSamples)
+{
+    bmxDrainFIFO(m_accel, BMA250E_FIFO_FRAMES, m_accelFrames);
+    bmxDrainFIFO(m_gyro, BMG160_FIFO_FRAMES, m_gyroFrames);
+
+    int num = bmxMergeFIFO(m_accelFrames, m_gyroFrames,
+                           m_accelHeld, m_gyroHeld,
+                           samples, maxSamples);
+
+    return num;
+}
+
+void BMI055::enableFIFOStream(bool enable)
+{
+    if (m_accel)
+        m_accel->fifoConfig((enable) ? BMA250E_FIFO_MODE_STREAM
+                            : BMA250E_FIFO_MODE_BYPASS,
+                            BMA250E_FIFO_DATA_SEL_XYZ);
+
+    if (m_gyro)
+        m_gyro->fifoConfig((enable) ? BMG160_FIFO_MODE_STREAM
+                           : BMG160_FIFO_MODE_BYPASS,
+                           BMG160_FIFO_DATA_SEL_XYZ);
+
+    m_accelFrames.clear();
+    m_gyroFrames.clear();
+}
@@ -12,6 +12,7 @@
  */
 #pragma once
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -56,6 +57,18 @@ namespace upm {
 
     class BMI055: virtual public iAcceleration, virtual public iGyroscope {
     public:
+        /**
+         * A synchronized sample returned by readFIFO()
+         */
+        typedef struct {
+            // microseconds, on the monotonic clock
+            uint64_t timestamp;
+            // gravities
+            float accel[3];
+            // degrees per second
+            float gyro[3];
+        } FIFO_SAMPLE_T;
+
         /**
          * BMI055 constructor.
          *
@@ -189,11 +202,46 @@ namespace upm {
          */
         std::vector<float> getGyroscope();
 
+        /**
+         * Drain the accelerometer and gyroscope FIFOs, and return
+         * their frames as synchronized samples, oldest first.  Call
+         * enableFIFOStream() first.
+         *
+         * The device producing the most frames sets the time base:
+         * there is a sample for each of its frames, holding the
+         * latest frame of the other device sampled at or before it.
+         * Frames not returned yet are kept for the next call.
+         *
+         * @param samples The array to store the samples in.
+         * @param maxSamples The maximum number of samples to return.
+         * @return The number of samples returned.
+         * @throws std::runtime_error on failure.
+         */
+        int readFIFO(FIFO_SAMPLE_T *samples, int maxSamples);
+
+        /**
+         * Switch the accelerometer and gyroscope FIFOs between stream
+         * mode, for readFIFO(), and the bypass mode set by the init
+         * methods.  All three axes are stored.  Frames kept by
+         * readFIFO() are discarded.
+         *
+         * @param enable True to select stream mode, false for bypass
+         * mode.
+         * @throws std::runtime_error on failure.
+         */
+        void enableFIFOStream(bool enable);
 
     protected:
         BMA250E *m_accel;
         BMG160 *m_gyro;
 
+        // FIFO frames not yet returned by readFIFO(), and the latest
+        // ones returned
+        std::deque<BMA250E_FIFO_FRAME_T> m_accelFrames;
+        std::deque<BMG160_FIFO_FRAME_T> m_gyroFrames;
+        BMA250E_FIFO_FRAME_T m_accelHeld;
+        BMG160_FIFO_FRAME_T m_gyroHeld;
+
     private:
         /* Disable implicit copy and assignment operators */
         BMI055(const BMI055&) = delete;
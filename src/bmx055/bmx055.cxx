@@ -17,6 +17,7 @@
 #include <string>
 
 #include "bmx055.hpp"
+#include "bmx055_fifo.hpp"
 #include "upm_string_parser.hpp"
 
 using namespace upm;
@@ -25,7 +26,7 @@ using namespace std;
 BMX055::BMX055(int accelBus, int accelAddr, int accelCS,
                int gyroBus, int gyroAddr, int gyroCS,
                int magBus, int magAddr, int magCS) :
-    m_accel(0), m_gyro(0), m_mag(0)
+    m_accel(0), m_gyro(0), m_mag(0), m_accelHeld(), m_gyroHeld()
 {
     // if -1 is supplied as a bus for any of these, we will not
     // instantiate them
@@ -40,7 +41,8 @@ BMX055::BMX055(int accelBus, int accelAddr, int accelCS,
         m_mag = new BMM150(magBus, magAddr, magCS);
 }
 
-BMX055::BMX055(std::string initStr) :m_accel(0), m_gyro(0), m_mag(0)
+BMX055::BMX055(std::string initStr) :m_accel(0), m_gyro(0), m_mag(0),
+                                      m_accelHeld(), m_gyroHeld()
 {
     int accelBus = BMA250E_DEFAULT_I2C_BUS;
     int accelAddr = BMA250E_DEFAULT_ADDR;
@@ -245,3 +247,45 @@ std::vector<float> BMX055::getMagnetometer()
     else
         return {0, 0, 0};
 }
+
+int BMX055::readFIFO(FIFO_SAMPLE_T *samples, int maxSamples)
+{
+    bmxDrainFIFO(m_accel, BMA250E_FIFO_FRAMES, m_accelFrames);
+    bmxDrainFIFO(m_gyro, BMG160_FIFO_FRAMES, m_gyroFrames);
+
+    int num = bmxMergeFIFO(m_accelFrames, m_gyroFrames,
+                           m_accelHeld, m_gyroHeld,
+                           samples, maxSamples);
+
+    float x = 0, y = 0, z = 0;
+    if (m_mag && num > 0)
+    {
+        m_mag->update();
+        m_mag->getMagnetometer(&x, &y, &z);
+    }
+
+    for (int i=0; i<num; i++)
+    {
+        samples[i].mag[0] = x;
+        samples[i].mag[1] = y;
+        samples[i].mag[2] = z;
+    }
+
+    return num;
+}
+
+void BMX055::enableFIFOStream(bool enable)
+{
+    if (m_accel)
+        m_accel->fifoConfig((enable) ? BMA250E_FIFO_MODE_STREAM
+                            : BMA250E_FIFO_MODE_BYPASS,
+                            BMA250E_FIFO_DATA_SEL_XYZ);
+
+    if (m_gyro)
+        m_gyro->fifoConfig((enable) ? BMG160_FIFO_MODE_STREAM
+                           : BMG160_FIFO_MODE_BYPASS,
+                           BMG160_FIFO_DATA_SEL_XYZ);
+
+    m_accelFrames.clear();
+    m_gyroFrames.clear();
+}
@@ -12,6 +12,7 @@
  */
 #pragma once
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -63,11 +64,29 @@ namespace upm {
    * simply initializes all three devices, and provides a mechanism to
    * read accelerometer, gyroscope and magnetometer data from them.
    *
+   * readFIFO() returns batches of synchronized samples from the
+   * accelerometer and gyroscope FIFOs.
+   *
    * @snippet bmx055.cxx Interesting
+   * @snippet bmx055-fifo.cxx Interesting
    */
 
     class BMX055: virtual public iAcceleration, virtual public iGyroscope, public virtual iMagnetometer {
     public:
+        /**
+         * A synchronized sample returned by readFIFO()
+         */
+        typedef struct {
+            // microseconds, on the monotonic clock
+            uint64_t timestamp;
+            // gravities
+            float accel[3];
+            // degrees per second
+            float gyro[3];
+            // micro-Teslas
+            float mag[3];
+        } FIFO_SAMPLE_T;
+
         /**
          * BMX055 constructor.
          *
@@ -245,11 +264,49 @@ namespace upm {
          */
         std::vector<float> getMagnetometer();
 
+        /**
+         * Drain the accelerometer and gyroscope FIFOs, and return
+         * their frames as synchronized samples, oldest first.  Call
+         * enableFIFOStream() first.
+         *
+         * The device producing the most frames sets the time base:
+         * there is a sample for each of its frames, holding the
+         * latest frame of the other device sampled at or before it.
+         * Frames not returned yet are kept for the next call.  The
+         * magnetometer has no FIFO, so it is read once per call, and
+         * that reading is used for every sample.
+         *
+         * @param samples The array to store the samples in.
+         * @param maxSamples The maximum number of samples to return.
+         * @return The number of samples returned.
+         * @throws std::runtime_error on failure.
+         */
+        int readFIFO(FIFO_SAMPLE_T *samples, int maxSamples);
+
+        /**
+         * Switch the accelerometer and gyroscope FIFOs between stream
+         * mode, for readFIFO(), and the bypass mode set by the init
+         * methods.  All three axes are stored.  Frames kept by
+         * readFIFO() are discarded.
+         *
+         * @param enable True to select stream mode, false for bypass
+         * mode.
+         * @throws std::runtime_error on failure.
+         */
+        void enableFIFOStream(bool enable);
+
     protected:
         BMA250E *m_accel;
         BMG160 *m_gyro;
         BMM150 *m_mag;
 
+        // FIFO frames not yet returned by readFIFO(), and the latest
+        // ones returned
+        std::deque<BMA250E_FIFO_FRAME_T> m_accelFrames;
+        std::deque<BMG160_FIFO_FRAME_T> m_gyroFrames;
+        BMA250E_FIFO_FRAME_T m_accelHeld;
+        BMG160_FIFO_FRAME_T m_gyroHeld;
+
     private:
         /* Disable implicit copy and assignment operators */
         BMX055(const BMX055&) = delete;
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * The MIT License
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+// Internal helper shared by BMX055 and BMI055 for merging the
+// accelerometer and gyroscope FIFOs.  This header is not installed.
+
+#include <deque>
+#include <vector>
+
+#include "bma250e.hpp"
+#include "bmg160.hpp"
+
+namespace upm {
+
+    // Frames kept pending per stream, beyond which the oldest are
+    // dropped.  This only matters if readFIFO() is called with a small
+    // maxSamples for a long time.
+    const size_t BMX055_FIFO_MAX_PENDING = 2 * BMG160_FIFO_FRAMES;
+
+    // Drain a FIFO into pending, in a single burst
+    template <typename DEV, typename FRAME>
+    void bmxDrainFIFO(DEV *dev, int fifoFrames, std::deque<FRAME>& pending)
+    {
+        if (!dev)
+            return;
+
+        std::vector<FRAME> frames(fifoFrames);
+        int num = dev->readFIFO(frames.data(), fifoFrames);
+
+        pending.insert(pending.end(), frames.begin(), frames.begin() + num);
+
+        while (pending.size() > BMX055_FIFO_MAX_PENDING)
+            pending.pop_front();
+    }
+
+    // Merge the pending accelerometer and gyroscope frames into
+    // samples.  The stream with the most pending frames is the time
+    // base, and each of its frames is paired with the latest frame of
+    // the other stream sampled at or before it (held in accelHeld or
+    // gyroHeld).  Frames of the other stream sampled after the last
+    // base frame used are left pending for the next call.
+    template <typename SAMPLE>
+    int bmxMergeFIFO(std::deque<BMA250E_FIFO_FRAME_T>& accelPending,
+                     std::deque<BMG160_FIFO_FRAME_T>& gyroPending,
+                     BMA250E_FIFO_FRAME_T& accelHeld,
+                     BMG160_FIFO_FRAME_T& gyroHeld,
+                     SAMPLE *samples, int maxSamples)
+    {
+        bool accelBase = accelPending.size() > gyroPending.size();
+        int num = 0;
+
+        while (num < maxSamples)
+        {
+            if (accelBase && !accelPending.empty())
+            {
+                accelHeld = accelPending.front();
+                accelPending.pop_front();
+
+                while (!gyroPending.empty()
+                       && gyroPending.front().timestamp <= accelHeld.timestamp)
+                {
+                    gyroHeld = gyroPending.front();
+                    gyroPending.pop_front();
+                }
+
+                samples[num].timestamp = accelHeld.timestamp;
+            }
+            else if (!accelBase && !gyroPending.empty())
+            {
+                gyroHeld = gyroPending.front();
+                gyroPending.pop_front();
+
+                while (!accelPending.empty()
+                       && accelPending.front().timestamp <= gyroHeld.timestamp)
+                {
+                    accelHeld = accelPending.front();
+                    accelPending.pop_front();
+                }
+
+                samples[num].timestamp = gyroHeld.timestamp;
+            }
+            else
+                break;
+
+            samples[num].accel[0] = accelHeld.x;
+            samples[num].accel[1] = accelHeld.y;
+            samples[num].accel[2] = accelHeld.z;
+
+            samples[num].gyro[0] = gyroHeld.x;
+            samples[num].gyro[1] = gyroHeld.y;
+            samples[num].gyro[2] = gyroHeld.z;
+
+            num++;
+        }
+
+        return num;
+    }
+}
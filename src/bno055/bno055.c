@@ -37,80 +37,22 @@ static void _clear_data(const bno055_context dev)
     dev->grvX = dev->grvY = dev->grvZ = 0;
 }
 
-// load fusion data
-static upm_result_t _update_fusion_data(const bno055_context dev)
-{
-    assert(dev != NULL);
-
-    // bail (with success code) if we are in config mode, or aren't in
-    // a fusion mode...
-    if (dev->currentMode == BNO055_OPERATION_MODE_CONFIGMODE ||
-        dev->currentMode < BNO055_OPERATION_MODE_IMU)
-        return UPM_SUCCESS;
-
-    if (bno055_set_page(dev, 0, false))
-        return UPM_ERROR_OPERATION_FAILED;
-
-    // FIXME/MAYBE? - abort early if SYS calibration is == 0?
-
-    const int fusionBytes = 26;
-    uint8_t buf[fusionBytes];
-
-    if (bno055_read_regs(dev, BNO055_REG_EUL_HEADING_LSB, buf, fusionBytes))
-        return UPM_ERROR_OPERATION_FAILED;
-
-    dev->eulHeading = INT16_TO_FLOAT(buf[0], buf[1]);
-    dev->eulRoll    = INT16_TO_FLOAT(buf[2], buf[3]);
-    dev->eulPitch   = INT16_TO_FLOAT(buf[4], buf[5]);
-
-    dev->quaW       = INT16_TO_FLOAT(buf[6], buf[7]);
-    dev->quaX       = INT16_TO_FLOAT(buf[8], buf[9]);
-    dev->quaY       = INT16_TO_FLOAT(buf[10], buf[11]);
-    dev->quaZ       = INT16_TO_FLOAT(buf[12], buf[13]);
-
-    dev->liaX       = INT16_TO_FLOAT(buf[14], buf[15]);
-    dev->liaY       = INT16_TO_FLOAT(buf[16], buf[17]);
-    dev->liaZ       = INT16_TO_FLOAT(buf[18], buf[19]);
-
-    dev->grvX       = INT16_TO_FLOAT(buf[20], buf[21]);
-    dev->grvY       = INT16_TO_FLOAT(buf[22], buf[23]);
-    dev->grvZ       = INT16_TO_FLOAT(buf[24], buf[25]);
-
-    return UPM_SUCCESS;
-}
-
-// update non-fusion data
-static upm_result_t _update_non_fusion_data(const bno055_context dev)
-{
-    assert(dev != NULL);
-
-    // bail (with success code) if we are in config mode...
-    if (dev->currentMode == BNO055_OPERATION_MODE_CONFIGMODE)
-        return UPM_SUCCESS;
-
-    if (bno055_set_page(dev, 0, false))
-        return UPM_ERROR_OPERATION_FAILED;
-
-    const int nonFusionBytes = 18;
-    uint8_t buf[nonFusionBytes];
-
-    if (bno055_read_regs(dev, BNO055_REG_ACC_DATA_X_LSB, buf, nonFusionBytes))
-        return UPM_ERROR_OPERATION_FAILED;
-
-    dev->accX = INT16_TO_FLOAT(buf[0], buf[1]);
-    dev->accY = INT16_TO_FLOAT(buf[2], buf[3]);
-    dev->accZ = INT16_TO_FLOAT(buf[4], buf[5]);
-
-    dev->magX = INT16_TO_FLOAT(buf[6], buf[7]);
-    dev->magY = INT16_TO_FLOAT(buf[8], buf[9]);
-    dev->magZ = INT16_TO_FLOAT(buf[10], buf[11]);
-
-    dev->gyrX = INT16_TO_FLOAT(buf[12], buf[13]);
-    dev->gyrY = INT16_TO_FLOAT(buf[14], buf[15]);
-    dev->gyrZ = INT16_TO_FLOAT(buf[16], buf[17]);
-
-    return UPM_SUCCESS;
-}
+// first register of each data group, in BNO055_DATA_GROUPS_T bit
+// order, followed by the register after the last group
+static const uint8_t _data_group_regs[] = {
+    BNO055_REG_ACC_DATA_X_LSB,
+    BNO055_REG_MAG_DATA_X_LSB,
+    BNO055_REG_GYR_DATA_X_LSB,
+    BNO055_REG_EUL_HEADING_LSB,
+    BNO055_REG_QUA_DATA_W_LSB,
+    BNO055_REG_LIA_DATA_X_LSB,
+    BNO055_REG_GRV_DATA_X_LSB,
+    BNO055_REG_TEMPERATURE,
+    BNO055_REG_TEMPERATURE + 1
+};
+
+#define DATA_GROUPS (sizeof(_data_group_regs) - 1)
+#define DATA_BYTES (BNO055_REG_TEMPERATURE + 1 - BNO055_REG_ACC_DATA_X_LSB)
 
 // init
 bno055_context bno055_init(int bus, uint8_t addr, mraa_io_descriptor* descs)
@@ -170,6 +112,8 @@ bno055_context bno055_init(int bus, uint8_t addr, mraa_io_descriptor* descs)
 
     _clear_data(dev);
 
+    dev->dataGroups = BNO055_DATA_GROUP_ALL;
+
     // forcibly set page 0, so we are synced with the device
     if (bno055_set_page(dev, 0, true))
     {
@@ -251,24 +195,105 @@ upm_result_t bno055_update(const bno055_context dev)
 {
     assert(dev != NULL);
 
+    unsigned int groups = dev->dataGroups;
+
+    // only the temperature is available in config mode, and fusion
+    // data only in fusion modes
+    if (dev->currentMode == BNO055_OPERATION_MODE_CONFIGMODE)
+        groups &= BNO055_DATA_GROUP_TEMPERATURE;
+    else if (dev->currentMode < BNO055_OPERATION_MODE_IMU)
+        groups &= ~BNO055_DATA_GROUP_FUSION;
+
+    if (!groups)
+        return UPM_SUCCESS;
+
     if (bno055_set_page(dev, 0, false))
         return UPM_ERROR_OPERATION_FAILED;
 
-    // temperature first, always in Celsius
-    uint8_t tempreg = 0;
-    if (bno055_read_reg(dev, BNO055_REG_TEMPERATURE, &tempreg))
-        return UPM_ERROR_OPERATION_FAILED;
+    // read everything from the first to the last selected group in one
+    // go.  buf is indexed from BNO055_REG_ACC_DATA_X_LSB whatever the
+    // range read.
+    int first = 0;
+    int last = DATA_GROUPS - 1;
 
-    dev->temperature = (float)((int8_t)tempreg);
+    while (!(groups & (1 << first)))
+        first++;
+    while (!(groups & (1 << last)))
+        last--;
 
-    if (_update_fusion_data(dev))
-        return UPM_ERROR_OPERATION_FAILED;
-    if (_update_non_fusion_data(dev))
+    uint8_t buf[DATA_BYTES];
+    uint8_t reg = _data_group_regs[first];
+
+    if (bno055_read_regs(dev, reg, buf + (reg - BNO055_REG_ACC_DATA_X_LSB),
+                         _data_group_regs[last + 1] - reg))
         return UPM_ERROR_OPERATION_FAILED;
 
+    if (groups & BNO055_DATA_GROUP_ACC)
+    {
+        dev->accX = INT16_TO_FLOAT(buf[0], buf[1]);
+        dev->accY = INT16_TO_FLOAT(buf[2], buf[3]);
+        dev->accZ = INT16_TO_FLOAT(buf[4], buf[5]);
+    }
+
+    if (groups & BNO055_DATA_GROUP_MAG)
+    {
+        dev->magX = INT16_TO_FLOAT(buf[6], buf[7]);
+        dev->magY = INT16_TO_FLOAT(buf[8], buf[9]);
+        dev->magZ = INT16_TO_FLOAT(buf[10], buf[11]);
+    }
+
+    if (groups & BNO055_DATA_GROUP_GYR)
+    {
+        dev->gyrX = INT16_TO_FLOAT(buf[12], buf[13]);
+        dev->gyrY = INT16_TO_FLOAT(buf[14], buf[15]);
+        dev->gyrZ = INT16_TO_FLOAT(buf[16], buf[17]);
+    }
+
+    // FIXME/MAYBE? - skip fusion data if SYS calibration is == 0?
+
+    if (groups & BNO055_DATA_GROUP_EUL)
+    {
+        dev->eulHeading = INT16_TO_FLOAT(buf[18], buf[19]);
+        dev->eulRoll    = INT16_TO_FLOAT(buf[20], buf[21]);
+        dev->eulPitch   = INT16_TO_FLOAT(buf[22], buf[23]);
+    }
+
+    if (groups & BNO055_DATA_GROUP_QUA)
+    {
+        dev->quaW       = INT16_TO_FLOAT(buf[24], buf[25]);
+        dev->quaX       = INT16_TO_FLOAT(buf[26], buf[27]);
+        dev->quaY       = INT16_TO_FLOAT(buf[28], buf[29]);
+        dev->quaZ       = INT16_TO_FLOAT(buf[30], buf[31]);
+    }
+
+    if (groups & BNO055_DATA_GROUP_LIA)
+    {
+        dev->liaX       = INT16_TO_FLOAT(buf[32], buf[33]);
+        dev->liaY       = INT16_TO_FLOAT(buf[34], buf[35]);
+        dev->liaZ       = INT16_TO_FLOAT(buf[36], buf[37]);
+    }
+
+    if (groups & BNO055_DATA_GROUP_GRV)
+    {
+        dev->grvX       = INT16_TO_FLOAT(buf[38], buf[39]);
+        dev->grvY       = INT16_TO_FLOAT(buf[40], buf[41]);
+        dev->grvZ       = INT16_TO_FLOAT(buf[42], buf[43]);
+    }
+
+    // always in Celsius
+    if (groups & BNO055_DATA_GROUP_TEMPERATURE)
+        dev->temperature = (float)((int8_t)buf[44]);
+
     return UPM_SUCCESS;
 }
 
+void bno055_set_data_groups(const bno055_context dev, unsigned int groups)
+{
+    assert(dev != NULL);
+
+    dev->dataGroups = groups & BNO055_DATA_GROUP_ALL;
+}
+
 upm_result_t bno055_read_reg(const bno055_context dev, uint8_t reg,
                              uint8_t *retval)
 {
@@ -315,6 +340,10 @@ upm_result_t bno055_write_reg(const bno055_context dev,
         return UPM_ERROR_OPERATION_FAILED;
     }
 
+    // keep the cached page in sync with direct page writes
+    if (reg == BNO055_REG_PAGE_ID)
+        dev->currentPage = val;
+
     return UPM_SUCCESS;
 }
 
@@ -152,6 +152,11 @@ void BNO055::update()
                                  + ": bno055_update() failed");
 }
 
+void BNO055::setDataGroups(unsigned int groups)
+{
+    bno055_set_data_groups(m_bno055, groups);
+}
+
 uint8_t BNO055::readReg(uint8_t reg)
 {
     uint8_t rv = 0;
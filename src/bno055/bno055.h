@@ -48,6 +48,9 @@ extern "C" {
         int currentPage;
         BNO055_OPERATION_MODES_T currentMode;
 
+        // BNO055_DATA_GROUPS_T bits loaded by bno055_update()
+        unsigned int dataGroups;
+
         // uncompensated data
 
         // mag data
@@ -122,13 +125,31 @@ extern "C" {
     void bno055_close(bno055_context dev);
 
     /**
-     * Update the internal stored values from sensor data.
+     * Update the internal stored values from sensor data.  Only the
+     * data groups selected with bno055_set_data_groups() are loaded,
+     * all of them by default.  They are read in a single I2C
+     * transaction.
      *
      * @param dev The device context.
      * @return UPM result.
      */
     upm_result_t bno055_update(const bno055_context dev);
 
+    /**
+     * Select the data loaded by bno055_update().  The smallest
+     * register range covering the selected groups is read, so
+     * selecting only what is needed (for example, just
+     * BNO055_DATA_GROUP_QUA) shortens each update.  The values of
+     * groups that are not selected are left as they were.  Fusion
+     * data is only loaded in fusion modes, and nothing but the
+     * temperature is loaded in config mode.
+     *
+     * @param dev The device context.
+     * @param groups BNO055_DATA_GROUPS_T bits OR'd together.
+     */
+    void bno055_set_data_groups(const bno055_context dev,
+                                unsigned int groups);
+
     /**
      * Return the chip ID.
      *
@@ -128,12 +128,28 @@ namespace upm {
         virtual ~BNO055();
 
         /**
-         * Update the internal stored values from sensor data.
+         * Update the internal stored values from sensor data.  Only
+         * the data groups selected with setDataGroups() are loaded,
+         * all of them by default.  They are read in a single I2C
+         * transaction.
          *
          * @throws std::runtime_error on failure.
          */
         void update();
 
+        /**
+         * Select the data loaded by update().  The smallest register
+         * range covering the selected groups is read, so selecting
+         * only what is needed (for example, just
+         * BNO055_DATA_GROUP_QUA) shortens each update.  The values of
+         * groups that are not selected are left as they were.  Fusion
+         * data is only loaded in fusion modes, and nothing but the
+         * temperature is loaded in config mode.
+         *
+         * @param groups BNO055_DATA_GROUPS_T bits OR'd together.
+         */
+        void setDataGroups(unsigned int groups);
+
         /**
          * Return the chip ID.
          *
@@ -807,6 +807,25 @@ extern "C" {
         BNO055_SLOPE_SAMPLES_64                 = 3
     } BNO055_SLOPE_SAMPLES_T;
 
+    /**
+     * Data groups loaded by update(), in register order.  These may be
+     * OR'd together.
+     */
+    typedef enum {
+        BNO055_DATA_GROUP_ACC                   = 0x01,
+        BNO055_DATA_GROUP_MAG                   = 0x02,
+        BNO055_DATA_GROUP_GYR                   = 0x04,
+        BNO055_DATA_GROUP_EUL                   = 0x08,
+        BNO055_DATA_GROUP_QUA                   = 0x10,
+        BNO055_DATA_GROUP_LIA                   = 0x20,
+        BNO055_DATA_GROUP_GRV                   = 0x40,
+        BNO055_DATA_GROUP_TEMPERATURE           = 0x80,
+
+        // only available in fusion modes
+        BNO055_DATA_GROUP_FUSION                = 0x78,
+        BNO055_DATA_GROUP_ALL                   = 0xff
+    } BNO055_DATA_GROUPS_T;
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,12 +19,23 @@ struct _ds18b20_info_t {
     uint8_t id[MRAA_UART_OW_ROMCODE_SIZE];          // 8-byte romcode id
     float temperature;
     DS18B20_RESOLUTIONS_T resolution;
+    bool parasite;                                  // parasitically powered
 };
 
+// how often ds18b20_update() polls for the end of a conversion
+#define DS18B20_POLL_MS 5
+
 // internal utility function forward to read temperature from a single
 // device
 static float readSingleTemp(const ds18b20_context dev, unsigned int index);
 
+// worst case conversion time in us: 750ms at 12 bits, halved for
+// every bit less
+static uint32_t conversionTime(DS18B20_RESOLUTIONS_T res)
+{
+    return 750000 >> (DS18B20_RESOLUTION_12BITS - res);
+}
+
 ds18b20_context ds18b20_init(unsigned int uart)
 {
     // make sure MRAA is initialized
@@ -114,6 +125,7 @@ ds18b20_context ds18b20_init(unsigned int uart)
             dev->devices[dev->numDevices].temperature = 0.0;
             dev->devices[dev->numDevices].resolution =
                 DS18B20_RESOLUTION_12BITS;
+            dev->devices[dev->numDevices].parasite = false;
 
             dev->numDevices++;
         }
@@ -156,6 +168,14 @@ ds18b20_context ds18b20_init(unsigned int uart)
 
         // reset the bus
         mraa_uart_ow_reset(dev->ow);
+
+        // parasitically powered devices pull the bus low in the read
+        // time slot following this command
+        mraa_uart_ow_command(dev->ow, DS18B20_CMD_READ_POWER_SUPPLY,
+                             dev->devices[i].id);
+        dev->devices[i].parasite = !mraa_uart_ow_bit(dev->ow, 1);
+
+        mraa_uart_ow_reset(dev->ow);
     }
 
     return dev;
@@ -177,37 +197,94 @@ void ds18b20_update(const ds18b20_context dev, int index)
 {
     assert(dev != NULL);
 
+    if (ds18b20_start_conversion(dev, index) != UPM_SUCCESS)
+        return;
+
+    // wait for conversion(s) to finish
+    while (!ds18b20_poll_complete(dev))
+        upm_delay_ms(DS18B20_POLL_MS);
+}
+
+upm_result_t ds18b20_start_conversion(const ds18b20_context dev, int index)
+{
+    assert(dev != NULL);
+
     if (index >= (int)dev->numDevices)
     {
         printf("%s: device index %d out of range\n", __FUNCTION__, index);
-        return;
+        return UPM_ERROR_OUT_OF_RANGE;
     }
 
-    // should we update all of them?
-    bool doAll = (index < 0) ? true : false;
+    uint8_t *id = NULL;
+    uint32_t convTime = 0;
+    bool convPoll = true;
 
-    if (doAll)
+    if (index < 0)
     {
-        // if we want to update all of them, we will first send the
-        // convert command to all of them, then wait.  This will be
-        // faster, timey-wimey wise, then converting, sleeping, and
-        // reading each individual sensor.
+        // a NULL id sends Skip ROM, so every device on the bus starts
+        // converting with this one command.  The slowest one (highest
+        // resolution) determines how long to wait.
         for (unsigned int i=0; i<dev->numDevices; i++)
-            mraa_uart_ow_command(dev->ow, DS18B20_CMD_CONVERT, dev->devices[i].id);
+        {
+            uint32_t t = conversionTime(dev->devices[i].resolution);
+            if (t > convTime)
+                convTime = t;
+            if (dev->devices[i].parasite)
+                convPoll = false;
+        }
     }
     else
-        mraa_uart_ow_command(dev->ow, DS18B20_CMD_CONVERT, dev->devices[index].id);
+    {
+        id = dev->devices[index].id;
+        convTime = conversionTime(dev->devices[index].resolution);
+        convPoll = !dev->devices[index].parasite;
+    }
 
-    // wait for conversion(s) to finish
-    upm_delay_ms(750); // 750ms max
+    dev->converting = false;
+
+    if (mraa_uart_ow_command(dev->ow, DS18B20_CMD_CONVERT, id)
+        != MRAA_SUCCESS)
+    {
+        printf("%s: mraa_uart_ow_command() failed\n", __FUNCTION__);
+        return UPM_ERROR_OPERATION_FAILED;
+    }
+
+    dev->convertIndex = index;
+    dev->convertTime = convTime;
+    dev->convertPoll = convPoll;
+    dev->convertClock = upm_clock_init();
+    dev->converting = true;
+
+    return UPM_SUCCESS;
+}
+
+bool ds18b20_poll_complete(const ds18b20_context dev)
+{
+    assert(dev != NULL);
+
+    if (!dev->converting)
+        return true;
 
-    if (doAll)
+    // while converting, the devices answer read time slots with 0.
+    // Since the bus is wired-AND, a 1 means that all of them are done.
+    // Parasitically powered devices can't answer, so only the timeout
+    // counts for them.
+    if (upm_elapsed_us(&dev->convertClock) < dev->convertTime
+        && (!dev->convertPoll || !mraa_uart_ow_bit(dev->ow, 1)))
+        return false;
+
+    dev->converting = false;
+
+    if (dev->convertIndex < 0)
     {
         for (unsigned int i=0; i<dev->numDevices; i++)
             dev->devices[i].temperature = readSingleTemp(dev, i);
     }
     else
-        dev->devices[index].temperature = readSingleTemp(dev, index);
+        dev->devices[dev->convertIndex].temperature =
+            readSingleTemp(dev, dev->convertIndex);
+
+    return true;
 }
 
 // utility function to read temp data from a single sensor
@@ -324,6 +401,9 @@ void ds18b20_set_resolution(const ds18b20_context dev, unsigned int index,
                          dev->devices[index].id);
     for (i=0; i<3; i++)
         mraa_uart_ow_write_byte(dev->ow, scratch[i+2]);
+
+    // used to mask the fraction and to time conversions
+    dev->devices[index].resolution = res;
 }
 
 void ds18b20_copy_scratchpad(const ds18b20_context dev, unsigned int index)
@@ -13,6 +13,7 @@
 #include <stdexcept>
 
 #include "ds18b20.hpp"
+#include "upm_utilities.h"
 
 using namespace upm;
 using namespace std;
@@ -50,6 +51,37 @@ void DS18B20::update(int index)
     ds18b20_update(m_ds18b20, index);
 }
 
+void DS18B20::startConversion(int index)
+{
+    if (index >= (int)ds18b20_devices_found(m_ds18b20))
+        throw std::out_of_range(string(__FUNCTION__)
+                                + ": Invalid index");
+
+    if (ds18b20_start_conversion(m_ds18b20, index) != UPM_SUCCESS)
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": ds18b20_start_conversion() failed");
+}
+
+bool DS18B20::pollComplete()
+{
+    return ds18b20_poll_complete(m_ds18b20);
+}
+
+std::future<std::vector<float> > DS18B20::updateAsync(bool fahrenheit)
+{
+    startConversion(-1);
+
+    return std::async(std::launch::async, [this, fahrenheit]() {
+        while (!pollComplete())
+            upm_delay_ms(5);
+
+        std::vector<float> temps;
+        for (unsigned int i=0; i<ds18b20_devices_found(m_ds18b20); i++)
+            temps.push_back(getTemperature(i, fahrenheit));
+        return temps;
+    });
+}
+
 float DS18B20::getTemperature(unsigned int index, bool fahrenheit)
 {
     if (index >= ds18b20_devices_found(m_ds18b20))
@@ -16,6 +16,7 @@
 
 #include <mraa/uart_ow.h>
 #include <upm.h>
+#include <upm_utilities.h>
 #include "ds18b20_defs.h"
 
 #ifdef __cplusplus
@@ -44,6 +45,18 @@ extern "C" {
 
         // list of allocated ds18b20_info_t instances
         ds18b20_info_t *devices;
+
+        // conversion in progress
+        bool converting;
+        // device being converted, -1 for all of them
+        int convertIndex;
+        // start of the conversion
+        upm_clock_t convertClock;
+        // longest conversion time of the converting device(s) in us
+        uint32_t convertTime;
+        // false if a converting device is parasitically powered, and so
+        // can't report the end of the conversion
+        bool convertPoll;
     } *ds18b20_context;
 
     /**
@@ -64,13 +77,44 @@ extern "C" {
 
     /**
      * Update our stored temperature for a device.  This method must
-     * be called prior to ds18b20_get_temperature().
+     * be called prior to ds18b20_get_temperature().  It blocks until the
+     * conversion is done, see ds18b20_start_conversion() for a
+     * non-blocking alternative.
      *
      * @param index The device index to access (starts at 0).  Specify
      * -1 to query all detected devices.  Default: -1
      */
     void ds18b20_update(const ds18b20_context dev, int index);
 
+    /**
+     * Start a temperature conversion and return without waiting for it.
+     * When all devices are selected, a single broadcast (Skip ROM)
+     * command starts them together.  Use ds18b20_poll_complete() to
+     * find out when the conversion is done.  The bus must not be used
+     * for anything else in the meantime.
+     *
+     * @param index The device index to access (starts at 0).  Specify
+     * -1 to convert on all detected devices.
+     * @return UPM result
+     */
+    upm_result_t ds18b20_start_conversion(const ds18b20_context dev,
+                                          int index);
+
+    /**
+     * Check whether the conversion started by
+     * ds18b20_start_conversion() is done, and if so, read the
+     * temperature(s) so that ds18b20_get_temperature() returns them.
+     * The devices are asked with a read time slot, so the conversion
+     * usually completes before the worst case time for the configured
+     * resolution (93.75ms at 9 bits up to 750ms at 12 bits), which is
+     * used as a timeout.  Parasitically powered devices can't be
+     * asked, so if any of the converting devices is, the conversion
+     * always takes the worst case time.
+     *
+     * @return true when no conversion is in progress anymore
+     */
+    bool ds18b20_poll_complete(const ds18b20_context dev);
+
     /**
      * Get the current temperature.  ds18b20_update() must have been
      * called prior to calling this method.
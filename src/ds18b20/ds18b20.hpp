@@ -13,6 +13,8 @@
 #include <string>
 #include <iostream>
 #include <map>
+#include <future>
+#include <vector>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -127,13 +129,51 @@ namespace upm {
 
       /**
        * Update our stored temperature for a device.  This method must
-       * be called prior to getTemperature().
+       * be called prior to getTemperature().  It blocks until the
+       * conversion is done, see startConversion() and updateAsync() for
+       * non-blocking alternatives.
        *
        * @param index The device index to access (starts at 0).  Specify
        * -1 to query all detected devices.  Default: -1
        */
       void update(int index=-1);
 
+      /**
+       * Start a temperature conversion and return without waiting for
+       * it.  When all devices are selected, a single broadcast command
+       * starts them together.  Use pollComplete() to find out when the
+       * conversion is done.  The bus must not be used for anything else
+       * in the meantime.
+       *
+       * @param index The device index to access (starts at 0).  Specify
+       * -1 to convert on all detected devices.  Default: -1
+       */
+      void startConversion(int index=-1);
+
+      /**
+       * Check whether the conversion started by startConversion() is
+       * done, and if so, read the temperature(s) so that
+       * getTemperature() returns them.  This does not block.
+       * Conversions involving parasitically powered devices always
+       * take the worst case time for the resolution.
+       *
+       * @return true when no conversion is in progress anymore
+       */
+      bool pollComplete();
+
+      /**
+       * Convert and read the temperature of all devices in the
+       * background.  The conversion is started before returning.  Do
+       * not access the device until the returned future is ready.
+       *
+       * @param fahrenheit true to return the temperatures in degrees
+       * fahrenheit, false to return them in degrees celsius.  The
+       * default is false (degrees Celsius).
+       * @return A future holding the temperature of each device, in
+       * device index order
+       */
+      std::future<std::vector<float> > updateAsync(bool fahrenheit=false);
+
       /**
        * Get the current temperature.  update() must have been called
        * prior to calling this method.
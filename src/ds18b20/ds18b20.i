@@ -7,6 +7,8 @@ JAVA_JNI_LOADLIBRARY(javaupm_ds18b20)
 /* END Java syntax */
 
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
+%ignore updateAsync;
+
 %include "carrays.i"
 %{
 #include "ds18b20_defs.h"
@@ -29,12 +29,28 @@ E50HX::E50HX(uint32_t targetDeviceObjectID) :
 
   // we disable this by default for performance reasons
   checkReliability(false);
+
+  // update() reads all of the Analog Inputs, except the reserved
+  // ones and AI_Pulse_Count_2, which only the H5 variant has
+  for (uint32_t ai = AI_Energy; ai <= AI_Alarm_Bitmap; ai++)
+    {
+      if (ai == 24 || ai == AI_Pulse_Count_2 || ai == 46 || ai == 48
+          || ai == 49)
+        continue;
+
+      addPollObject(OBJECT_ANALOG_INPUT, ai);
+    }
 }
 
 E50HX::~E50HX()
 {
 }
 
+void E50HX::update()
+{
+  poll();
+}
+
 uint16_t E50HX::getAlarmBits()
 {
   return uint16_t(getAnalogInput(AI_Alarm_Bitmap));
@@ -290,6 +290,16 @@ namespace upm {
      */
     void writePhaseLossIT(float phaseLoss);
 
+    /**
+     * Read the Present_Value of every Analog Input with as few
+     * requests as the device allows, usually one or two instead of
+     * one per object.  Until the next update(), getAnalogInput() and
+     * getAlarmBits() return the values read here instead of querying
+     * the device each time.  See BACNETUTIL::setCacheTTL() to limit
+     * how long they are used.  This method will throw on error.
+     */
+    void update();
+
     /**
      * Query the AI52 Object and return a bitmask of current Alarms.
      * Compare against ALARM_BITS_T to determine what conditions are
@@ -19,6 +19,8 @@ JAVA_JNI_LOADLIBRARY(javaupm_e50hx)
 /* END Java syntax */
 
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
+%include "../bacnetmstp/bacnetmstp_ignores.i"
+
 %{
 #include "bacnetmstp.hpp"
 #include "bacnetutil.hpp"
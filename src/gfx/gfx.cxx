@@ -11,8 +11,12 @@
  * SPDX-License-Identifier: MIT
  */
 
-#include "ili9341_gfx.hpp"
-#include "mraa.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+#include "gfx.hpp"
+
+#define adagfxswap(a, b) { int16_t t = a; a = b; b = t; }
 
 using namespace upm;
 
@@ -20,7 +24,7 @@ GFX::GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {
     _width = WIDTH;
     _height = HEIGHT;
     rotation = 0;
-    
+
     cursor_x = 0;
     cursor_y = 0;
     textsize = 1;
@@ -30,12 +34,53 @@ GFX::GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {
     _cp437 = false;
 }
 
-void GFX::drawLine(int16_t x0, 
-                   int16_t y0, 
-                   int16_t x1, 
-                   int16_t y1, 
+void GFX::fillRect(int16_t x,
+                   int16_t y,
+                   int16_t w,
+                   int16_t h,
                    uint16_t color) {
-                   
+    if (!clipRect(x, y, w, h)) return;
+
+    for (int16_t j = y; j < y + h; j++) {
+        for (int16_t i = x; i < x + w; i++) {
+            drawPixel(i, j, color);
+        }
+    }
+}
+
+void GFX::pushColors(int16_t x,
+                     int16_t y,
+                     int16_t w,
+                     int16_t h,
+                     const uint16_t *colors) {
+    int16_t stride = w, skipX, skipY;
+    if (!clipRect(x, y, w, h, &skipX, &skipY)) return;
+
+    colors += skipY * stride + skipX;
+    for (int16_t j = 0; j < h; j++, colors += stride) {
+        for (int16_t i = 0; i < w; i++) {
+            drawPixel(x + i, y + j, colors[i]);
+        }
+    }
+}
+
+void GFX::drawLine(int16_t x0,
+                   int16_t y0,
+                   int16_t x1,
+                   int16_t y1,
+                   uint16_t color) {
+
+    if (x0 == x1) {
+        if (y0 > y1) adagfxswap(y0, y1);
+        drawFastVLine(x0, y0, y1 - y0 + 1, color);
+        return;
+    }
+    if (y0 == y1) {
+        if (x0 > x1) adagfxswap(x0, x1);
+        drawFastHLine(x0, y0, x1 - x0 + 1, color);
+        return;
+    }
+
     int16_t steep = abs(y1 - y0) > abs(x1 - x0);
     if (steep) {
         adagfxswap(x0, y0);
@@ -60,38 +105,44 @@ void GFX::drawLine(int16_t x0,
         ystep = -1;
     }
 
+    // Same pixels as plain Bresenham, but the pixels sharing a minor
+    // axis coordinate are drawn together as one span
+    int16_t start = x0;
     for (; x0<=x1; x0++) {
-        if (steep) {
-            drawPixel(y0, x0, color);
-        } else {
-            drawPixel(x0, y0, color);
-        }
         err -= dy;
+        if (err < 0 || x0 == x1) {
+            if (steep) {
+                drawFastVLine(y0, start, x0 - start + 1, color);
+            } else {
+                drawFastHLine(start, y0, x0 - start + 1, color);
+            }
+            start = x0 + 1;
+        }
         if (err < 0) {
             y0 += ystep;
-          err += dx;
+            err += dx;
         }
     }
 }
 
-void GFX::drawFastVLine(int16_t x, 
-                        int16_t y, 
-                        int16_t h, 
+void GFX::drawFastVLine(int16_t x,
+                        int16_t y,
+                        int16_t h,
                         uint16_t color) {
-    drawLine(x, y, x, y+h-1, color);
+    fillRect(x, y, 1, h, color);
 }
 
-void GFX::drawFastHLine(int16_t x, 
-                        int16_t y, 
-                        int16_t w, 
+void GFX::drawFastHLine(int16_t x,
+                        int16_t y,
+                        int16_t w,
                         uint16_t color) {
-    drawLine(x, y, x+w-1, y, color);
+    fillRect(x, y, w, 1, color);
 }
 
-void GFX::drawRect(int16_t x, 
-                   int16_t y, 
-                   int16_t w, 
-                   int16_t h, 
+void GFX::drawRect(int16_t x,
+                   int16_t y,
+                   int16_t w,
+                   int16_t h,
                    uint16_t color) {
     drawFastHLine(x, y, w, color);
     drawFastHLine(x, y+h-1, w, color);
@@ -99,16 +150,6 @@ void GFX::drawRect(int16_t x,
     drawFastVLine(x+w-1, y, h, color);
 }
 
-void GFX::fillRect(int16_t x, 
-                   int16_t y, 
-                   int16_t w, 
-                   int16_t h, 
-                   uint16_t color) {
-    for (int16_t i=x; i<x+w; i++) {
-        drawFastVLine(i, y, h, color);
-    }
-}
-
 void GFX::fillScreen(uint16_t color) {
     fillRect(0, 0, _width, _height, color);
 }
@@ -118,41 +159,17 @@ void GFX::invertDisplay(bool i) {
 }
 
 void GFX::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
     drawPixel(x0  , y0+r, color);
     drawPixel(x0  , y0-r, color);
     drawPixel(x0+r, y0  , color);
     drawPixel(x0-r, y0  , color);
 
-    while (x<y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        drawPixel(x0 + x, y0 + y, color);
-        drawPixel(x0 - x, y0 + y, color);
-        drawPixel(x0 + x, y0 - y, color);
-        drawPixel(x0 - x, y0 - y, color);
-        drawPixel(x0 + y, y0 + x, color);
-        drawPixel(x0 - y, y0 + x, color);
-        drawPixel(x0 + y, y0 - x, color);
-        drawPixel(x0 - y, y0 - x, color);
-    }
+    drawCircleHelper(x0, y0, r, 0xF, color);
 }
 
-void GFX::drawCircleHelper(int16_t x0, 
-                           int16_t y0, 
-                           int16_t r, 
+void GFX::drawCircleHelper(int16_t x0,
+                           int16_t y0,
+                           int16_t r,
                            uint8_t cornername,
                            uint16_t color) {
     int16_t f     = 1 - r;
@@ -161,8 +178,17 @@ void GFX::drawCircleHelper(int16_t x0,
     int16_t x     = 0;
     int16_t y     = r;
 
+    // Steps which keep y are collected into a run and drawn as spans,
+    // horizontal ones near the top and bottom and vertical ones at the
+    // sides of each octant
+    int16_t start = 1;
     while (x<y) {
         if (f >= 0) {
+            if (x >= start) {
+                circleSpans(x0, y0, start, y, x - start + 1, cornername,
+                            color);
+            }
+            start = x + 1;
             y--;
             ddF_y += 2;
             f     += ddF_y;
@@ -170,22 +196,30 @@ void GFX::drawCircleHelper(int16_t x0,
         x++;
         ddF_x += 2;
         f     += ddF_x;
-        if (cornername & 0x4) {
-            drawPixel(x0 + x, y0 + y, color);
-            drawPixel(x0 + y, y0 + x, color);
-        }
-        if (cornername & 0x2) {
-            drawPixel(x0 + x, y0 - y, color);
-            drawPixel(x0 + y, y0 - x, color);
-        }
-        if (cornername & 0x8) {
-            drawPixel(x0 - y, y0 + x, color);
-            drawPixel(x0 - x, y0 + y, color);
-        }
-        if (cornername & 0x1) {
-            drawPixel(x0 - y, y0 - x, color);
-            drawPixel(x0 - x, y0 - y, color);
-        }
+    }
+    if (x >= start) {
+        circleSpans(x0, y0, start, y, x - start + 1, cornername, color);
+    }
+}
+
+void GFX::circleSpans(int16_t x0, int16_t y0, int16_t x, int16_t y,
+                      int16_t n, uint8_t cornername, uint16_t color) {
+    // The run covers x .. x+n-1 at distance y from the center
+    if (cornername & 0x4) {
+        drawFastHLine(x0 + x, y0 + y, n, color);
+        drawFastVLine(x0 + y, y0 + x, n, color);
+    }
+    if (cornername & 0x2) {
+        drawFastHLine(x0 + x, y0 - y, n, color);
+        drawFastVLine(x0 + y, y0 - x - n + 1, n, color);
+    }
+    if (cornername & 0x8) {
+        drawFastVLine(x0 - y, y0 + x, n, color);
+        drawFastHLine(x0 - x - n + 1, y0 + y, n, color);
+    }
+    if (cornername & 0x1) {
+        drawFastVLine(x0 - y, y0 - x - n + 1, n, color);
+        drawFastHLine(x0 - x - n + 1, y0 - y, n, color);
     }
 }
 
@@ -194,9 +228,9 @@ void GFX::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
     fillCircleHelper(x0, y0, r, 3, 0, color);
 }
 
-void GFX::fillCircleHelper(int16_t x0, 
-                           int16_t y0, 
-                           int16_t r, 
+void GFX::fillCircleHelper(int16_t x0,
+                           int16_t y0,
+                           int16_t r,
                            uint8_t cornername,
                            int16_t delta,
                            uint16_t color) {
@@ -227,24 +261,24 @@ void GFX::fillCircleHelper(int16_t x0,
     }
 }
 
-void GFX::drawTriangle(int16_t x0, 
+void GFX::drawTriangle(int16_t x0,
                        int16_t y0,
-                       int16_t x1, 
-                       int16_t y1, 
-                       int16_t x2, 
-                       int16_t y2, 
+                       int16_t x1,
+                       int16_t y1,
+                       int16_t x2,
+                       int16_t y2,
                        uint16_t color) {
   drawLine(x0, y0, x1, y1, color);
   drawLine(x1, y1, x2, y2, color);
   drawLine(x2, y2, x0, y0, color);
 }
 
-void GFX::fillTriangle(int16_t x0, 
+void GFX::fillTriangle(int16_t x0,
                        int16_t y0,
-                       int16_t x1, 
+                       int16_t x1,
                        int16_t y1,
-                       int16_t x2, 
-                       int16_t y2, 
+                       int16_t x2,
+                       int16_t y2,
                        uint16_t color) {
 
   int16_t a, b, y, last;
@@ -322,13 +356,13 @@ void GFX::fillTriangle(int16_t x0,
 }
 
 // Draw a rounded rectangle
-void GFX::drawRoundRect(int16_t x, 
-                        int16_t y, 
+void GFX::drawRoundRect(int16_t x,
+                        int16_t y,
                         int16_t w,
-                        int16_t h, 
-                        int16_t r, 
+                        int16_t h,
+                        int16_t r,
                         uint16_t color) {
-                        
+
   // smarter version
   drawFastHLine(x+r  , y    , w-2*r, color); // Top
   drawFastHLine(x+r  , y+h-1, w-2*r, color); // Bottom
@@ -341,13 +375,13 @@ void GFX::drawRoundRect(int16_t x,
   drawCircleHelper(x+r    , y+h-r-1, r, 8, color);
 }
 
-void GFX::fillRoundRect(int16_t x, 
-                        int16_t y, 
+void GFX::fillRoundRect(int16_t x,
+                        int16_t y,
                         int16_t w,
-                        int16_t h, 
-                        int16_t r, 
+                        int16_t h,
+                        int16_t r,
                         uint16_t color) {
-                        
+
   // smarter version
   fillRect(x+r, y, w-2*r, h, color);
 
@@ -356,11 +390,55 @@ void GFX::fillRoundRect(int16_t x,
   fillCircleHelper(x+r    , y+r, r, 2, h-2*r-1, color);
 }
 
-void GFX::drawChar(int16_t x, 
-                  int16_t y, 
+void GFX::drawBitmap(int16_t x,
+                     int16_t y,
+                     const uint8_t *bitmap,
+                     int16_t w,
+                     int16_t h,
+                     uint16_t color,
+                     uint16_t bg) {
+    if ((w <= 0) || (h <= 0)) return;
+
+    int16_t stride = (w + 7) / 8;
+    m_block.resize(w * h);
+
+    uint16_t *pixel = m_block.data();
+    for (int16_t j = 0; j < h; j++, bitmap += stride) {
+        for (int16_t i = 0; i < w; i++) {
+            *pixel++ = (bitmap[i / 8] & (0x80 >> (i & 7))) ? color : bg;
+        }
+    }
+
+    pushColors(x, y, w, h, m_block.data());
+}
+
+void GFX::drawBitmap(int16_t x,
+                     int16_t y,
+                     const uint8_t *bitmap,
+                     int16_t w,
+                     int16_t h,
+                     uint16_t color) {
+    int16_t stride = (w + 7) / 8;
+
+    for (int16_t j = 0; j < h; j++, bitmap += stride) {
+        int16_t i = 0;
+        while (i < w) {
+            if (!(bitmap[i / 8] & (0x80 >> (i & 7)))) {
+                i++;
+                continue;
+            }
+            int16_t start = i;
+            while ((i < w) && (bitmap[i / 8] & (0x80 >> (i & 7)))) i++;
+            drawFastHLine(x + start, y + j, i - start, color);
+        }
+    }
+}
+
+void GFX::drawChar(int16_t x,
+                  int16_t y,
                   unsigned char c,
-                  uint16_t color, 
-                  uint16_t bg, 
+                  uint16_t color,
+                  uint16_t bg,
                   uint8_t size) {
 
     if((x >= _width)            || // Clip right
@@ -371,20 +449,45 @@ void GFX::drawChar(int16_t x,
 
     if(!_cp437 && (c >= 176)) c++; // Handle 'classic' charset behavior
 
-    for(int8_t i=0; i<6; i++ ) {
-        uint8_t line;
-        if(i < 5) line = font[(c * 5) + i];
-        else      line = 0x0;
-        for(int8_t j=0; j<8; j++, line >>= 1) {
-            if(line & 0x1) {
-                if(size == 1) drawPixel(x+i, y+j, color);
-                else          fillRect(x+(i*size), y+(j*size), size, size, color);
-            } else if(bg != color) {
-                if(size == 1) drawPixel(x+i, y+j, bg);
-                else          fillRect(x+i*size, y+j*size, size, size, bg);
+    const unsigned char *glyph = &font[c * 5];
+
+    if(bg == color) {
+        // Transparent, draw each run of set pixels in a glyph row as one
+        // span (a size x size block per font pixel when scaled)
+        for(int8_t j=0; j<8; j++) {
+            int8_t i = 0;
+            while(i < 5) {
+                if(!(glyph[i] & (1 << j))) {
+                    i++;
+                    continue;
+                }
+                int8_t start = i;
+                while((i < 5) && (glyph[i] & (1 << j))) i++;
+                fillRect(x + start * size, y + j * size,
+                         (i - start) * size, size, color);
             }
         }
+        return;
+    }
+
+    // Opaque, render the whole cell (including the spacing column) and
+    // send it as a single block
+    int16_t w = 6 * size, h = 8 * size;
+    m_block.resize(w * h);
+
+    for(int8_t j=0; j<8; j++) {
+        uint16_t *row = &m_block[j * size * w];
+        for(int8_t i=0; i<6; i++) {
+            uint16_t pixel = ((i < 5) && (glyph[i] & (1 << j))) ? color : bg;
+            for(uint8_t s=0; s<size; s++) *row++ = pixel;
+        }
+        for(uint8_t s=1; s<size; s++) {
+            std::copy(&m_block[j * size * w], &m_block[(j * size + 1) * w],
+                      &m_block[(j * size + s) * w]);
+        }
     }
+
+    pushColors(x, y, w, h, m_block.data());
 }
 
 int16_t GFX::getCursorX(void) const {
@@ -444,14 +547,14 @@ void GFX::cp437(bool x) {
 }
 
 void GFX::write(uint8_t c) {
-    
+
     if(c == '\n') {
         cursor_y += textsize*8;
         cursor_x  = 0;
     } else if(c == '\r') {
         // skip em
     } else {
-    
+
         // Heading off edge?
         if(wrap && ((cursor_x + textsize * 6) >= _width)) {
             cursor_x  = 0;            // Reset x to zero
@@ -477,7 +580,30 @@ int16_t GFX::height(void) const {
     return _height;
 }
 
-const unsigned char GFX::font[] = {    
+bool GFX::clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h,
+                   int16_t *skipX, int16_t *skipY) const {
+    int16_t dx = 0, dy = 0;
+
+    if (x < 0) {
+        dx = -x;
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        dy = -y;
+        h += y;
+        y = 0;
+    }
+    if ((x + w - 1) >= _width)  w = _width  - x;
+    if ((y + h - 1) >= _height) h = _height - y;
+
+    if (skipX) *skipX = dx;
+    if (skipY) *skipY = dy;
+
+    return (w > 0) && (h > 0);
+}
+
+const unsigned char GFX::font[] = {
     0x00, 0x00, 0x00, 0x00, 0x00,
     0x3E, 0x5B, 0x4F, 0x5B, 0x3E,
     0x3E, 0x6B, 0x4F, 0x6B, 0x3E,
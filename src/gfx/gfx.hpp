@@ -13,19 +13,26 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
-#define adagfxswap(a, b) { int16_t t = a; a = b; b = t; }
-
-namespace upm 
+namespace upm
 {
     /**
      * @brief GFX helper class
+     *
+     * Rasterizer shared by the RGB565 display drivers (ILI9341, ST7735,
+     * SSD1351). Shapes are broken down into horizontal or vertical spans
+     * which end up in fillRect(), and text and bitmaps into blocks of
+     * pixels which end up in pushColors(). A driver only has to provide
+     * drawPixel(), but overriding fillRect() and pushColors() with its
+     * own bulk writes is what makes drawing fast.
      */
     class GFX {
         public:
-        
+
             /**
              * Creates a GFX object
              *
@@ -35,10 +42,10 @@ namespace upm
             GFX(int16_t w, int16_t h);
 
             /**
-             * Empyt virtual destructor
+             * Empty virtual destructor
              */
             virtual ~GFX() {};
-             
+
             /**
              * Sends a pixel color (RGB) to the driver chip. This must be
              * defined by the subclass (pure virtual function).
@@ -48,7 +55,40 @@ namespace upm
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
             virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
-            
+
+            /**
+             * Draw a filled rectangle. All spans drawn by this class end
+             * up here, the default implementation draws pixel by pixel.
+             *
+             * @param x Axis on the horizontal scale of upper-left corner
+             * @param y Axis on the vertical scale of upper-left corner
+             * @param w Width of rectangle in pixels
+             * @param h Height of rectangle in pixels
+             * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
+             */
+            virtual void fillRect(int16_t x,
+                                  int16_t y,
+                                  int16_t w,
+                                  int16_t h,
+                                  uint16_t color);
+
+            /**
+             * Draw a block of pixels. The block is clipped to the screen.
+             * Text and bitmaps drawn by this class end up here, the
+             * default implementation draws pixel by pixel.
+             *
+             * @param x Axis on the horizontal scale of upper-left corner
+             * @param y Axis on the vertical scale of upper-left corner
+             * @param w Width of the block in pixels
+             * @param h Height of the block in pixels
+             * @param colors w * h RGB (16-bit) colors, row by row
+             */
+            virtual void pushColors(int16_t x,
+                                    int16_t y,
+                                    int16_t w,
+                                    int16_t h,
+                                    const uint16_t *colors);
+
             /**
              * Draw a line.
              *
@@ -57,39 +97,39 @@ namespace upm
              * @param x1 End of line x coordinate
              * @param y1 End of line y coordinate
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
-             */            
-            virtual void drawLine(int16_t x0, 
-                                  int16_t y0, 
-                                  int16_t x1, 
-                                  int16_t y1, 
+             */
+            virtual void drawLine(int16_t x0,
+                                  int16_t y0,
+                                  int16_t x1,
+                                  int16_t y1,
                                   uint16_t color);
-            
+
             /**
-             * Draws a vertical line using minimal SPI writes.
+             * Draws a vertical line as a single span.
              *
              * @param x Axis on the horizontal scale to begin line
              * @param y Axis on the vertical scale to begin line
              * @param h Height of line in pixels
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
-            virtual void drawFastVLine(int16_t x, 
-                                       int16_t y, 
-                                       int16_t h, 
+            virtual void drawFastVLine(int16_t x,
+                                       int16_t y,
+                                       int16_t h,
                                        uint16_t color);
-            
+
             /**
-             * Draws a horizontal line using  minimal SPI writes.
+             * Draws a horizontal line as a single span.
              *
              * @param x Axis on the horizontal scale to begin line
              * @param y Axis on the vertical scale to begin line
              * @param w Width of line in pixels
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
-            virtual void drawFastHLine(int16_t x, 
-                                       int16_t y, 
-                                       int16_t w, 
+            virtual void drawFastHLine(int16_t x,
+                                       int16_t y,
+                                       int16_t w,
                                        uint16_t color);
-    
+
             /**
              * Draws a rectangle (not filled).
              *
@@ -97,43 +137,28 @@ namespace upm
              * @param y Position of upper left corner on vertical axis
              * @param w Width of rectangle
              * @param h Height of rectangle
-             * @color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
-             */
-            virtual void drawRect(int16_t x, 
-                                  int16_t y, 
-                                  int16_t w, 
-                                  int16_t h, 
-                                  uint16_t color);
-                                 
-            /**
-             * Draw a filled rectangle.
-             *
-             * @param x Axis on the horizontal scale of upper-left corner
-             * @param y Axis on the vertical scale of upper-left corner
-             * @param w Width of rectangle in pixels
-             * @param h Height of rectangle in pixels
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
-             */ 
-            virtual void fillRect(int16_t x, 
-                                  int16_t y, 
-                                  int16_t w, 
-                                  int16_t h, 
+             */
+            virtual void drawRect(int16_t x,
+                                  int16_t y,
+                                  int16_t w,
+                                  int16_t h,
                                   uint16_t color);
-    
+
             /**
              * Fill the screen with a single color.
              *
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
             virtual void fillScreen(uint16_t color);
-    
+
             /**
              * Invert colors on the display.
              *
              * @param i True or false to invert colors
              */
             virtual void invertDisplay(bool i);
-            
+
             /**
              * Draw a circle outline.
              *
@@ -143,7 +168,7 @@ namespace upm
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
             void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
-            
+
             /**
              * Used to draw rounded corners.
              *
@@ -153,9 +178,9 @@ namespace upm
              * @param cornername Mask of corner number (1, 2, 4, 8)
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
-            void drawCircleHelper(int16_t x0, 
-                                  int16_t y0, 
-                                  int16_t r, 
+            void drawCircleHelper(int16_t x0,
+                                  int16_t y0,
+                                  int16_t r,
                                   uint8_t cornername,
                                   uint16_t color);
 
@@ -166,9 +191,9 @@ namespace upm
              * @param y0 Center point of circle on y-axis
              * @param r Radius of circle
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
-             */    
+             */
             void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
-    
+
             /**
              * Used to draw a filled circle and rounded rectangles.
              *
@@ -179,13 +204,13 @@ namespace upm
              * @param delta Line offset
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
-            void fillCircleHelper(int16_t x0, 
-                                  int16_t y0, 
-                                  int16_t r, 
+            void fillCircleHelper(int16_t x0,
+                                  int16_t y0,
+                                  int16_t r,
                                   uint8_t cornername,
                                   int16_t delta,
                                   uint16_t color);
-                                  
+
             /**
              * Draw a triangle.
              *
@@ -197,14 +222,14 @@ namespace upm
              * @param y2 Third point coordinate on y-axis
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
-            void drawTriangle(int16_t x0, 
-                              int16_t y0, 
-                              int16_t x1, 
+            void drawTriangle(int16_t x0,
+                              int16_t y0,
+                              int16_t x1,
                               int16_t y1,
-                              int16_t x2, 
-                              int16_t y2, 
+                              int16_t x2,
+                              int16_t y2,
                               uint16_t color);
-                              
+
             /**
              * Draw a filled triangle.
              *
@@ -234,13 +259,13 @@ namespace upm
              * @param radius Radius of rounded corners
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
-            void drawRoundRect(int16_t x0, 
-                               int16_t y0, 
-                               int16_t w, 
+            void drawRoundRect(int16_t x0,
+                               int16_t y0,
+                               int16_t w,
                                int16_t h,
-                               int16_t radius, 
+                               int16_t radius,
                                uint16_t color);
-                               
+
             /**
              * Draw a filled rectangle with rounded corners
              *
@@ -251,15 +276,57 @@ namespace upm
              * @param radius Radius of rounded corners
              * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
-            void fillRoundRect(int16_t x0, 
-                               int16_t y0, 
-                               int16_t w, 
+            void fillRoundRect(int16_t x0,
+                               int16_t y0,
+                               int16_t w,
                                int16_t h,
-                               int16_t radius, 
+                               int16_t radius,
                                uint16_t color);
-                               
+
+            /**
+             * Draw a 1-bit bitmap with a background color. Each row of
+             * the bitmap starts on a byte boundary, most significant bit
+             * first. The whole bitmap is sent as a single block.
+             *
+             * @param x X-axis coordinate of the top-left corner
+             * @param y Y-axis coordinate of the top-left corner
+             * @param bitmap Bitmap data, (w + 7) / 8 * h bytes
+             * @param w Width of the bitmap in pixels
+             * @param h Height of the bitmap in pixels
+             * @param color Color of the set bits (16-bit RGB)
+             * @param bg Color of the clear bits (16-bit RGB)
+             */
+            void drawBitmap(int16_t x,
+                            int16_t y,
+                            const uint8_t *bitmap,
+                            int16_t w,
+                            int16_t h,
+                            uint16_t color,
+                            uint16_t bg);
+
             /**
-             * Draw a character at the specified point.
+             * Draw a 1-bit bitmap, leaving the clear bits untouched. Each
+             * row of the bitmap starts on a byte boundary, most
+             * significant bit first. Runs of set bits are drawn as spans.
+             *
+             * @param x X-axis coordinate of the top-left corner
+             * @param y Y-axis coordinate of the top-left corner
+             * @param bitmap Bitmap data, (w + 7) / 8 * h bytes
+             * @param w Width of the bitmap in pixels
+             * @param h Height of the bitmap in pixels
+             * @param color Color of the set bits (16-bit RGB)
+             */
+            void drawBitmap(int16_t x,
+                            int16_t y,
+                            const uint8_t *bitmap,
+                            int16_t w,
+                            int16_t h,
+                            uint16_t color);
+
+            /**
+             * Draw a character at the specified point. With a background
+             * color the glyph is sent as a single block, without one
+             * (bg == color) each glyph row is drawn as spans.
              *
              * @param x X-axis coordinate of the top-left corner
              * @param y Y-axis coordinate of the top-left corner
@@ -268,27 +335,27 @@ namespace upm
              * @param bg Background color (16-bit RGB)
              * @param size Font size
              */
-            void drawChar(int16_t x, 
-                          int16_t y, 
-                          unsigned char c, 
+            void drawChar(int16_t x,
+                          int16_t y,
+                          unsigned char c,
                           uint16_t color,
-                          uint16_t bg, 
+                          uint16_t bg,
                           uint8_t size);
-            
+
             /**
              * Get the x-axis coordinate of the upper-left corner of the cursor.
              *
              * @return X-axis coordinate of the cursor
              */
             int16_t getCursorX(void) const;
-            
+
             /**
              * Get the y-axis coordinate of the upper-left corner of the cursor.
              *
              * @return Y-axis coordinate of the cursor
              */
             int16_t getCursorY(void) const;
-             
+
             /**
              * Set the cursor for writing text.
              *
@@ -296,14 +363,14 @@ namespace upm
              * @param y Y-axis coordinate of the top-left corner of the cursor
              */
             void setCursor(int16_t x, int16_t y);
-             
+
             /**
              * Set the color for text.
              *
              * @param c RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
              */
             void setTextColor(uint16_t c);
-            
+
             /**
              * Set the color for text and text background (highlight).
              *
@@ -311,28 +378,28 @@ namespace upm
              * @param bg Background text color (RGB, 16-bit)
              */
             void setTextColor(uint16_t c, uint16_t bg);
-            
+
             /**
              * Set the size of the text.
              *
              * @param s Font size (multiples of 8 pixel text height)
-             */ 
+             */
             void setTextSize(uint8_t s);
-            
+
             /**
              * Enable or disable text wrapping.
              *
              * @param w True to wrap text. False to truncate.
              */
             void setTextWrap(bool w);
-            
+
             /**
              * Get the current rotation configuration of the screen.
              *
              * @return current rotation 0-3
              */
             uint8_t getRotation(void) const;
-            
+
             /**
              * Sets the rotation of the screen. Can be overridden with another
              * screen-specific definition.
@@ -340,53 +407,68 @@ namespace upm
              * @param r Rotation 0-3
              */
             void setRotation(uint8_t r);
-                        
+
             /**
              * Enable (or disable) Code Page 437-compatible charset.
              *
              * @param x True to enable CP437 charset. False to disable.
              */
             void cp437(bool x);
-            
+
             /**
-             * Write a character at the current cursor position. Definition
-             * can be overridden with board-specific code.
+             * Write a character at the current cursor position.
              *
              * @param c Character to draw
              */
-            virtual void write(uint8_t c);
-            
+            void write(uint8_t c);
+
             /**
              * Prints a string to the screen.
              *
              * @param msg Message to print
              */
             void print(std::string msg);
-            
+
             /**
              * Get the current width of the screen.
              *
              * @return the width in pixels
              */
             int16_t width(void) const;
-            
+
             /**
              * Get the current height of the screen.
              *
              * @return the height in pixels
              */
             int16_t height(void) const;
-            
+
         protected:
-        
+
+            /**
+             * Clips a rectangle to the screen.
+             *
+             * @param x Left edge, moved onto the screen
+             * @param y Top edge, moved onto the screen
+             * @param w Width, reduced to what is on the screen
+             * @param h Height, reduced to what is on the screen
+             * @param skipX If not NULL, receives the number of columns cut
+             * from the left
+             * @param skipY If not NULL, receives the number of rows cut
+             * from the top
+             * @return false if nothing of the rectangle is on the screen
+             */
+            bool clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h,
+                          int16_t *skipX = NULL, int16_t *skipY = NULL) const;
+
             const int16_t WIDTH;
             const int16_t HEIGHT;
-            
+
             int16_t _width;
             int16_t _height;
-            
+
             uint8_t rotation;
-            
+
             uint16_t textcolor;
             uint16_t textbgcolor;
             int16_t cursor_x;
@@ -395,5 +477,12 @@ namespace upm
             bool wrap;
             bool _cp437;
             static const unsigned char font[];
+
+        private:
+            // Staging buffer for glyphs and bitmaps sent with pushColors
+            std::vector<uint16_t> m_block;
+
+            void circleSpans(int16_t x0, int16_t y0, int16_t x, int16_t y,
+                             int16_t n, uint8_t cornername, uint16_t color);
     };
-}     
+}
@@ -0,0 +1,16 @@
+%include "../common_top.i"
+
+/* BEGIN Java syntax  ------------------------------------------------------- */
+#ifdef SWIGJAVA
+%apply uint8_t *INPUT { const uint8_t *bitmap }
+
+JAVA_JNI_LOADLIBRARY(javaupm_gfx)
+#endif
+/* END Java syntax */
+
+/* BEGIN Common SWIG syntax ------------------------------------------------- */
+%{
+#include "gfx.hpp"
+%}
+%include "gfx.hpp"
+/* END Common SWIG syntax */
@@ -44,72 +44,26 @@ static float regs2float(uint16_t h, uint16_t l)
 
 H803X::H803X(std::string device, int address, int baud, int bits, char parity,
                int stopBits) :
-  m_mbContext(0)
+  m_address(address & 0xff), m_pollID(0)
 {
-  // check some of the parameters
-  if (!(bits == 7 || bits == 8))
-    {
-      throw std::out_of_range(std::string(__FUNCTION__)
-                              + ": bits must be 7 or 8");
-    }
-
-  if (!(parity == 'N' || parity == 'E' || parity == 'O'))
-    {
-      throw std::out_of_range(std::string(__FUNCTION__)
-                              + ": parity must be 'N', 'O', or 'E'");
-    }
-
-  if (!(stopBits == 1 || stopBits == 2))
-    {
-      throw std::out_of_range(std::string(__FUNCTION__)
-                              + ": stopBits must be 1 or 2");
-    }
-
-  // now, open/init the device and modbus context
-
-  if (!(m_mbContext = modbus_new_rtu(device.c_str(), baud, parity, bits,
-                                     stopBits)))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__)
-                               + ": modbus_new_rtu() failed");
-    }
-
-  // set the slave address of the device we want to talk to
-
-  // addresses are only 8bits wide
-  address &= 0xff;
-  if (modbus_set_slave(m_mbContext, address))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__)
-                               + ": modbus_set_slave() failed");
-    }
-
-  // set the serial mode
-  modbus_rtu_set_serial_mode(m_mbContext, MODBUS_RTU_RS232);
-
-  // now connect..
-  if (modbus_connect(m_mbContext))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__)
-                               + ": modbus_connect() failed");
-    }
+  // open (or share) the bus, this checks the line parameters
+  m_bus = MODBUSRTU::instance(device, baud, bits, parity, stopBits);
 
   // will set m_isH8036 appropriately
   testH8036();
 
   clearData();
 
+  setupPoll();
+
   // turn off debugging
   setDebug(false);
 }
 
 H803X::~H803X()
 {
-  if (m_mbContext)
-    {
-      modbus_close(m_mbContext);
-      modbus_free(m_mbContext);
-    }
+  if (m_pollID)
+    m_bus->removePoll(m_pollID);
 }
 
 int H803X::readHoldingRegs(HOLDING_REGS_T reg, int len, uint16_t *buf)
@@ -122,7 +76,8 @@ int H803X::readHoldingRegs(HOLDING_REGS_T reg, int len, uint16_t *buf)
 
   while (retries >= 0)
     {
-      if ((rv = modbus_read_registers(m_mbContext, reg, len, buf)) < 0)
+      if ((rv = m_bus->readRegs(m_address, MODBUSRTU::TABLE_HOLDING_REGS,
+                                reg, len, buf)) < 0)
         {
           if (errno == ETIMEDOUT)
             {
@@ -157,7 +112,7 @@ int H803X::readHoldingRegs(HOLDING_REGS_T reg, int len, uint16_t *buf)
 
 void H803X::writeHoldingReg(HOLDING_REGS_T reg, int value)
 {
-  if (modbus_write_register(m_mbContext, reg, value) != 1)
+  if (m_bus->writeReg(m_address, reg, value) != 1)
     {
       throw std::runtime_error(std::string(__FUNCTION__)
                                + ": modbus_write_register() failed: "
@@ -165,23 +120,60 @@ void H803X::writeHoldingReg(HOLDING_REGS_T reg, int value)
     }
 }
 
-void H803X::update()
+void H803X::setupPoll()
 {
   static const int h8035NumRegs = 4; // 2 regs * 2
   static const int h8036NumRegs = 52; // 26 regs * 2
 
+  if (m_pollID)
+    m_bus->removePoll(m_pollID);
+
   int numRegs = (isH8036() ? h8036NumRegs : h8035NumRegs);
 
-  uint16_t buf[numRegs];
+  m_pollID = m_bus->addPoll(m_address, MODBUSRTU::TABLE_HOLDING_REGS,
+                            HOLDING_CONSUMPTION_KWH, numRegs,
+                            [this](const uint16_t *buf, int len) {
+                              decodeRegs(buf, len);
+                            });
+}
+
+void H803X::update()
+{
+  int retries = 5;
+
+  // Sometimes it seems the device goes to sleep, and therefore a read
+  // will timeout, so we will retry up to 5 times.
 
-  // This should only fail (return -1) if we got isH8036() wrong
-  if (readHoldingRegs(HOLDING_CONSUMPTION_KWH, numRegs, buf) < 0)
+  while (m_bus->poll(m_address) < 0)
     {
-      throw std::out_of_range(std::string(__FUNCTION__) +
-                              ": readHoldingRegs() failed: "
-                               + modbus_strerror(errno));
+      if (errno == ETIMEDOUT && retries-- > 0)
+        {
+          sleep(1);
+        }
+      else if (errno == ETIMEDOUT)
+        {
+          throw std::runtime_error(std::string(__FUNCTION__)
+                                   + ": poll() timed out after "
+                                   + "5 retries");
+        }
+      else if (errno == EMBXILADD)
+        {
+          // This should only happen if we got isH8036() wrong
+          throw std::out_of_range(std::string(__FUNCTION__) +
+                                  ": poll() failed: "
+                                  + modbus_strerror(errno));
+        }
+      else
+        {
+          throw std::runtime_error(std::string(__FUNCTION__)
+                                   + ": poll() failed: "
+                                   + modbus_strerror(errno));
+        }
     }
+}
 
+void H803X::decodeRegs(const uint16_t *buf, int len)
+{
   // And so it begins...
 
   // H8035 / H8036
@@ -189,7 +181,7 @@ void H803X::update()
   m_realPowerkW                 = regs2float(buf[2], buf[3]);
   
   // H8036 only
-  if (isH8036())
+  if (len >= 52)
     {
       m_reactivePowerkVAR       = regs2float(buf[4], buf[5]);
       m_apparentPowerkVA        = regs2float(buf[6], buf[7]);
@@ -230,7 +222,7 @@ string H803X::getSlaveID()
   uint8_t id[MODBUS_MAX_PDU_LENGTH];
   int rv;
 
-  if ((rv = modbus_report_slave_id(m_mbContext, MODBUS_MAX_PDU_LENGTH, id)) < 0)
+  if ((rv = m_bus->reportSlaveID(m_address, MODBUS_MAX_PDU_LENGTH, id)) < 0)
     {
       throw std::runtime_error(std::string(__FUNCTION__)
                                + ": modbus_report_slave_id() failed: "
@@ -254,30 +246,23 @@ string H803X::getSlaveID()
 void H803X::setSlaveAddress(int addr)
 {
   // addresses are only 8bits wide
-  addr &= 0xff;
-
-  if (modbus_set_slave(m_mbContext, addr))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__)
-                               + ": modbus_set_slave() failed: "
-                               + modbus_strerror(errno));
-    }
+  m_address = addr & 0xff;
 
   // retest H8036
   testH8036();
 
   // clear out any previously stored data
   clearData();
+
+  // and poll the new address
+  setupPoll();
 }
 
 void H803X::setDebug(bool enable)
 {
   m_debugging = enable;
 
-  if (enable)
-    modbus_set_debug(m_mbContext, 1);
-  else
-    modbus_set_debug(m_mbContext, 0);
+  m_bus->setDebug(enable);
 }
 
 void H803X::clearData()
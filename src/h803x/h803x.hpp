@@ -10,9 +10,10 @@
  */
 #pragma once
 
+#include <memory>
 #include <string>
 
-#include <modbus/modbus.h>
+#include "modbusrtu.hpp"
 
 namespace upm {
 
@@ -57,6 +58,10 @@ namespace upm {
    * must use a full Serial RS232->RS485 or USB-RS485 interface
    * connected via USB.
    *
+   * Devices on the same serial port share one MODBUSRTU bus.  Besides
+   * update(), the values of every device on the bus can be refreshed
+   * together with MODBUSRTU::instance(device)->poll().
+   *
    * @snippet h803x.cxx Interesting
    */
 
@@ -136,7 +141,7 @@ namespace upm {
     /**
      * Read current values from the sensor and update internal stored
      * values.  This method must be called prior to querying any
-     * values.
+     * values, unless the bus is being polled instead.
      */
     void update();
 
@@ -485,9 +490,16 @@ namespace upm {
 
     // clear out all stored data
     void clearData();
-    
-    // MODBUS context
-    modbus_t *m_mbContext;
+
+    // (re)register our poll plan with the bus
+    void setupPoll();
+    // decode the polled data registers
+    void decodeRegs(const uint16_t *buf, int len);
+
+    // shared MODBUS bus
+    std::shared_ptr<MODBUSRTU> m_bus;
+    int m_address;
+    int m_pollID;
 
     // test to see if the connected device is an H8036, and set
     // m_isH8036 appropriately
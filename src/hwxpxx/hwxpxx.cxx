@@ -10,6 +10,7 @@
  */
 
 #include <unistd.h>
+#include <errno.h>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -33,59 +34,14 @@ static float c2f(float c)
 
 HWXPXX::HWXPXX(std::string device, int address, int baud, int bits, char parity,
                int stopBits) :
-  m_mbContext(0)
+  m_address(address & 0xff), m_inputPollID(0), m_coilPollID(0)
 {
-  // check some of the parameters
-  if (!(bits == 7 || bits == 8))
-    {
-      throw std::out_of_range(std::string(__FUNCTION__) +
-                              ": bits must be 7 or 8");
-    }
-
-  if (!(parity == 'N' || parity == 'E' || parity == 'O'))
-    {
-      throw std::out_of_range(std::string(__FUNCTION__) +
-                              ": parity must be 'N', 'O', or 'E'");
-    }
-
-  if (!(stopBits == 1 || stopBits == 2))
-    {
-      throw std::out_of_range(std::string(__FUNCTION__) +
-                              ": stopBits must be 1 or 2");
-    }
-
   m_temperature = 0.0;
   m_humidity = 0.0;
   m_slider = 0;
 
-  // now, open/init the device and modbus context
-
-  if (!(m_mbContext = modbus_new_rtu(device.c_str(), baud, parity, bits,
-                                     stopBits)))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": modbus_new_rtu() failed");
-    }
-
-  // set the slave address of the device we want to talk to
-
-  // addresses are only 8bits wide
-  address &= 0xff;
-  if (modbus_set_slave(m_mbContext, address))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": modbus_set_slave() failed");
-    }
-
-  // set the serial mode
-  modbus_rtu_set_serial_mode(m_mbContext, MODBUS_RTU_RS232);
-
-  // now connect..
-  if (modbus_connect(m_mbContext))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": modbus_connect() failed");
-    }
+  // open (or share) the bus, this checks the line parameters
+  m_bus = MODBUSRTU::instance(device, baud, bits, parity, stopBits);
 
   // read the 2 coils to determine temperature scale and current status
   // of (optional) override switch
@@ -101,24 +57,26 @@ HWXPXX::HWXPXX(std::string device, int address, int baud, int bits, char parity,
   // current override switch status
   m_override = ((coils[1]) ? true : false);
 
+  setupPoll();
+
   // turn off debugging
   setDebug(false);
 }
 
 HWXPXX::~HWXPXX()
 {
-  if (m_mbContext)
-    {
-      modbus_close(m_mbContext);
-      modbus_free(m_mbContext);
-    }
+  if (m_inputPollID)
+    m_bus->removePoll(m_inputPollID);
+  if (m_coilPollID)
+    m_bus->removePoll(m_coilPollID);
 }
 
 int HWXPXX::readInputRegs(INPUT_REGS_T reg, int len, uint16_t *buf)
 {
   int rv;
 
-  if ((rv = modbus_read_input_registers(m_mbContext, reg, len, buf)) < 0)
+  if ((rv = m_bus->readRegs(m_address, MODBUSRTU::TABLE_INPUT_REGS, reg, len,
+                            buf)) < 0)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
                                ": modbus_read_input_registers() failed");
@@ -144,7 +102,8 @@ int HWXPXX::readHoldingRegs(HOLDING_REGS_T reg, int len, uint16_t *buf)
 {
   int rv;
 
-  if ((rv = modbus_read_registers(m_mbContext, reg, len, buf)) < 0)
+  if ((rv = m_bus->readRegs(m_address, MODBUSRTU::TABLE_HOLDING_REGS, reg,
+                            len, buf)) < 0)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
                                ": modbus_read_registers() failed");
@@ -168,7 +127,7 @@ uint16_t HWXPXX::readHoldingReg(HOLDING_REGS_T reg)
 
 void HWXPXX::writeHoldingReg(HOLDING_REGS_T reg, int value)
 {
-  if (modbus_write_register(m_mbContext, reg, value) != 1)
+  if (m_bus->writeReg(m_address, reg, value) != 1)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
                                ": modbus_write_register() failed");
@@ -177,14 +136,19 @@ void HWXPXX::writeHoldingReg(HOLDING_REGS_T reg, int value)
 
 int HWXPXX::readCoils(COIL_REGS_T reg, int numBits, uint8_t *buf)
 {
+  uint16_t bits[numBits];
   int rv;
 
-  if ((rv = modbus_read_bits(m_mbContext, reg, numBits, buf)) < 0)
+  if ((rv = m_bus->readRegs(m_address, MODBUSRTU::TABLE_COILS, reg, numBits,
+                            bits)) < 0)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
                                ": modbus_read_bits() failed");
     }
 
+  for (int i = 0; i < rv; i++)
+    buf[i] = uint8_t(bits[i]);
+
   return rv;
 }
 
@@ -203,27 +167,49 @@ bool HWXPXX::readCoil(COIL_REGS_T reg)
 
 void HWXPXX::writeCoil(COIL_REGS_T reg, bool val)
 {
-  int value = (val) ? TRUE : FALSE;
-
-  if (modbus_write_bit(m_mbContext, reg, value) != 1)
+  if (m_bus->writeCoil(m_address, reg, val) != 1)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
                                ": modbus_write_bit() failed");
     }
 }
 
-void HWXPXX::update()
+void HWXPXX::setupPoll()
 {
-  static const int dataLen = 3;
-  uint16_t data[dataLen];
+  if (m_inputPollID)
+    m_bus->removePoll(m_inputPollID);
+  if (m_coilPollID)
+    m_bus->removePoll(m_coilPollID);
+
+  // the 3 input registers starting at humidity
+  m_inputPollID = m_bus->addPoll(m_address, MODBUSRTU::TABLE_INPUT_REGS,
+                                 INPUT_HUMIDITY, 3,
+                                 [this](const uint16_t *buf, int len) {
+                                   decodeInputs(buf, len);
+                                 });
+
+  // both coils, the temperature scale and the override switch.  Coils
+  // are polled before the input registers, so the scale is current
+  // when the temperature is decoded.
+  m_coilPollID = m_bus->addPoll(m_address, MODBUSRTU::TABLE_COILS,
+                                COIL_TEMP_SCALE, 2,
+                                [this](const uint16_t *buf, int len) {
+                                  decodeCoils(buf, len);
+                                });
+}
 
-  // we read 3 input registers starting at humidity
-  if (readInputRegs(INPUT_HUMIDITY, dataLen, data) != dataLen)
+void HWXPXX::update()
+{
+  if (m_bus->poll(m_address) < 0)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": readInputRegs() failed to read 3 registers");
+                               ": poll() failed: "
+                               + modbus_strerror(errno));
     }
+}
 
+void HWXPXX::decodeInputs(const uint16_t *data, int len)
+{
   // humidity
   m_humidity = float((int16_t)data[0]) / 10.0;
 
@@ -237,9 +223,18 @@ void HWXPXX::update()
 
   // optional slider level
   m_slider = int(data[2]);
+}
+
+void HWXPXX::decodeCoils(const uint16_t *data, int len)
+{
+  // temp scale
+  if (data[0])
+    m_isCelsius = false;
+  else
+    m_isCelsius = true;
 
   // optional override switch status
-  m_override = readCoil(COIL_OVERRIDE);
+  m_override = ((data[1]) ? true : false);
 }
 
 float HWXPXX::getTemperature(bool fahrenheit)
@@ -323,7 +318,7 @@ string HWXPXX::getSlaveID()
   uint8_t id[MODBUS_MAX_PDU_LENGTH];
   int rv;
 
-  if ((rv = modbus_report_slave_id(m_mbContext, MODBUS_MAX_PDU_LENGTH, id)) < 0)
+  if ((rv = m_bus->reportSlaveID(m_address, MODBUS_MAX_PDU_LENGTH, id)) < 0)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
                                ": modbus_report_slave_id() failed");
@@ -345,27 +340,21 @@ string HWXPXX::getSlaveID()
 void HWXPXX::setSlaveAddress(int addr)
 {
   // addresses are only 8bits wide
-  addr &= 0xff;
-
-  if (modbus_set_slave(m_mbContext, addr))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": modbus_set_slave() failed");
-    }
+  m_address = addr & 0xff;
 
   // now re-read and set m_isCelsius properly
   if (readCoil(COIL_TEMP_SCALE))
     m_isCelsius = false;
   else
     m_isCelsius = true;
+
+  // and poll the new address
+  setupPoll();
 }
 
 void HWXPXX::setDebug(bool enable)
 {
   m_debugging = enable;
 
-  if (enable)
-    modbus_set_debug(m_mbContext, 1);
-  else
-    modbus_set_debug(m_mbContext, 0);
+  m_bus->setDebug(enable);
 }
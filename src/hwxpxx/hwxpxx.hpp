@@ -12,7 +12,9 @@
 
 #include <string>
 
-#include <modbus/modbus.h>
+#include <memory>
+
+#include "modbusrtu.hpp"
 #include <interfaces/iHumidity.hpp>
 #include <interfaces/iTemperature.hpp>
 
@@ -50,6 +52,10 @@ namespace upm {
    * the built in MCU TTL UART pins for accessing this device -- you
    * must use a full serial RS232->RS485 interface connected via USB.
    *
+   * Devices on the same serial port share one MODBUSRTU bus.  Besides
+   * update(), the values of every device on the bus can be refreshed
+   * together with MODBUSRTU::instance(device)->poll().
+   *
    * @snippet hwxpxx.cxx Interesting
    */
 
@@ -264,8 +270,17 @@ namespace upm {
     uint16_t readHoldingReg(HOLDING_REGS_T reg);
     void writeHoldingReg(HOLDING_REGS_T reg, int value);
 
-    // MODBUS context
-    modbus_t *m_mbContext;
+    // (re)register our poll plans with the bus
+    void setupPoll();
+    // decode the polled registers and coils
+    void decodeInputs(const uint16_t *buf, int len);
+    void decodeCoils(const uint16_t *buf, int len);
+
+    // shared MODBUS bus
+    std::shared_ptr<MODBUSRTU> m_bus;
+    int m_address;
+    int m_inputPollID;
+    int m_coilPollID;
 
     // is the device reporting in C or F?
     bool m_isCelsius;
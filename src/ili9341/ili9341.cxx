@@ -19,14 +19,25 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
 
 #include "ili9341.hpp"
 
 using namespace upm;
 
+// Color in SPI byte order (high byte first), as held in the framebuffer
+static inline uint16_t wireColor(uint16_t color) {
+    uint8_t bytes[2] = { (uint8_t)(color >> 8), (uint8_t)color };
+    uint16_t wire;
+    memcpy(&wire, bytes, sizeof(wire));
+    return wire;
+}
+
 ILI9341::ILI9341(int csLCD, int csSD, int dc, int rst) :
     GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT), m_csLCDPinCtx(csLCD), 
-    m_csSDPinCtx(csSD), m_dcPinCtx(dc), m_rstPinCtx(rst), m_spi(0) {
+    m_csSDPinCtx(csSD), m_dcPinCtx(dc), m_rstPinCtx(rst), m_spi(0),
+    m_useFramebuffer(false), m_shownValid(false), m_burst(ILI9341_BURST),
+    m_dirtyX0(0), m_dirtyY0(0), m_dirtyX1(-1), m_dirtyY1(-1) {
     
     initModule();
     configModule();
@@ -89,6 +100,12 @@ void ILI9341::setRotation(uint8_t r) {
         _height = ILI9341_TFTWIDTH;
         break;
     }
+
+    // The framebuffer keeps its pixels, laid out for the new dimensions
+    if (m_useFramebuffer) {
+        m_shownValid = false;
+        markDirty(0, 0, _width - 1, _height - 1);
+    }
 }
 
 void ILI9341::configModule() {
@@ -215,17 +232,27 @@ void ILI9341::setAddrWindow(uint16_t x0,
                             uint16_t x1, 
                             uint16_t y1) {
     
+    uint8_t data[4];
+
     writecommand(ILI9341_CASET); // Column addr set
-    writedata(x0 >> 8);
-    writedata(x0 & 0xFF);     // XSTART 
-    writedata(x1 >> 8);
-    writedata(x1 & 0xFF);     // XEND
+    data[0] = x0 >> 8;
+    data[1] = x0 & 0xFF;     // XSTART 
+    data[2] = x1 >> 8;
+    data[3] = x1 & 0xFF;     // XEND
+    lcdCSOn();
+    dcHigh();
+    writeBurst(data, 4);
+    lcdCSOff();
     
     writecommand(ILI9341_PASET); // Row addr set
-    writedata(y0>>8);
-    writedata(y0);     // YSTART
-    writedata(y1>>8);
-    writedata(y1);     // YEND
+    data[0] = y0 >> 8;
+    data[1] = y0;     // YSTART
+    data[2] = y1 >> 8;
+    data[3] = y1;     // YEND
+    lcdCSOn();
+    dcHigh();
+    writeBurst(data, 4);
+    lcdCSOff();
 
     writecommand(ILI9341_RAMWR); // write to RAM
 }
@@ -235,100 +262,84 @@ void ILI9341::drawPixel(int16_t x, int16_t y, uint16_t color) {
     if((x < 0) ||(x >= _width) || (y < 0) || (y >= _height)) {
         return;
     }
-    
-    setAddrWindow(x, y, x + 1, y + 1);
-    
-    writedata(color >> 8);
-    writedata(color);
-}
-
-void ILI9341::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
 
-    // Rudimentary clipping
-    if((x >= _width) || (y >= _height)) {
+    if (m_useFramebuffer) {
+        m_frame[y * _width + x] = wireColor(color);
+        markDirty(x, y, x, y);
         return;
     }
     
-    if((y+h-1) >= _height) {
-        h = _height-y;
-    }
-
-    setAddrWindow(x, y, x, y+h-1);
-
-    uint8_t hi = color >> 8;
-    uint8_t lo = color;
+    setAddrWindow(x, y, x, y);
     
+    uint8_t data[2] = { (uint8_t)(color >> 8), (uint8_t)color };
     lcdCSOn();
     dcHigh();
-
-    while (h--) {
-        m_spi.writeByte(hi);
-        m_spi.writeByte(lo);
-    }
-
+    writeBurst(data, 2);
     lcdCSOff();
 }
 
-void ILI9341::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+void ILI9341::fillRect(int16_t x, 
+                       int16_t y, 
+                       int16_t w, 
+                       int16_t h,
+                       uint16_t color) {
+                       
+    // clipping (drawChar w/big text requires this)
+    if (!clipRect(x, y, w, h)) return;
 
-    // Rudimentary clipping
-    if((x >= _width) || (y >= _height)) {
+    if (m_useFramebuffer) {
+        frameFill(x, y, w, h, color);
         return;
     }
 
-    if((x+w-1) >= _width) {
-        w = _width - x;
-    }
-
-    setAddrWindow(x, y, x+w-1, y);
-
-    uint8_t hi = color >> 8;
-    uint8_t lo = color;
+    setAddrWindow(x, y, x+w-1, y+h-1);
 
     lcdCSOn();
     dcHigh();
-
-    while (w--) {
-        m_spi.writeByte(hi);
-        m_spi.writeByte(lo);
-    }
-
+    writePixels(color, (uint32_t)w * h);
     lcdCSOff();
 }
 
-void ILI9341::fillRect(int16_t x, 
-                       int16_t y, 
-                       int16_t w, 
-                       int16_t h,
-                       uint16_t color) {
-                       
-    // rudimentary clipping (drawChar w/big text requires this)
-    if((x >= _width) || (y >= _height)) return;
-    if((x + w - 1) >= _width)  w = _width  - x;
-    if((y + h - 1) >= _height) h = _height - y;
+void ILI9341::pushColors(int16_t x,
+                         int16_t y,
+                         int16_t w,
+                         int16_t h,
+                         const uint16_t *colors) {
+    int16_t stride = w, skipX, skipY;
+    if (!clipRect(x, y, w, h, &skipX, &skipY)) return;
+    colors += skipY * stride + skipX;
+
+    if (m_useFramebuffer) {
+        for (int16_t row = 0; row < h; row++, colors += stride) {
+            uint16_t *pixel = &m_frame[(y + row) * _width + x];
+            std::transform(colors, colors + w, pixel, wireColor);
+        }
+        markDirty(x, y, x + w - 1, y + h - 1);
+        return;
+    }
 
     setAddrWindow(x, y, x+w-1, y+h-1);
 
-    uint8_t hi = color >> 8;
-    uint8_t lo = color;
-  
     lcdCSOn();
     dcHigh();
 
-    for(y = h; y > 0; y--) {
-        for(x = w; x > 0; x--) {
-            m_spi.writeByte(hi);
-            m_spi.writeByte(lo);
+    // Pack the rows into bursts in SPI byte order
+    int fill = 0;
+    for (int16_t row = 0; row < h; row++, colors += stride) {
+        for (int16_t i = 0; i < w; i++) {
+            if (fill == ILI9341_BURST) {
+                writeBurst(m_burst.data(), fill);
+                fill = 0;
+            }
+            m_burst[fill++] = colors[i] >> 8;
+            m_burst[fill++] = colors[i];
         }
     }
+    writeBurst(m_burst.data(), fill);
 
     lcdCSOff();
 }
 
-void ILI9341::fillScreen(uint16_t color) {
-    fillRect(0, 0,  _width, _height, color);
-}
-
 void ILI9341::invertDisplay(bool i) {
     writecommand(i ? ILI9341_INVON : ILI9341_INVOFF);
 }
@@ -361,6 +372,161 @@ void ILI9341::executeCMDList(const uint8_t *addr) {
     }
 }
 
+void ILI9341::useFramebuffer(bool enable) {
+    if (enable && !m_useFramebuffer) {
+        m_frame.assign(ILI9341_TFTWIDTH * ILI9341_TFTHEIGHT, 0);
+        m_shown.assign(m_frame.size(), 0);
+        m_shownValid = false;
+        markDirty(0, 0, _width - 1, _height - 1);
+    } else if (!enable) {
+        std::vector<uint16_t>().swap(m_frame);
+        std::vector<uint16_t>().swap(m_shown);
+        m_dirtyX0 = 0;
+        m_dirtyX1 = -1;
+    }
+
+    m_useFramebuffer = enable;
+}
+
+void ILI9341::flush() {
+    if (!m_useFramebuffer || (m_dirtyX0 > m_dirtyX1)) {
+        return;
+    }
+
+    int16_t x0 = m_dirtyX0, x1 = m_dirtyX1;
+    int16_t bandY0 = -1, bandX0 = x1, bandX1 = x0;
+
+    // Group consecutive changed rows into bands, each band is sent as a
+    // single window covering the columns that changed in it
+    for (int16_t y = m_dirtyY0; y <= m_dirtyY1; y++) {
+        const uint16_t *frame = &m_frame[y * _width];
+        const uint16_t *shown = &m_shown[y * _width];
+
+        int16_t first = x0, last = x1;
+        if (m_shownValid) {
+            while ((first <= x1) && (frame[first] == shown[first])) first++;
+            while ((last > first) && (frame[last] == shown[last])) last--;
+        }
+
+        if (first > x1) {
+            if (bandY0 >= 0) {
+                flushRegion(bandX0, bandY0, bandX1, y - 1);
+                bandY0 = -1;
+            }
+            continue;
+        }
+
+        if (bandY0 < 0) {
+            bandY0 = y;
+            bandX0 = first;
+            bandX1 = last;
+        } else {
+            bandX0 = std::min(bandX0, first);
+            bandX1 = std::max(bandX1, last);
+        }
+    }
+
+    if (bandY0 >= 0) {
+        flushRegion(bandX0, bandY0, bandX1, m_dirtyY1);
+    }
+
+    m_shownValid = true;
+    m_dirtyX0 = 0;
+    m_dirtyX1 = -1;
+}
+
+void ILI9341::markDirty(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    if (m_dirtyX0 > m_dirtyX1) {
+        m_dirtyX0 = x0;
+        m_dirtyY0 = y0;
+        m_dirtyX1 = x1;
+        m_dirtyY1 = y1;
+        return;
+    }
+
+    m_dirtyX0 = std::min(m_dirtyX0, x0);
+    m_dirtyY0 = std::min(m_dirtyY0, y0);
+    m_dirtyX1 = std::max(m_dirtyX1, x1);
+    m_dirtyY1 = std::max(m_dirtyY1, y1);
+}
+
+void ILI9341::frameFill(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color) {
+    uint16_t wire = wireColor(color);
+
+    for (int16_t row = 0; row < h; row++) {
+        uint16_t *pixel = &m_frame[(y + row) * _width + x];
+        std::fill(pixel, pixel + w, wire);
+    }
+
+    markDirty(x, y, x + w - 1, y + h - 1);
+}
+
+void ILI9341::writePixels(uint16_t color, uint32_t count) {
+    uint32_t chunk = std::min<uint32_t>(count, ILI9341_BURST / 2);
+    for (uint32_t i = 0; i < chunk; i++) {
+        m_burst[i * 2] = color >> 8;
+        m_burst[i * 2 + 1] = color;
+    }
+
+    while (count) {
+        uint32_t n = std::min(count, chunk);
+        writeBurst(m_burst.data(), n * 2);
+        count -= n;
+    }
+}
+
+void ILI9341::writeBurst(const uint8_t *data, int len) {
+    while (len > 0) {
+        int n = std::min(len, ILI9341_BURST);
+        mraa::Result error = m_spi.transfer(const_cast<uint8_t *>(data),
+                                            NULL, n);
+        if (error != mraa::SUCCESS) {
+            mraa::printError(error);
+        }
+        data += n;
+        len -= n;
+    }
+}
+
+void ILI9341::flushRegion(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    int rowPixels = x1 - x0 + 1;
+    int rowBytes = rowPixels * 2;
+
+    setAddrWindow(x0, y0, x1, y1);
+
+    lcdCSOn();
+    dcHigh();
+
+    // Pack the rows of the window into bursts, full width rows are
+    // contiguous in the framebuffer and sent in place
+    int fill = 0;
+    for (int16_t y = y0; y <= y1; y++) {
+        const uint16_t *row = &m_frame[y * _width + x0];
+        std::copy(row, row + rowPixels, &m_shown[y * _width + x0]);
+
+        if (rowPixels == _width) {
+            continue;
+        }
+
+        if (fill + rowBytes > ILI9341_BURST) {
+            writeBurst(m_burst.data(), fill);
+            fill = 0;
+        }
+        memcpy(&m_burst[fill], row, rowBytes);
+        fill += rowBytes;
+    }
+
+    if (rowPixels == _width) {
+        writeBurst((const uint8_t *)&m_frame[y0 * _width],
+                   rowBytes * (y1 - y0 + 1));
+    } else if (fill) {
+        writeBurst(m_burst.data(), fill);
+    }
+
+    lcdCSOff();
+}
+
 void ILI9341::writecommand(uint8_t c) {
     lcdCSOn();
     dcLow();
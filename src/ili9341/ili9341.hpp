@@ -16,10 +16,11 @@
 
 // Includes
 #include <string>
+#include <vector>
 #include <mraa/common.hpp>
 #include <mraa/gpio.hpp>
 #include <mraa/spi.hpp>
-#include "ili9341_gfx.hpp"
+#include "gfx.hpp"
 
 // Defines
 #define ILI9341_TFTWIDTH    240
@@ -27,6 +28,9 @@
 
 #define SPI_FREQ            15000000
 
+// Largest single SPI transfer (spidev default buffer size)
+#define ILI9341_BURST       4096
+
 #define ILI9341_NOP         0x00
 #define ILI9341_SWRESET     0x01
 #define ILI9341_RDDID       0x04
@@ -189,26 +193,6 @@ namespace upm {
              */
             void drawPixel(int16_t x, int16_t y, uint16_t color);
 
-            /**
-             * Draws a vertical line using minimal SPI writes.
-             *
-             * @param x Axis on the horizontal scale to begin line
-             * @param y Axis on the vertical scale to begin line
-             * @param h Height of line in pixels
-             * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
-             */
-            void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
-
-            /**
-             * Draws a horizontal line using  minimal SPI writes.
-             *
-             * @param x Axis on the horizontal scale to begin line
-             * @param y Axis on the vertical scale to begin line
-             * @param w Width of line in pixels
-             * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
-             */
-            void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
-
             /**
              * Draw a filled rectangle.
              *
@@ -225,14 +209,46 @@ namespace upm {
                           uint16_t color);
 
             /**
-             * Fill the screen with a single color.
+             * Draw a block of pixels. In direct mode the block is sent as
+             * a single window.
              *
-             * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15]
+             * @param x Axis on the horizontal scale of upper-left corner
+             * @param y Axis on the vertical scale of upper-left corner
+             * @param w Width of the block in pixels
+             * @param h Height of the block in pixels
+             * @param colors w * h RGB (16-bit) colors, row by row
              */
-            void fillScreen(uint16_t color);
+            void pushColors(int16_t x,
+                            int16_t y,
+                            int16_t w,
+                            int16_t h,
+                            const uint16_t *colors);
+
+            /**
+             * Enables or disables the off-screen framebuffer. While it is
+             * enabled, drawing only updates the framebuffer (RGB565) and
+             * flush() sends the regions that changed to the display.
+             *
+             * A second buffer holds what the display currently shows, so
+             * redrawing pixels with the same color costs no SPI traffic.
+             * Enabling the framebuffer starts from a black screen.
+             *
+             * @param enable True to draw to the framebuffer, false to draw
+             * to the display directly
+             */
+            void useFramebuffer(bool enable);
+
+            /**
+             * Sends the regions of the framebuffer that changed since the
+             * last flush to the display, in as few SPI bursts as possible.
+             * Does nothing unless the framebuffer is enabled.
+             */
+            void flush();
 
             /**
              * Sets the screen to one of four 90 deg rotations.
+             * The framebuffer contents are kept and sent again in full
+             * on the next flush.
              *
              * @param r Rotation setting: 0, 1, 2, 3
              */
@@ -325,6 +341,29 @@ namespace upm {
             mraa::Spi   m_spi;
 
             std::string m_name;
+
+            bool        m_useFramebuffer;
+            // False when the display contents are unknown
+            bool        m_shownValid;
+            // Framebuffer and what the display shows, pixels in SPI byte
+            // order so that rows can be sent as they are
+            std::vector<uint16_t> m_frame;
+            std::vector<uint16_t> m_shown;
+            // Staging buffer for SPI bursts
+            std::vector<uint8_t> m_burst;
+
+            // Region drawn since the last flush, empty when x0 > x1
+            int16_t     m_dirtyX0;
+            int16_t     m_dirtyY0;
+            int16_t     m_dirtyX1;
+            int16_t     m_dirtyY1;
+
+            void markDirty(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+            void frameFill(int16_t x, int16_t y, int16_t w, int16_t h,
+                           uint16_t color);
+            void writePixels(uint16_t color, uint32_t count);
+            void writeBurst(const uint8_t *data, int len);
+            void flushRegion(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
     };
 }
 
@@ -10,9 +10,9 @@ JAVA_JNI_LOADLIBRARY(javaupm_ili9341)
 
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
 %{
-#include "ili9341_gfx.hpp"
+#include "gfx.hpp"
 #include "ili9341.hpp"
 %}
-%include "ili9341_gfx.hpp"
+%include "gfx.hpp"
 %include "ili9341.hpp"
 /* END Common SWIG syntax */
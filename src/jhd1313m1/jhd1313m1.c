@@ -22,6 +22,14 @@
 #include "jhd1313m1.h"
 #include "hd44780_bits.h"
 
+// unchanged characters a render run may span, rather than starting a
+// new I2C write.  A new write with a cursor move costs four bytes.
+#define RENDER_MAX_GAP 4
+
+// bus bytes needed to send a byte through jhd1313m1_data() or
+// jhd1313m1_command(): address, control and data
+#define SINGLE_BYTE_COST 3
+
 jhd1313m1_context jhd1313m1_init(int bus, int lcd_addr, int rgb_addr)
 {
     jhd1313m1_context dev =
@@ -32,6 +40,8 @@ jhd1313m1_context jhd1313m1_init(int bus, int lcd_addr, int rgb_addr)
 
     memset((void *)dev, 0, sizeof(struct _jhd1313m1_context));
 
+    dev->cursorAddr = -1;
+
     // make sure MRAA is initialized
     int mraa_rv;
     if ((mraa_rv = mraa_init()) != MRAA_SUCCESS)
@@ -106,8 +116,8 @@ jhd1313m1_context jhd1313m1_init(int bus, int lcd_addr, int rgb_addr)
     jhd1313m1_clear(dev);
     upm_delay_us(2000);
 
-    jhd1313m1_command(dev, HD44780_ENTRYMODESET | HD44780_ENTRYLEFT
-                      | HD44780_ENTRYSHIFTDECREMENT);
+    dev->entryDisplayMode = HD44780_ENTRYLEFT | HD44780_ENTRYSHIFTDECREMENT;
+    jhd1313m1_command(dev, HD44780_ENTRYMODESET | dev->entryDisplayMode);
 
     jhd1313m1_backlight_on(dev, true);
     // full white
@@ -164,12 +174,123 @@ upm_result_t jhd1313m1_write(const jhd1313m1_context dev, char *buffer,
     return error;
 }
 
+upm_result_t jhd1313m1_render(const jhd1313m1_context dev, const char *frame)
+{
+    assert(dev != NULL);
+
+    // runs only carry on through DDRAM when entering left to right
+    // without autoscroll, otherwise every character needs a cursor
+    // move
+    bool contiguous = (dev->entryDisplayMode == HD44780_ENTRYLEFT);
+    bool full = !dev->shadowValid;
+
+    // cursor move, data control byte and a full row
+    uint8_t buf[3 + JHD1313M1_COLUMNS];
+
+    upm_result_t rv = UPM_SUCCESS;
+    dev->renderBytes = 0;
+
+    unsigned int row;
+    for (row = 0; row < JHD1313M1_ROWS && rv == UPM_SUCCESS; row++)
+    {
+        const char *src = frame + row * JHD1313M1_COLUMNS;
+        char *dst = dev->shadow + row * JHD1313M1_COLUMNS;
+
+        unsigned int col = 0;
+        while (col < JHD1313M1_COLUMNS)
+        {
+            if (!full && src[col] == dst[col])
+            {
+                col++;
+                continue;
+            }
+
+            // extend the run over the following changes, as long as
+            // the gaps are short enough
+            unsigned int end = col + 1;
+            unsigned int i;
+
+            if (contiguous)
+            {
+                for (i = end;
+                     i < JHD1313M1_COLUMNS && i - end <= RENDER_MAX_GAP; i++)
+                {
+                    if (full || src[i] != dst[i])
+                        end = i + 1;
+                }
+            }
+
+            // this should work for any display with two rows
+            uint8_t addr = col + row * 0x40;
+            int len = 0;
+
+            // a command control byte with the continuation bit set
+            // can be followed by the data control byte, and then by
+            // any number of data bytes
+            if (!contiguous || addr != dev->cursorAddr)
+            {
+                buf[len++] = HD44780_CMD;
+                buf[len++] = HD44780_CMD | addr;
+            }
+
+            buf[len++] = HD44780_DATA;
+            for (i = col; i < end; i++)
+            {
+                buf[len++] = src[i];
+                dst[i] = src[i];
+            }
+
+            // count the address byte as well
+            dev->renderBytes += len + 1;
+
+            if (mraa_i2c_write(dev->i2cLCD, buf, len))
+            {
+                printf("%s: mraa_i2c_write() failed\n", __FUNCTION__);
+                rv = UPM_ERROR_OPERATION_FAILED;
+                break;
+            }
+
+            dev->cursorAddr = (contiguous) ? (int)(addr + (end - col)) : -1;
+            col = end;
+        }
+    }
+
+    // on failure we don't know what the display shows
+    dev->shadowValid = (rv == UPM_SUCCESS);
+    if (rv != UPM_SUCCESS)
+        dev->cursorAddr = -1;
+
+    unsigned int fullBytes = JHD1313M1_ROWS * (JHD1313M1_COLUMNS + 1)
+        * SINGLE_BYTE_COST;
+
+    if (fullBytes > dev->renderBytes)
+        dev->renderBytesSaved = fullBytes - dev->renderBytes;
+    else
+        dev->renderBytesSaved = 0;
+
+    return rv;
+}
+
+unsigned int jhd1313m1_get_render_bytes(const jhd1313m1_context dev)
+{
+    assert(dev != NULL);
+
+    return dev->renderBytes;
+}
+
+unsigned int jhd1313m1_get_render_bytes_saved(const jhd1313m1_context dev)
+{
+    assert(dev != NULL);
+
+    return dev->renderBytesSaved;
+}
+
 upm_result_t jhd1313m1_set_cursor(const jhd1313m1_context dev, unsigned int row,
                                   unsigned int column)
 {
     assert(dev != NULL);
 
-    column = column % 16;
+    column = column % JHD1313M1_COLUMNS;
     uint8_t offset = column;
 
     // this should work for any display with two rows
@@ -188,6 +309,15 @@ upm_result_t jhd1313m1_clear(const jhd1313m1_context dev)
     upm_result_t ret;
     ret = jhd1313m1_command(dev, HD44780_CLEARDISPLAY);
     upm_delay_us(2000); // this command takes awhile
+
+    if (ret == UPM_SUCCESS)
+    {
+        // the display is now all spaces, with the cursor at home
+        memset(dev->shadow, ' ', sizeof(dev->shadow));
+        dev->shadowValid = true;
+        dev->cursorAddr = 0;
+    }
+
     return ret;
 }
 
@@ -198,6 +328,10 @@ upm_result_t jhd1313m1_home(const jhd1313m1_context dev)
     upm_result_t ret;
     ret = jhd1313m1_command(dev, HD44780_RETURNHOME);
     upm_delay_us(2000); // this command takes awhile
+
+    if (ret == UPM_SUCCESS)
+        dev->cursorAddr = 0;
+
     return ret;
 }
 
@@ -215,9 +349,17 @@ upm_result_t jhd1313m1_create_char(const jhd1313m1_context dev,
 
     if (error == UPM_SUCCESS)
     {
-        int i;
-        for (i = 0; i < 8; i++) {
-            error = jhd1313m1_data(dev, data[i]);
+        // send all 8 bytes in one go.  Writing CGRAM doesn't change
+        // the display contents.
+        uint8_t buf[9];
+
+        buf[0] = HD44780_DATA;
+        memcpy(buf + 1, data, 8);
+
+        if (mraa_i2c_write(dev->i2cLCD, buf, sizeof(buf)))
+        {
+            printf("%s: mraa_i2c_write() failed\n", __FUNCTION__);
+            error = UPM_ERROR_OPERATION_FAILED;
         }
     }
 
@@ -331,6 +473,9 @@ upm_result_t jhd1313m1_command(const jhd1313m1_context dev, uint8_t cmd)
 {
     assert(dev != NULL);
 
+    // commands may move the address counter
+    dev->cursorAddr = -1;
+
     if (mraa_i2c_write_byte_data(dev->i2cLCD, cmd, HD44780_CMD))
     {
         printf("%s: mraa_i2c_write_byte_data() failed\n", __FUNCTION__);
@@ -344,6 +489,10 @@ upm_result_t jhd1313m1_data(const jhd1313m1_context dev, uint8_t cmd)
 {
     assert(dev != NULL);
 
+    // the next render must redraw everything
+    dev->shadowValid = false;
+    dev->cursorAddr = -1;
+
     if (mraa_i2c_write_byte_data(dev->i2cLCD, cmd, HD44780_DATA))
     {
         printf("%s: mraa_i2c_write_byte_data() failed\n", __FUNCTION__);
@@ -44,6 +44,23 @@ upm_result_t Jhd1313m1::write(std::string msg)
     return jhd1313m1_write(m_jhd1313m1, (char *)msg.data(), msg.size());
 }
 
+upm_result_t Jhd1313m1::render(std::string frame)
+{
+    frame.resize(JHD1313M1_ROWS * JHD1313M1_COLUMNS, ' ');
+
+    return jhd1313m1_render(m_jhd1313m1, frame.data());
+}
+
+unsigned int Jhd1313m1::getRenderBytes()
+{
+    return jhd1313m1_get_render_bytes(m_jhd1313m1);
+}
+
+unsigned int Jhd1313m1::getRenderBytesSaved()
+{
+    return jhd1313m1_get_render_bytes_saved(m_jhd1313m1);
+}
+
 upm_result_t Jhd1313m1::setCursor(int row, int column)
 {
     return jhd1313m1_set_cursor(m_jhd1313m1, row, column);
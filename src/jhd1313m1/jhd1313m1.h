@@ -36,6 +36,10 @@ extern "C" {
      * @include jhd1313m1.c
      */
 
+    // display size
+#define JHD1313M1_ROWS 2
+#define JHD1313M1_COLUMNS 16
+
     /**
      * Device context
      */
@@ -48,6 +52,17 @@ extern "C" {
         // display command
         uint8_t                  displayControl;
         uint8_t                  entryDisplayMode;
+
+        // what jhd1313m1_render() last put in DDRAM
+        char                     shadow[JHD1313M1_ROWS * JHD1313M1_COLUMNS];
+        bool                     shadowValid;
+        // DDRAM address of the cursor, -1 if unknown
+        int                      cursorAddr;
+
+        // bus bytes used by the last render, and saved compared to
+        // rewriting every row
+        unsigned int             renderBytes;
+        unsigned int             renderBytesSaved;
     } *jhd1313m1_context;
 
     /**
@@ -79,6 +94,47 @@ extern "C" {
     upm_result_t jhd1313m1_write(const jhd1313m1_context dev, char *buffer,
                                  int len);
 
+    /**
+     * Render a full frame on the display.  Only the characters that
+     * differ from what the display already shows (as far as the
+     * driver knows) are sent.  Nearby changes are grouped into runs,
+     * and each run is sent in a single I2C write, together with the
+     * cursor move if one is needed.  This relies on the bus running
+     * at the standard 100KHz, where each byte takes longer to
+     * transfer than the controller takes to process it.
+     *
+     * The first render after initialization, or after
+     * jhd1313m1_write() or jhd1313m1_data() were used, redraws the
+     * whole display.  The cursor is left after the last character
+     * written.
+     *
+     * @param dev The device context.
+     * @param frame Buffer containing JHD1313M1_ROWS *
+     * JHD1313M1_COLUMNS characters, row by row.
+     * @return UPM result.
+     */
+    upm_result_t jhd1313m1_render(const jhd1313m1_context dev,
+                                  const char *frame);
+
+    /**
+     * Return the number of bus bytes, including the address bytes,
+     * used by the last jhd1313m1_render().
+     *
+     * @param dev The device context.
+     * @return The bus bytes used by the last render.
+     */
+    unsigned int jhd1313m1_get_render_bytes(const jhd1313m1_context dev);
+
+    /**
+     * Return the number of bus bytes the last jhd1313m1_render()
+     * saved, compared to rewriting every row with
+     * jhd1313m1_set_cursor() and jhd1313m1_write().
+     *
+     * @param dev The device context.
+     * @return The bus bytes saved by the last render.
+     */
+    unsigned int jhd1313m1_get_render_bytes_saved(const jhd1313m1_context dev);
+
     /**
      * Sets the cursor to specified coordinates
      *
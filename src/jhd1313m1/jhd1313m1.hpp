@@ -82,6 +82,33 @@ namespace upm
          */
         upm_result_t write(std::string msg);
 
+        /**
+         * Renders a full frame on the LCD.  Only the characters that
+         * differ from what the LCD already shows are sent, each run
+         * of changes in a single I2C write.  The first render after
+         * write() was used redraws the whole LCD.
+         *
+         * @param frame The characters to display, row by row.  It is
+         * padded with spaces or truncated to fill the LCD.
+         * @return Result of the operation
+         */
+        upm_result_t render(std::string frame);
+
+        /**
+         * Returns the number of bus bytes used by the last render()
+         *
+         * @return The bus bytes used by the last render
+         */
+        unsigned int getRenderBytes();
+
+        /**
+         * Returns the number of bus bytes the last render() saved,
+         * compared to rewriting every row with setCursor() and write()
+         *
+         * @return The bus bytes saved by the last render
+         */
+        unsigned int getRenderBytesSaved();
+
         /**
          * Makes the LCD scroll text
          *
@@ -11,6 +11,8 @@
 * SPDX-License-Identifier: MIT
 */
 
+#include <time.h>
+
 #include "kx122.h"
 
 //Used to set the bit required for SPI reading
@@ -58,6 +60,9 @@
 
 //Earth gravity constant (m/s^2)
 #define GRAVITY 9.81f
+
+//Shortest time the stream reader waits for an interrupt before draining the buffer anyway
+#define MIN_STREAM_TIMEOUT_US 1000
 /**
 Enables the chip select on the chip_select GPIO pin.
 Chip select is active low.
@@ -94,6 +99,19 @@ Reads multiple continous registers.
 */
 static upm_result_t kx122_read_registers(const kx122_context dev, uint8_t reg, uint8_t *buffer, uint len);
 
+/**
+Reads multiple continous registers in place, without an intermediate buffer.
+The first byte of the buffer is used for the SPI command, the values are
+stored starting from the second byte.
+
+@param dev The device context.
+@param reg The start register.
+@param buffer Pointer to a uint8_t buffer of at least len + 1 bytes.
+@param len Amount of bytes to read.
+@return UPM result
+*/
+static upm_result_t kx122_read_burst(const kx122_context dev, uint8_t reg, uint8_t *buffer, uint len);
+
 /**
 Writes to a register.
 
@@ -150,6 +168,57 @@ Sets acceleration scale of sensor and the buffer.
 */
 static void kx122_map_grange(const kx122_context dev, KX122_RANGE_T grange);
 
+/**
+Reads all of the samples in the buffer, up to len, with one burst.
+
+@param dev The device context.
+@param buffer Pointer to a uint8_t buffer of KX122_BUFFER_BYTES + 1 bytes, the samples are stored starting from the second byte.
+@param len Maximum amount of samples to read.
+@param samples Pointer to an uint variable to store the amount of samples in the buffer.
+@param count Pointer to an uint variable to store the amount of samples read.
+@return UPM result.
+*/
+static upm_result_t kx122_read_buffer_burst(const kx122_context dev, uint8_t *buffer, uint len, uint *samples, uint *count);
+
+/**
+Unpacks samples read from the buffer into frames and timestamps them.
+Frame i is stored at frames[(start + i) & mask].
+
+Samples newer than the unpacked ones that were read but dropped are given in
+dropped, so that the timestamps stay correct.
+
+@param dev The device context.
+@param data Pointer to the samples read from the buffer.
+@param count Amount of samples.
+@param frames Pointer to the frame array.
+@param start Index of the first frame.
+@param mask Index mask of the frame array.
+@param dropped Amount of newer samples which were dropped.
+*/
+static void kx122_decode_frames(const kx122_context dev, const uint8_t *data, uint count, kx122_frame *frames, uint start, uint mask, uint dropped);
+
+/**
+Drains the buffer into the stream ring.
+
+@param dev The device context.
+@return UPM result.
+*/
+static upm_result_t kx122_stream_drain(const kx122_context dev);
+
+/**
+Stream reader thread, drains the buffer whenever an interrupt is received.
+
+@param ctx The device context.
+*/
+static void *kx122_stream_reader(void *ctx);
+
+/**
+Stream interrupt handler, wakes the reader thread.
+
+@param ctx The device context.
+*/
+static void kx122_stream_isr(void *ctx);
+
 kx122_context kx122_init(int bus, int addr, int chip_select_pin, int spi_bus_frequency)
 {
   kx122_context dev = (kx122_context)malloc(sizeof(struct _kx122_context));
@@ -167,6 +236,13 @@ kx122_context kx122_init(int bus, int addr, int chip_select_pin, int spi_bus_fre
   dev->gpio1 = NULL;
   dev->gpio2 = NULL;
 
+  dev->stream_ring = NULL;
+  dev->stream_alive = false;
+  dev->stream_pending = false;
+  dev->stream_intp = INT1;
+  dev->stream_clock = upm_clock_init();
+  dev->stream_period_us = 0;
+
   if(mraa_init() != MRAA_SUCCESS){
     printf("%s: mraa_init() failed.\n", __FUNCTION__);
     kx122_close(dev);
@@ -238,6 +314,7 @@ kx122_context kx122_init(int bus, int addr, int chip_select_pin, int spi_bus_fre
 void kx122_close(kx122_context dev)
 {
   assert(dev != NULL);
+  kx122_stream_stop(dev);
   kx122_uninstall_isr(dev,INT1);
   kx122_uninstall_isr(dev,INT2);
 
@@ -327,16 +404,36 @@ static upm_result_t kx122_read_registers(const kx122_context dev, uint8_t reg, u
     return UPM_SUCCESS;
   }
   else{
-      uint8_t data_buffer[len];
-      if(mraa_i2c_read_bytes_data(dev->i2c,reg,data_buffer,len) != (int)len){
+      if(mraa_i2c_read_bytes_data(dev->i2c,reg,buffer,len) != (int)len){
         return UPM_ERROR_OPERATION_FAILED;
       }
-      else{
-        for(size_t i = 0; i < len; i++){
-          buffer[i] = data_buffer[i];
-        }
-        return UPM_SUCCESS;
-      }
+      return UPM_SUCCESS;
+  }
+}
+
+static upm_result_t kx122_read_burst(const kx122_context dev, uint8_t reg, uint8_t *buffer, uint len)
+{
+  if(dev->using_spi){
+    buffer[0] = reg | SPI_READ;
+
+    kx122_chip_select_on(dev);
+
+    if(mraa_spi_transfer_buf(dev->spi,buffer,buffer,len + 1) != MRAA_SUCCESS){
+      printf("%s: mraa_spi_transfer_buf() failed.\n", __FUNCTION__);
+
+      kx122_chip_select_off(dev);
+      return UPM_ERROR_OPERATION_FAILED;
+    }
+
+    kx122_chip_select_off(dev);
+    return UPM_SUCCESS;
+  }
+  else{
+    if(mraa_i2c_read_bytes_data(dev->i2c,reg,buffer + 1,len) != (int)len){
+      printf("%s: mraa_i2c_read_bytes_data() failed, reading from register 0x%x\n",__FUNCTION__, reg);
+      return UPM_ERROR_OPERATION_FAILED;
+    }
+    return UPM_SUCCESS;
   }
 }
 
@@ -449,7 +546,7 @@ float kx122_get_sample_period(const kx122_context dev)
     {KX122_ODR_0P781,0.781f},{KX122_ODR_1P563,1.563f},{KX122_ODR_3P125,3.125f},{KX122_ODR_6P25,6.25f},
     {KX122_ODR_12P5,12.5f},{KX122_ODR_25,25},{KX122_ODR_50,50},{KX122_ODR_100,100},{KX122_ODR_200,200},
     {KX122_ODR_400,400},{KX122_ODR_800,800},{KX122_ODR_1600,1600},{KX122_ODR_3200,3200},{KX122_ODR_6400,6400},
-    {KX122_ODR_12800,128000},{KX122_ODR_25600,25600}
+    {KX122_ODR_12800,12800},{KX122_ODR_25600,25600}
   };
 
   uint8_t reg_val = 0;
@@ -959,20 +1056,16 @@ upm_result_t kx122_clear_buffer(const kx122_context dev)
 
 upm_result_t kx122_get_buffer_status(const kx122_context dev, uint *samples)
 {
-  uint8_t reg_val;
+  uint8_t reg_val[3]; //SPI command, BUF_STATUS 1 and BUF_STATUS 2
   uint16_t temp; //Using only 10 bits
 
-  if(kx122_read_register(dev,KX122_BUF_STATUS_2,&reg_val) != UPM_SUCCESS){
+  //BUF_STATUS 1 and 2 are read with a single burst
+  if(kx122_read_burst(dev,KX122_BUF_STATUS_1,reg_val,2) != UPM_SUCCESS){
     return UPM_ERROR_OPERATION_FAILED;
   }
 
-  temp = (reg_val & 0x0007) << 8; //Get 3 MSb from BUF_STATUS 2
-
-  if(kx122_read_register(dev,KX122_BUF_STATUS_1, &reg_val) != UPM_SUCCESS){
-    return UPM_ERROR_OPERATION_FAILED;
-  }
-
-  temp = (temp + (reg_val & 0x00FF)); //Get rest of the bits from BUF_STATUS 1
+  temp = (reg_val[2] & 0x0007) << 8; //Get 3 MSb from BUF_STATUS 2
+  temp = (temp + (reg_val[1] & 0x00FF)); //Get rest of the bits from BUF_STATUS 1
 
   //Get the amount of samples
   if(dev->buffer_res == LOW_RES){
@@ -991,15 +1084,22 @@ upm_result_t kx122_read_buffer_samples_raw(const kx122_context dev, uint len, fl
 {
   assert(dev != NULL);
   if(dev->buffer_res == LOW_RES){
+    if(len > MAX_BUFFER_SAMPLES_LOW_RES){
+      len = MAX_BUFFER_SAMPLES_LOW_RES;
+    }
     len *= LOW_RES_SAMPLE_MODIFIER; //3 axis / sample
   }
   else{
+    if(len > MAX_BUFFER_SAMPLES_HIGH_RES){
+      len = MAX_BUFFER_SAMPLES_HIGH_RES;
+    }
     len *= HIGH_RES_SAMPLE_MODIFIER; //3 axis * 2 bytes / sample
   }
 
-  uint8_t buffer[len];
+  uint8_t burst[KX122_BUFFER_BYTES + 1];
+  uint8_t *buffer = burst + 1;
 
-  if(kx122_read_registers(dev,KX122_BUF_READ,buffer,len) != UPM_SUCCESS){
+  if(kx122_read_burst(dev,KX122_BUF_READ,burst,len) != UPM_SUCCESS){
     return UPM_ERROR_OPERATION_FAILED;
   }
 
@@ -1080,3 +1180,288 @@ upm_result_t kx122_read_buffer_samples(const kx122_context dev, uint len, float
 
   return UPM_SUCCESS;
 }
+
+static upm_result_t kx122_read_buffer_burst(const kx122_context dev, uint8_t *buffer, uint len, uint *samples, uint *count)
+{
+  if(kx122_get_buffer_status(dev,samples) != UPM_SUCCESS){
+    return UPM_ERROR_OPERATION_FAILED;
+  }
+
+  *count = (*samples < len) ? *samples : len;
+  if(*count == 0){
+    return UPM_SUCCESS;
+  }
+
+  uint bytes = *count * ((dev->buffer_res == LOW_RES) ? LOW_RES_SAMPLE_MODIFIER : HIGH_RES_SAMPLE_MODIFIER);
+  if(bytes > KX122_BUFFER_BYTES){
+    return UPM_ERROR_OPERATION_FAILED;
+  }
+
+  return kx122_read_burst(dev,KX122_BUF_READ,buffer,bytes);
+}
+
+static void kx122_decode_frames(const kx122_context dev, const uint8_t *data, uint count, kx122_frame *frames, uint start, uint mask, uint dropped)
+{
+  //The newest sample was taken about when the burst completed
+  uint64_t now = upm_elapsed_us(&dev->stream_clock);
+  float period_us = dev->stream_period_us;
+  bool filo = (dev->buffer_mode == KX122_FILO_MODE);
+
+  for (uint i = 0; i < count; i++) {
+    kx122_frame *frame = &frames[(start + i) & mask];
+
+    if(dev->buffer_res == HIGH_RES){
+      const uint8_t *sample = data + i * HIGH_RES_SAMPLE_MODIFIER;
+      if(!filo){
+        frame->x = (int16_t)((sample[1] << 8) | sample[0]);
+        frame->y = (int16_t)((sample[3] << 8) | sample[2]);
+        frame->z = (int16_t)((sample[5] << 8) | sample[4]);
+      }
+      else{
+        frame->x = (int16_t)((sample[4] << 8) | sample[5]);
+        frame->y = (int16_t)((sample[2] << 8) | sample[3]);
+        frame->z = (int16_t)((sample[0] << 8) | sample[1]);
+      }
+    }
+    else{ //Low resolution
+      const uint8_t *sample = data + i * LOW_RES_SAMPLE_MODIFIER;
+      if(!filo){
+        frame->x = (int8_t)sample[0];
+        frame->y = (int8_t)sample[1];
+        frame->z = (int8_t)sample[2];
+      }
+      else{
+        frame->x = (int8_t)sample[2];
+        frame->y = (int8_t)sample[1];
+        frame->z = (int8_t)sample[0];
+      }
+    }
+
+    //FIFO and stream modes return the oldest sample first, FILO the newest
+    uint64_t age = (uint64_t)(((filo ? i : (count - 1 - i)) + dropped) * period_us);
+    frame->timestamp_us = (age < now) ? (now - age) : 0;
+  }
+}
+
+upm_result_t kx122_read_buffer_frames(const kx122_context dev, kx122_frame *frames, uint len, uint *count)
+{
+  assert(dev != NULL && frames != NULL && count != NULL);
+  uint8_t buffer[KX122_BUFFER_BYTES + 1];
+  uint samples;
+
+  if(!dev->stream_alive){
+    dev->stream_period_us = kx122_get_sample_period(dev) * MICRO_S;
+  }
+
+  if(kx122_read_buffer_burst(dev,buffer,len,&samples,count) != UPM_SUCCESS){
+    *count = 0;
+    return UPM_ERROR_OPERATION_FAILED;
+  }
+
+  kx122_decode_frames(dev,buffer + 1,*count,frames,0,~0u,0);
+  return UPM_SUCCESS;
+}
+
+void kx122_frame_to_acceleration(const kx122_context dev, const kx122_frame *frame, float *x, float *y, float *z)
+{
+  assert(dev != NULL && frame != NULL);
+  float scale = dev->buffer_accel_scale * GRAVITY;
+
+  if(x){
+    *x = frame->x * scale;
+  }
+  if(y){
+    *y = frame->y * scale;
+  }
+  if(z){
+    *z = frame->z * scale;
+  }
+}
+
+upm_result_t kx122_ring_init(kx122_ring *ring, kx122_frame *frames, uint size)
+{
+  assert(ring != NULL);
+  if(!frames || size == 0 || (size & (size - 1))){
+    return UPM_ERROR_INVALID_PARAMETER;
+  }
+
+  ring->frames = frames;
+  ring->size = size;
+  ring->head = 0;
+  ring->tail = 0;
+  ring->overruns = 0;
+
+  return UPM_SUCCESS;
+}
+
+uint kx122_ring_available(kx122_ring *ring)
+{
+  assert(ring != NULL);
+  uint tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+  return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+}
+
+uint kx122_ring_read(kx122_ring *ring, kx122_frame *frames, uint len)
+{
+  assert(ring != NULL && frames != NULL);
+  uint tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+  uint available = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+  uint count = (available < len) ? available : len;
+
+  for (uint i = 0; i < count; i++) {
+    frames[i] = ring->frames[(tail + i) & (ring->size - 1)];
+  }
+
+  //Hand the slots back to the reader thread
+  __atomic_store_n(&ring->tail, tail + count, __ATOMIC_RELEASE);
+  return count;
+}
+
+static upm_result_t kx122_stream_drain(const kx122_context dev)
+{
+  kx122_ring *ring = dev->stream_ring;
+  uint8_t buffer[KX122_BUFFER_BYTES + 1];
+  uint samples, count;
+
+  //Always empty the buffer, samples that do not fit in the ring are dropped
+  if(kx122_read_buffer_burst(dev,buffer,~0u,&samples,&count) != UPM_SUCCESS){
+    return UPM_ERROR_OPERATION_FAILED;
+  }
+  if(count == 0){
+    return UPM_SUCCESS;
+  }
+
+  uint head = ring->head;
+  uint space = ring->size - (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE));
+  uint stored = (count < space) ? count : space;
+  uint dropped = count - stored;
+  uint skip = 0;
+
+  if(dropped){
+    __atomic_store_n(&ring->overruns, ring->overruns + dropped, __ATOMIC_RELAXED);
+    //Keep the oldest samples, in FILO mode they are at the end of the burst
+    if(dev->buffer_mode == KX122_FILO_MODE){
+      skip = dropped;
+    }
+  }
+
+  uint sample_bytes = (dev->buffer_res == LOW_RES) ? LOW_RES_SAMPLE_MODIFIER : HIGH_RES_SAMPLE_MODIFIER;
+  kx122_decode_frames(dev,buffer + 1 + skip * sample_bytes,stored,ring->frames,head,ring->size - 1,dropped);
+
+  //Publish the frames to the consumer
+  __atomic_store_n(&ring->head, head + stored, __ATOMIC_RELEASE);
+  return UPM_SUCCESS;
+}
+
+static void *kx122_stream_reader(void *ctx)
+{
+  kx122_context dev = (kx122_context)ctx;
+
+  //Drain at least twice per buffer fill in case an interrupt is missed
+  uint max_samples = (dev->buffer_res == LOW_RES) ? MAX_BUFFER_SAMPLES_LOW_RES : MAX_BUFFER_SAMPLES_HIGH_RES;
+  uint64_t timeout_us = (uint64_t)(dev->stream_period_us * max_samples / 2);
+  if(timeout_us < MIN_STREAM_TIMEOUT_US){
+    timeout_us = MIN_STREAM_TIMEOUT_US;
+  }
+
+  pthread_mutex_lock(&dev->stream_lock);
+  while(dev->stream_alive){
+    if(!dev->stream_pending){
+      struct timespec deadline;
+      clock_gettime(CLOCK_MONOTONIC,&deadline);
+      uint64_t nsec = deadline.tv_nsec + (timeout_us % MICRO_S) * 1000;
+      deadline.tv_sec += timeout_us / MICRO_S + nsec / 1000000000;
+      deadline.tv_nsec = nsec % 1000000000;
+
+      pthread_cond_timedwait(&dev->stream_cond,&dev->stream_lock,&deadline);
+      if(!dev->stream_alive){
+        break;
+      }
+    }
+    dev->stream_pending = false;
+    pthread_mutex_unlock(&dev->stream_lock);
+
+    if(kx122_stream_drain(dev) != UPM_SUCCESS){
+      printf("%s: kx122_stream_drain() failed.\n", __FUNCTION__);
+    }
+
+    pthread_mutex_lock(&dev->stream_lock);
+  }
+  pthread_mutex_unlock(&dev->stream_lock);
+
+  return NULL;
+}
+
+static void kx122_stream_isr(void *ctx)
+{
+  kx122_context dev = (kx122_context)ctx;
+
+  pthread_mutex_lock(&dev->stream_lock);
+  dev->stream_pending = true;
+  pthread_cond_signal(&dev->stream_cond);
+  pthread_mutex_unlock(&dev->stream_lock);
+}
+
+upm_result_t kx122_stream_start(const kx122_context dev, kx122_ring *ring, mraa_gpio_edge_t edge, KX122_INTERRUPT_PIN_T intp, int pin)
+{
+  assert(dev != NULL && ring != NULL);
+  kx122_stream_stop(dev);
+
+  float period = kx122_get_sample_period(dev);
+  if(period < 0){
+    printf("%s: kx122_get_sample_period() failed.\n", __FUNCTION__);
+    return UPM_ERROR_OPERATION_FAILED;
+  }
+
+  dev->stream_ring = ring;
+  dev->stream_intp = intp;
+  dev->stream_period_us = period * MICRO_S;
+  dev->stream_clock = upm_clock_init();
+
+  //Drain whatever is already in the buffer right away
+  dev->stream_pending = true;
+  dev->stream_alive = true;
+
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr,CLOCK_MONOTONIC);
+  pthread_cond_init(&dev->stream_cond,&attr);
+  pthread_condattr_destroy(&attr);
+  pthread_mutex_init(&dev->stream_lock,NULL);
+
+  if(pthread_create(&dev->stream_thread,NULL,&kx122_stream_reader,dev)){
+    printf("%s: pthread_create() failed.\n", __FUNCTION__);
+    dev->stream_alive = false;
+    pthread_cond_destroy(&dev->stream_cond);
+    pthread_mutex_destroy(&dev->stream_lock);
+    return UPM_ERROR_OPERATION_FAILED;
+  }
+
+  if(kx122_install_isr(dev,edge,intp,pin,&kx122_stream_isr,dev) != UPM_SUCCESS){
+    kx122_stream_stop(dev);
+    return UPM_ERROR_OPERATION_FAILED;
+  }
+
+  return UPM_SUCCESS;
+}
+
+void kx122_stream_stop(const kx122_context dev)
+{
+  assert(dev != NULL);
+  if(!dev->stream_alive){
+    return;
+  }
+
+  kx122_uninstall_isr(dev,dev->stream_intp);
+
+  pthread_mutex_lock(&dev->stream_lock);
+  dev->stream_alive = false;
+  pthread_cond_signal(&dev->stream_cond);
+  pthread_mutex_unlock(&dev->stream_lock);
+
+  pthread_join(dev->stream_thread,NULL);
+
+  pthread_cond_destroy(&dev->stream_cond);
+  pthread_mutex_destroy(&dev->stream_lock);
+  dev->stream_ring = NULL;
+}
@@ -356,3 +356,36 @@ void KX122::clearBuffer()
     throw std::runtime_error(std::string(__FUNCTION__) + "kx122_clear_buffer failed");
   }
 }
+
+std::vector<kx122_frame> KX122::getBufferFrames(uint len)
+{
+  if(len > MAX_SAMPLES_IN_BUFFER){
+    len = MAX_SAMPLES_IN_BUFFER;
+  }
+
+  std::vector<kx122_frame> frames(len);
+  uint count = 0;
+  if(kx122_read_buffer_frames(m_kx122,frames.data(),len,&count)){
+    throw std::runtime_error(std::string(__FUNCTION__) + "kx122_read_buffer_frames failed");
+  }
+
+  frames.resize(count);
+  return frames;
+}
+
+void KX122::getFrameAcceleration(const kx122_frame &frame, float *x, float *y, float *z)
+{
+  kx122_frame_to_acceleration(m_kx122,&frame,x,y,z);
+}
+
+void KX122::startBufferStream(kx122_ring *ring, mraa::Edge edge, KX122_INTERRUPT_PIN_T intp, int pin)
+{
+  if(kx122_stream_start(m_kx122,ring,(mraa_gpio_edge_t)edge,intp,pin)){
+    throw std::runtime_error(std::string(__FUNCTION__) + "kx122_stream_start failed");
+  }
+}
+
+void KX122::stopBufferStream()
+{
+  kx122_stream_stop(m_kx122);
+}
@@ -20,6 +20,7 @@ extern "C"{
 #include <assert.h>
 #include <unistd.h>
 #include <math.h>
+#include <pthread.h>
 #include <sys/types.h>
 
 #include <mraa/i2c.h>
@@ -27,6 +28,7 @@ extern "C"{
 #include <mraa/gpio.h>
 
 #include <upm.h>
+#include <upm_utilities.h>
 
 #include "kx122_registers.h"
 
@@ -48,6 +50,9 @@ extern "C"{
 //Microseconds in a second
 #define MICRO_S 1000000
 
+//Size of the sample buffer in bytes
+#define KX122_BUFFER_BYTES 2048
+
 //Sensor ODR values
 typedef enum{
   KX122_ODR_12P5 = KX122_ODCNTL_OSA_12P5,
@@ -125,6 +130,23 @@ typedef enum{
   ACTIVE_HIGH
 } KX122_INTERRUPT_POLARITY_T;
 
+//Raw buffer sample
+typedef struct _kx122_frame {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+  uint64_t timestamp_us; //Sample time in microseconds since the stream was started or the device was initialized
+} kx122_frame;
+
+//Single producer, single consumer ring of buffer samples, storage is supplied by the caller
+typedef struct _kx122_ring {
+  kx122_frame *frames;
+  uint size; //Number of frames, must be a power of two
+  uint head; //Total amount of frames written
+  uint tail; //Total amount of frames read
+  uint overruns; //Frames dropped because the ring was full
+} kx122_ring;
+
 //Device context
 typedef struct _kx122_context {
   mraa_i2c_context i2c;
@@ -143,6 +165,17 @@ typedef struct _kx122_context {
 
   bool using_spi;
 
+  //Buffer streaming
+  kx122_ring *stream_ring; //Ring the reader thread drains the buffer into
+  pthread_t stream_thread; //Reader thread
+  pthread_mutex_t stream_lock;
+  pthread_cond_t stream_cond; //Signaled from the interrupt handler
+  bool stream_alive; //Reader thread is running
+  bool stream_pending; //Interrupt received but the buffer is not drained yet
+  KX122_INTERRUPT_PIN_T stream_intp; //Interrupt pin used for streaming
+  upm_clock_t stream_clock; //Stream start time
+  float stream_period_us; //Sample period when the stream was started
+
 } *kx122_context;
 
 //Struct for ODR values and their decimal counterparts.
@@ -659,6 +692,95 @@ Clears the buffer, removing all existing samples from the buffer.
 */
 upm_result_t kx122_clear_buffer(const kx122_context dev);
 
+/**
+Reads all of the samples in the buffer, up to len, as raw frames.
+The sample count and the samples are each read with a single burst.
+
+Frame timestamps are relative to the start of the last stream, or to the device
+initialization, with the newest sample stamped with the time it was read.
+
+@param dev The device context.
+@param frames Pointer to an array of at least len frames.
+@param len Maximum amount of samples to read.
+@param count Pointer to an uint variable to store the amount of samples read.
+@return UPM result.
+*/
+upm_result_t kx122_read_buffer_frames(const kx122_context dev, kx122_frame *frames, uint len, uint *count);
+
+/**
+Converts a raw buffer frame to acceleration (m/s^2), using the current buffer
+resolution and range.
+
+@param dev The device context.
+@param frame Pointer to the frame to convert.
+@param x Pointer to a floating point variable to store the x-axis value. Can be set to NULL if not wanted.
+@param y Pointer to a floating point variable to store the y-axis value. Can be set to NULL if not wanted.
+@param z Pointer to a floating point variable to store the z-axis value. Can be set to NULL if not wanted.
+*/
+void kx122_frame_to_acceleration(const kx122_context dev, const kx122_frame *frame, float *x, float *y, float *z);
+
+/**
+Initializes a ring of buffer frames with caller supplied storage.
+
+@param ring Pointer to the ring.
+@param frames Pointer to an array of size frames.
+@param size Amount of frames in the array, must be a power of two.
+@return UPM result.
+*/
+upm_result_t kx122_ring_init(kx122_ring *ring, kx122_frame *frames, uint size);
+
+/**
+Gets the amount of frames waiting in the ring.
+
+@param ring Pointer to the ring.
+@return Amount of frames.
+*/
+uint kx122_ring_available(kx122_ring *ring);
+
+/**
+Moves up to len of the oldest frames out of the ring.
+Only one thread may read from a ring.
+
+@param ring Pointer to the ring.
+@param frames Pointer to an array of at least len frames.
+@param len Maximum amount of frames to read.
+@return Amount of frames read.
+*/
+uint kx122_ring_read(kx122_ring *ring, kx122_frame *frames, uint len);
+
+/**
+Starts streaming the buffer into a ring.
+
+An interrupt handler is installed on the given pin, which wakes a reader thread
+that drains the whole buffer into the ring with a single burst. If an interrupt
+is missed, the reader also drains the buffer before it can fill up.
+When the ring is full, new frames are dropped and counted in the ring overruns.
+
+The buffer and the watermark and/or buffer full interrupts need to be configured
+and routed to the interrupt pin before starting, eg. with kx122_buffer_init(),
+kx122_route_interrupt1() and kx122_enable_interrupt1(). The sampling rate should
+not be changed while streaming.
+
+While streaming, the device must not be accessed from other threads except
+through the ring.
+
+@param dev The device context.
+@param ring Pointer to an initialized ring.
+@param edge Interrupt trigger edge.
+@param intp One of the KX122_INTERRUPT_PIN_T values. Specifies which interrupt pin is used.
+@param pin The GPIO pin to use as the interrupt pin.
+@return UPM result.
+*/
+upm_result_t kx122_stream_start(const kx122_context dev, kx122_ring *ring, mraa_gpio_edge_t edge, KX122_INTERRUPT_PIN_T intp, int pin);
+
+/**
+Stops streaming the buffer, uninstalling the interrupt handler and stopping the
+reader thread.
+
+@param dev The device context.
+*/
+void kx122_stream_stop(const kx122_context dev);
+
 #ifdef __cplusplus
 }
 #endif
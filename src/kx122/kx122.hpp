@@ -491,6 +491,51 @@ namespace upm{
       @throws std::runtime_error on failure.
       */
       void clearBuffer();
+
+      /**
+      Reads all of the samples in the buffer, up to len, as raw frames.
+      The sample count and the samples are each read with a single burst.
+
+      @param len Maximum amount of samples to read.
+      @return vector containing the frames read.
+      @throws std::runtime_error on failure.
+      */
+      std::vector<kx122_frame> getBufferFrames(uint len);
+
+      /**
+      Converts a raw buffer frame to acceleration (m/s^2), using the current buffer
+      resolution and range.
+
+      @param frame The frame to convert.
+      @param x Pointer to a floating point variable to store the x-axis value. Can be set to NULL if not wanted.
+      @param y Pointer to a floating point variable to store the y-axis value. Can be set to NULL if not wanted.
+      @param z Pointer to a floating point variable to store the z-axis value. Can be set to NULL if not wanted.
+      */
+      void getFrameAcceleration(const kx122_frame &frame, float *x, float *y, float *z);
+
+      /**
+      Starts streaming the buffer into a ring initialized with kx122_ring_init().
+
+      An interrupt handler is installed on the given pin, which wakes a reader thread
+      that drains the whole buffer into the ring with a single burst. Frames are
+      taken out of the ring with kx122_ring_read().
+
+      The buffer and the watermark and/or buffer full interrupts need to be configured
+      and routed to the interrupt pin before starting. While streaming, the sensor must
+      not be accessed from other threads.
+
+      @param ring Pointer to an initialized ring.
+      @param edge One of the mraa::Edge values. Interrupt trigger edge.
+      @param intp One of the KX122_INTERRUPT_PIN_T values. Specifies which interrupt pin is used.
+      @param pin The GPIO pin to use as the interrupt pin.
+      @throws std::runtime_error on failure.
+      */
+      void startBufferStream(kx122_ring *ring, mraa::Edge edge, KX122_INTERRUPT_PIN_T intp, int pin);
+
+      /**
+      Stops streaming the buffer.
+      */
+      void stopBufferStream();
     private:
       //Device context
       kx122_context m_kx122;
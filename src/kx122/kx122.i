@@ -16,5 +16,6 @@ JAVA_JNI_LOADLIBRARY(javaupm_kx122)
 #include "kx122.hpp"
 %}
 %include "kx122.h"
+%template(kx122FrameVector) std::vector<kx122_frame>;
 %include "kx122.hpp"
 /* END Common SWIG syntax */
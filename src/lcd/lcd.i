@@ -42,15 +42,17 @@ JAVA_JNI_LOADLIBRARY(javaupm_i2clcd)
 %{
 #include "lcd.hpp"
 #include "eboled.hpp"
+#include "ssd_framebuffer.hpp"
 #include "ssd1306.hpp"
 #include "ssd1308.hpp"
 #include "ssd1327.hpp"
 %}
 
 %include "lcd.hpp"
+%include "ssd.hpp"
 %include "eboled.hpp"
+%include "ssd_framebuffer.hpp"
 %include "ssd1306.hpp"
 %include "ssd1308.hpp"
 %include "ssd1327.hpp"
-%include "ssd.hpp"
 /* END Common SWIG syntax */
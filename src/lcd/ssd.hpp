@@ -21,6 +21,14 @@ const uint8_t BASE_HIGH_COLUMN_ADDR = 0x10;
 const uint8_t BASE_PAGE_START_ADDR = 0xB0;
 const uint8_t DISPLAY_CMD_MEM_ADDR_MODE = 0x20;
 
+// control byte starting a stream of commands
+const uint8_t DISPLAY_CMD_STREAM = 0x00;
+
+// pixel colors for the screen buffers
+const uint8_t COLOR_WHITE = 0x01;
+const uint8_t COLOR_BLACK = 0x00;
+const uint8_t COLOR_XOR = 0x02;
+
 const uint8_t BasicFont[][8] = { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
                                  { 0x00, 0x00, 0x5F, 0x00, 0x00, 0x00, 0x00, 0x00 },
                                  { 0x00, 0x00, 0x07, 0x00, 0x07, 0x00, 0x00, 0x00 },
@@ -13,6 +13,7 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stdexcept>
 #include <string>
 #include <unistd.h>
 #include <syslog.h>
@@ -22,7 +23,8 @@
 
 using namespace upm;
 
-SSD1306::SSD1306(int bus_in, int addr_in) : m_i2c_lcd_control(bus_in)
+SSD1306::SSD1306(int bus_in, int addr_in) :
+    SSDFramebuffer(SSD1306_LCDWIDTH, SSD1306_LCDHEIGHT), m_i2c_lcd_control(bus_in)
 {
     int vccstate = SSD1306_SWITCHCAPVCC;
     _vccstate = vccstate;
@@ -102,14 +104,11 @@ SSD1306::~SSD1306()
 mraa::Result
 SSD1306::draw(uint8_t* data, int bytes)
 {
-    mraa::Result error = mraa::SUCCESS;
+    // the display no longer shows the screen buffer
+    invalidate();
 
     setAddressingMode(HORIZONTAL);
-    for (int idx = 0; idx < bytes; idx++) {
-        m_i2c_lcd_control.writeReg(LCD_DATA, data[idx]);
-    }
-
-    return error;
+    return writeStream(m_i2c_lcd_control, LCD_DATA, data, bytes);
 }
 
 /*
@@ -122,6 +121,8 @@ SSD1306::write(std::string msg)
 {
     mraa::Result error = mraa::SUCCESS;
 
+    invalidate();
+
     setAddressingMode(PAGE);
     for (std::string::size_type i = 0; i < msg.size(); ++i) {
         writeChar(msg[i]);
@@ -163,6 +164,7 @@ SSD1306::clear()
     }
     m_i2c_lcd_control.writeReg(LCD_CMD, DISPLAY_CMD_ON); // display on
     home();
+    screenCleared();
 
     return error;
 }
@@ -173,6 +175,28 @@ SSD1306::home()
     return setCursor(0, 0);
 }
 
+/*
+ * ****************
+ *  protected area
+ * ****************
+ */
+mraa::Result
+SSD1306::refreshWindow(int page, int x0, int x1)
+{
+    uint8_t cmds[] = { DISPLAY_CMD_MEM_ADDR_MODE, PAGE,
+                       (uint8_t) (BASE_PAGE_START_ADDR + page),
+                       (uint8_t) (BASE_LOW_COLUMN_ADDR + (x0 & 0x0F)),
+                       (uint8_t) (BASE_HIGH_COLUMN_ADDR + ((x0 >> 4) & 0x0F)) };
+
+    mraa::Result rv = writeStream(m_i2c_lcd_control, DISPLAY_CMD_STREAM,
+                                  cmds, sizeof(cmds));
+    if (rv != mraa::SUCCESS)
+        return rv;
+
+    return writeStream(m_i2c_lcd_control, LCD_DATA,
+                       &m_buffer[page * m_width + x0], x1 - x0 + 1);
+}
+
 /*
  * **************
  *  private area
@@ -17,8 +17,7 @@
 
 #include <string>
 #include <mraa/i2c.hpp>
-#include "lcd.hpp"
-#include "ssd.hpp"
+#include "ssd_framebuffer.hpp"
 
 namespace upm
 {
@@ -90,9 +89,16 @@ const uint8_t  SSD1306_LCDHEIGHT = 64;
  * SSD1306 device from eBay.
  *
  * @image html ssd1306.jpeg
+ *
+ * Besides the character and image writes, it can be drawn on through
+ * a screen buffer, see SSDFramebuffer.  refresh() then only sends the
+ * columns of each page that changed, which keeps updates of a few
+ * characters or a small graph cheap on a slow bus.
+ *
  * @snippet lcd-ssd1306-oled.cxx Interesting
+ * @snippet lcd-ssd1306-framebuffer.cxx Interesting
  */
-class SSD1306 : public LCD
+class SSD1306 : public SSDFramebuffer
 {
   public:
     /**
@@ -204,6 +210,9 @@ class SSD1306 : public LCD
      */
     void dim(bool dim);
 
+  protected:
+    mraa::Result refreshWindow(int page, int x0, int x1);
+
   private:
     mraa::Result writeChar(uint8_t value);
     mraa::Result setNormalDisplay();
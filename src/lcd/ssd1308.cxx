@@ -18,7 +18,8 @@
 
 using namespace upm;
 
-SSD1308::SSD1308(int bus_in, int addr_in) : m_i2c_lcd_control(bus_in)
+SSD1308::SSD1308(int bus_in, int addr_in) :
+    SSDFramebuffer(128, 64), m_i2c_lcd_control(bus_in)
 {
     m_lcd_control_address = addr_in;
     m_name = "SSD1308";
@@ -47,14 +48,11 @@ SSD1308::~SSD1308()
 mraa::Result
 SSD1308::draw(uint8_t* data, int bytes)
 {
-    mraa::Result error = mraa::SUCCESS;
+    // the display no longer shows the screen buffer
+    invalidate();
 
     setAddressingMode(HORIZONTAL);
-    for (int idx = 0; idx < bytes; idx++) {
-        m_i2c_lcd_control.writeReg(LCD_DATA, data[idx]);
-    }
-
-    return error;
+    return writeStream(m_i2c_lcd_control, LCD_DATA, data, bytes);
 }
 
 /*
@@ -65,6 +63,8 @@ SSD1308::draw(uint8_t* data, int bytes)
 mraa::Result
 SSD1308::write(std::string msg)
 {
+    invalidate();
+
     setAddressingMode(PAGE);
     for (std::string::size_type i = 0; i < msg.size(); ++i) {
         writeChar(msg[i]);
@@ -105,6 +105,7 @@ SSD1308::clear()
     }
     m_i2c_lcd_control.writeReg(LCD_CMD, DISPLAY_CMD_ON); // display on
     home();
+    screenCleared();
 
     return mraa::SUCCESS;
 }
@@ -115,6 +116,28 @@ SSD1308::home()
     return setCursor(0, 0);
 }
 
+/*
+ * ****************
+ *  protected area
+ * ****************
+ */
+mraa::Result
+SSD1308::refreshWindow(int page, int x0, int x1)
+{
+    uint8_t cmds[] = { DISPLAY_CMD_MEM_ADDR_MODE, PAGE,
+                       (uint8_t) (BASE_PAGE_START_ADDR + page),
+                       (uint8_t) (BASE_LOW_COLUMN_ADDR + (x0 & 0x0F)),
+                       (uint8_t) (BASE_HIGH_COLUMN_ADDR + ((x0 >> 4) & 0x0F)) };
+
+    mraa::Result rv = writeStream(m_i2c_lcd_control, DISPLAY_CMD_STREAM,
+                                  cmds, sizeof(cmds));
+    if (rv != mraa::SUCCESS)
+        return rv;
+
+    return writeStream(m_i2c_lcd_control, LCD_DATA,
+                       &m_buffer[page * m_width + x0], x1 - x0 + 1);
+}
+
 /*
  * **************
  *  private area
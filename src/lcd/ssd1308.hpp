@@ -13,8 +13,7 @@
 
 #include <string>
 #include <mraa/i2c.hpp>
-#include "lcd.hpp"
-#include "ssd.hpp"
+#include "ssd_framebuffer.hpp"
 
 namespace upm
 {
@@ -38,9 +37,13 @@ const uint8_t DISPLAY_CMD_SET_NORMAL_1308 = 0xA6;
  * Display module, which is an OLED monochrome display.
  *
  * @image html ssd1308.jpeg
+ *
+ * The drawing functions of SSDFramebuffer are also available; see the
+ * SSD1306 for an example.
+ *
  * @snippet lcd-ssd1308-oled.cxx Interesting
  */
-class SSD1308 : public LCD
+class SSD1308 : public SSDFramebuffer
 {
   public:
     /**
@@ -92,6 +95,9 @@ class SSD1308 : public LCD
      */
     mraa::Result home();
 
+  protected:
+    mraa::Result refreshWindow(int page, int x0, int x1);
+
   private:
     mraa::Result writeChar(uint8_t value);
     mraa::Result setNormalDisplay();
@@ -12,6 +12,7 @@
 #include <stdexcept>
 #include <string>
 #include <unistd.h>
+#include <vector>
 
 #include "hd44780_bits.hpp"
 #include "ssd1327.hpp"
@@ -21,12 +22,15 @@ using namespace upm;
 #define INIT_SLEEP 50000
 #define CMD_SLEEP 10000
 
-SSD1327::SSD1327(int bus_in, int addr_in) : m_i2c_lcd_control(bus_in)
+SSD1327::SSD1327(int bus_in, int addr_in) :
+    SSDFramebuffer(SSD1327_LCDWIDTH, SSD1327_LCDHEIGHT),
+    m_i2c_lcd_control(bus_in)
 {
     mraa::Result error = mraa::SUCCESS;
 
     m_lcd_control_address = addr_in;
     m_name = "SSD1327";
+    setGrayLevel(12);
 
     error = m_i2c_lcd_control.address(m_lcd_control_address);
     if (error != mraa::SUCCESS) {
@@ -138,6 +142,9 @@ SSD1327::draw(uint8_t* data, int bytes)
 {
     mraa::Result error = mraa::SUCCESS;
 
+    // the display no longer shows the screen buffer
+    invalidate();
+
     setHorizontalMode();
     for (int row = 0; row < bytes; row++) {
         for (uint8_t col = 0; col < 8; col += 2) {
@@ -167,6 +174,8 @@ SSD1327::write(std::string msg)
 {
     mraa::Result error = mraa::SUCCESS;
 
+    invalidate();
+
     setVerticalMode();
     for (std::string::size_type i = 0; i < msg.size(); ++i) {
         writeChar(msg[i]);
@@ -204,12 +213,18 @@ SSD1327::clear()
 {
     uint8_t columnIdx, rowIdx;
 
+    // the blanks must cover the whole panel for screenCleared()
+    mraa::Result rv = setTextWindow();
+    if (rv != mraa::SUCCESS)
+        return rv;
+
     for (rowIdx = 0; rowIdx < 12; rowIdx++) {
         // clear all columns
         for (columnIdx = 0; columnIdx < 12; columnIdx++) {
             writeChar(' ');
         }
     }
+    screenCleared();
 
     return mraa::SUCCESS;
 }
@@ -227,6 +242,52 @@ SSD1327::setGrayLevel(uint8_t level)
     grayLow = level & 0x0F;
 }
 
+/*
+ * ****************
+ *  protected area
+ * ****************
+ */
+mraa::Result
+SSD1327::refreshWindow(int page, int x0, int x1)
+{
+    // each display column holds 2 pixels
+    int cx0 = x0 / 2;
+    int cx1 = x1 / 2;
+
+    uint8_t cmds[] = { 0xA0, 0x42,                  // horizontal mode
+                       0x15, (uint8_t) (0x08 + cx0), // columns
+                       (uint8_t) (0x08 + cx1),
+                       0x75, (uint8_t) (page * 8),   // rows
+                       (uint8_t) (page * 8 + 7) };
+
+    mraa::Result rv = writeStream(m_i2c_lcd_control, DISPLAY_CMD_STREAM,
+                                  cmds, sizeof(cmds));
+    if (rv != mraa::SUCCESS)
+        return rv;
+
+    std::vector<uint8_t> data;
+    data.reserve(8 * (cx1 - cx0 + 1));
+
+    for (int y = page * 8; y < page * 8 + 8; y++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            uint8_t value = 0x0;
+
+            value |= getPixel(cx * 2, y) ? grayHigh : 0x00;
+            value |= getPixel(cx * 2 + 1, y) ? grayLow : 0x00;
+
+            data.push_back(value);
+        }
+    }
+
+    rv = writeStream(m_i2c_lcd_control, LCD_DATA, data.data(), data.size());
+    if (rv != mraa::SUCCESS)
+        return rv;
+
+    // refreshes change the mode and window, restore them for the text
+    // functions
+    return setTextWindow();
+}
+
 /*
  * **************
  *  private area
@@ -293,6 +354,18 @@ SSD1327::setHorizontalMode()
     return rv;
 }
 
+mraa::Result
+SSD1327::setTextWindow()
+{
+    uint8_t cmds[] = { 0xA0, 0x46,       // vertical mode
+                       0x15, 0x08, 0x37, // columns 8 - 55
+                       0x75, 0x00, 0x5f  // rows 0 - 95
+    };
+
+    return writeStream(m_i2c_lcd_control, DISPLAY_CMD_STREAM,
+                       cmds, sizeof(cmds));
+}
+
 mraa::Result
 SSD1327::setVerticalMode()
 {
@@ -13,12 +13,13 @@
 
 #include <string>
 #include <mraa/i2c.hpp>
-#include "lcd.hpp"
-#include "ssd.hpp"
+#include "ssd_framebuffer.hpp"
 
 namespace upm
 {
 const uint8_t DISPLAY_CMD_SET_NORMAL = 0xA4;
+const uint8_t SSD1327_LCDWIDTH = 96;
+const uint8_t SSD1327_LCDHEIGHT = 96;
 
 /**
  * @library lcd
@@ -37,9 +38,15 @@ const uint8_t DISPLAY_CMD_SET_NORMAL = 0xA4;
  * which is an OLED monochrome display.
  *
  * @image html ssd1327.jpeg
+ *
+ * The drawing functions of SSDFramebuffer draw in a monochrome screen
+ * buffer, which refresh() sends to the display using the current gray
+ * level.  Each changed window is sent as 4-bit pixels in one
+ * transfer, instead of a byte at a time.
+ *
  * @snippet lcd-ssd1327-oled.cxx Interesting
  */
-class SSD1327 : public LCD
+class SSD1327 : public SSDFramebuffer
 {
   public:
     /**
@@ -63,7 +70,7 @@ class SSD1327 : public LCD
      */
     mraa::Result draw(uint8_t* data, int bytes);
     /**
-     * Sets the gray level for the LCD panel
+     * Sets the gray level for the LCD panel.  The default is 12.
      *
      * @param level level from 0 to 255
      * @return Result of the operation
@@ -98,11 +105,16 @@ class SSD1327 : public LCD
      */
     mraa::Result home();
 
+  protected:
+    mraa::Result refreshWindow(int page, int x0, int x1);
+
   private:
     mraa::Result writeChar(uint8_t value);
     mraa::Result setNormalDisplay();
     mraa::Result setHorizontalMode();
     mraa::Result setVerticalMode();
+    // vertical mode and the whole panel, as the text functions expect
+    mraa::Result setTextWindow();
 
     uint8_t grayHigh;
     uint8_t grayLow;
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "ssd_framebuffer.hpp"
+
+using namespace upm;
+
+SSDFramebuffer::SSDFramebuffer(int width, int height) :
+    m_width(width), m_height(height), m_pages(height / 8),
+    m_buffer(m_pages * width, 0),
+    m_dirtyFirst(m_pages, width), m_dirtyLast(m_pages, -1),
+    m_maxTransfer(0), m_refreshBytes(0)
+{
+    if (height % 8)
+        throw std::invalid_argument(std::string(__FUNCTION__) +
+                                    ": height must be a multiple of 8");
+}
+
+SSDFramebuffer::~SSDFramebuffer()
+{
+}
+
+mraa::Result
+SSDFramebuffer::refresh()
+{
+    m_refreshBytes = 0;
+
+    for (int page = 0; page < m_pages; page++) {
+        if (m_dirtyFirst[page] > m_dirtyLast[page])
+            continue;
+
+        // a page that failed stays marked for the next refresh
+        mraa::Result rv = refreshWindow(page, m_dirtyFirst[page],
+                                        m_dirtyLast[page]);
+        if (rv != mraa::SUCCESS)
+            return rv;
+
+        m_dirtyFirst[page] = m_width;
+        m_dirtyLast[page] = -1;
+    }
+
+    return mraa::SUCCESS;
+}
+
+void
+SSDFramebuffer::invalidate()
+{
+    std::fill(m_dirtyFirst.begin(), m_dirtyFirst.end(), 0);
+    std::fill(m_dirtyLast.begin(), m_dirtyLast.end(), m_width - 1);
+}
+
+void
+SSDFramebuffer::setMaxTransfer(int bytes)
+{
+    m_maxTransfer = bytes;
+}
+
+int
+SSDFramebuffer::getRefreshBytes()
+{
+    return m_refreshBytes;
+}
+
+void
+SSDFramebuffer::clearScreenBuffer()
+{
+    fillScreen(COLOR_BLACK);
+}
+
+void
+SSDFramebuffer::fillScreen(uint8_t color)
+{
+    for (int page = 0; page < m_pages; page++) {
+        for (int x = 0; x < m_width; x++) {
+            uint8_t value = m_buffer[page * m_width + x];
+
+            switch (color) {
+            case COLOR_XOR:
+                value = ~value;
+                break;
+            case COLOR_WHITE:
+                value = 0xff;
+                break;
+            case COLOR_BLACK:
+                value = 0x00;
+                break;
+            }
+
+            setByte(page, x, value);
+        }
+    }
+}
+
+void
+SSDFramebuffer::drawPixel(int x, int y, uint8_t color)
+{
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height)
+        return;
+
+    int page = y / 8;
+    uint8_t bit = 1 << (y % 8);
+    uint8_t value = m_buffer[page * m_width + x];
+
+    switch (color) {
+    case COLOR_XOR:
+        value ^= bit;
+        break;
+    case COLOR_WHITE:
+        value |= bit;
+        break;
+    case COLOR_BLACK:
+        value &= ~bit;
+        break;
+    }
+
+    setByte(page, x, value);
+}
+
+bool
+SSDFramebuffer::getPixel(int x, int y)
+{
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height)
+        return false;
+
+    return m_buffer[(y / 8) * m_width + x] & (1 << (y % 8));
+}
+
+void
+SSDFramebuffer::drawLine(int x0, int y0, int x1, int y1, uint8_t color)
+{
+    // Bresenham, stepping along the longer axis
+    int dx = std::abs(x1 - x0);
+    int dy = -std::abs(y1 - y0);
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int err = dx + dy;
+
+    while (true) {
+        drawPixel(x0, y0, color);
+
+        if (x0 == x1 && y0 == y1)
+            break;
+
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void
+SSDFramebuffer::drawLineHorizontal(int x, int y, int width, uint8_t color)
+{
+    for (int i = 0; i < width; i++)
+        drawPixel(x + i, y, color);
+}
+
+void
+SSDFramebuffer::drawLineVertical(int x, int y, int height, uint8_t color)
+{
+    for (int i = 0; i < height; i++)
+        drawPixel(x, y + i, color);
+}
+
+void
+SSDFramebuffer::drawRectangle(int x, int y, int width, int height, uint8_t color)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    drawLineHorizontal(x, y, width, color);
+    if (height > 1)
+        drawLineHorizontal(x, y + height - 1, width, color);
+
+    // the corners are already drawn, don't toggle them twice
+    drawLineVertical(x, y + 1, height - 2, color);
+    if (width > 1)
+        drawLineVertical(x + width - 1, y + 1, height - 2, color);
+}
+
+void
+SSDFramebuffer::drawRectangleFilled(int x, int y, int width, int height, uint8_t color)
+{
+    for (int i = 0; i < width; i++)
+        drawLineVertical(x + i, y, height, color);
+}
+
+void
+SSDFramebuffer::drawString(int x, int y, std::string msg, uint8_t color)
+{
+    for (std::string::size_type i = 0; i < msg.size(); i++, x += 8) {
+        uint8_t value = msg[i];
+        if (value < 0x20 || value > 0x7F) {
+            value = 0x20; // space
+        }
+
+        for (int col = 0; col < 8; col++) {
+            uint8_t bits = BasicFont[value - 32][col];
+
+            for (int row = 0; row < 8; row++) {
+                bool on = bits & (1 << row);
+
+                if (color == COLOR_XOR) {
+                    if (on)
+                        drawPixel(x + col, y + row, COLOR_XOR);
+                } else {
+                    drawPixel(x + col, y + row,
+                              (on == (color == COLOR_WHITE)) ?
+                              COLOR_WHITE : COLOR_BLACK);
+                }
+            }
+        }
+    }
+}
+
+mraa::Result
+SSDFramebuffer::writeStream(mraa::I2c& i2c, uint8_t control,
+                            const uint8_t* data, int len)
+{
+    int chunk = (m_maxTransfer > 1) ? m_maxTransfer - 1 : len;
+    std::vector<uint8_t> buf(std::min(chunk, len) + 1);
+
+    buf[0] = control;
+
+    for (int offset = 0; offset < len; offset += chunk) {
+        int n = std::min(chunk, len - offset);
+
+        std::copy(data + offset, data + offset + n, buf.begin() + 1);
+
+        // count the address byte as well
+        m_refreshBytes += n + 2;
+
+        mraa::Result rv = i2c.write(buf.data(), n + 1);
+        if (rv != mraa::SUCCESS)
+            return rv;
+    }
+
+    return mraa::SUCCESS;
+}
+
+void
+SSDFramebuffer::screenCleared()
+{
+    for (int page = 0; page < m_pages; page++) {
+        m_dirtyFirst[page] = m_width;
+        m_dirtyLast[page] = -1;
+
+        for (int x = 0; x < m_width; x++) {
+            if (m_buffer[page * m_width + x]) {
+                m_dirtyFirst[page] = std::min(m_dirtyFirst[page], x);
+                m_dirtyLast[page] = x;
+            }
+        }
+    }
+}
+
+void
+SSDFramebuffer::setByte(int page, int x, uint8_t value)
+{
+    uint8_t& current = m_buffer[page * m_width + x];
+
+    if (current == value)
+        return;
+
+    current = value;
+
+    if (x < m_dirtyFirst[page])
+        m_dirtyFirst[page] = x;
+    if (x > m_dirtyLast[page])
+        m_dirtyLast[page] = x;
+}
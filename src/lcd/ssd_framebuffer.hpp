@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mraa/i2c.hpp>
+
+#include "lcd.hpp"
+#include "ssd.hpp"
+
+namespace upm
+{
+/**
+ * @brief Screen buffer for the SSD13xx I2C OLED displays
+ *
+ * This is the base class of the SSD1306, SSD1308 and SSD1327
+ * drivers.  It keeps a monochrome screen buffer laid out like the
+ * SSD1306 display RAM: 8 pixel high pages, one byte per column with
+ * the top pixel in bit 0.
+ *
+ * Drawing only changes the screen buffer.  For each page, the range
+ * of columns whose contents actually changed is tracked, and
+ * refresh() sends just those column windows to the display, each in
+ * as few I2C transfers as setMaxTransfer() allows.  Redrawing a line
+ * of text with one changed digit then only costs a few bytes on the
+ * bus, instead of a full frame.
+ *
+ * refresh() assumes the display shows the screen buffer.  Using
+ * draw() or write() marks the whole screen buffer as changed, so
+ * the next refresh() redraws everything.
+ */
+class SSDFramebuffer : public LCD
+{
+  public:
+    /**
+     * SSDFramebuffer constructor
+     *
+     * @param width Display width, in pixels
+     * @param height Display height, in pixels.  This must be a
+     * multiple of 8.
+     */
+    SSDFramebuffer(int width, int height);
+
+    /**
+     * SSDFramebuffer destructor
+     */
+    virtual ~SSDFramebuffer();
+
+    /**
+     * Send the parts of the screen buffer that changed since the last
+     * refresh() to the display
+     *
+     * @return Result of the operation
+     */
+    mraa::Result refresh();
+
+    /**
+     * Mark the whole screen buffer as changed, so that the next
+     * refresh() redraws the whole display
+     */
+    void invalidate();
+
+    /**
+     * Set the largest I2C transfer to use, in bytes, for adapters that
+     * can't handle long transfers.  The default, 0, sends each window
+     * in a single transfer.
+     *
+     * @param bytes The largest transfer size, or 0 for no limit
+     */
+    void setMaxTransfer(int bytes);
+
+    /**
+     * Return the number of bus bytes, including the address bytes,
+     * sent by the last refresh()
+     *
+     * @return The bus bytes sent by the last refresh
+     */
+    int getRefreshBytes();
+
+    /**
+     * Clear the screen buffer
+     */
+    void clearScreenBuffer();
+
+    /**
+     * Fill the screen buffer with specified color.
+     *
+     * @param color fill color is COLOR_WHITE, COLOR_BLACK or COLOR_XOR
+     */
+    void fillScreen(uint8_t color = COLOR_WHITE);
+
+    /**
+     * Write a single pixel to the screen buffer.
+     * Can do an specific color write or toggle (xor) a pixel.
+     *
+     * @param x the x position of the pixel
+     * @param y the y position of the pixel
+     * @param color pixel is COLOR_WHITE, COLOR_BLACK or COLOR_XOR
+     */
+    void drawPixel(int x, int y, uint8_t color = COLOR_WHITE);
+
+    /**
+     * Return whether a pixel of the screen buffer is set
+     *
+     * @param x the x position of the pixel
+     * @param y the y position of the pixel
+     * @return true if the pixel is set, false if not or if it's off
+     * the screen
+     */
+    bool getPixel(int x, int y);
+
+    /**
+     * Draw a line to the screen buffer.
+     *
+     * @param x0 the x position of the beginning of the line
+     * @param y0 the y position of the beginning of the line
+     * @param x1 the x position of the end of the line
+     * @param y1 the y position of the end of the line
+     * @param color line is COLOR_WHITE, COLOR_BLACK or COLOR_XOR
+     */
+    void drawLine(int x0, int y0, int x1, int y1, uint8_t color = COLOR_WHITE);
+
+    /**
+     * Draw a horizontal line to the screen buffer.
+     *
+     * @param x the x position of the beginning of the line
+     * @param y the y position of the beginning of the line
+     * @param width is the horizontal length of the line
+     * @param color line is COLOR_WHITE, COLOR_BLACK or COLOR_XOR
+     */
+    void drawLineHorizontal(int x, int y, int width, uint8_t color = COLOR_WHITE);
+
+    /**
+     * Draw a vertical line to the screen buffer.
+     *
+     * @param x the x position of the beginning of the line
+     * @param y the y position of the beginning of the line
+     * @param height is the vertical length of the line
+     * @param color line is COLOR_WHITE, COLOR_BLACK or COLOR_XOR
+     */
+    void drawLineVertical(int x, int y, int height, uint8_t color = COLOR_WHITE);
+
+    /**
+     * Draw a rectangle to the screen buffer.
+     *
+     * @param x the left edge
+     * @param y the top edge
+     * @param width sets the right edge
+     * @param height bottom edge
+     * @param color outline is COLOR_WHITE, COLOR_BLACK or COLOR_XOR
+     */
+    void drawRectangle(int x, int y, int width, int height, uint8_t color = COLOR_WHITE);
+
+    /**
+     * Draw a filled rectangle to the screen buffer.
+     *
+     * @param x the left edge
+     * @param y the top edge
+     * @param width sets the right edge
+     * @param height bottom edge
+     * @param color fill color is COLOR_WHITE, COLOR_BLACK or COLOR_XOR
+     */
+    void drawRectangleFilled(int x, int y, int width, int height, uint8_t color = COLOR_WHITE);
+
+    /**
+     * Draw a string to the screen buffer, using the 8x8 font.  Each
+     * character replaces the 8x8 cell it is drawn in, so that text
+     * can be redrawn in place.  With COLOR_BLACK the text is drawn
+     * inverted, and with COLOR_XOR only the character pixels are
+     * toggled.
+     *
+     * @param x the x position of the first character
+     * @param y the y position of the first character
+     * @param msg the std::string to draw, note only ascii chars are
+     * supported
+     * @param color text is COLOR_WHITE, COLOR_BLACK or COLOR_XOR
+     */
+    void drawString(int x, int y, std::string msg, uint8_t color = COLOR_WHITE);
+
+  protected:
+    /**
+     * Send a column window of a page of the screen buffer to the
+     * display
+     *
+     * @param page The page
+     * @param x0 The first column
+     * @param x1 The last column
+     * @return Result of the operation
+     */
+    virtual mraa::Result refreshWindow(int page, int x0, int x1) = 0;
+
+    // send a control byte followed by data, split into transfers of
+    // at most m_maxTransfer bytes
+    mraa::Result writeStream(mraa::I2c& i2c, uint8_t control,
+                             const uint8_t* data, int len);
+
+    // the display was cleared, mark whatever isn't blank as changed
+    void screenCleared();
+
+    // set a byte of the screen buffer, tracking changes
+    void setByte(int page, int x, uint8_t value);
+
+    int m_width;
+    int m_height;
+    int m_pages;
+
+    // pages of m_width bytes
+    std::vector<uint8_t> m_buffer;
+
+  private:
+    // first and last changed column of each page, first > last when
+    // unchanged
+    std::vector<int> m_dirtyFirst;
+    std::vector<int> m_dirtyLast;
+
+    int m_maxTransfer;
+    int m_refreshBytes;
+};
+}
@@ -32,6 +32,34 @@ static upm_result_t send(const lcm1602_context dev, uint8_t value, int mode);
 static upm_result_t write4bits(const lcm1602_context dev, uint8_t value);
 static upm_result_t expandWrite(const lcm1602_context dev, uint8_t value);
 static upm_result_t pulseEnable(const lcm1602_context dev, uint8_t value);
+static uint8_t ddramAddr(const lcm1602_context dev, unsigned int row,
+                         unsigned int column);
+
+// unchanged characters a render run may span, rather than moving the
+// cursor.  Moving the cursor costs as much as one character.
+#define RENDER_MAX_GAP 1
+
+// size of the I2C expander batch buffer used by lcm1602_render()
+#define RENDER_BATCH_MAX 128
+
+// bus bytes needed to send a byte through lcm1602_data() or
+// lcm1602_command() with an I2C expander: two nibbles, each written
+// then pulsed in three single byte transactions
+#define EXPANDER_BYTE_COST 12
+
+// batched transfers for lcm1602_render()
+typedef struct {
+    uint8_t buf[RENDER_BATCH_MAX];
+    int len;
+    // RS state of the expander outputs, -1 if unknown
+    int mode;
+} render_batch_t;
+
+static upm_result_t batchFlush(const lcm1602_context dev,
+                               render_batch_t *batch);
+static upm_result_t batchSend(const lcm1602_context dev,
+                              render_batch_t *batch, uint8_t value,
+                              int mode);
 
 lcm1602_context lcm1602_i2c_init(int bus, int address, bool is_expander,
                                  uint8_t num_columns, uint8_t num_rows)
@@ -78,6 +106,14 @@ lcm1602_context lcm1602_i2c_init(int bus, int address, bool is_expander,
     dev->columns = num_columns;
     dev->rows = num_rows;
 
+    if (!(dev->shadow = (char *)malloc(num_columns * num_rows)))
+    {
+        printf("%s: malloc() failed.\n", __FUNCTION__);
+        lcm1602_close(dev);
+        return NULL;
+    }
+    dev->cursorAddr = -1;
+
     // if we are not dealing with an expander we will only initialize
     // the I2C context and bail, leaving it up to the caller to handle
     // further communications (like JHD1313M1)
@@ -200,6 +236,14 @@ lcm1602_context lcm1602_gpio_init(int rs, int enable,
     dev->columns = num_columns;
     dev->rows = num_rows;
 
+    if (!(dev->shadow = (char *)malloc(num_columns * num_rows)))
+    {
+        printf("%s: malloc() failed.\n", __FUNCTION__);
+        lcm1602_close(dev);
+        return NULL;
+    }
+    dev->cursorAddr = -1;
+
     // set RS and Enable low to begin issuing commands
     mraa_gpio_write(dev->gpioRS, 0);
     mraa_gpio_write(dev->gpioEN, 0);
@@ -266,6 +310,7 @@ void lcm1602_close(lcm1602_context dev)
     if (dev->gpioD3)
         mraa_gpio_close(dev->gpioD3);
 
+    free(dev->shadow);
     free(dev);
 }
 
@@ -283,63 +328,120 @@ upm_result_t lcm1602_write(const lcm1602_context dev, char *buffer,
     return error;
 }
 
-upm_result_t lcm1602_set_cursor(const lcm1602_context dev, unsigned int row,
-                                unsigned int column)
+upm_result_t lcm1602_render(const lcm1602_context dev, const char *frame)
 {
     assert(dev != NULL);
 
-    column = column % dev->columns;
-    uint8_t offset = column;
+    // runs only carry on through DDRAM when entering left to right
+    // without autoscroll, otherwise every character needs a cursor
+    // move
+    bool contiguous = (dev->entryDisplayMode == HD44780_ENTRYLEFT);
+    bool full = !dev->shadowValid;
 
-    switch (dev->rows)
-    {
-    case 1:
-        // Single row displays with more than 8 columns usually have their
-        // DDRAM split in two halves. The first half starts at address 00.
-        // The second half starts at address 40. E.g. 16x2 DDRAM mapping:
-        // 00 01 02 03 04 05 06 07 40 41 42 43 44 45 46 47
-        if (dev->columns > 8)
-        {
-            offset = (column % (dev->columns / 2)) +
-                (column / (dev->columns / 2)) * 0x40;
-        }
-        break;
+    render_batch_t batch;
+    batch.len = 0;
+    batch.mode = -1;
 
-    case 2:
-        // this should work for any display with two rows
-        // DDRAM mapping:
-        // 00 .. 27
-        // 40 .. 67
-        offset += row * 0x40;
-        break;
+    upm_result_t rv = UPM_SUCCESS;
+    dev->renderBytes = 0;
 
-    case 4:
-        if (dev->columns == 16)
-        {
-            // 16x4 display
-            // DDRAM mapping:
-            // 00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F
-            // 40 41 42 43 43 45 46 47 48 49 4A 4B 4C 4D 4E 4F
-            // 10 11 12 13 14 15 16 17 18 19 1A 1B 1C 1D 1E 1F
-            // 50 51 52 53 54 55 56 57 58 59 5A 5B 5C 5D 5E 5F
-            int row_addr[] = { 0x00, 0x40, 0x10, 0x50 };
-            offset += row_addr[row];
-        }
-        else
+    unsigned int row;
+    for (row = 0; row < dev->rows && rv == UPM_SUCCESS; row++)
+    {
+        const char *src = frame + row * dev->columns;
+        char *dst = dev->shadow + row * dev->columns;
+
+        unsigned int col = 0;
+        while (col < dev->columns && rv == UPM_SUCCESS)
         {
-            // 20x4 display
-            // DDRAM mapping:
-            // 00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F 10 11 12 13
-            // 40 41 42 43 43 45 46 47 48 49 4A 4B 4C 4D 4E 4F 50 51 52 53
-            // 14 15 16 17 18 19 1A 1B 1C 1D 1E 1F 20 21 22 23 24 25 26 27
-            // 54 55 56 57 58 59 5A 5B 5C 5D 5E 5F 60 61 62 63 64 65 66 67
-            int row_addr[] = { 0x00, 0x40, 0x14, 0x54 };
-            offset += row_addr[row];
+            if (!full && src[col] == dst[col])
+            {
+                col++;
+                continue;
+            }
+
+            // extend the run over the following changes, as long as
+            // the gaps are short enough
+            unsigned int end = col + 1;
+            unsigned int i;
+
+            if (contiguous)
+            {
+                for (i = end; i < dev->columns && i - end <= RENDER_MAX_GAP;
+                     i++)
+                {
+                    if (full || src[i] != dst[i])
+                        end = i + 1;
+                }
+            }
+
+            uint8_t addr = ddramAddr(dev, row, col);
+
+            // a row may be split over two DDRAM areas (single row
+            // displays), end the run where the addresses jump
+            for (i = col + 1; i < end; i++)
+            {
+                if (ddramAddr(dev, row, i) != addr + (i - col))
+                {
+                    end = i;
+                    break;
+                }
+            }
+
+            if (!contiguous || addr != dev->cursorAddr)
+                rv = batchSend(dev, &batch, HD44780_CMD | addr, 0);
+
+            for (i = col; i < end && rv == UPM_SUCCESS; i++)
+            {
+                rv = batchSend(dev, &batch, src[i], HD44780_RS);
+                dst[i] = src[i];
+            }
+
+            dev->cursorAddr = (contiguous) ? (int)(addr + (end - col)) : -1;
+            col = end;
         }
-        break;
     }
 
-    return lcm1602_command(dev, HD44780_CMD | offset);
+    if (rv == UPM_SUCCESS)
+        rv = batchFlush(dev, &batch);
+
+    // on failure we don't know what the display shows
+    dev->shadowValid = (rv == UPM_SUCCESS);
+    if (rv != UPM_SUCCESS)
+        dev->cursorAddr = -1;
+
+    unsigned int fullBytes = dev->rows * (dev->columns + 1);
+    if (dev->isI2C)
+        fullBytes *= EXPANDER_BYTE_COST;
+
+    if (fullBytes > dev->renderBytes)
+        dev->renderBytesSaved = fullBytes - dev->renderBytes;
+    else
+        dev->renderBytesSaved = 0;
+
+    return rv;
+}
+
+unsigned int lcm1602_get_render_bytes(const lcm1602_context dev)
+{
+    assert(dev != NULL);
+
+    return dev->renderBytes;
+}
+
+unsigned int lcm1602_get_render_bytes_saved(const lcm1602_context dev)
+{
+    assert(dev != NULL);
+
+    return dev->renderBytesSaved;
+}
+
+upm_result_t lcm1602_set_cursor(const lcm1602_context dev, unsigned int row,
+                                unsigned int column)
+{
+    assert(dev != NULL);
+
+    return lcm1602_command(dev, HD44780_CMD | ddramAddr(dev, row, column));
 }
 
 upm_result_t lcm1602_clear(const lcm1602_context dev)
@@ -349,6 +451,15 @@ upm_result_t lcm1602_clear(const lcm1602_context dev)
     upm_result_t ret;
     ret = lcm1602_command(dev, HD44780_CLEARDISPLAY);
     upm_delay_us(2000); // this command takes awhile
+
+    if (ret == UPM_SUCCESS)
+    {
+        // the display is now all spaces, with the cursor at home
+        memset(dev->shadow, ' ', dev->columns * dev->rows);
+        dev->shadowValid = true;
+        dev->cursorAddr = 0;
+    }
+
     return ret;
 }
 
@@ -359,6 +470,10 @@ upm_result_t lcm1602_home(const lcm1602_context dev)
     upm_result_t ret;
     ret = lcm1602_command(dev, HD44780_RETURNHOME);
     upm_delay_us(2000); // this command takes awhile
+
+    if (ret == UPM_SUCCESS)
+        dev->cursorAddr = 0;
+
     return ret;
 }
 
@@ -376,9 +491,11 @@ upm_result_t lcm1602_create_char(const lcm1602_context dev,
 
     if (error == UPM_SUCCESS)
     {
+        // send directly, writing CGRAM doesn't change the display
+        // contents
         int i;
         for (i = 0; i < 8; i++) {
-            error = lcm1602_data(dev, data[i]);
+            error = send(dev, data[i], HD44780_RS);
         }
     }
 
@@ -477,12 +594,20 @@ upm_result_t lcm1602_command(const lcm1602_context dev, uint8_t cmd)
 {
     assert(dev != NULL);
 
+    // commands may move the address counter
+    dev->cursorAddr = -1;
+
     return send(dev, cmd, 0);
 }
 
 upm_result_t lcm1602_data(const lcm1602_context dev, uint8_t cmd)
 {
     assert(dev != NULL);
+
+    // the next render must redraw everything
+    dev->shadowValid = false;
+    dev->cursorAddr = -1;
+
     return send(dev, cmd, HD44780_RS); // 1
 }
 
@@ -625,3 +750,126 @@ static upm_result_t pulseEnable(const lcm1602_context dev,
 
     return rv;
 }
+
+static uint8_t ddramAddr(const lcm1602_context dev, unsigned int row,
+                         unsigned int column)
+{
+    assert(dev != NULL);
+
+    column = column % dev->columns;
+    uint8_t offset = column;
+
+    switch (dev->rows)
+    {
+    case 1:
+        // Single row displays with more than 8 columns usually have their
+        // DDRAM split in two halves. The first half starts at address 00.
+        // The second half starts at address 40. E.g. 16x2 DDRAM mapping:
+        // 00 01 02 03 04 05 06 07 40 41 42 43 44 45 46 47
+        if (dev->columns > 8)
+        {
+            offset = (column % (dev->columns / 2)) +
+                (column / (dev->columns / 2)) * 0x40;
+        }
+        break;
+
+    case 2:
+        // this should work for any display with two rows
+        // DDRAM mapping:
+        // 00 .. 27
+        // 40 .. 67
+        offset += row * 0x40;
+        break;
+
+    case 4:
+        if (dev->columns == 16)
+        {
+            // 16x4 display
+            // DDRAM mapping:
+            // 00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F
+            // 40 41 42 43 43 45 46 47 48 49 4A 4B 4C 4D 4E 4F
+            // 10 11 12 13 14 15 16 17 18 19 1A 1B 1C 1D 1E 1F
+            // 50 51 52 53 54 55 56 57 58 59 5A 5B 5C 5D 5E 5F
+            int row_addr[] = { 0x00, 0x40, 0x10, 0x50 };
+            offset += row_addr[row];
+        }
+        else
+        {
+            // 20x4 display
+            // DDRAM mapping:
+            // 00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F 10 11 12 13
+            // 40 41 42 43 43 45 46 47 48 49 4A 4B 4C 4D 4E 4F 50 51 52 53
+            // 14 15 16 17 18 19 1A 1B 1C 1D 1E 1F 20 21 22 23 24 25 26 27
+            // 54 55 56 57 58 59 5A 5B 5C 5D 5E 5F 60 61 62 63 64 65 66 67
+            int row_addr[] = { 0x00, 0x40, 0x14, 0x54 };
+            offset += row_addr[row];
+        }
+        break;
+    }
+
+    return offset;
+}
+
+static upm_result_t batchFlush(const lcm1602_context dev,
+                               render_batch_t *batch)
+{
+    assert(dev != NULL);
+
+    if (!batch->len)
+        return UPM_SUCCESS;
+
+    // count the address byte as well
+    dev->renderBytes += batch->len + 1;
+
+    int len = batch->len;
+    batch->len = 0;
+
+    if (mraa_i2c_write(dev->i2c, batch->buf, len))
+    {
+        printf("%s: mraa_i2c_write() failed\n", __FUNCTION__);
+        return UPM_ERROR_OPERATION_FAILED;
+    }
+
+    return UPM_SUCCESS;
+}
+
+static upm_result_t batchSend(const lcm1602_context dev,
+                              render_batch_t *batch, uint8_t value,
+                              int mode)
+{
+    assert(dev != NULL);
+
+    // nothing to batch over gpio
+    if (!dev->isI2C)
+    {
+        dev->renderBytes++;
+        return send(dev, value, mode);
+    }
+
+    // worst case is an RS setup byte and two pulsed nibbles
+    if (batch->len + 5 > RENDER_BATCH_MAX)
+    {
+        if (batchFlush(dev, batch))
+            return UPM_ERROR_OPERATION_FAILED;
+    }
+
+    uint8_t nibbles[2] = { value & 0xf0, (value << 4) & 0xf0 };
+    int i;
+
+    // RS must be settled before EN rises.  The data lines only need
+    // to be valid when EN falls, so they can change along with it.
+    if (mode != batch->mode)
+    {
+        batch->buf[batch->len++] = nibbles[0] | mode | dev->backlight;
+        batch->mode = mode;
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        batch->buf[batch->len++] = nibbles[i] | mode | HD44780_EN
+            | dev->backlight;
+        batch->buf[batch->len++] = nibbles[i] | mode | dev->backlight;
+    }
+
+    return UPM_SUCCESS;
+}
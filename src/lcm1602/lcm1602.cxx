@@ -57,6 +57,23 @@ upm_result_t Lcm1602::write(std::string msg)
     return lcm1602_write(m_lcm1602, (char *)msg.data(), msg.size());
 }
 
+upm_result_t Lcm1602::render(std::string frame)
+{
+    frame.resize(m_lcm1602->rows * m_lcm1602->columns, ' ');
+
+    return lcm1602_render(m_lcm1602, frame.data());
+}
+
+unsigned int Lcm1602::getRenderBytes()
+{
+    return lcm1602_get_render_bytes(m_lcm1602);
+}
+
+unsigned int Lcm1602::getRenderBytesSaved()
+{
+    return lcm1602_get_render_bytes_saved(m_lcm1602);
+}
+
 upm_result_t Lcm1602::setCursor(int row, int column)
 {
     return lcm1602_set_cursor(m_lcm1602, row, column);
@@ -66,6 +66,17 @@ extern "C" {
         uint8_t                  displayControl;
         uint8_t                  entryDisplayMode;
         uint8_t                  backlight;
+
+        // what lcm1602_render() last put in DDRAM, rows * columns
+        char                     *shadow;
+        bool                     shadowValid;
+        // DDRAM address of the cursor, -1 if unknown
+        int                      cursorAddr;
+
+        // bus bytes used by the last render, and saved compared to
+        // rewriting every row
+        unsigned int             renderBytes;
+        unsigned int             renderBytesSaved;
     } *lcm1602_context;
 
     /**
@@ -126,6 +137,48 @@ extern "C" {
     upm_result_t lcm1602_write(const lcm1602_context dev, char *buffer,
                                int len);
 
+    /**
+     * Render a full frame on the display.  Only the characters that
+     * differ from what the display already shows (as far as the
+     * driver knows) are sent.  Nearby changes are grouped into runs,
+     * the cursor is only moved where a run doesn't start at the
+     * current cursor position, and with an I2C expander all of the
+     * nibble transfers are batched into as few I2C writes as
+     * possible.
+     *
+     * The first render after initialization, or after
+     * lcm1602_write() or lcm1602_data() were used, redraws the whole
+     * display.  The cursor is left after the last character written.
+     *
+     * @param dev The device context.
+     * @param frame Buffer containing rows * columns characters, row
+     * by row.
+     * @return UPM result.
+     */
+    upm_result_t lcm1602_render(const lcm1602_context dev,
+                                const char *frame);
+
+    /**
+     * Return the number of bus bytes used by the last
+     * lcm1602_render().  For I2C expanders this includes the address
+     * byte of each transaction.  For GPIO connected displays, this is
+     * the number of bytes sent to the controller.
+     *
+     * @param dev The device context.
+     * @return The bus bytes used by the last render.
+     */
+    unsigned int lcm1602_get_render_bytes(const lcm1602_context dev);
+
+    /**
+     * Return the number of bus bytes the last lcm1602_render() saved,
+     * compared to rewriting every row with lcm1602_set_cursor() and
+     * lcm1602_write().
+     *
+     * @param dev The device context.
+     * @return The bus bytes saved by the last render.
+     */
+    unsigned int lcm1602_get_render_bytes_saved(const lcm1602_context dev);
+
     /**
      * Sets the cursor to specified coordinates
      *
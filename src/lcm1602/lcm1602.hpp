@@ -51,11 +51,16 @@ namespace upm
  * parallel GPIO connections directly to the HD44780 in case you are not using
  * an I2C expander/backpack.
  *
+ * For displays that are refreshed often, render() keeps a copy of
+ * what the display shows and only sends the characters that changed.
+ *
  * @image html lcm1602.jpeg
  * Example for LCM1602 displays that use the I2C bus
  * @snippet lcm1602-i2c.cxx Interesting
  * Code sample for GPIO based LCM1602 displays
  * @snippet lcm1602-parallel.cxx Interesting
+ * Refreshing a status display with render()
+ * @snippet lcm1602-render.cxx Interesting
  */
     class Lcm1602
     {
@@ -105,6 +110,35 @@ namespace upm
          */
         upm_result_t write(std::string msg);
 
+        /**
+         * Render a full frame on the display.  Only the characters
+         * that differ from what the display already shows are sent,
+         * with as few cursor moves as possible.  With an I2C expander,
+         * the transfers are batched into as few I2C writes as
+         * possible.  The first render after write() was used redraws
+         * the whole display.
+         *
+         * @param frame The characters to display, row by row.  It is
+         * padded with spaces or truncated to fill the display.
+         * @return Result of the operation
+         */
+        upm_result_t render(std::string frame);
+
+        /**
+         * Return the number of bus bytes used by the last render()
+         *
+         * @return The bus bytes used by the last render
+         */
+        unsigned int getRenderBytes();
+
+        /**
+         * Return the number of bus bytes the last render() saved,
+         * compared to rewriting every row with setCursor() and write()
+         *
+         * @return The bus bytes saved by the last render
+         */
+        unsigned int getRenderBytesSaved();
+
         /**
          * Sets the cursor to specified coordinates
          *
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "ledstrip.hpp"
+
+using namespace upm;
+
+LEDStrip::LEDStrip() :
+    m_ledCount(0), m_brightness(255), m_gamma(1.0), m_wireValid(false),
+    m_maxTransfer(0), m_pendingValid(false), m_pushing(false),
+    m_framesDropped(0)
+{
+}
+
+LEDStrip::~LEDStrip()
+{
+    // drivers should have stopped it already, see the class description
+    if (m_pushThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_pushing = false;
+        }
+        m_cv.notify_one();
+        m_pushThread.join();
+    }
+}
+
+void
+LEDStrip::initStrip(int ledCount, int frameLength)
+{
+    m_ledCount = ledCount;
+    m_rgb.assign(ledCount * 3, 0);
+    m_pending.assign(frameLength, 0);
+    m_sending.assign(frameLength, 0);
+}
+
+int
+LEDStrip::getLedCount()
+{
+    return m_ledCount;
+}
+
+void
+LEDStrip::setPixel(int idx, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (idx < 0 || idx >= m_ledCount)
+        return;
+
+    m_rgb[idx * 3] = r;
+    m_rgb[idx * 3 + 1] = g;
+    m_rgb[idx * 3 + 2] = b;
+}
+
+void
+LEDStrip::setPixels(int startIdx, int endIdx, uint8_t r, uint8_t g, uint8_t b)
+{
+    startIdx = std::max(startIdx, 0);
+    endIdx = std::min(endIdx, m_ledCount - 1);
+
+    for (int i = startIdx; i <= endIdx; i++) {
+        m_rgb[i * 3] = r;
+        m_rgb[i * 3 + 1] = g;
+        m_rgb[i * 3 + 2] = b;
+    }
+}
+
+void
+LEDStrip::setPixelHSV(int idx, uint16_t h, uint8_t s, uint8_t v)
+{
+    // six sectors of 60 degrees, with the position in the sector
+    // scaled to 0-255
+    h %= 360;
+    int sector = h / 60;
+    int f = (h % 60) * 255 / 60;
+
+    uint8_t p = v * (255 - s) / 255;
+    uint8_t q = v * (255 - s * f / 255) / 255;
+    uint8_t t = v * (255 - s * (255 - f) / 255) / 255;
+
+    switch (sector) {
+    case 0:  setPixel(idx, v, t, p); break;
+    case 1:  setPixel(idx, q, v, p); break;
+    case 2:  setPixel(idx, p, v, t); break;
+    case 3:  setPixel(idx, p, q, v); break;
+    case 4:  setPixel(idx, t, p, v); break;
+    default: setPixel(idx, v, p, q); break;
+    }
+}
+
+void
+LEDStrip::setBrightness(uint8_t brightness)
+{
+    m_brightness = brightness;
+    m_wireValid = false;
+}
+
+void
+LEDStrip::setGamma(float gamma)
+{
+    m_gamma = gamma;
+    m_wireValid = false;
+}
+
+void
+LEDStrip::setMaxTransfer(int bytes)
+{
+    m_maxTransfer = bytes;
+}
+
+void
+LEDStrip::show()
+{
+    if (!m_wireValid)
+        buildWireTable();
+
+    if (!m_pushThread.joinable()) {
+        encodeFrame(m_sending.data());
+        writeFrame(m_sending.data(), m_sending.size());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        if (m_pushError) {
+            std::exception_ptr error = m_pushError;
+            m_pushError = nullptr;
+            std::rethrow_exception(error);
+        }
+
+        encodeFrame(m_pending.data());
+        if (m_pendingValid)
+            m_framesDropped++;
+        m_pendingValid = true;
+    }
+    m_cv.notify_one();
+}
+
+void
+LEDStrip::startPushThread()
+{
+    if (m_pushThread.joinable())
+        return;
+
+    m_pushing = true;
+    m_pushThread = std::thread(&LEDStrip::pushThread, this);
+}
+
+void
+LEDStrip::stopPushThread()
+{
+    if (!m_pushThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_pushing = false;
+    }
+    m_cv.notify_one();
+    m_pushThread.join();
+}
+
+unsigned int
+LEDStrip::getFramesDropped()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_framesDropped;
+}
+
+uint8_t
+LEDStrip::wireValue(uint8_t level)
+{
+    return level;
+}
+
+void
+LEDStrip::spiWrite(mraa::Spi& spi, const uint8_t *data, int len)
+{
+    int chunk = (m_maxTransfer > 0) ? m_maxTransfer : len;
+
+    for (int offset = 0; offset < len; offset += chunk) {
+        int n = std::min(chunk, len - offset);
+
+        if (spi.transfer(const_cast<uint8_t *>(data + offset), NULL, n)
+            != mraa::SUCCESS) {
+            throw std::runtime_error(std::string(__FUNCTION__) +
+                                     ": SPI transfer failed");
+        }
+    }
+}
+
+void
+LEDStrip::buildWireTable()
+{
+    for (int v = 0; v < 256; v++) {
+        float level = std::pow(v / 255.0f, m_gamma) * m_brightness;
+        m_wire[v] = wireValue((uint8_t) std::lround(level));
+    }
+
+    m_wireValid = true;
+}
+
+void
+LEDStrip::pushThread()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (true) {
+        m_cv.wait(lock, [this] { return m_pendingValid || !m_pushing; });
+
+        // send the last frame before stopping
+        if (!m_pendingValid)
+            break;
+
+        std::swap(m_pending, m_sending);
+        m_pendingValid = false;
+
+        lock.unlock();
+        try {
+            writeFrame(m_sending.data(), m_sending.size());
+        } catch (...) {
+            lock.lock();
+            m_pushError = std::current_exception();
+            continue;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <mraa/spi.hpp>
+
+namespace upm
+{
+    /**
+     * @brief LEDStrip helper class
+     *
+     * Frame engine shared by the LED strip drivers (APA102, LPD8806,
+     * P9813).  Pixels are set as RGB or HSV in a pixel buffer.  show()
+     * encodes the whole buffer into the wire format of the chip, through
+     * a table combining gamma correction, global brightness and the
+     * chip's own encoding of a color level, then sends it as one frame.
+     *
+     * With startPushThread(), frames are sent by a background thread
+     * instead: show() only encodes the frame and returns, so animation
+     * runs independently of the transfer.  If frames are shown faster
+     * than they can be sent, the ones not yet picked up are replaced by
+     * newer ones, see getFramesDropped().
+     *
+     * A driver provides encodeFrame() and writeFrame(), and may override
+     * wireValue().  Since writeFrame() runs on the push thread, drivers
+     * must call stopPushThread() first thing in their destructor.
+     */
+    class LEDStrip {
+        public:
+            /**
+             * LEDStrip destructor
+             */
+            virtual ~LEDStrip();
+
+            /**
+             * Returns the number of LEDs in the strip
+             *
+             * @return The number of LEDs
+             */
+            int getLedCount();
+
+            /**
+             * Sets the color of an LED in the pixel buffer.  Nothing is
+             * sent until show() is called.
+             *
+             * @param idx Index of the LED in the strip (0 based)
+             * @param r Red component (0-255)
+             * @param g Green component (0-255)
+             * @param b Blue component (0-255)
+             */
+            void setPixel(int idx, uint8_t r, uint8_t g, uint8_t b);
+
+            /**
+             * Sets the color of a range of LEDs in the pixel buffer
+             *
+             * @param startIdx Index of the first LED (0 based)
+             * @param endIdx Index of the last LED (0 based)
+             * @param r Red component (0-255)
+             * @param g Green component (0-255)
+             * @param b Blue component (0-255)
+             */
+            void setPixels(int startIdx, int endIdx, uint8_t r, uint8_t g, uint8_t b);
+
+            /**
+             * Sets the color of an LED in the pixel buffer, as hue,
+             * saturation and value
+             *
+             * @param idx Index of the LED in the strip (0 based)
+             * @param h Hue in degrees (0-359)
+             * @param s Saturation (0-255)
+             * @param v Value (0-255)
+             */
+            void setPixelHSV(int idx, uint16_t h, uint8_t s, uint8_t v);
+
+            /**
+             * Sets the global brightness, applied to every LED when the
+             * frame is encoded.  The default is 255.
+             *
+             * @param brightness Brightness (0-255)
+             */
+            void setBrightness(uint8_t brightness);
+
+            /**
+             * Sets the gamma correction applied to the color components
+             * when the frame is encoded.  The default is 1.0, no
+             * correction; about 2.5 makes fades look even on most LEDs.
+             *
+             * @param gamma Gamma exponent
+             */
+            void setGamma(float gamma);
+
+            /**
+             * Sets the largest SPI transfer to use, in bytes, for frames
+             * longer than the SPI driver accepts in one transfer (4096
+             * bytes with the default spidev settings).  The default, 0,
+             * sends each frame in one transfer.
+             *
+             * @param bytes The largest transfer size, or 0 for no limit
+             */
+            void setMaxTransfer(int bytes);
+
+            /**
+             * Encodes the pixel buffer and sends it to the strip.  With
+             * the push thread running, the frame is handed to it and this
+             * returns right away.  If the push thread failed to send a
+             * frame, its exception is thrown here.
+             */
+            void show();
+
+            /**
+             * Starts the push thread, which sends the frames passed to
+             * show() in the background
+             */
+            void startPushThread();
+
+            /**
+             * Sends the last frame passed to show(), if it's still
+             * pending, and stops the push thread
+             */
+            void stopPushThread();
+
+            /**
+             * Returns the number of frames replaced by a newer one before
+             * the push thread could send them
+             *
+             * @return The number of frames dropped
+             */
+            unsigned int getFramesDropped();
+
+        protected:
+            /**
+             * Creates an empty strip; drivers call initStrip() once they
+             * know its size
+             */
+            LEDStrip();
+
+            /**
+             * Allocates the pixel buffer and frames
+             *
+             * @param ledCount The number of LEDs
+             * @param frameLength The length of an encoded frame, in bytes
+             */
+            void initStrip(int ledCount, int frameLength);
+
+            /**
+             * Returns the wire encoding of a color level.  This is used
+             * to build m_wire, the default is the level itself.
+             *
+             * @param level The color level, after gamma and brightness
+             * @return The byte to send
+             */
+            virtual uint8_t wireValue(uint8_t level);
+
+            /**
+             * Encodes the pixel buffer into a frame, using m_wire for the
+             * color components
+             *
+             * @param frame The frame, of the length given to initStrip()
+             */
+            virtual void encodeFrame(uint8_t *frame) = 0;
+
+            /**
+             * Sends a frame to the strip.  This is called from the push
+             * thread when it is running, and throws on failure.
+             *
+             * @param frame The frame
+             * @param len The length of the frame
+             */
+            virtual void writeFrame(const uint8_t *frame, int len) = 0;
+
+            /**
+             * Writes data to an SPI bus, in transfers no longer than
+             * setMaxTransfer() allows
+             *
+             * @param spi The SPI bus
+             * @param data The data
+             * @param len The length of the data
+             */
+            void spiWrite(mraa::Spi& spi, const uint8_t *data, int len);
+
+            int m_ledCount;
+
+            // r, g, b for each LED
+            std::vector<uint8_t> m_rgb;
+
+            // wire encoding of each color component value
+            uint8_t m_wire[256];
+
+        private:
+            void buildWireTable();
+            void pushThread();
+
+            uint8_t m_brightness;
+            float m_gamma;
+            bool m_wireValid;
+            int m_maxTransfer;
+
+            // the frame waiting for the push thread, and the one being
+            // sent
+            std::vector<uint8_t> m_pending;
+            std::vector<uint8_t> m_sending;
+            bool m_pendingValid;
+
+            std::thread m_pushThread;
+            bool m_pushing;
+            std::mutex m_lock;
+            std::condition_variable m_cv;
+            std::exception_ptr m_pushError;
+            unsigned int m_framesDropped;
+
+            /* Disable implicit copy and assignment operators */
+            LEDStrip(const LEDStrip&) = delete;
+            LEDStrip &operator=(const LEDStrip&) = delete;
+    };
+}
@@ -0,0 +1,14 @@
+%include "../common_top.i"
+
+/* BEGIN Java syntax  ------------------------------------------------------- */
+#ifdef SWIGJAVA
+JAVA_JNI_LOADLIBRARY(javaupm_ledstrip)
+#endif
+/* END Java syntax */
+
+/* BEGIN Common SWIG syntax ------------------------------------------------- */
+%{
+#include "ledstrip.hpp"
+%}
+%include "ledstrip.hpp"
+/* END Common SWIG syntax */
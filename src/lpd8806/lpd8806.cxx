@@ -23,8 +23,6 @@ LPD8806::LPD8806 (int bus, int csn, uint16_t pixelCount) :m_spi(bus), m_csnPinCt
     mraa::Result error = mraa::SUCCESS;
     m_name = "LPD8806";
 
-    m_pixels = NULL;
-
     error = m_csnPinCtx.dir (mraa::DIR_OUT);
     if (error != mraa::SUCCESS) {
         throw std::invalid_argument(std::string(__FUNCTION__) + 
@@ -43,49 +41,59 @@ LPD8806::LPD8806 (int bus, int csn, uint16_t pixelCount) :m_spi(bus), m_csnPinCt
     }
     CSOff ();
 
-    m_pixelsCount = pixelCount;
-
-    uint8_t  latchBytes;
-    uint16_t dataBytes, totalBytes;
-
-    dataBytes  = m_pixelsCount * 3;
-    latchBytes = (m_pixelsCount + 31) / 32;
-    totalBytes = dataBytes + latchBytes;
-    if ((m_pixels = (uint8_t *) malloc(totalBytes))) {
-        memset ( m_pixels           , 0x80, dataBytes);  // Init to RGB 'off' state
-        memset (&m_pixels[dataBytes], 0   , latchBytes); // Clear latch bytes
-    }
+    // RGB data, followed by the latch bytes
+    initStrip (pixelCount, pixelCount * 3 + (pixelCount + 31) / 32);
 }
 
 LPD8806::~LPD8806() {
-    if (m_pixels) {
-        free(m_pixels);
-    }
+    stopPushThread ();
 }
 
 void
 LPD8806::setPixelColor (uint16_t pixelOffset, uint8_t r, uint8_t g, uint8_t b) {
-    if (pixelOffset < m_pixelsCount) { // Arrays are 0-indexed, thus NOT '<='
-        uint8_t *ptr = &m_pixels[pixelOffset * 3];
-        *ptr++ = g | 0x80; // Strip color order is GRB,
-        *ptr++ = r | 0x80; // not the more common RGB,
-        *ptr++ = b | 0x80; // so the order here is intentional; don't "fix"
-    }
+    setPixel (pixelOffset, scaleLevel (r), scaleLevel (g), scaleLevel (b));
+}
+
+uint16_t
+LPD8806::getStripLength (void) {
+    return getLedCount ();
+}
+
+/*
+ * ****************
+ *  protected area
+ * ****************
+ */
+
+uint8_t
+LPD8806::scaleLevel (uint8_t level) {
+    // 7 bit color to the 8 bit pixel buffer, wireValue() gives it back
+    level &= 0x7f;
+    return (level << 1) | (level >> 6);
+}
+
+uint8_t
+LPD8806::wireValue (uint8_t level) {
+    // 7 bit color, with the high bit set
+    return 0x80 | (level >> 1);
 }
 
 void
-LPD8806::show (void) {
-    uint8_t  *ptr   = m_pixels;
-    uint16_t byte   = (m_pixelsCount * 3) + ((m_pixelsCount + 31) / 32);
-    
-    while (byte--) {
-        m_spi.writeByte (*ptr++);
+LPD8806::encodeFrame (uint8_t *frame) {
+    const uint8_t *rgb = m_rgb.data();
+
+    for (int i = 0; i < m_ledCount; i++, rgb += 3) {
+        *frame++ = m_wire[rgb[1]]; // Strip color order is GRB,
+        *frame++ = m_wire[rgb[0]]; // not the more common RGB,
+        *frame++ = m_wire[rgb[2]]; // so the order here is intentional; don't "fix"
     }
+
+    memset (frame, 0, (m_ledCount + 31) / 32); // Clear latch bytes
 }
 
-uint16_t
-LPD8806::getStripLength (void) {
-    return m_pixelsCount;
+void
+LPD8806::writeFrame (const uint8_t *frame, int len) {
+    spiWrite (m_spi, frame, len);
 }
 
 /*
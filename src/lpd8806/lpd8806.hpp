@@ -17,6 +17,8 @@
 
 #include <mraa/spi.hpp>
 
+#include "ledstrip.hpp"
+
 #define HIGH                    1
 #define LOW                     0
 
@@ -41,10 +43,15 @@ namespace upm {
  *
  * FastPixel* LPD8806 is an RGB LED strip controller.
  *
+ * Frames are encoded and sent by LEDStrip: with gamma correction and
+ * global brightness if set, in a single SPI transfer, and optionally
+ * from a background thread so that animations don't wait for the bus.
+ *
  * @image html lpd8806.jpg
  * @snippet lpd8806.cxx Interesting
+ * @snippet lpd8806-animation.cxx Interesting
  */
-class LPD8806 {
+class LPD8806 : public LEDStrip {
     public:
 
         /**
@@ -57,24 +64,23 @@ class LPD8806 {
         LPD8806 (int bus, int csn, uint16_t pixelCount);
 
         /**
-         * LPD8806 object destructor; basically, it frees the allocated
-         * pixel buffer.
+         * LPD8806 object destructor; stops the push thread if it is
+         * running.
          */
         ~LPD8806 ();
 
         /**
+         * Sets a pixel using the chip's 7 bit color components.  The
+         * LEDStrip methods, such as setPixel(), take 0-255 components
+         * instead.
+         *
          * @param pixelOffset Pixel offset in the strip of the pixel
-         * @param r Red LED
-         * @param g Green LED
-         * @param b Blue LED
+         * @param r Red LED (0-127)
+         * @param g Green LED (0-127)
+         * @param b Blue LED (0-127)
          */
         void setPixelColor (uint16_t pixelOffset, uint8_t r, uint8_t g, uint8_t b);
 
-        /**
-         * Writes the data stored in the array of pixels to the chip
-         */
-        void show (void);
-
         /**
          * Returns the length of the LED strip
          */
@@ -87,6 +93,14 @@ class LPD8806 {
         {
             return m_name;
         }
+
+    protected:
+        // scale a 0-127 component to 0-255
+        static uint8_t scaleLevel (uint8_t level);
+        uint8_t wireValue (uint8_t level);
+        void encodeFrame (uint8_t *frame);
+        void writeFrame (const uint8_t *frame, int len);
+
     private:
         /* Disable implicit copy and assignment operators */
         LPD8806(const LPD8806&) = delete;
@@ -96,9 +110,6 @@ class LPD8806 {
         mraa::Spi        m_spi;
         mraa::Gpio       m_csnPinCtx;
 
-        uint8_t*                m_pixels;
-        uint8_t                 m_pixelsCount;
-
         uint8_t readRegister (uint8_t reg);
         void writeRegister (uint8_t reg, uint8_t data);
 
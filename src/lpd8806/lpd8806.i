@@ -0,0 +1,16 @@
+%include "../common_top.i"
+
+/* BEGIN Java syntax  ------------------------------------------------------- */
+#ifdef SWIGJAVA
+JAVA_JNI_LOADLIBRARY(javaupm_lpd8806)
+#endif
+/* END Java syntax */
+
+/* BEGIN Common SWIG syntax ------------------------------------------------- */
+%{
+#include "ledstrip.hpp"
+#include "lpd8806.hpp"
+%}
+%include "ledstrip.hpp"
+%include "lpd8806.hpp"
+/* END Common SWIG syntax */
@@ -12,6 +12,8 @@
 #include <unistd.h>
 #include <string.h>
 #include <assert.h>
+#include <errno.h>
+#include <time.h>
 
 #include "mcp2515.h"
 
@@ -21,6 +23,16 @@
 // in ms
 #define MCP2515_MAX_TIMEOUT (5000)
 
+// the interrupts serviced in managed mode
+#define MCP2515_MANAGED_INTRS (MCP2515_CANINT_RX0I | MCP2515_CANINT_RX1I \
+                               | MCP2515_CANINT_TX0I | MCP2515_CANINT_TX1I \
+                               | MCP2515_CANINT_TX2I | MCP2515_CANINT_ERRI \
+                               | MCP2515_CANINT_MERR)
+
+// TX buffer ranks (priority * 3 + buffer number) run from 0 to 11.
+// The device sends the highest ranked buffer first.
+#define MCP2515_TX_RANKS (12)
+
 // static array of cnf1-3 value for setting speed.  These values were
 // taken from the Seeed code at:
 // https://github.com/Seeed-Studio/CAN_BUS_Shield/
@@ -138,6 +150,59 @@ static int mcp2515_id_to_int(const mcp2515_context dev, bool *ext,
     return id;
 }
 
+// build the 13 byte packet (SIDH to D7) the device uses for a message
+static void mcp2515_build_pkt(const mcp2515_context dev, int id, bool ext,
+                              bool rtr, uint8_t *payload, int len,
+                              MCP2515_PKT_T *packet)
+{
+    assert(dev != NULL);
+    assert(packet != NULL);
+
+    MCP2515_ID_T idBuf;
+
+    memset(packet, 0, sizeof(MCP2515_PKT_T));
+
+    // first add the id converted to the 4-byte id the device requires
+    // mask off all but the lower 29 bits
+    id &= 0x1fffffff;
+    mcp2515_int_to_id(dev, id, ext, false, &idBuf);
+
+    // copy in the [device]id bytes, then fill in the DLC reg.
+    packet->SIDH = idBuf.SIDH;
+    packet->SIDL = idBuf.SIDL;
+    packet->EID8 = idBuf.EID8;
+    packet->EID0 = idBuf.EID0;
+
+    // DLC register
+    if (len > MCP2515_MAX_PAYLOAD_DATA)
+        len = MCP2515_MAX_PAYLOAD_DATA;
+    if (len < 0)
+        len = 0;
+
+    packet->DLC = (len & _MCP2515_TXBDLC_MASK) << _MCP2515_TXBDLC_SHIFT;
+
+    if (rtr)
+        packet->DLC |= MCP2515_TXBDLC_RTR;
+
+    // now the payload
+    for (int i=0; i<len; i++)
+        packet->data[i+MCP2515_PKT_D0] = payload[i];
+}
+
+// compute a CLOCK_MONOTONIC deadline for pthread_cond_timedwait()
+static void mcp2515_deadline(struct timespec *ts, unsigned int timeout)
+{
+    clock_gettime(CLOCK_MONOTONIC, ts);
+
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (timeout % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
 // init...
 mcp2515_context mcp2515_init(int bus, int cs_pin)
 {
@@ -150,6 +215,37 @@ mcp2515_context mcp2515_init(int bus, int cs_pin)
     // zero out context
     memset((void *)dev, 0, sizeof(struct _mcp2515_context));
 
+    // managed mode waits are timed on the monotonic clock
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+
+    if (pthread_mutex_init(&dev->spi_lock, NULL))
+    {
+        pthread_condattr_destroy(&cond_attr);
+        free(dev);
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&dev->lock, NULL))
+    {
+        pthread_condattr_destroy(&cond_attr);
+        pthread_mutex_destroy(&dev->spi_lock);
+        free(dev);
+        return NULL;
+    }
+
+    if (pthread_cond_init(&dev->cond, &cond_attr))
+    {
+        pthread_condattr_destroy(&cond_attr);
+        pthread_mutex_destroy(&dev->lock);
+        pthread_mutex_destroy(&dev->spi_lock);
+        free(dev);
+        return NULL;
+    }
+
+    pthread_condattr_destroy(&cond_attr);
+
     // make sure MRAA is initialized
     int mraa_rv;
     if ((mraa_rv = mraa_init()) != MRAA_SUCCESS)
@@ -284,6 +380,13 @@ void mcp2515_close(mcp2515_context dev)
     if (dev->gpio)
         mraa_gpio_close(dev->gpio);
 
+    free(dev->rx_ring);
+    free(dev->tx_queue);
+
+    pthread_cond_destroy(&dev->cond);
+    pthread_mutex_destroy(&dev->lock);
+    pthread_mutex_destroy(&dev->spi_lock);
+
     free(dev);
 }
 
@@ -306,15 +409,18 @@ upm_result_t mcp2515_bus_read(const mcp2515_context dev, uint8_t cmd,
             sbuf[index++] = args[i];
     }
 
+    pthread_mutex_lock(&dev->spi_lock);
     mcp2515_cs_on(dev);
 
     if (mraa_spi_transfer_buf(dev->spi, sbuf, sbuf, buflen))
     {
         mcp2515_cs_off(dev);
+        pthread_mutex_unlock(&dev->spi_lock);
         printf("%s: mraa_spi_transfer_buf() failed.\n", __FUNCTION__);
         return UPM_ERROR_OPERATION_FAILED;
     }
     mcp2515_cs_off(dev);
+    pthread_mutex_unlock(&dev->spi_lock);
 
     // now copy it into user buffer
     for (int i=0; i<len; i++)
@@ -339,15 +445,18 @@ upm_result_t mcp2515_bus_write(const mcp2515_context dev, uint8_t cmd,
             sbuf[i + 1] = data[i];
     }
 
+    pthread_mutex_lock(&dev->spi_lock);
     mcp2515_cs_on(dev);
 
     if (mraa_spi_transfer_buf(dev->spi, sbuf, sbuf, len + 1))
     {
         mcp2515_cs_off(dev);
+        pthread_mutex_unlock(&dev->spi_lock);
         printf("%s: mraa_spi_transfer_buf() failed.\n", __FUNCTION__);
         return UPM_ERROR_OPERATION_FAILED;
     }
     mcp2515_cs_off(dev);
+    pthread_mutex_unlock(&dev->spi_lock);
 
     return UPM_SUCCESS;
 }
@@ -529,36 +638,9 @@ upm_result_t mcp2515_load_tx_buffer(const mcp2515_context dev,
     }
 
     // start preparing for the load
-    MCP2515_ID_T idBuf;
     MCP2515_PKT_T packet;
 
-    memset(&packet, 0, sizeof(MCP2515_PKT_T));
-
-    // first add the id converted to the 4-byte id the device requires
-    // mask off all but the lower 29 bits
-    id &= 0x1fffffff;
-    mcp2515_int_to_id(dev, id, ext, false, &idBuf);
-
-    // copy in the [device]id bytes, then fill in the DLC reg.
-    packet.SIDH = idBuf.SIDH;
-    packet.SIDL = idBuf.SIDL;
-    packet.EID8 = idBuf.EID8;
-    packet.EID0 = idBuf.EID0;
-
-    // DLC register
-    if (len > MCP2515_MAX_PAYLOAD_DATA)
-        len = MCP2515_MAX_PAYLOAD_DATA;
-    if (len < 0)
-        len = 0;
-
-    packet.DLC = (len & _MCP2515_TXBDLC_MASK) << _MCP2515_TXBDLC_SHIFT;
-
-    if (rtr)
-        packet.DLC |= MCP2515_TXBDLC_RTR;
-
-    // now the payload
-    for (int i=0; i<len; i++)
-        packet.data[i+MCP2515_PKT_D0] = payload[i];
+    mcp2515_build_pkt(dev, id, ext, rtr, payload, len, &packet);
 
     // load the buffer
     if (mcp2515_bus_write(dev, cmd, packet.data, MCP2515_MAX_PKT_DATA))
@@ -1015,6 +1097,241 @@ upm_result_t mcp2515_abort_tx(const mcp2515_context dev,
     return mcp2515_bit_modify(dev, reg, MCP2515_TXBCTRL_TXREQ, 0);
 }
 
+// Managed mode.  These are called with dev->lock held.
+
+// read a message out of an RX buffer into the ring.  status is the
+// RX STATUS byte, which describes this buffer.
+static void mcp2515_managed_rx(const mcp2515_context dev,
+                               MCP2515_RX_BUFFER_T bufnum, uint8_t status)
+{
+    MCP2515_MSG_T msg;
+    memset(&msg, 0, sizeof(MCP2515_MSG_T));
+
+    // READ RX BUFFER releases the buffer (clears RXnIF) once read
+    uint8_t cmd = (bufnum == MCP2515_RX_BUFFER0)
+        ? MCP2515_CMD_READ_RXBUF_RXB0SIDH : MCP2515_CMD_READ_RXBUF_RXB1SIDH;
+
+    if (mcp2515_bus_read(dev, cmd, NULL, 0, msg.pkt.data,
+                         MCP2515_MAX_PKT_DATA))
+        return;
+
+    MCP2515_ID_T did;
+    did.SIDH = msg.pkt.SIDH;
+    did.SIDL = msg.pkt.SIDL;
+    did.EID8 = msg.pkt.EID8;
+    did.EID0 = msg.pkt.EID0;
+
+    msg.id = mcp2515_id_to_int(dev, &(msg.ext), &did);
+
+    // RX STATUS has the remote frame flag and the filter hit, so we
+    // don't need to read RXBnCTRL
+    MCP2515_MSGTYPE_T msgtype =
+        (status &
+         (_MCP2515_RXSTATUS_MSGTYPE_MASK << _MCP2515_RXSTATUS_MSGTYPE_SHIFT))
+        >> _MCP2515_RXSTATUS_MSGTYPE_SHIFT;
+
+    if (msgtype == MCP2515_MSGTYPE_STDRF || msgtype == MCP2515_MSGTYPE_EXTRF)
+        msg.rtr = true;
+
+    // same numbering as RXBnCTRL: a rollover from RXB0 is reported as
+    // filter 0 or 1
+    MCP2515_FILTERMATCH_T fm =
+        (status &
+         (_MCP2515_RXSTATUS_FILTERMATCH_MASK
+          << _MCP2515_RXSTATUS_FILTERMATCH_SHIFT))
+        >> _MCP2515_RXSTATUS_FILTERMATCH_SHIFT;
+
+    if (fm >= MCP2515_FILTERMATCH_RXF0_ROLLOVER)
+        msg.filter_num = fm - MCP2515_FILTERMATCH_RXF0_ROLLOVER;
+    else
+        msg.filter_num = fm;
+
+    msg.len = ((msg.pkt.DLC & (_MCP2515_RXBDLC_MASK << _MCP2515_RXBDLC_SHIFT))
+               >> _MCP2515_RXBDLC_SHIFT);
+    if (msg.len > MCP2515_MAX_PAYLOAD_DATA)
+        msg.len = MCP2515_MAX_PAYLOAD_DATA;
+
+    dev->stats.rx_msgs++;
+
+    if (dev->rx_count == dev->rx_size)
+    {
+        // the reader isn't keeping up
+        dev->stats.rx_ring_overruns++;
+        return;
+    }
+
+    dev->rx_ring[(dev->rx_head + dev->rx_count) % dev->rx_size] = msg;
+    dev->rx_count++;
+
+    pthread_cond_broadcast(&dev->cond);
+}
+
+// load queued messages into free TX buffers.  Each message is loaded
+// with a lower rank than every message still awaiting transmission,
+// so that they go out in the order they were queued.  If there is no
+// such rank left, wait until the buffers drain.
+static void mcp2515_managed_tx(const mcp2515_context dev)
+{
+    while (dev->tx_count)
+    {
+        int limit = MCP2515_TX_RANKS;
+        for (int i=0; i<3; i++)
+            if ((dev->tx_busy & (1 << i)) && dev->tx_rank[i] < limit)
+                limit = dev->tx_rank[i];
+
+        int bufnum = -1;
+        int rank = -1;
+        for (int i=0; i<3; i++)
+        {
+            if ((dev->tx_busy & (1 << i)) || limit - 1 - i < 0)
+                continue;
+
+            int prio = (limit - 1 - i) / 3;
+            if (prio > MCP2515_TXP_HIGHEST)
+                prio = MCP2515_TXP_HIGHEST;
+
+            if (prio * 3 + i > rank)
+            {
+                rank = prio * 3 + i;
+                bufnum = i;
+            }
+        }
+
+        if (bufnum < 0)
+            return;
+
+        // write TXBnCTRL (for the priority) and the packet in one go,
+        // then request transmission
+        static const uint8_t ctrl_regs[3] = { MCP2515_REG_TXB0CTRL,
+                                              MCP2515_REG_TXB1CTRL,
+                                              MCP2515_REG_TXB2CTRL };
+        static const uint8_t rts_cmds[3] = { MCP2515_CMD_RTS_BUFFER0,
+                                             MCP2515_CMD_RTS_BUFFER1,
+                                             MCP2515_CMD_RTS_BUFFER2 };
+        uint8_t buf[2 + MCP2515_MAX_PKT_DATA];
+
+        buf[0] = ctrl_regs[bufnum];
+        buf[1] = (rank / 3) << _MCP2515_TXBCTRL_TXP_SHIFT;
+        memcpy(&buf[2], dev->tx_queue[dev->tx_head].data,
+               MCP2515_MAX_PKT_DATA);
+
+        if (mcp2515_bus_write(dev, MCP2515_CMD_WRITE, buf, sizeof(buf))
+            || mcp2515_bus_write(dev, rts_cmds[bufnum], NULL, 0))
+            return;
+
+        dev->tx_busy |= (1 << bufnum);
+        dev->tx_rank[bufnum] = rank;
+        dev->tx_head = (dev->tx_head + 1) % dev->tx_size;
+        dev->tx_count--;
+    }
+}
+
+// service the device until no managed interrupt flags are left set
+static void mcp2515_managed_service(const mcp2515_context dev)
+{
+    // The INT line stays low while any enabled flag is set, and we
+    // are only called on a falling edge, so nothing may be left
+    // pending when we return.
+    for (;;)
+    {
+        uint8_t status;
+
+        // drain the RX buffers, RXB0 first
+        while (!mcp2515_bus_read(dev, MCP2515_CMD_RX_STATUS, NULL, 0,
+                                 &status, 1))
+        {
+            MCP2515_RXMSG_T rxmsgs =
+                (status &
+                 (_MCP2515_RXSTATUS_RXMSG_MASK << _MCP2515_RXSTATUS_RXMSG_SHIFT))
+                >> _MCP2515_RXSTATUS_RXMSG_SHIFT;
+
+            if (rxmsgs == MCP2515_RXMSG_NONE)
+                break;
+
+            mcp2515_managed_rx(dev, (rxmsgs & MCP2515_RXMSG_RXB0)
+                               ? MCP2515_RX_BUFFER0 : MCP2515_RX_BUFFER1,
+                               status);
+        }
+
+        uint8_t flags;
+        if (mcp2515_read_reg(dev, MCP2515_REG_CANINTF, &flags))
+            return;
+
+        flags &= MCP2515_MANAGED_INTRS;
+        if (!flags)
+            return;
+
+        // anything else to clear (RX flags are cleared by reading the
+        // buffer)
+        uint8_t clear = flags & ~(MCP2515_CANINT_RX0I | MCP2515_CANINT_RX1I);
+
+        // transmissions completed
+        for (int i=0; i<3; i++)
+        {
+            if ((flags & (MCP2515_CANINT_TX0I << i))
+                && (dev->tx_busy & (1 << i)))
+            {
+                dev->tx_busy &= ~(1 << i);
+                dev->stats.tx_msgs++;
+            }
+        }
+
+        if (flags & MCP2515_CANINT_ERRI)
+        {
+            uint8_t ec[2];
+
+            dev->stats.error_intrs++;
+
+            if (!mcp2515_read_reg(dev, MCP2515_REG_EFLG, &dev->stats.eflg))
+            {
+                // the overflow flags must be cleared by us
+                if (dev->stats.eflg & MCP2515_EFLG_RX0OVR)
+                    dev->stats.rx_hw_overruns++;
+                if (dev->stats.eflg & MCP2515_EFLG_RX1OVR)
+                    dev->stats.rx_hw_overruns++;
+
+                if (dev->stats.eflg & (MCP2515_EFLG_RX0OVR
+                                       | MCP2515_EFLG_RX1OVR))
+                    mcp2515_clear_error_flags(dev, MCP2515_EFLG_RX0OVR
+                                              | MCP2515_EFLG_RX1OVR);
+            }
+
+            // TEC and REC are consecutive
+            uint8_t reg = MCP2515_REG_TEC;
+            if (!mcp2515_bus_read(dev, MCP2515_CMD_READ, &reg, 1, ec, 2))
+            {
+                dev->stats.tec = ec[0];
+                dev->stats.rec = ec[1];
+            }
+        }
+
+        if (flags & MCP2515_CANINT_MERR)
+            dev->stats.msg_errors++;
+
+        if (clear)
+            mcp2515_clear_intr_flags(dev, clear);
+
+        if (clear & (MCP2515_CANINT_TX0I | MCP2515_CANINT_TX1I
+                     | MCP2515_CANINT_TX2I))
+        {
+            mcp2515_managed_tx(dev);
+            pthread_cond_broadcast(&dev->cond);
+        }
+    }
+}
+
+static void mcp2515_managed_isr(void *ctx)
+{
+    mcp2515_context dev = (mcp2515_context)ctx;
+
+    pthread_mutex_lock(&dev->lock);
+    mcp2515_managed_service(dev);
+    pthread_mutex_unlock(&dev->lock);
+
+    if (dev->isr)
+        dev->isr(dev->isr_arg);
+}
+
 upm_result_t mcp2515_install_isr(const mcp2515_context dev, int pin,
                                  void (*isr)(void *), void *arg)
 {
@@ -1030,9 +1347,59 @@ upm_result_t mcp2515_install_isr(const mcp2515_context dev, int pin,
 
     mraa_gpio_dir(dev->intr, MRAA_GPIO_IN);
 
-    // install our interrupt handler
+    if (!dev->managed)
+    {
+        // install our interrupt handler
+        mraa_gpio_isr(dev->intr, MRAA_GPIO_EDGE_FALLING,
+                      isr, arg);
+
+        return UPM_SUCCESS;
+    }
+
+    pthread_mutex_lock(&dev->lock);
+
+    dev->isr = isr;
+    dev->isr_arg = arg;
+
+    // anything already loaded goes out first
+    uint8_t status = 0;
+    mcp2515_bus_read(dev, MCP2515_CMD_READ_STATUS, NULL, 0, &status, 1);
+    dev->tx_busy = 0;
+    if (status & MCP2515_RDSTATUS_TXB0REQ)
+        dev->tx_busy |= 0x01;
+    if (status & MCP2515_RDSTATUS_TXB1REQ)
+        dev->tx_busy |= 0x02;
+    if (status & MCP2515_RDSTATUS_TXB2REQ)
+        dev->tx_busy |= 0x04;
+    for (int i=0; i<3; i++)
+        dev->tx_rank[i] = MCP2515_TX_RANKS - 1;
+
+    // clear stale flags (but not the RX ones, that would drop the
+    // messages), and enable the interrupts we service
+    upm_result_t rv;
+    if ((rv = mcp2515_clear_intr_flags(dev, (uint8_t)
+                                       ~(MCP2515_CANINT_RX0I
+                                         | MCP2515_CANINT_RX1I)))
+        || (rv = mcp2515_set_intr_enables(dev, MCP2515_MANAGED_INTRS)))
+    {
+        pthread_mutex_unlock(&dev->lock);
+        mcp2515_uninstall_isr(dev);
+        return rv;
+    }
+
+    dev->managed_isr = true;
+
+    pthread_mutex_unlock(&dev->lock);
+
     mraa_gpio_isr(dev->intr, MRAA_GPIO_EDGE_FALLING,
-                  isr, arg);
+                  mcp2515_managed_isr, dev);
+
+    // the line may already have gone low before the handler was
+    // installed, in which case there won't be an edge for it
+    pthread_mutex_lock(&dev->lock);
+    mcp2515_managed_service(dev);
+    mcp2515_managed_tx(dev);
+    pthread_mutex_unlock(&dev->lock);
 
     return UPM_SUCCESS;
 }
@@ -1047,6 +1414,221 @@ void mcp2515_uninstall_isr(const mcp2515_context dev)
     mraa_gpio_isr_exit(dev->intr);
     mraa_gpio_close(dev->intr);
     dev->intr = NULL;
+
+    pthread_mutex_lock(&dev->lock);
+    if (dev->managed_isr)
+    {
+        mcp2515_set_intr_enables(dev, 0);
+        dev->managed_isr = false;
+        dev->isr = NULL;
+        dev->isr_arg = NULL;
+    }
+    pthread_mutex_unlock(&dev->lock);
+}
+
+upm_result_t mcp2515_set_managed_mode(const mcp2515_context dev,
+                                      unsigned int rx_size,
+                                      unsigned int tx_size)
+{
+    assert(dev != NULL);
+
+    if (dev->intr)
+    {
+        printf("%s: the ISR must be uninstalled first\n", __FUNCTION__);
+        return UPM_ERROR_NOT_SUPPORTED;
+    }
+
+    if (rx_size && !tx_size)
+        return UPM_ERROR_INVALID_PARAMETER;
+
+    pthread_mutex_lock(&dev->lock);
+
+    free(dev->rx_ring);
+    free(dev->tx_queue);
+    dev->rx_ring = NULL;
+    dev->tx_queue = NULL;
+    dev->managed = false;
+
+    if (rx_size)
+    {
+        dev->rx_ring = (MCP2515_MSG_T *)calloc(rx_size, sizeof(MCP2515_MSG_T));
+        dev->tx_queue = (MCP2515_PKT_T *)calloc(tx_size, sizeof(MCP2515_PKT_T));
+
+        if (!dev->rx_ring || !dev->tx_queue)
+        {
+            free(dev->rx_ring);
+            free(dev->tx_queue);
+            dev->rx_ring = NULL;
+            dev->tx_queue = NULL;
+            pthread_mutex_unlock(&dev->lock);
+            printf("%s: calloc() failed\n", __FUNCTION__);
+            return UPM_ERROR_NO_RESOURCES;
+        }
+
+        dev->rx_size = rx_size;
+        dev->tx_size = tx_size;
+        dev->rx_head = dev->rx_count = 0;
+        dev->tx_head = dev->tx_count = 0;
+        dev->tx_busy = 0;
+        memset(&dev->stats, 0, sizeof(MCP2515_STATS_T));
+        dev->managed = true;
+    }
+
+    pthread_mutex_unlock(&dev->lock);
+
+    return UPM_SUCCESS;
+}
+
+upm_result_t mcp2515_queue_tx(const mcp2515_context dev, int id,
+                              bool ext, bool rtr, uint8_t *payload,
+                              int len)
+{
+    assert(dev != NULL);
+
+    MCP2515_PKT_T packet;
+    mcp2515_build_pkt(dev, id, ext, rtr, payload, len, &packet);
+
+    pthread_mutex_lock(&dev->lock);
+
+    if (!dev->managed)
+    {
+        pthread_mutex_unlock(&dev->lock);
+        return UPM_ERROR_NOT_SUPPORTED;
+    }
+
+    if (dev->tx_count == dev->tx_size)
+    {
+        dev->stats.tx_queue_full++;
+        pthread_mutex_unlock(&dev->lock);
+        return UPM_ERROR_NO_RESOURCES;
+    }
+
+    dev->tx_queue[(dev->tx_head + dev->tx_count) % dev->tx_size] = packet;
+    dev->tx_count++;
+
+    // without the ISR, completions would go unnoticed, so just queue
+    if (dev->managed_isr)
+        mcp2515_managed_tx(dev);
+
+    pthread_mutex_unlock(&dev->lock);
+
+    return UPM_SUCCESS;
+}
+
+upm_result_t mcp2515_flush_tx(const mcp2515_context dev,
+                              unsigned int timeout)
+{
+    assert(dev != NULL);
+
+    struct timespec deadline;
+    mcp2515_deadline(&deadline, timeout);
+
+    pthread_mutex_lock(&dev->lock);
+
+    while (dev->managed && (dev->tx_count || dev->tx_busy))
+    {
+        if (pthread_cond_timedwait(&dev->cond, &dev->lock, &deadline)
+            == ETIMEDOUT)
+            break;
+    }
+
+    bool done = !dev->managed || !(dev->tx_count || dev->tx_busy);
+
+    pthread_mutex_unlock(&dev->lock);
+
+    if (!done)
+        return UPM_ERROR_TIMED_OUT;
+    else
+        return UPM_SUCCESS;
+}
+
+upm_result_t mcp2515_read_msg(const mcp2515_context dev, MCP2515_MSG_T *msg)
+{
+    assert(dev != NULL);
+    assert(msg != NULL);
+
+    pthread_mutex_lock(&dev->lock);
+
+    if (!dev->managed || !dev->rx_count)
+    {
+        pthread_mutex_unlock(&dev->lock);
+        return UPM_ERROR_NO_DATA;
+    }
+
+    *msg = dev->rx_ring[dev->rx_head];
+    dev->rx_head = (dev->rx_head + 1) % dev->rx_size;
+    dev->rx_count--;
+
+    pthread_mutex_unlock(&dev->lock);
+
+    return UPM_SUCCESS;
+}
+
+bool mcp2515_wait_msg(const mcp2515_context dev, unsigned int timeout)
+{
+    assert(dev != NULL);
+
+    struct timespec deadline;
+    mcp2515_deadline(&deadline, timeout);
+
+    pthread_mutex_lock(&dev->lock);
+
+    while (dev->managed && !dev->rx_count)
+    {
+        if (pthread_cond_timedwait(&dev->cond, &dev->lock, &deadline)
+            == ETIMEDOUT)
+            break;
+    }
+
+    bool avail = (dev->managed && dev->rx_count);
+
+    pthread_mutex_unlock(&dev->lock);
+
+    return avail;
+}
+
+unsigned int mcp2515_rx_pending(const mcp2515_context dev)
+{
+    assert(dev != NULL);
+
+    pthread_mutex_lock(&dev->lock);
+    unsigned int count = dev->rx_count;
+    pthread_mutex_unlock(&dev->lock);
+
+    return count;
+}
+
+unsigned int mcp2515_tx_pending(const mcp2515_context dev)
+{
+    assert(dev != NULL);
+
+    pthread_mutex_lock(&dev->lock);
+    unsigned int count = dev->tx_count;
+    for (int i=0; i<3; i++)
+        if (dev->tx_busy & (1 << i))
+            count++;
+    pthread_mutex_unlock(&dev->lock);
+
+    return count;
+}
+
+void mcp2515_get_stats(const mcp2515_context dev, MCP2515_STATS_T *stats)
+{
+    assert(dev != NULL);
+    assert(stats != NULL);
+
+    pthread_mutex_lock(&dev->lock);
+    *stats = dev->stats;
+    pthread_mutex_unlock(&dev->lock);
+}
+
+void mcp2515_clear_stats(const mcp2515_context dev)
+{
+    assert(dev != NULL);
+
+    pthread_mutex_lock(&dev->lock);
+    memset(&dev->stats, 0, sizeof(MCP2515_STATS_T));
+    pthread_mutex_unlock(&dev->lock);
 }
 
 upm_result_t mcp2515_set_intr_enables(const mcp2515_context dev,
@@ -139,6 +139,71 @@ void MCP2515::uninstallISR()
     mcp2515_uninstall_isr(m_mcp2515);
 }
 
+void MCP2515::installISR(int pin)
+{
+    installISR(pin, NULL, NULL);
+}
+
+void MCP2515::setManagedMode(unsigned int rxSize, unsigned int txSize)
+{
+    if (mcp2515_set_managed_mode(m_mcp2515, rxSize, txSize))
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": mcp2515_set_managed_mode() failed");
+}
+
+bool MCP2515::queueTX(int id, bool ext, bool rtr, std::string payload)
+{
+    upm_result_t rv = mcp2515_queue_tx(m_mcp2515, id, ext, rtr,
+                                       (uint8_t *)payload.data(),
+                                       payload.size());
+
+    if (rv == UPM_ERROR_NO_RESOURCES)
+        return false;
+    else if (rv)
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": mcp2515_queue_tx() failed");
+
+    return true;
+}
+
+bool MCP2515::flushTX(unsigned int timeout)
+{
+    return (mcp2515_flush_tx(m_mcp2515, timeout) == UPM_SUCCESS);
+}
+
+bool MCP2515::readMsg()
+{
+    return (mcp2515_read_msg(m_mcp2515, &m_message) == UPM_SUCCESS);
+}
+
+bool MCP2515::waitMsg(unsigned int timeout)
+{
+    return mcp2515_wait_msg(m_mcp2515, timeout);
+}
+
+unsigned int MCP2515::rxPending()
+{
+    return mcp2515_rx_pending(m_mcp2515);
+}
+
+unsigned int MCP2515::txPending()
+{
+    return mcp2515_tx_pending(m_mcp2515);
+}
+
+MCP2515_STATS_T MCP2515::getStats()
+{
+    MCP2515_STATS_T stats;
+    mcp2515_get_stats(m_mcp2515, &stats);
+
+    return stats;
+}
+
+void MCP2515::clearStats()
+{
+    mcp2515_clear_stats(m_mcp2515);
+}
+
 void MCP2515::setIntrEnables(uint8_t enables)
 {
     if (mcp2515_set_intr_enables(m_mcp2515, enables))
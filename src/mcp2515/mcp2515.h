@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <pthread.h>
 #include <upm.h>
 
 #include <mraa/i2c.h>
@@ -45,6 +46,37 @@ extern "C" {
 
         // interrupt, if enabled
         mraa_gpio_context       intr;
+
+        // serializes SPI transactions, the ISR runs in its own thread
+        pthread_mutex_t         spi_lock;
+
+        // managed mode.  lock protects everything below, and is
+        // always taken before spi_lock.
+        pthread_mutex_t         lock;
+        pthread_cond_t          cond;
+        bool                    managed;
+        bool                    managed_isr;
+        void                    (*isr)(void *);
+        void                    *isr_arg;
+
+        // received messages
+        MCP2515_MSG_T           *rx_ring;
+        unsigned int            rx_size;
+        unsigned int            rx_head;
+        unsigned int            rx_count;
+
+        // messages waiting to be loaded into a TX buffer
+        MCP2515_PKT_T           *tx_queue;
+        unsigned int            tx_size;
+        unsigned int            tx_head;
+        unsigned int            tx_count;
+
+        // TX buffers loaded and awaiting transmission, and the rank
+        // (priority * 3 + buffer number) they were loaded with
+        uint8_t                 tx_busy;
+        int                     tx_rank[3];
+
+        MCP2515_STATS_T         stats;
     } *mcp2515_context;
 
     /**
@@ -285,11 +317,15 @@ extern "C" {
 
     /**
      * Installs an interrupt service routine (ISR) to be called when
-     * an interrupt occurs.
+     * an interrupt occurs.  In managed mode (see
+     * mcp2515_set_managed_mode()), the interrupt enables are set up
+     * by the driver and isr is called after the driver has serviced
+     * the interrupt.
      *
      * @param dev Device context.
      * @param pin GPIO pin to use as the interrupt pin.
-     * @param isr Pointer to a function to be called on interrupt.
+     * @param isr Pointer to a function to be called on interrupt.  In
+     * managed mode this may be NULL.
      * @param arg Pointer to an object to be supplied as an
      * argument to the ISR.
      * @return UPM result.
@@ -304,6 +340,118 @@ extern "C" {
      */
     void mcp2515_uninstall_isr(const mcp2515_context dev);
 
+    /**
+     * Enable or disable managed mode.  In managed mode,
+     * mcp2515_install_isr() installs a driver interrupt handler that
+     * drains both RX buffers into a software ring as soon as a
+     * message arrives, using the READ RX BUFFER instructions, and
+     * keeps all 3 TX buffers loaded from a software queue.  Messages
+     * are then sent with mcp2515_queue_tx() and retrieved with
+     * mcp2515_read_msg(), and the isr passed to mcp2515_install_isr()
+     * (which may be NULL) is called after each interrupt has been
+     * serviced.  Queued messages are transmitted in the order they
+     * were queued.
+     *
+     * This must be called before mcp2515_install_isr().  While
+     * managed mode is enabled, do not use the functions that access
+     * the RX and TX buffers directly, or change the interrupt
+     * enables.
+     *
+     * @param dev Device context.
+     * @param rx_size The number of received messages to hold, or 0 to
+     * disable managed mode.
+     * @param tx_size The number of messages that can be queued for
+     * transmission.
+     * @return UPM result.
+     */
+    upm_result_t mcp2515_set_managed_mode(const mcp2515_context dev,
+                                          unsigned int rx_size,
+                                          unsigned int tx_size);
+
+    /**
+     * Queue a message for transmission in managed mode.  This
+     * returns immediately.
+     *
+     * @param dev Device context.
+     * @param id The integer representation of the CAN bus ID.
+     * @param ext True if the ID is an extended identifier, false otherwise.
+     * @param rtr True if this is a Remote Transfer Request, false otherwise.
+     * @param payload A pointer to an array of bytes that make up the
+     * payload to send.
+     * @param len The length of the payload.  The length is limited to
+     * 8.
+     * @return UPM result.  UPM_ERROR_NO_RESOURCES is returned if the
+     * queue is full.
+     */
+    upm_result_t mcp2515_queue_tx(const mcp2515_context dev, int id,
+                                  bool ext, bool rtr, uint8_t *payload,
+                                  int len);
+
+    /**
+     * Wait for all queued messages to be transmitted in managed mode.
+     *
+     * @param dev Device context.
+     * @param timeout The timeout in milliseconds.
+     * @return UPM result.
+     */
+    upm_result_t mcp2515_flush_tx(const mcp2515_context dev,
+                                  unsigned int timeout);
+
+    /**
+     * Retrieve the oldest received message in managed mode.
+     *
+     * @param dev Device context.
+     * @param msg A pointer to a MCP2515_MSG_T, which will be filled
+     * with the message.
+     * @return UPM result.  UPM_ERROR_NO_DATA is returned if no
+     * messages are waiting.
+     */
+    upm_result_t mcp2515_read_msg(const mcp2515_context dev,
+                                  MCP2515_MSG_T *msg);
+
+    /**
+     * Wait for a received message to be available in managed mode.
+     *
+     * @param dev Device context.
+     * @param timeout The timeout in milliseconds.
+     * @return True if a message is available, false on timeout.
+     */
+    bool mcp2515_wait_msg(const mcp2515_context dev, unsigned int timeout);
+
+    /**
+     * Return the number of received messages waiting in managed mode.
+     *
+     * @param dev Device context.
+     * @return The number of messages waiting to be read.
+     */
+    unsigned int mcp2515_rx_pending(const mcp2515_context dev);
+
+    /**
+     * Return the number of messages queued or loaded for
+     * transmission, but not yet transmitted, in managed mode.
+     *
+     * @param dev Device context.
+     * @return The number of messages waiting to be transmitted.
+     */
+    unsigned int mcp2515_tx_pending(const mcp2515_context dev);
+
+    /**
+     * Retrieve the managed mode counters, including RX overruns and
+     * the device error counters as of the last error interrupt.
+     *
+     * @param dev Device context.
+     * @param stats A pointer to a MCP2515_STATS_T to fill in.
+     */
+    void mcp2515_get_stats(const mcp2515_context dev,
+                           MCP2515_STATS_T *stats);
+
+    /**
+     * Reset the managed mode counters.
+     *
+     * @param dev Device context.
+     */
+    void mcp2515_clear_stats(const mcp2515_context dev);
+
     /**
      * Set the interrupt enables register.
      *
@@ -42,6 +42,12 @@ namespace upm {
      * @snippet mcp2515.cxx Interesting
      * A simple transmit and receive example.
      * @snippet mcp2515-txrx.cxx Interesting
+     *
+     * For busy buses, see setManagedMode().  The driver then services
+     * the interrupts itself, draining received messages into a ring
+     * and keeping the 3 TX buffers loaded from a queue, so that
+     * messages are not lost between polls and can be sent back to
+     * back.
      */
     class MCP2515 {
     public:
@@ -331,6 +337,102 @@ namespace upm {
          */
         void uninstallISR();
 
+        /**
+         * Install the driver interrupt handler in managed mode,
+         * without a callback.  See setManagedMode().
+         *
+         * @param pin GPIO pin to use as the interrupt pin.
+         */
+        void installISR(int pin);
+
+        /**
+         * Enable or disable managed mode.  In managed mode,
+         * installISR() installs a driver interrupt handler that drains
+         * both RX buffers into a ring as soon as a message arrives,
+         * and keeps all 3 TX buffers loaded from a queue.  Messages are
+         * then sent with queueTX() and retrieved with readMsg().  Any
+         * ISR passed to installISR() is called after the driver has
+         * serviced the interrupt.
+         *
+         * This must be called before installISR().  While managed mode
+         * is enabled, do not access the RX and TX buffers directly, or
+         * change the interrupt enables.
+         *
+         * @param rxSize The number of received messages to hold, or 0
+         * to disable managed mode.
+         * @param txSize The number of messages that can be queued for
+         * transmission.
+         */
+        void setManagedMode(unsigned int rxSize, unsigned int txSize);
+
+        /**
+         * Queue a message for transmission in managed mode.  Messages
+         * are transmitted in the order they were queued.
+         *
+         * @param id Integer representation of the CAN bus ID.
+         * @param ext True if the ID is an extended identifier, false
+         * otherwise.
+         * @param rtr Remote Transfer Request bit.
+         * @param payload A string containing the payload bytes.
+         * Maximum length is 8.
+         * @return True if the message was queued, false if the queue
+         * is full.
+         */
+        bool queueTX(int id, bool ext, bool rtr, std::string payload);
+
+        /**
+         * Wait until all queued messages have been transmitted.
+         *
+         * @param timeout The maximum time to wait, in milliseconds.
+         * @return True if the queue was flushed, false on timeout.
+         */
+        bool flushTX(unsigned int timeout);
+
+        /**
+         * Retrieve the oldest received message in managed mode.  The
+         * msgGet*() methods can then be used to access it.
+         *
+         * @return True if a message was retrieved, false if there
+         * were none.
+         */
+        bool readMsg();
+
+        /**
+         * Wait for a received message in managed mode.
+         *
+         * @param timeout The maximum time to wait, in milliseconds.
+         * @return True if a message is available, false on timeout.
+         */
+        bool waitMsg(unsigned int timeout);
+
+        /**
+         * Return the number of received messages waiting to be read
+         * in managed mode.
+         *
+         * @return The number of messages in the RX ring.
+         */
+        unsigned int rxPending();
+
+        /**
+         * Return the number of messages not yet transmitted in managed
+         * mode, including those loaded into the TX buffers.
+         *
+         * @return The number of messages awaiting transmission.
+         */
+        unsigned int txPending();
+
+        /**
+         * Return the managed mode statistics.
+         *
+         * @return The statistics.
+         */
+        MCP2515_STATS_T getStats();
+
+        /**
+         * Reset the managed mode statistics.
+         */
+        void clearStats();
+
         /**
          * Set the interrupt enables register.
          *
@@ -85,6 +85,21 @@ extern "C" {
         MCP2515_PKT_T pkt;
     } MCP2515_MSG_T;
 
+    // Counters maintained in managed mode (see
+    // mcp2515_set_managed_mode()).
+    typedef struct {
+        unsigned int rx_msgs;            // messages received
+        unsigned int tx_msgs;            // messages transmitted
+        unsigned int rx_ring_overruns;   // dropped, software ring full
+        unsigned int rx_hw_overruns;     // dropped, RXB0/RXB1 overflow
+        unsigned int tx_queue_full;      // messages refused, queue full
+        unsigned int error_intrs;        // error interrupts (ERRIF)
+        unsigned int msg_errors;         // message errors (MERRF)
+        uint8_t tec;                     // last TX error count
+        uint8_t rec;                     // last RX error count
+        uint8_t eflg;                    // last error flags
+    } MCP2515_STATS_T;
+
     // Registers
     typedef enum {
         // 5 RX filters, each composed of SIDH, SIDL, EID8, EID0.  We
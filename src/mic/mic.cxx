@@ -16,11 +16,39 @@
 #include <stdlib.h>
 #include <functional>
 #include <string.h>
+#include <algorithm>
+#include <errno.h>
+#include <limits>
+#include <math.h>
+#include <time.h>
 #include "mic.hpp"
 
 using namespace upm;
 
-Microphone::Microphone(int micPin) {
+static void addUS(struct timespec *ts, unsigned long long us)
+{
+    unsigned long long ns = ts->tv_nsec + us * 1000ULL;
+    ts->tv_sec += ns / 1000000000ULL;
+    ts->tv_nsec = ns % 1000000000ULL;
+}
+
+static double diffUS(const struct timespec *a, const struct timespec *b)
+{
+    return (a->tv_sec - b->tv_sec) * 1000000.0
+        + (a->tv_nsec - b->tv_nsec) / 1000.0;
+}
+
+static void sleepUntil(const struct timespec *deadline)
+{
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL)
+           == EINTR)
+        ;
+}
+
+Microphone::Microphone(int micPin) :
+    m_mask(0), m_head(0), m_tail(0), m_sampling(false), m_periodUS(0),
+    m_samples(0), m_overruns(0), m_missed(0), m_jitterSum(0),
+    m_jitterSumSq(0), m_jitterMax(0) {
     // initialise analog mic input
     
     if ( !(m_micCtx = mraa_aio_init(micPin)) ) 
@@ -29,9 +57,13 @@ Microphone::Microphone(int micPin) {
                                     ": mraa_aio_init() failed, invalid pin?");
         return;
       }
+
+    m_fullScale = (float)(1 << mraa_aio_get_bit(m_micCtx)) / 2;
 }
 
 Microphone::~Microphone() {
+    stopSampling();
+
     // close analog input
     mraa_result_t error;
     error = mraa_aio_close(m_micCtx);
@@ -55,13 +87,17 @@ Microphone::getSampledWindow (unsigned int freqMS, int numberOfSamples,
         return 0;
     }
 
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
     while (sampleIdx < numberOfSamples) {
         int x = mraa_aio_read (m_micCtx);
         if (x == -1) {
             return 0;
         }
         buffer[sampleIdx++] = x;
-        usleep(freqMS * 1000);
+        addUS(&deadline, freqMS * 1000ULL);
+        sleepUntil(&deadline);
     }
 
     return sampleIdx;
@@ -91,3 +127,180 @@ Microphone::printGraph (thresholdContext* ctx) {
         std::cout << ".";
     std::cout << std::endl;
 }
+
+void
+Microphone::startSampling (unsigned int periodUS, unsigned int depth) {
+    if (!periodUS) {
+        throw std::invalid_argument(std::string(__FUNCTION__) +
+                                    ": periodUS must be > 0");
+    }
+
+    stopSampling();
+
+    size_t size = 1;
+    while (size < depth)
+        size <<= 1;
+    m_ring.assign(size, 0);
+    m_mask = size - 1;
+    m_head = 0;
+    m_tail = 0;
+
+    m_periodUS = periodUS;
+    m_samples = 0;
+    m_overruns = 0;
+    m_missed = 0;
+    m_jitterSum = 0;
+    m_jitterSumSq = 0;
+    m_jitterMax = 0;
+
+    m_sampling = true;
+    m_thread = std::thread(&Microphone::samplingThread, this);
+}
+
+void
+Microphone::stopSampling () {
+    m_sampling = false;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+int
+Microphone::samplesAvailable () {
+    return m_head.load(std::memory_order_acquire)
+        - m_tail.load(std::memory_order_relaxed);
+}
+
+int
+Microphone::getSamples (int numberOfSamples, uint16_t * buffer) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t count = m_head.load(std::memory_order_acquire) - tail;
+    if (numberOfSamples < 0)
+        numberOfSamples = 0;
+    if (count > (size_t)numberOfSamples)
+        count = numberOfSamples;
+
+    for (size_t i = 0; i < count; i++)
+        buffer[i] = m_ring[(tail + i) & m_mask];
+
+    m_tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+bool
+Microphone::getWindowStats (int numberOfSamples, micWindowStats &stats) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t count = m_head.load(std::memory_order_acquire) - tail;
+    if (numberOfSamples <= 0 || count < (size_t)numberOfSamples)
+        return false;
+
+    // The window may wrap around the end of the ring
+    size_t first = tail & m_mask;
+    int len = std::min((size_t)numberOfSamples, m_ring.size() - first);
+    stats = windowStats(&m_ring[first], len, &m_ring[0],
+                        numberOfSamples - len);
+
+    m_tail.store(tail + numberOfSamples, std::memory_order_release);
+    return true;
+}
+
+micWindowStats
+Microphone::computeWindowStats (uint16_t * buffer, int len) {
+    return windowStats(buffer, len, NULL, 0);
+}
+
+micSamplingStats
+Microphone::getSamplingStats () {
+    micSamplingStats stats;
+    stats.samples = m_samples;
+    stats.overruns = m_overruns;
+    stats.missed = m_missed;
+    stats.meanJitterUS = 0;
+    stats.stdDevJitterUS = 0;
+    stats.maxJitterUS = m_jitterMax;
+    if (stats.samples) {
+        double mean = m_jitterSum / stats.samples;
+        double var = m_jitterSumSq / stats.samples - mean * mean;
+        stats.meanJitterUS = mean;
+        stats.stdDevJitterUS = var > 0 ? sqrt(var) : 0;
+    }
+    return stats;
+}
+
+micWindowStats
+Microphone::windowStats (const uint16_t *a, int lenA,
+                         const uint16_t *b, int lenB) {
+    micWindowStats stats = {0, 0, 0, 0,
+                            -std::numeric_limits<float>::infinity()};
+    int len = std::max(lenA, 0) + std::max(lenB, 0);
+    if (len <= 0)
+        return stats;
+
+    const uint16_t *span[2] = {a, b};
+    int spanLen[2] = {lenA, lenB};
+
+    unsigned long sum = 0;
+    uint16_t lo = 0xFFFF, hi = 0;
+    for (int s = 0; s < 2; s++)
+        for (int i = 0; i < spanLen[s]; i++) {
+            sum += span[s][i];
+            lo = std::min(lo, span[s][i]);
+            hi = std::max(hi, span[s][i]);
+        }
+    float mean = (float)sum / len;
+
+    float sumSq = 0;
+    for (int s = 0; s < 2; s++)
+        for (int i = 0; i < spanLen[s]; i++) {
+            float d = span[s][i] - mean;
+            sumSq += d * d;
+        }
+
+    stats.samples = len;
+    stats.mean = mean;
+    stats.rms = sqrtf(sumSq / len);
+    stats.peak = std::max(hi - mean, mean - lo);
+    if (stats.rms > 0)
+        stats.dB = 20 * log10f(stats.rms / m_fullScale);
+    return stats;
+}
+
+void
+Microphone::samplingThread () {
+    struct timespec deadline, now;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    while (m_sampling) {
+        addUS(&deadline, m_periodUS);
+        sleepUntil(&deadline);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        int x = mraa_aio_read(m_micCtx);
+
+        // Only this thread writes the statistics
+        double late = diffUS(&now, &deadline);
+        m_jitterSum = m_jitterSum + late;
+        m_jitterSumSq = m_jitterSumSq + late * late;
+        if (late > m_jitterMax)
+            m_jitterMax = late;
+
+        // Woke up too late for the following deadlines, skip them rather
+        // than sampling in a burst
+        if (late >= m_periodUS) {
+            unsigned long skip = late / m_periodUS;
+            m_missed += skip;
+            addUS(&deadline, (unsigned long long)skip * m_periodUS);
+        }
+
+        m_samples++;
+        if (x == -1)
+            continue;
+
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+            m_overruns++;
+            continue;
+        }
+        m_ring[head & m_mask] = x;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+}
@@ -10,7 +10,10 @@
  */
 #pragma once
 
+#include <atomic>
 #include <string>
+#include <thread>
+#include <vector>
 #include <mraa/gpio.h>
 #include <mraa/aio.h>
 
@@ -20,6 +23,42 @@ struct thresholdContext {
     int averagedOver;
 };
 
+/**
+ * Timing statistics of the sampling thread. Jitter is how late each
+ * sample was taken relative to its deadline.
+ */
+struct micSamplingStats {
+    /** Samples taken */
+    unsigned long samples;
+    /** Samples dropped because the ring was full */
+    unsigned long overruns;
+    /** Deadlines skipped because the thread woke more than a period late */
+    unsigned long missed;
+    /** Mean jitter in microseconds */
+    double meanJitterUS;
+    /** Standard deviation of the jitter in microseconds */
+    double stdDevJitterUS;
+    /** Largest jitter in microseconds */
+    double maxJitterUS;
+};
+
+/**
+ * Level of a window of samples. The DC bias of the microphone is
+ * removed first; dB is relative to a half scale amplitude (dBFS).
+ */
+struct micWindowStats {
+    /** Number of samples in the window */
+    int samples;
+    /** Mean reading, i.e. the DC bias */
+    float mean;
+    /** RMS of the readings around the mean */
+    float rms;
+    /** Largest distance of a reading from the mean */
+    float peak;
+    /** RMS in dBFS, -infinity for silence */
+    float dB;
+};
+
 namespace upm {
 
 /**
@@ -61,9 +100,10 @@ class Microphone {
 
         /**
          * Gets samples from the microphone according to the provided window and
-         * number of samples
+         * number of samples. Samples are taken on absolute deadlines, so
+         * the read latency doesn't add to the period.
          *
-         * @param freqMS Time between each sample (in microseconds)
+         * @param freqMS Time between each sample (in milliseconds)
          * @param numberOfSamples Number of sample to sample for this window
          * @param buffer Buffer with sampled data
          */
@@ -88,8 +128,97 @@ class Microphone {
          */
         void printGraph (thresholdContext* ctx);
 
+        /**
+         * Starts sampling on a dedicated thread, paced by an absolute
+         * deadline timer at periodUS microseconds. Samples are stored in
+         * a lock-free ring, read with getSamples() or
+         * getWindowStats(). When the ring is full new samples are
+         * dropped. Only one thread may read the ring.
+         *
+         * @param periodUS Time between each sample (in microseconds)
+         * @param depth Minimum ring size in samples, rounded up to a power
+         * of two
+         */
+        void startSampling (unsigned int periodUS, unsigned int depth = 4096);
+
+        /**
+         * Stops the sampling thread. Samples left in the ring can still
+         * be read.
+         */
+        void stopSampling ();
+
+        /**
+         * Returns true while the sampling thread is running
+         */
+        bool isSampling () { return m_sampling; }
+
+        /**
+         * Returns the number of samples waiting in the ring
+         */
+        int samplesAvailable ();
+
+        /**
+         * Removes up to numberOfSamples of the oldest samples from the ring
+         *
+         * @param numberOfSamples Maximum number of samples to read
+         * @param buffer Buffer receiving the samples
+         * @return Number of samples read
+         */
+        int getSamples (int numberOfSamples, uint16_t * buffer);
+
+        /**
+         * Computes the level of the oldest numberOfSamples samples in the
+         * ring, in place, and removes them. Nothing is removed unless
+         * numberOfSamples are available.
+         *
+         * @param numberOfSamples Window size in samples
+         * @param stats Filled in with the level of the window
+         * @return true if a full window was available, false otherwise
+         */
+        bool getWindowStats (int numberOfSamples, micWindowStats &stats);
+
+        /**
+         * Computes the level of a buffer of samples, e.g. from
+         * getSampledWindow()
+         *
+         * @param buffer Buffer with samples
+         * @param len Buffer length
+         */
+        micWindowStats computeWindowStats (uint16_t * buffer, int len);
+
+        /**
+         * Returns the timing statistics of the sampling thread since
+         * startSampling()
+         */
+        micSamplingStats getSamplingStats ();
+
     private:
         mraa_aio_context    m_micCtx;
+        float               m_fullScale;
+
+        // Single producer, single consumer ring; m_head is only written by
+        // the sampling thread and m_tail only by the reader.
+        std::vector<uint16_t>       m_ring;
+        size_t                      m_mask;
+        std::atomic<size_t>         m_head;
+        std::atomic<size_t>         m_tail;
+
+        std::thread                 m_thread;
+        std::atomic<bool>           m_sampling;
+        unsigned int                m_periodUS;
+
+        // Written by the sampling thread, read after it is stopped or
+        // approximately while it runs
+        std::atomic<unsigned long>  m_samples;
+        std::atomic<unsigned long>  m_overruns;
+        std::atomic<unsigned long>  m_missed;
+        std::atomic<double>         m_jitterSum;
+        std::atomic<double>         m_jitterSumSq;
+        std::atomic<double>         m_jitterMax;
+
+        void samplingThread ();
+        micWindowStats windowStats (const uint16_t *a, int lenA,
+                                    const uint16_t *b, int lenB);
 };
 
 }
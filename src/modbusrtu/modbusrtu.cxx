@@ -0,0 +1,542 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "modbusrtu.hpp"
+
+using namespace upm;
+using namespace std;
+
+// the largest read a single request can make of a table
+static int maxReadLen(MODBUSRTU::TABLE_T table)
+{
+  switch (table)
+    {
+    case MODBUSRTU::TABLE_COILS:
+    case MODBUSRTU::TABLE_DISCRETE_INPUTS:
+      return MODBUS_MAX_READ_BITS;
+
+    default:
+      return MODBUS_MAX_READ_REGISTERS;
+    }
+}
+
+MODBUSRTU::MODBUSRTU(std::string device, int baud, int bits, char parity,
+                     int stopBits) :
+  m_mbContext(0), m_nextPlanID(1), m_scheduleValid(true), m_maxGap(0),
+  m_baud(baud), m_bits(bits), m_parity(parity), m_stopBits(stopBits)
+{
+  // check some of the parameters
+  if (!(bits == 7 || bits == 8))
+    {
+      throw std::out_of_range(std::string(__FUNCTION__)
+                              + ": bits must be 7 or 8");
+    }
+
+  if (!(parity == 'N' || parity == 'E' || parity == 'O'))
+    {
+      throw std::out_of_range(std::string(__FUNCTION__)
+                              + ": parity must be 'N', 'O', or 'E'");
+    }
+
+  if (!(stopBits == 1 || stopBits == 2))
+    {
+      throw std::out_of_range(std::string(__FUNCTION__)
+                              + ": stopBits must be 1 or 2");
+    }
+
+  // now, open/init the device and modbus context
+
+  if (!(m_mbContext = modbus_new_rtu(device.c_str(), baud, parity, bits,
+                                     stopBits)))
+    {
+      throw std::runtime_error(std::string(__FUNCTION__)
+                               + ": modbus_new_rtu() failed");
+    }
+
+  // set the serial mode
+  modbus_rtu_set_serial_mode(m_mbContext, MODBUS_RTU_RS232);
+
+  // now connect..
+  if (modbus_connect(m_mbContext))
+    {
+      modbus_free(m_mbContext);
+      throw std::runtime_error(std::string(__FUNCTION__)
+                               + ": modbus_connect() failed");
+    }
+
+  resetStats();
+}
+
+MODBUSRTU::~MODBUSRTU()
+{
+  if (m_mbContext)
+    {
+      modbus_close(m_mbContext);
+      modbus_free(m_mbContext);
+    }
+}
+
+std::shared_ptr<MODBUSRTU> MODBUSRTU::instance(std::string device, int baud,
+                                               int bits, char parity,
+                                               int stopBits)
+{
+  static std::mutex lock;
+  static std::map<std::string, std::weak_ptr<MODBUSRTU> > buses;
+
+  std::lock_guard<std::mutex> guard(lock);
+
+  std::shared_ptr<MODBUSRTU> bus = buses[device].lock();
+
+  if (bus)
+    {
+      if (bus->m_baud != baud || bus->m_bits != bits
+          || bus->m_parity != parity || bus->m_stopBits != stopBits)
+        {
+          throw std::invalid_argument(std::string(__FUNCTION__)
+                                      + ": " + device
+                                      + " is already open with different "
+                                      + "line settings");
+        }
+
+      return bus;
+    }
+
+  bus = std::make_shared<MODBUSRTU>(device, baud, bits, parity, stopBits);
+  buses[device] = bus;
+
+  return bus;
+}
+
+bool MODBUSRTU::selectSlave(int slave)
+{
+  // addresses are only 8bits wide
+  return (modbus_set_slave(m_mbContext, slave & 0xff) == 0);
+}
+
+int MODBUSRTU::record(int slave, clock_t::time_point start, int rv)
+{
+  // don't let the bookkeeping clobber errno for the caller
+  int err = errno;
+
+  clock_t::duration elapsed = clock_t::now() - start;
+  slaveStats_t& stats = m_stats[slave];
+
+  stats.transactions++;
+  if (rv < 0)
+    stats.errors++;
+
+  stats.total += elapsed;
+  stats.max = std::max(stats.max, elapsed);
+
+  m_busy += elapsed;
+
+  errno = err;
+  return rv;
+}
+
+int MODBUSRTU::readLocked(int slave, TABLE_T table, int addr, int len,
+                          uint16_t *buf)
+{
+  if (!selectSlave(slave))
+    return -1;
+
+  clock_t::time_point start = clock_t::now();
+  int rv;
+
+  switch (table)
+    {
+    case TABLE_HOLDING_REGS:
+      rv = modbus_read_registers(m_mbContext, addr, len, buf);
+      break;
+
+    case TABLE_INPUT_REGS:
+      rv = modbus_read_input_registers(m_mbContext, addr, len, buf);
+      break;
+
+    default:
+      {
+        // bits are returned one per byte, widen them in place, from
+        // the end so nothing is overwritten before it's used
+        uint8_t *bits = reinterpret_cast<uint8_t *>(buf);
+
+        if (table == TABLE_COILS)
+          rv = modbus_read_bits(m_mbContext, addr, len, bits);
+        else
+          rv = modbus_read_input_bits(m_mbContext, addr, len, bits);
+
+        for (int i = rv - 1; i >= 0; i--)
+          buf[i] = bits[i] ? 1 : 0;
+      }
+      break;
+    }
+
+  return record(slave, start, rv);
+}
+
+int MODBUSRTU::readRegs(int slave, TABLE_T table, int addr, int len,
+                        uint16_t *buf)
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  return readLocked(slave, table, addr, len, buf);
+}
+
+int MODBUSRTU::writeReg(int slave, int addr, int value)
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  if (!selectSlave(slave))
+    return -1;
+
+  clock_t::time_point start = clock_t::now();
+
+  return record(slave, start, modbus_write_register(m_mbContext, addr,
+                                                    value));
+}
+
+int MODBUSRTU::writeCoil(int slave, int addr, bool value)
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  if (!selectSlave(slave))
+    return -1;
+
+  clock_t::time_point start = clock_t::now();
+
+  return record(slave, start, modbus_write_bit(m_mbContext, addr,
+                                               (value) ? TRUE : FALSE));
+}
+
+int MODBUSRTU::reportSlaveID(int slave, int maxLen, uint8_t *dest)
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  if (!selectSlave(slave))
+    return -1;
+
+  clock_t::time_point start = clock_t::now();
+
+  return record(slave, start, modbus_report_slave_id(m_mbContext, maxLen,
+                                                     dest));
+}
+
+int MODBUSRTU::addPoll(int slave, TABLE_T table, int addr, int len,
+                       POLL_CALLBACK_T callback)
+{
+  if (len < 1 || len > maxReadLen(table))
+    {
+      throw std::out_of_range(std::string(__FUNCTION__)
+                              + ": len must be between 1 and "
+                              + std::to_string(maxReadLen(table)));
+    }
+
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  pollPlan_t plan = { slave & 0xff, table, addr, len, false, false,
+                      callback };
+  int id = m_nextPlanID++;
+
+  m_plans[id] = plan;
+  m_scheduleValid = false;
+
+  return id;
+}
+
+void MODBUSRTU::removePoll(int id)
+{
+  // wait for callbacks running in other threads
+  std::lock_guard<std::recursive_mutex> dispatchGuard(m_dispatchLock);
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  m_plans.erase(id);
+  m_scheduleValid = false;
+}
+
+void MODBUSRTU::setMaxGap(int regs)
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  m_maxGap = std::max(regs, 0);
+  m_scheduleValid = false;
+}
+
+void MODBUSRTU::schedule()
+{
+  // sort the plans by slave, then table, then address, so each
+  // slave's transactions go out back to back in register order
+  std::vector<int> ids;
+
+  for (auto it = m_plans.begin(); it != m_plans.end(); it++)
+    ids.push_back(it->first);
+
+  std::sort(ids.begin(), ids.end(), [this](int a, int b) {
+      const pollPlan_t& pa = m_plans[a];
+      const pollPlan_t& pb = m_plans[b];
+
+      if (pa.slave != pb.slave)
+        return pa.slave < pb.slave;
+      if (pa.table != pb.table)
+        return pa.table < pb.table;
+      if (pa.addr != pb.addr)
+        return pa.addr < pb.addr;
+      return pa.len > pb.len;
+    });
+
+  m_schedule.clear();
+
+  bool merging = false;
+
+  for (size_t i = 0; i < ids.size(); i++)
+    {
+      const pollPlan_t& plan = m_plans[ids[i]];
+      int end = plan.addr + plan.len;
+
+      if (merging && !plan.noMerge)
+        {
+          pollBlock_t& block = m_schedule.back();
+          int blockEnd = block.addr + block.len;
+          int gap = (block.noGap || plan.noGap) ? 0 : m_maxGap;
+
+          // merge overlapping, adjacent or close enough ranges, as
+          // long as the result fits in one request
+          if (block.slave == plan.slave && block.table == plan.table
+              && plan.addr <= blockEnd + gap
+              && std::max(end, blockEnd) - block.addr
+                 <= maxReadLen(plan.table))
+            {
+              block.len = std::max(end, blockEnd) - block.addr;
+              block.noGap = block.noGap || plan.noGap;
+              block.plans.push_back(ids[i]);
+              continue;
+            }
+        }
+
+      pollBlock_t block = { plan.slave, plan.table, plan.addr, plan.len,
+                            plan.noGap, std::vector<int>(1, ids[i]) };
+      m_schedule.push_back(block);
+
+      merging = !plan.noMerge;
+    }
+
+  m_scheduleValid = true;
+}
+
+int MODBUSRTU::pollBlock(const pollBlock_t& block,
+                         std::vector<pollResult_t>& results)
+{
+  std::vector<uint16_t> buf(block.len);
+
+  int rv = readLocked(block.slave, block.table, block.addr, block.len,
+                      buf.data());
+
+  if (rv < 0)
+    {
+      // a merged read may span registers the slave refuses.  Stop
+      // merging these plans across gaps, or if the ranges were
+      // contiguous, at all.  Read them separately for this poll.
+      if (errno == EMBXILADD && block.plans.size() > 1)
+        {
+          int covered = 0;
+          int coveredEnd = block.addr;
+
+          for (size_t i = 0; i < block.plans.size(); i++)
+            {
+              const pollPlan_t& plan = m_plans[block.plans[i]];
+              int end = plan.addr + plan.len;
+
+              covered += std::max(end, coveredEnd)
+                - std::max(plan.addr, coveredEnd);
+              coveredEnd = std::max(end, coveredEnd);
+            }
+
+          int err = 0;
+
+          m_scheduleValid = false;
+
+          for (size_t i = 0; i < block.plans.size(); i++)
+            {
+              pollPlan_t& plan = m_plans[block.plans[i]];
+              pollBlock_t single = { plan.slave, plan.table, plan.addr,
+                                     plan.len, true,
+                                     std::vector<int>(1, block.plans[i]) };
+
+              if (covered < block.len)
+                plan.noGap = true;
+              else
+                plan.noMerge = true;
+
+              if (pollBlock(single, results) < 0)
+                err = errno;
+            }
+
+          errno = err;
+          return (err) ? -1 : 0;
+        }
+
+      return -1;
+    }
+
+  if (rv != block.len)
+    {
+      errno = EMBBADDATA;
+      return -1;
+    }
+
+  // save each plan's part of the block for its callback
+  for (size_t i = 0; i < block.plans.size(); i++)
+    {
+      const pollPlan_t& plan = m_plans[block.plans[i]];
+      const uint16_t *data = &buf[plan.addr - block.addr];
+      pollResult_t result = { block.plans[i],
+                              std::vector<uint16_t>(data, data + plan.len) };
+
+      results.push_back(result);
+    }
+
+  return 0;
+}
+
+void MODBUSRTU::dispatch(const std::vector<pollResult_t>& results)
+{
+  std::lock_guard<std::recursive_mutex> dispatchGuard(m_dispatchLock);
+
+  for (size_t i = 0; i < results.size(); i++)
+    {
+      POLL_CALLBACK_T callback;
+
+      {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        // the plan may have been removed since it was read
+        auto it = m_plans.find(results[i].id);
+        if (it == m_plans.end())
+          continue;
+
+        callback = it->second.callback;
+      }
+
+      if (callback)
+        callback(results[i].data.data(), results[i].data.size());
+    }
+}
+
+int MODBUSRTU::poll()
+{
+  std::vector<pollResult_t> results;
+  int failed = 0;
+
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if (!m_scheduleValid)
+      schedule();
+
+    for (size_t i = 0; i < m_schedule.size(); i++)
+      if (pollBlock(m_schedule[i], results) < 0)
+        failed++;
+  }
+
+  // the callbacks may use the bus themselves, so run them unlocked
+  dispatch(results);
+
+  return failed;
+}
+
+int MODBUSRTU::poll(int slave)
+{
+  std::vector<pollResult_t> results;
+  int rv = 0;
+  int err = 0;
+
+  slave &= 0xff;
+
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if (!m_scheduleValid)
+      schedule();
+
+    for (size_t i = 0; i < m_schedule.size(); i++)
+      if (m_schedule[i].slave == slave
+          && pollBlock(m_schedule[i], results) < 0)
+        {
+          err = errno;
+          rv = -1;
+          break;
+        }
+  }
+
+  // the callbacks may use the bus themselves, so run them unlocked
+  dispatch(results);
+
+  if (rv < 0)
+    errno = err;
+  return rv;
+}
+
+float MODBUSRTU::getBusUtilization()
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  clock_t::duration elapsed = clock_t::now() - m_statsStart;
+
+  if (elapsed.count() <= 0)
+    return 0.0;
+
+  return std::chrono::duration<float>(m_busy).count()
+    / std::chrono::duration<float>(elapsed).count();
+}
+
+MODBUSRTU::SLAVE_STATS_T MODBUSRTU::getSlaveStats(int slave)
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  SLAVE_STATS_T rv = { 0, 0, 0.0, 0.0 };
+
+  auto it = m_stats.find(slave & 0xff);
+  if (it == m_stats.end())
+    return rv;
+
+  const slaveStats_t& stats = it->second;
+
+  rv.transactions = stats.transactions;
+  rv.errors = stats.errors;
+  if (stats.transactions)
+    rv.avgLatencyMS = std::chrono::duration<float, std::milli>(
+      stats.total).count() / stats.transactions;
+  rv.maxLatencyMS = std::chrono::duration<float, std::milli>(
+    stats.max).count();
+
+  return rv;
+}
+
+void MODBUSRTU::resetStats()
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  m_stats.clear();
+  m_statsStart = clock_t::now();
+  m_busy = clock_t::duration::zero();
+}
+
+void MODBUSRTU::setDebug(bool enable)
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  if (enable)
+    modbus_set_debug(m_mbContext, 1);
+  else
+    modbus_set_debug(m_mbContext, 0);
+}
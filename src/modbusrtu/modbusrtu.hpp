@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <modbus/modbus.h>
+
+namespace upm {
+
+  /**
+   * @brief MODBUSRTU Library
+   * @defgroup modbusrtu libupm-modbusrtu
+   * @ingroup uart
+   */
+
+  /**
+   * @library modbusrtu
+   * @sensor modbusrtu
+   * @comname UPM API for Shared Modbus RTU Communications
+   * @con uart
+   * @web http://libmodbus.org/
+   * @brief UPM API for MODBUSRTU
+   *
+   * This class provides a Modbus RTU bus shared by UPM Modbus drivers
+   * (like H803X, HWXPXX and T3311).  Several slaves on the same RS-485
+   * line can then be used at the same time, each through its own
+   * driver, over a single libmodbus context.  Use instance() to get
+   * the bus for a serial device; drivers opened on the same device
+   * share it.
+   *
+   * This driver is not intended to be used by end users.  It is
+   * intended for use with other UPM drivers that need access to a
+   * Modbus RTU network, so no examples are provided.  Look at the
+   * H803X driver to see how this class can be used.
+   *
+   * Drivers register poll plans with addPoll(): a slave, a register
+   * table, a register range and a callback that decodes the data.
+   * poll() then merges overlapping and adjacent ranges of each slave
+   * and table into as few block reads as the Modbus PDU allows, issues
+   * them grouped by slave in register order, and hands each callback
+   * its part of the data.  If a merged read is refused with an illegal
+   * data address exception, the plans involved are no longer merged
+   * across gaps, or if there were none, are read separately from then
+   * on.
+   *
+   * The time spent in transactions is measured, see
+   * getBusUtilization() and getSlaveStats().
+   *
+   * All methods are serialized on the bus, so drivers may be used from
+   * different threads.  Poll callbacks run once the transactions of
+   * the poll are done and the bus is unlocked again, so they may call
+   * back into the bus, e.g. to write a register.
+   */
+
+  class MODBUSRTU {
+  public:
+
+    /**
+     * The Modbus data tables a poll plan can read
+     */
+    typedef enum {
+      TABLE_COILS                        = 0,
+      TABLE_DISCRETE_INPUTS,
+      TABLE_HOLDING_REGS,
+      TABLE_INPUT_REGS
+    } TABLE_T;
+
+    /**
+     * Poll callback.  It is passed the registers read for the plan,
+     * one per element.  Coils and discrete inputs are passed as 0 or
+     * 1.
+     */
+    typedef std::function<void(const uint16_t *data, int len)> POLL_CALLBACK_T;
+
+    /**
+     * Transaction statistics for a slave, see getSlaveStats()
+     */
+    typedef struct {
+      unsigned int transactions; // transactions sent
+      unsigned int errors;       // transactions that failed
+      float avgLatencyMS;        // average transaction time
+      float maxLatencyMS;        // longest transaction time
+    } SLAVE_STATS_T;
+
+    /**
+     * MODBUSRTU constructor.  This opens and connects a new libmodbus
+     * context.  Drivers should use instance() instead, so that a
+     * serial device is only opened once.
+     *
+     * @param device Path to the serial device, e.g. /dev/ttyUSB0
+     * @param baud Baud rate
+     * @param bits Number of data bits, 7 or 8
+     * @param parity Parity, 'N', 'O' or 'E'
+     * @param stopBits Number of stop bits, 1 or 2
+     */
+    MODBUSRTU(std::string device, int baud=9600, int bits=8,
+              char parity='N', int stopBits=2);
+
+    /**
+     * MODBUSRTU Destructor
+     */
+    ~MODBUSRTU();
+
+    /**
+     * Return the shared bus for a serial device, opening it if
+     * needed.  It is closed once the last driver using it releases
+     * it.  An exception is thrown if the device is already open with
+     * different line settings.
+     *
+     * @param device Path to the serial device, e.g. /dev/ttyUSB0
+     * @param baud Baud rate
+     * @param bits Number of data bits, 7 or 8
+     * @param parity Parity, 'N', 'O' or 'E'
+     * @param stopBits Number of stop bits, 1 or 2
+     * @return The shared bus
+     */
+    static std::shared_ptr<MODBUSRTU> instance(std::string device,
+                                               int baud=9600, int bits=8,
+                                               char parity='N',
+                                               int stopBits=2);
+
+    /**
+     * Read a register range from a slave right away.  This returns
+     * like the libmodbus read functions do: the number of registers
+     * read, or -1 with errno set on failure.
+     *
+     * @param slave The slave address
+     * @param table The table to read
+     * @param addr The first register
+     * @param len The number of registers to read
+     * @param buf The buffer to store the data in.  Coils and discrete
+     * inputs are stored as 0 or 1.
+     * @return The number of registers read, or -1 on failure
+     */
+    int readRegs(int slave, TABLE_T table, int addr, int len,
+                 uint16_t *buf);
+
+    /**
+     * Write a holding register.  Returns like modbus_write_register().
+     *
+     * @param slave The slave address
+     * @param addr The register
+     * @param value The value to write
+     * @return 1 on success, or -1 with errno set on failure
+     */
+    int writeReg(int slave, int addr, int value);
+
+    /**
+     * Write a coil.  Returns like modbus_write_bit().
+     *
+     * @param slave The slave address
+     * @param addr The coil
+     * @param value The value to write
+     * @return 1 on success, or -1 with errno set on failure
+     */
+    int writeCoil(int slave, int addr, bool value);
+
+    /**
+     * Request the slave ID.  Returns like modbus_report_slave_id().
+     *
+     * @param slave The slave address
+     * @param maxLen The size of dest
+     * @param dest The buffer to store the response in
+     * @return The length of the response, or -1 with errno set on
+     * failure
+     */
+    int reportSlaveID(int slave, int maxLen, uint8_t *dest);
+
+    /**
+     * Add a poll plan.  The range is read by every poll() (or
+     * poll(slave)) and passed to the callback.
+     *
+     * @param slave The slave address
+     * @param table The table to read
+     * @param addr The first register
+     * @param len The number of registers to read
+     * @param callback The callback to pass the data to
+     * @return An ID for the plan, for removePoll()
+     */
+    int addPoll(int slave, TABLE_T table, int addr, int len,
+                POLL_CALLBACK_T callback);
+
+    /**
+     * Remove a poll plan.  Drivers must remove their plans before
+     * they are destroyed.  If another thread is running poll
+     * callbacks, this waits for it to finish, so the plan's callback
+     * isn't called once this returns.
+     *
+     * @param id The ID returned by addPoll()
+     */
+    void removePoll(int id);
+
+    /**
+     * Run every poll plan once.  A failed transaction doesn't stop
+     * the others, so one unresponsive slave doesn't hold up the rest
+     * of the bus.
+     *
+     * @return The number of transactions that failed
+     */
+    int poll();
+
+    /**
+     * Run the poll plans of one slave.  This stops at the first failed
+     * transaction.
+     *
+     * @param slave The slave address
+     * @return 0 on success, or -1 with errno set on failure
+     */
+    int poll(int slave);
+
+    /**
+     * Allow merged reads to span up to this many unused registers.
+     * Reading a few extra registers is usually quicker than another
+     * transaction, but some slaves refuse reads of registers they
+     * don't implement.  The default is 0.
+     *
+     * @param regs The number of unused registers a read may span
+     */
+    void setMaxGap(int regs);
+
+    /**
+     * Return the fraction of the time since the statistics were last
+     * reset that was spent in transactions.
+     *
+     * @return The bus utilization, from 0.0 to 1.0
+     */
+    float getBusUtilization();
+
+    /**
+     * Return the transaction statistics for a slave
+     *
+     * @param slave The slave address
+     * @return The statistics for the slave
+     */
+    SLAVE_STATS_T getSlaveStats(int slave);
+
+    /**
+     * Reset the bus utilization and slave statistics
+     */
+    void resetStats();
+
+    /**
+     * Enable or disable libmodbus debugging output.  This applies to
+     * every driver on the bus.
+     *
+     * @param enable true to enable debugging, false otherwise
+     */
+    void setDebug(bool enable);
+
+  protected:
+    typedef std::chrono::steady_clock clock_t;
+
+    // a registered poll plan
+    typedef struct {
+      int slave;
+      TABLE_T table;
+      int addr;
+      int len;
+      bool noGap;               // only merge with adjacent ranges
+      bool noMerge;             // read by itself
+      POLL_CALLBACK_T callback;
+    } pollPlan_t;
+
+    // a block read covering one or more plans
+    typedef struct {
+      int slave;
+      TABLE_T table;
+      int addr;
+      int len;
+      bool noGap;
+      std::vector<int> plans;
+    } pollBlock_t;
+
+    // the data read for a plan, to be passed to its callback
+    typedef struct {
+      int id;
+      std::vector<uint16_t> data;
+    } pollResult_t;
+
+    typedef struct {
+      unsigned int transactions;
+      unsigned int errors;
+      clock_t::duration total;
+      clock_t::duration max;
+    } slaveStats_t;
+
+    // build m_schedule from m_plans
+    void schedule();
+    // read a block and add its plans' data to results
+    int pollBlock(const pollBlock_t& block,
+                  std::vector<pollResult_t>& results);
+    // run the callbacks for results, called without m_lock held
+    void dispatch(const std::vector<pollResult_t>& results);
+
+    // these are called with m_lock held
+    bool selectSlave(int slave);
+    int readLocked(int slave, TABLE_T table, int addr, int len,
+                   uint16_t *buf);
+    // account for a transaction that started at start, returns rv
+    int record(int slave, clock_t::time_point start, int rv);
+
+    modbus_t *m_mbContext;
+
+    std::mutex m_lock;
+    // held while running poll callbacks, so removePoll() can wait for
+    // them.  Recursive, as callbacks may poll or remove plans.
+    std::recursive_mutex m_dispatchLock;
+
+    std::map<int, pollPlan_t> m_plans;
+    int m_nextPlanID;
+    std::vector<pollBlock_t> m_schedule;
+    bool m_scheduleValid;
+    int m_maxGap;
+
+    std::map<int, slaveStats_t> m_stats;
+    clock_t::time_point m_statsStart;
+    clock_t::duration m_busy;
+
+  private:
+    // line settings, to check instance() requests against
+    int m_baud;
+    int m_bits;
+    char m_parity;
+    int m_stopBits;
+
+    /* Disable implicit copy and assignment operators */
+    MODBUSRTU(const MODBUSRTU&) = delete;
+    MODBUSRTU &operator=(const MODBUSRTU&) = delete;
+  };
+}
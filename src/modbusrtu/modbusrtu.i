@@ -0,0 +1,20 @@
+%include "../common_top.i"
+
+/* BEGIN Java syntax  ------------------------------------------------------- */
+#ifdef SWIGJAVA
+JAVA_JNI_LOADLIBRARY(javaupm_modbusrtu)
+#endif
+/* END Java syntax */
+
+/* BEGIN Common SWIG syntax ------------------------------------------------- */
+/* The shared bus and poll plans are handled through std::shared_ptr and
+ * std::function, which are not wrapped; construct a MODBUSRTU directly
+ * and use readRegs() instead. */
+%ignore instance;
+%ignore addPoll;
+
+%{
+#include "modbusrtu.hpp"
+%}
+%include "modbusrtu.hpp"
+/* END Common SWIG syntax */
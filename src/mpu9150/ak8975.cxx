@@ -149,6 +149,13 @@ bool AK8975::update(bool selfTest)
   uint8_t data[6];
   m_i2c.readBytesReg(REG_HXL, data, 6);
 
+  setRawData(data);
+
+  return true;
+}
+
+void AK8975::setRawData(const uint8_t *data)
+{
   int16_t x, y, z;
   x = ( (data[1] << 8) | data[0] );
   y = ( (data[3] << 8) | data[2] );
@@ -157,8 +164,6 @@ bool AK8975::update(bool selfTest)
   m_xData = float(x);
   m_yData = float(y);
   m_zData = float(z);
-
-  return true;
 }
 
 bool AK8975::selfTest()
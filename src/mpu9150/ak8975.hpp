@@ -201,6 +201,15 @@ namespace upm {
      */
     std::vector<float> getMagnetometer();
 
+    /**
+     * store measurement data that was read by another device instead
+     * of by update(), for example by the I2C master of an MPU9150.
+     * The data is then available through getMagnetometer().
+     *
+     * @param data the 6 data bytes, starting at REG_HXL
+     */
+    void setRawData(const uint8_t *data);
+
 
   protected:
     /**
@@ -11,6 +11,7 @@
 
 #include <unistd.h>
 #include <iostream>
+#include <stdexcept>
 #include <string.h>
 
 #include "mpu60x0.hpp"
@@ -20,7 +21,9 @@ using namespace std;
 
 
 MPU60X0::MPU60X0(int bus, uint8_t address) :
-  m_i2c(bus), m_gpioIRQ(0)
+  m_i2c(bus), m_gpioIRQ(0), m_fifoSensors(0), m_fifoFrameLen(0),
+  m_fifoExtLen(0), m_fifoPeriodUS(1000), m_fifoSampleNum(0),
+  m_fifoOverflows(0)
 {
   m_addr = address;
 
@@ -320,9 +323,14 @@ std::vector<float> MPU60X0::getGyroscope()
 
 
 float MPU60X0::getTemperature()
+{
+  return convertTemperature(m_temp);
+}
+
+float MPU60X0::convertTemperature(float raw)
 {
   // this equation is taken from the datasheet
-  return (m_temp / 340.0) + 36.53;
+  return (raw / 340.0) + 36.53;
 }
 
 bool MPU60X0::enableTemperatureSensor(bool enable)
@@ -420,3 +428,196 @@ void MPU60X0::uninstallISR()
   {
     return m_gpioIRQ;
   }
+
+void MPU60X0::enableFIFO(uint8_t sensors)
+{
+  uint8_t reg = readReg(REG_USER_CTRL);
+
+  // stop the FIFO while we reconfigure it
+  writeReg(REG_FIFO_EN, 0);
+  writeReg(REG_USER_CTRL, reg & ~FIFO_EN);
+
+  m_fifoSensors = sensors;
+
+  if (!sensors)
+    return;
+
+  // work out the frame layout.  Data is stored in register order.
+  m_fifoFrameLen = 0;
+
+  if (sensors & ACCEL_FIFO_EN)
+    m_fifoFrameLen += 6;
+  if (sensors & TEMP_FIFO_EN)
+    m_fifoFrameLen += 2;
+  if (sensors & XG_FIFO_EN)
+    m_fifoFrameLen += 2;
+  if (sensors & YG_FIFO_EN)
+    m_fifoFrameLen += 2;
+  if (sensors & ZG_FIFO_EN)
+    m_fifoFrameLen += 2;
+
+  // external sensor data, as much as each enabled slave reads
+  const uint8_t slvCtrl[4] = { REG_I2C_SLV0_CTRL, REG_I2C_SLV1_CTRL,
+                               REG_I2C_SLV2_CTRL, REG_I2C_SLV3_CTRL };
+  bool slvFIFO[4] = { (sensors & SLV0_FIFO_EN) != 0,
+                      (sensors & SLV1_FIFO_EN) != 0,
+                      (sensors & SLV2_FIFO_EN) != 0,
+                      (readReg(REG_I2C_MST_CTRL) & SLV_3_FIFO_EN) != 0 };
+
+  m_fifoExtLen = 0;
+  for (int i=0; i<4; i++)
+    {
+      if (!slvFIFO[i])
+        continue;
+
+      uint8_t ctrl = readReg(slvCtrl[i]);
+      if (ctrl & I2C_SLV_EN)
+        m_fifoExtLen += (ctrl >> _I2C_SLV_LEN_SHIFT) & _I2C_SLV_LEN_MASK;
+    }
+
+  m_fifoFrameLen += m_fifoExtLen;
+
+  if (!m_fifoFrameLen)
+    {
+      m_fifoSensors = 0;
+      throw std::invalid_argument(std::string(__FUNCTION__) +
+                                  ": no data selected for the FIFO");
+    }
+
+  m_fifoPeriodUS = getSamplePeriodUS();
+
+  m_fifoBuffer.resize(MPU60X0_FIFO_SIZE);
+  m_fifoOverflows = 0;
+
+  writeReg(REG_USER_CTRL, reg | FIFO_EN);
+  writeReg(REG_FIFO_EN, sensors);
+
+  m_fifoStart = std::chrono::steady_clock::now();
+  resetFIFO();
+}
+
+void MPU60X0::resetFIFO()
+{
+  uint8_t reg = readReg(REG_USER_CTRL);
+
+  // FIFO_RESET clears itself
+  writeReg(REG_USER_CTRL, reg | FIFO_RESET);
+
+  if (!m_fifoSensors)
+    return;
+
+  // the next sample is stored from now on
+  uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>
+    (std::chrono::steady_clock::now() - m_fifoStart).count();
+
+  m_fifoSampleNum = (elapsed + m_fifoPeriodUS - 1) / m_fifoPeriodUS;
+}
+
+int MPU60X0::getFIFOCount()
+{
+  if (!m_fifoSensors)
+    return 0;
+
+  uint8_t buffer[2];
+  readRegs(REG_FIFO_COUNTH, buffer, 2);
+
+  int count = (buffer[0] << 8) | buffer[1];
+
+  return count / m_fifoFrameLen;
+}
+
+int MPU60X0::readFIFO(FIFO_SAMPLE_T *samples, int maxSamples)
+{
+  if (!m_fifoSensors || maxSamples <= 0)
+    return 0;
+
+  uint8_t buffer[2];
+  readRegs(REG_FIFO_COUNTH, buffer, 2);
+
+  int count = (buffer[0] << 8) | buffer[1];
+
+  // The FIFO count stops at the FIFO size, and the oldest data is
+  // overwritten from then on.  Since the frame boundaries are lost
+  // along with it, the only thing to do is to start over.
+  int maxFill = (MPU60X0_FIFO_SIZE / m_fifoFrameLen) * m_fifoFrameLen;
+  if (count >= MPU60X0_FIFO_SIZE || count > maxFill)
+    {
+      m_fifoOverflows++;
+      resetFIFO();
+      return 0;
+    }
+
+  int frames = count / m_fifoFrameLen;
+  if (frames > maxSamples)
+    frames = maxSamples;
+
+  if (!frames)
+    return 0;
+
+  // read them all in one go
+  readRegs(REG_FIFO_R_W, m_fifoBuffer.data(), frames * m_fifoFrameLen);
+
+  const uint8_t *frame = m_fifoBuffer.data();
+  for (int i=0; i<frames; i++)
+    {
+      FIFO_SAMPLE_T *sample = &samples[i];
+      memset(sample, 0, sizeof(FIFO_SAMPLE_T));
+
+      sample->timestamp = m_fifoSampleNum++ * m_fifoPeriodUS;
+
+      const uint8_t *ptr = frame;
+
+      if (m_fifoSensors & ACCEL_FIFO_EN)
+        {
+          for (int j=0; j<3; j++, ptr += 2)
+            sample->accel[j] = float(int16_t((ptr[0] << 8) | ptr[1]))
+              / m_accelScale;
+        }
+
+      if (m_fifoSensors & TEMP_FIFO_EN)
+        {
+          sample->temp =
+            convertTemperature(float(int16_t((ptr[0] << 8) | ptr[1])));
+          ptr += 2;
+        }
+
+      const uint8_t gyroBits[3] = { XG_FIFO_EN, YG_FIFO_EN, ZG_FIFO_EN };
+      for (int j=0; j<3; j++)
+        {
+          if (m_fifoSensors & gyroBits[j])
+            {
+              sample->gyro[j] = float(int16_t((ptr[0] << 8) | ptr[1]))
+                / m_gyroScale;
+              ptr += 2;
+            }
+        }
+
+      if (m_fifoExtLen)
+        decodeFIFOExt(ptr, m_fifoExtLen, sample);
+
+      frame += m_fifoFrameLen;
+    }
+
+  return frames;
+}
+
+unsigned int MPU60X0::getFIFOOverflows()
+{
+  return m_fifoOverflows;
+}
+
+uint32_t MPU60X0::getSamplePeriodUS()
+{
+  // Sample Rate = Gyro output rate / (1 + sample rate divider), and
+  // the gyro output rate is 8Khz if the DLPF is disabled.
+  uint8_t dlpf = (readReg(REG_CONFIG) >> _CONFIG_DLPF_SHIFT) & _CONFIG_DLPF_MASK;
+  uint32_t gyroRate = (dlpf == DLPF_260_256 || dlpf == DLPF_RESERVED)
+    ? 8000 : 1000;
+
+  return (1000000 * (1 + uint32_t(getSampleRateDivider()))) / gyroRate;
+}
+
+void MPU60X0::decodeFIFOExt(const uint8_t *data, int len,
+                            FIFO_SAMPLE_T *sample)
+{
+}
@@ -10,6 +10,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <mraa/common.hpp>
@@ -24,6 +25,9 @@
 #define MPU60X0_I2C_BUS 0
 #define MPU60X0_DEFAULT_I2C_ADDR 0x68
 
+// size of the FIFO in bytes
+#define MPU60X0_FIFO_SIZE 1024
+
 namespace upm {
 
   /**
@@ -48,6 +52,11 @@ namespace upm {
    * should allow an end user to implement whatever features are
    * required.
    *
+   * For high sample rates, the FIFO can be used instead of update().
+   * enableFIFO() selects the sensors to store in the FIFO at each
+   * sample, and readFIFO() drains it in a single burst, returning
+   * timestamped samples.
+   *
    * @image html mpu60x0.jpg
    * @snippet mpu9150-mpu60x0.cxx Interesting
    */
@@ -643,6 +652,19 @@ namespace upm {
     } LP_WAKE_CRTL_T;
 
 
+    /**
+     * A sample read from the FIFO, see readFIFO().  Values of sensors
+     * that are not stored in the FIFO are 0.
+     */
+    typedef struct {
+      uint64_t timestamp;       // microseconds since enableFIFO()
+      float accel[3];           // g
+      float gyro[3];            // degrees per second
+      float mag[3];             // micro-teslas (MPU9150/MPU9250 only)
+      float temp;               // degrees Celsius
+    } FIFO_SAMPLE_T;
+
+
     /**
      * mpu60x0 constructor
      *
@@ -918,7 +940,90 @@ namespace upm {
 
     mraa::Gpio* get_gpioIRQ();
 
+    /**
+     * enable or disable the FIFO.  The FIFO is reset, and from then
+     * on a frame containing the selected sensors is stored in it at
+     * each sample (see setSampleRateDivider()), to be retrieved with
+     * readFIFO().  Set up the sample rate, scales and any I2C slaves
+     * before calling this.
+     *
+     * External sensor data (SLV0_FIFO_EN - SLV2_FIFO_EN, and
+     * SLV_3_FIFO_EN in REG_I2C_MST_CTRL) is stored using the lengths
+     * currently set in the slave control registers.
+     *
+     * @param sensors bitmask of FIFO_EN_BITS_T values, or 0 to
+     * disable the FIFO
+     */
+    virtual void enableFIFO(uint8_t sensors);
+
+    /**
+     * reset the FIFO, discarding its contents.  The sample timestamps
+     * are resynchronized to the current time.
+     */
+    void resetFIFO();
+
+    /**
+     * return the number of complete samples waiting in the FIFO
+     *
+     * @return the number of samples in the FIFO
+     */
+    int getFIFOCount();
+
+    /**
+     * read and decode samples from the FIFO, oldest first.  All of
+     * the samples are read in a single burst.
+     *
+     * If the FIFO has overflowed, data has been lost and the frame
+     * boundaries are no longer known, so the FIFO is reset instead,
+     * no samples are returned, and the count returned by
+     * getFIFOOverflows() is incremented.  Samples must be read often
+     * enough to avoid this: the FIFO holds 1024 bytes, so for
+     * example 73 samples of accelerometer, temperature and gyroscope
+     * data.
+     *
+     * @param samples the buffer to store the samples in
+     * @param maxSamples the maximum number of samples to read
+     * @return the number of samples read
+     */
+    int readFIFO(FIFO_SAMPLE_T *samples, int maxSamples);
+
+    /**
+     * return the number of FIFO overflows detected by readFIFO()
+     * since the FIFO was enabled
+     *
+     * @return the number of overflows
+     */
+    unsigned int getFIFOOverflows();
+
   protected:
+    /**
+     * decode the external sensor data of a FIFO frame.  Derived
+     * classes override this to decode data from their I2C slaves.
+     * The default does nothing.
+     *
+     * @param data the external sensor data
+     * @param len the length of the data
+     * @param sample the sample to store the decoded values in
+     */
+    virtual void decodeFIFOExt(const uint8_t *data, int len,
+                               FIFO_SAMPLE_T *sample);
+
+    /**
+     * convert a raw temperature value to degrees Celsius
+     *
+     * @param raw the raw temperature value
+     * @return the temperature in degrees Celsius
+     */
+    virtual float convertTemperature(float raw);
+
+    /**
+     * return the current sample period, based on the sample rate
+     * divider and the DLPF setting
+     *
+     * @return the sample period in microseconds
+     */
+    uint32_t getSamplePeriodUS();
+
     // uncompensated accelerometer and gyroscope values
     float m_accelX;
     float m_accelY;
@@ -945,5 +1050,15 @@ namespace upm {
     uint8_t m_addr;
 
     mraa::Gpio *m_gpioIRQ;
+
+    // FIFO state
+    uint8_t m_fifoSensors;
+    int m_fifoFrameLen;
+    int m_fifoExtLen;
+    uint32_t m_fifoPeriodUS;
+    uint64_t m_fifoSampleNum;
+    std::chrono::steady_clock::time_point m_fifoStart;
+    unsigned int m_fifoOverflows;
+    std::vector<uint8_t> m_fifoBuffer;
   };
 }
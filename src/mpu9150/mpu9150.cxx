@@ -19,7 +19,7 @@ using namespace upm;
 using namespace std;
 
 MPU9150::MPU9150 (int bus, int address, int magAddress, bool enableAk8975) :
-  MPU60X0(bus, address), m_mag(0)
+  MPU60X0(bus, address), m_mag(0), m_magMaster(false)
 {
   m_magAddress = magAddress;
   m_i2cBus = bus;
@@ -75,7 +75,15 @@ void MPU9150::update()
 {
   MPU60X0::update();
 
-  if (m_mag)
+  if (m_magMaster)
+    {
+      // ST1, the data, and ST2, as read by the I2C master
+      uint8_t buffer[8];
+      readRegs(REG_EXT_SENS_DATA_00, buffer, 8);
+
+      m_mag->setRawData(&buffer[1]);
+    }
+  else if (m_mag)
     m_mag->update();
 }
 
@@ -102,3 +110,94 @@ std::vector<float> MPU9150::getMagnetometer()
     m_mag->getMagnetometer(&v[0], &v[1], &v[2]);
     return v;
 }
+
+void MPU9150::enableFIFO(uint8_t sensors)
+{
+  // set up the slaves first, so that the FIFO frame includes them
+  if (m_mag && (sensors & SLV0_FIFO_EN))
+    setMagnetometerMaster(true);
+  else if (m_magMaster)
+    setMagnetometerMaster(false);
+
+  MPU60X0::enableFIFO(sensors);
+}
+
+void MPU9150::setMagnetometerMaster(bool enable)
+{
+  uint8_t userCtrl = readReg(REG_USER_CTRL);
+
+  // stop the master before touching the slaves
+  writeReg(REG_USER_CTRL, userCtrl & ~I2C_MST_EN);
+  writeReg(REG_I2C_SLV0_CTRL, 0);
+  writeReg(REG_I2C_SLV1_CTRL, 0);
+
+  if (!enable)
+    {
+      m_magMaster = false;
+
+      uint8_t delayCtrl = readReg(REG_I2C_MST_DELAY_CTRL);
+      writeReg(REG_I2C_MST_DELAY_CTRL,
+               delayCtrl & ~(I2C_SLV0_DLY_EN | I2C_SLV1_DLY_EN));
+
+      if (!enableI2CBypass(true))
+        throw std::runtime_error(std::string(__FUNCTION__) +
+                                 ": Unable to enable I2C bypass");
+      return;
+    }
+
+  // the master and bypass mode are mutually exclusive
+  if (!enableI2CBypass(false))
+    throw std::runtime_error(std::string(__FUNCTION__) +
+                             ": Unable to disable I2C bypass");
+
+  // 400Khz, and hold the data ready interrupt until the slaves have
+  // been read
+  uint8_t mstCtrl = readReg(REG_I2C_MST_CTRL);
+  mstCtrl &= ~(_I2C_MST_CLK_MASK << _I2C_MST_CLK_SHIFT);
+  mstCtrl |= (MST_CLK_400 << _I2C_MST_CLK_SHIFT) | WAIT_FOR_ES;
+  writeReg(REG_I2C_MST_CTRL, mstCtrl);
+
+  // slave 0 reads ST1, the data, and ST2 (which ends the
+  // measurement)...
+  writeReg(REG_I2C_SLV0_ADDR, m_magAddress | I2C_SLV_RW);
+  writeReg(REG_I2C_SLV0_REG, AK8975::REG_ST1);
+  writeReg(REG_I2C_SLV0_CTRL, I2C_SLV_EN | 8);
+
+  // ...and then slave 1 starts the next one
+  writeReg(REG_I2C_SLV1_ADDR, m_magAddress);
+  writeReg(REG_I2C_SLV1_REG, AK8975::REG_CNTL);
+  writeReg(REG_I2C_SLV1_DO, AK8975::CNTL_MEASURE);
+  writeReg(REG_I2C_SLV1_CTRL, I2C_SLV_EN | 1);
+
+  // A measurement takes up to 9ms, so access the magnetometer every
+  // (1 + MST_DLY) samples to stay at or below 100Hz.
+  uint32_t period = getSamplePeriodUS();
+  uint32_t dly = (10000 + period - 1) / period;
+  dly = (dly > 0) ? dly - 1 : 0;
+  if (dly > _I2C_MST_DLY_MASK)
+    dly = _I2C_MST_DLY_MASK;
+
+  uint8_t slv4Ctrl = readReg(REG_I2C_SLV4_CTRL);
+  slv4Ctrl &= ~(_I2C_MST_DLY_MASK << _I2C_MST_DLY_SHIFT);
+  slv4Ctrl |= (dly << _I2C_MST_DLY_SHIFT);
+  writeReg(REG_I2C_SLV4_CTRL, slv4Ctrl);
+
+  uint8_t delayCtrl = readReg(REG_I2C_MST_DELAY_CTRL);
+  writeReg(REG_I2C_MST_DELAY_CTRL,
+           delayCtrl | I2C_SLV0_DLY_EN | I2C_SLV1_DLY_EN);
+
+  writeReg(REG_USER_CTRL, readReg(REG_USER_CTRL) | I2C_MST_EN);
+
+  m_magMaster = true;
+}
+
+void MPU9150::decodeFIFOExt(const uint8_t *data, int len,
+                            FIFO_SAMPLE_T *sample)
+{
+  // slave 0 data comes first
+  if (!m_magMaster || len < 8)
+    return;
+
+  m_mag->setRawData(&data[1]);
+  m_mag->getMagnetometer(&sample->mag[0], &sample->mag[1], &sample->mag[2]);
+}
@@ -41,8 +41,13 @@ namespace upm {
    *
    * This module defines the MPU9150 interface for libmpu9150
    *
+   * Magnetometer data can be stored in the FIFO along with the
+   * other sensors, see enableFIFO().
+   *
    * @image html mpu9150.jpg
    * @snippet mpu9150.cxx Interesting
+   * Reading from the FIFO.
+   * @snippet mpu9150-fifo.cxx Interesting
    */
 
   class MPU9150: public MPU60X0, virtual public iMagnetometer
@@ -104,10 +109,34 @@ namespace upm {
      */
     std::vector<float> getMagnetometer();
 
+    /**
+     * Enable or disable the FIFO, see MPU60X0::enableFIFO().  Include
+     * SLV0_FIFO_EN in sensors to store magnetometer data in the FIFO
+     * as well.  The MPU9150 I2C master then takes over the
+     * magnetometer from I2C bypass mode, triggering a measurement
+     * and reading it through I2C slaves 0 and 1, at up to 100Hz.
+     * Until the FIFO is disabled, or enabled without SLV0_FIFO_EN,
+     * update() reads the magnetometer data collected by the I2C
+     * master.
+     *
+     * @param sensors Bitmask of FIFO_EN_BITS_T values, or 0 to
+     * disable the FIFO
+     */
+    void enableFIFO(uint8_t sensors);
+
   protected:
     // magnetometer instance
     AK8975* m_mag;
 
+    // decode the magnetometer data read by the I2C master
+    void decodeFIFOExt(const uint8_t *data, int len, FIFO_SAMPLE_T *sample);
+
+    // hand the magnetometer to the I2C master, or back to bypass mode
+    void setMagnetometerMaster(bool enable);
+
+    // true if the magnetometer is read by the I2C master
+    bool m_magMaster;
+
 
   private:
       /* Disable implicit copy and assignment operators */
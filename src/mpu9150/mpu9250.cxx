@@ -28,10 +28,15 @@ MPU9250::~MPU9250()
 }
 
 float MPU9250::getTemperature()
+{
+  return convertTemperature(m_temp);
+}
+
+float MPU9250::convertTemperature(float raw)
 {
   // this equation is taken from the datasheet.  The 333.87 value was
   // taken from the adafruit code (it is referenced as
   // Temp_Sensitivity in the datasheet, but no value is provided there).
-  return (m_temp / 333.87) + 21.0;
+  return (raw / 333.87) + 21.0;
 }
 
@@ -65,6 +65,7 @@ namespace upm {
     float getTemperature();
 
   protected:
+    float convertTemperature(float raw);
 
   private:
   };
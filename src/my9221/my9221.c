@@ -70,7 +70,8 @@ my9221_context my9221_init(int dataPin, int clockPin,
     }
 
     mraa_gpio_dir(dev->gpioClk, MRAA_GPIO_OUT);
-
+    mraa_gpio_write(dev->gpioClk, 0);
+    dev->clockState = 0;
 
     if ( !(dev->gpioData = mraa_gpio_init(dataPin)) )
     {
@@ -245,14 +246,8 @@ static void my9221_send_16bit_block(const my9221_context dev, uint16_t data)
         uint32_t state = (data & 0x8000) ? 1 : 0;
         mraa_gpio_write(dev->gpioData, state);
 
-        state = mraa_gpio_read(dev->gpioClk);
-
-        if (state)
-            state = 0;
-        else
-            state = 1;
-
-        mraa_gpio_write(dev->gpioClk, state);
+        dev->clockState = !dev->clockState;
+        mraa_gpio_write(dev->gpioClk, dev->clockState);
 
         data <<= 1;
     }
@@ -46,6 +46,10 @@ extern "C" {
         mraa_gpio_context gpioClk;
         mraa_gpio_context gpioData;
 
+        // the level last written to the clock pin, which toggles for
+        // every bit, so it doesn't have to be read back
+        int               clockState;
+
         bool              autoRefresh;
         // we're only doing 8-bit greyscale, so the high order bits are
         // always 0
@@ -12,8 +12,8 @@
 #include <chrono>
 #include <ctime>
 #include <iomanip>
+#include <cstring>
 #include <iostream>
-#include <regex>
 #include <sstream>
 #include <stdexcept>
 
@@ -23,14 +23,26 @@
 using namespace upm;
 using namespace std;
 
+/* Largest queue depth, the queues are allocated for it up front */
+static const size_t max_queue_depth = 1000;
+
 NMEAGPS::NMEAGPS(unsigned int uart, unsigned int baudrate,
                  int enable_pin) :
   m_nmea_gps(nmea_gps_init(uart, baudrate, enable_pin)),
+    _source(nullptr),
     _running(false),
+    _queue_nmea_sentence(max_queue_depth, 10),
+    _queue_fix(max_queue_depth, 10),
+    _queue_txt(max_queue_depth, 10),
+    _fix_waiters(0),
     _maxQueueDepth(10),
     _sentences_since_start(0),
     _bytes_since_start(0),
-    _seconds_since_start(0.0)
+    _seconds_since_start(0.0),
+    _frm_state(framer_state::seek),
+    _frm_len(0),
+    _frm_chksum(0),
+    _frm_rx_chksum(0)
 {
   if (!m_nmea_gps)
     throw std::runtime_error(string(__FUNCTION__)
@@ -39,11 +51,20 @@ NMEAGPS::NMEAGPS(unsigned int uart, unsigned int baudrate,
 
 NMEAGPS::NMEAGPS(const std::string& uart, unsigned int baudrate) :
   m_nmea_gps(nmea_gps_init_raw(uart.c_str(), baudrate)),
+    _source(nullptr),
     _running(false),
+    _queue_nmea_sentence(max_queue_depth, 10),
+    _queue_fix(max_queue_depth, 10),
+    _queue_txt(max_queue_depth, 10),
+    _fix_waiters(0),
     _maxQueueDepth(10),
     _sentences_since_start(0),
     _bytes_since_start(0),
-    _seconds_since_start(0.0)
+    _seconds_since_start(0.0),
+    _frm_state(framer_state::seek),
+    _frm_len(0),
+    _frm_chksum(0),
+    _frm_rx_chksum(0)
 {
   if (!m_nmea_gps)
     throw std::runtime_error(string(__FUNCTION__)
@@ -52,44 +73,94 @@ NMEAGPS::NMEAGPS(const std::string& uart, unsigned int baudrate) :
 
 NMEAGPS::NMEAGPS(unsigned int bus, uint8_t addr) :
   m_nmea_gps(nmea_gps_init_ublox_i2c(bus, addr)),
+    _source(nullptr),
     _running(false),
+    _queue_nmea_sentence(max_queue_depth, 10),
+    _queue_fix(max_queue_depth, 10),
+    _queue_txt(max_queue_depth, 10),
+    _fix_waiters(0),
     _maxQueueDepth(10),
     _sentences_since_start(0),
     _bytes_since_start(0),
-    _seconds_since_start(0.0)
+    _seconds_since_start(0.0),
+    _frm_state(framer_state::seek),
+    _frm_len(0),
+    _frm_chksum(0),
+    _frm_rx_chksum(0)
 {
   if (!m_nmea_gps)
     throw std::runtime_error(string(__FUNCTION__)
                              + ": nmea_gps_init() failed");
 }
 
+NMEAGPS::NMEAGPS(NMEASource& source) :
+  m_nmea_gps(nullptr),
+    _source(&source),
+    _running(false),
+    _queue_nmea_sentence(max_queue_depth, 10),
+    _queue_fix(max_queue_depth, 10),
+    _queue_txt(max_queue_depth, 10),
+    _fix_waiters(0),
+    _maxQueueDepth(10),
+    _sentences_since_start(0),
+    _bytes_since_start(0),
+    _seconds_since_start(0.0),
+    _frm_state(framer_state::seek),
+    _frm_len(0),
+    _frm_chksum(0),
+    _frm_rx_chksum(0)
+{
+}
+
 NMEAGPS::~NMEAGPS()
 {
   _running = false;
   if (_parser.joinable())
     _parser.join();
-  nmea_gps_close(m_nmea_gps);
+  if (m_nmea_gps)
+    nmea_gps_close(m_nmea_gps);
 }
 
-std::string NMEAGPS::readStr(size_t size)
+int NMEAGPS::_read(char* buffer, size_t size)
 {
-  char buffer[size];
-
   int rv;
 
-  if ((rv = nmea_gps_read(m_nmea_gps, buffer, size)) < 0)
+  if (_source)
+    {
+      if ((rv = _source->read(buffer, size)) < 0)
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": NMEASource::read() failed");
+    }
+  else if ((rv = nmea_gps_read(m_nmea_gps, buffer, size)) < 0)
     throw std::runtime_error(string(__FUNCTION__)
                              + ": nmea_gps_read() failed");
 
   /* Keep track of bytes read */
   _bytes_since_start += rv;
-  return buffer;
+  return rv;
+}
+
+std::string NMEAGPS::readStr(size_t size)
+{
+  char buffer[size];
+
+  int rv = _read(buffer, size);
+
+  return std::string(buffer, rv);
 }
 
 int NMEAGPS::writeStr(const std::string& buffer)
 {
   int rv;
 
+  if (_source)
+    {
+      if ((rv = _source->write(buffer.data(), buffer.size())) < 0)
+        throw std::runtime_error(string(__FUNCTION__)
+                                 + ": NMEASource::write() failed");
+      return rv;
+    }
+
   /* The write takes a char*.  This should be OK since it's known that the mraa
    * write call does not change buffer */
   if ((rv = nmea_gps_write(m_nmea_gps, const_cast<char*>(buffer.c_str()),
@@ -102,6 +173,9 @@ int NMEAGPS::writeStr(const std::string& buffer)
 
 void NMEAGPS::enable(bool enable)
 {
+  /* Nothing to enable on a replay source */
+  if (_source) return;
+
   if (nmea_gps_enable(m_nmea_gps, enable))
     throw std::runtime_error(string(__FUNCTION__)
                              + ": nmea_gps_enable() failed");
@@ -109,6 +183,8 @@ void NMEAGPS::enable(bool enable)
 
 void NMEAGPS::setBaudrate(unsigned int baudrate)
 {
+  if (_source) return;
+
   if (nmea_gps_set_baudrate(m_nmea_gps, baudrate))
     throw std::runtime_error(string(__FUNCTION__)
                              + ": nmea_gps_baudrate() failed");
@@ -116,6 +192,9 @@ void NMEAGPS::setBaudrate(unsigned int baudrate)
 
 bool NMEAGPS::dataAvailable(unsigned int millis)
 {
+  if (_source)
+    return _source->dataAvailable(millis);
+
   return nmea_gps_data_available(m_nmea_gps, millis);
 }
 
@@ -127,136 +206,326 @@ size_t NMEAGPS::getMaxQueueDepth()
 size_t NMEAGPS::setMaxQueueDepth(size_t depth)
 {
     /* 1 <= depth <= 1000 */
-    if (depth > 1000) depth = 1000;
+    if (depth > max_queue_depth) depth = max_queue_depth;
     if (depth == 0) depth = 1;
 
+    /* The rings are allocated for the largest depth, so this only
+     * changes the limit the parsing thread checks when pushing */
     _maxQueueDepth = depth;
+    _queue_nmea_sentence.set_depth(depth);
+    _queue_fix.set_depth(depth);
+    _queue_txt.set_depth(depth);
+
     return _maxQueueDepth;
 }
 
-/* Given a NMEA sentence, return a checksum which is calculated on
- * all characters between the '$' and the '*' */
-static uint8_t checksum(const std::string& sentence)
+namespace {
+    /* A single comma separated NMEA field, references the sentence buffer */
+    struct field {
+        const char* b;
+        const char* e;
+        bool empty() const { return b == e; }
+        size_t size() const { return e - b; }
+        bool is(char c) const { return (size() == 1) && (*b == c); }
+    };
+
+    /* Cursor over the comma separated fields of a NMEA sentence body */
+    class field_cursor {
+        public:
+            field_cursor(const char* begin, const char* end) :
+                _p(begin), _end(end), _done(false) {}
+
+            /* Get the next field, false when no fields remain */
+            bool next(field& f)
+            {
+                if (_done) return false;
+                f.b = _p;
+                while ((_p != _end) && (*_p != ',')) ++_p;
+                f.e = _p;
+                if (_p == _end) _done = true;
+                else ++_p;
+                return true;
+            }
+
+            /* Fill up to max fields, return the number of fields found */
+            size_t split(field* fields, size_t max)
+            {
+                size_t n = 0;
+                while ((n < max) && next(fields[n])) n++;
+                return n;
+            }
+
+            /* Remaining characters after the last field returned */
+            const char* rest() const { return _p; }
+        private:
+            const char* _p;
+            const char* _end;
+            bool _done;
+    };
+
+    int hexval(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    bool is_digits(const char* b, const char* e)
+    {
+        if (b == e) return false;
+        for (; b != e; ++b)
+            if (*b < '0' || *b > '9') return false;
+        return true;
+    }
+
+    /* Parse an unsigned integer field, all characters must be digits */
+    bool to_int(const field& f, int& out)
+    {
+        if (!is_digits(f.b, f.e)) return false;
+        out = 0;
+        for (const char* p = f.b; p != f.e; ++p)
+            out = out * 10 + (*p - '0');
+        return true;
+    }
+
+    /* Parse a decimal field of the form [+-]d+.d+, the sign is only
+     * accepted when signed_ok is true */
+    bool to_decimal(const field& f, double& out, bool signed_ok = false)
+    {
+        const char* p = f.b;
+        bool neg = false;
+        if (signed_ok && (p != f.e) && (*p == '+' || *p == '-'))
+            neg = (*p++ == '-');
+
+        const char* dot = static_cast<const char*>(std::memchr(p, '.', f.e - p));
+        if (!dot || !is_digits(p, dot) || !is_digits(dot + 1, f.e))
+            return false;
+
+        /* Accumulate as an integer mantissa, then scale once */
+        double mantissa = 0.0;
+        double scale = 1.0;
+        for (; p != dot; ++p) mantissa = mantissa * 10.0 + (*p - '0');
+        for (p = dot + 1; p != f.e; ++p)
+        {
+            mantissa = mantissa * 10.0 + (*p - '0');
+            scale *= 10.0;
+        }
+        out = (neg ? -mantissa : mantissa) / scale;
+        return true;
+    }
+
+    /* Parse a (d)ddmm.mmmm coordinate and its hemisphere into decimal
+     * degrees.  Requires at least two digits of whole minutes. */
+    bool to_coordinate(const field& value, const field& hemi, char pos,
+            char neg, double& out)
+    {
+        if (!(hemi.is(pos) || hemi.is(neg))) return false;
+
+        const char* dot = static_cast<const char*>(
+                std::memchr(value.b, '.', value.size()));
+        if (!dot || (dot - value.b) < 3) return false;
+
+        field deg_f = {value.b, dot - 2};
+        field min_f = {dot - 2, value.e};
+        int deg;
+        double min;
+        if (!to_int(deg_f, deg) || !to_decimal(min_f, min)) return false;
+
+        out = (deg + min/60.0) * (hemi.is(pos) ? 1.0 : -1.0);
+        return true;
+    }
+
+    /* Parse a number which may omit the fractional part, d+ or d+.d+ */
+    bool to_number(const field& f, double& out)
+    {
+        int i;
+        if (!to_int(f, i)) return to_decimal(f, out);
+        out = i;
+        return true;
+    }
+
+    /* Talker IDs are two upper case characters, GP, GN, GL, GA, GB... */
+    bool is_talker(const char* id)
+    {
+        return (id[0] >= 'A') && (id[0] <= 'Z') &&
+            (id[1] >= 'A') && (id[1] <= 'Z');
+    }
+
+    /* Pack a 3 character sentence type (GGA, RMC, ...) into a switch label */
+    constexpr uint32_t nmea_type(char a, char b, char c)
+    {
+        return (static_cast<uint32_t>(a) << 16) |
+            (static_cast<uint32_t>(b) << 8) | static_cast<uint32_t>(c);
+    }
+}
+
+/* Given a NMEA sentence, find the '*' which delimits the checksum and
+ * compare the transmitted checksum to one which is calculated on all
+ * characters between the '$' and the '*'.  Returns nullptr if the
+ * sentence has no well formed *XX suffix. */
+static const char* find_checksum(const char* sentence, size_t size,
+        bool& chksum_match)
 {
+    const char* end = sentence + size;
+    /* Tolerate trailing line endings */
+    while ((end != sentence) && (end[-1] == '\r' || end[-1] == '\n'))
+        --end;
+
+    if ((end - sentence) < 4 || end[-3] != '*') return nullptr;
+    int hi = hexval(end[-2]);
+    int lo = hexval(end[-1]);
+    if (hi < 0 || lo < 0) return nullptr;
+
+    const char* star = end - 3;
     uint8_t chksum = 0;
-    std::string::const_iterator it = sentence.begin();
+    const char* it = sentence;
     /* Skip the '$' */
     if (*it == '$') ++it;
+    while (it != star) chksum ^= *it++;
 
-    /* Calculate the checksum on all characters */
-    while ((*it != '*') && (it != sentence.end()))
-        chksum ^= *it++;
-    return chksum;
+    chksum_match = ((hi << 4) | lo) == chksum;
+    return star;
 }
 
-/* Regex for matching NMEA GGA coordinates
+/* Parse NMEA GGA sentences
  * Unfortunately these sentences appear-non standard between the devices tested
  * so it can be expected that these would need updating to match additional
  * devices.
  * GPGGA,164800.00,4532.52680,N,12257.59972,W,1,10,0.93,73.3,M,-21.3,M,,*5E
  */
-static std::regex rex_gga(R"(^\$GPGGA,(\d+\.\d+),(\d+)(\d{2}\.\d+),([NS]),(\d+)(\d{2}.\d+),([WE]),(\d+),(\d+),(\d+\.\d+),(\d+\.\d+),M,([+-]?\d+\.\d+),M,([+-]?\d+\.\d+)?,?(\S+)?[*]([A-Z0-9]{2}))");
-void NMEAGPS::_parse_gpgga(const std::string& sentence)
+void NMEAGPS::_parse_gga(const nmea_view& sentence)
 {
-    /* Parse the GGA message */
-    std::smatch m;
-    if (!std::regex_search(sentence, m, rex_gga))
+    /* type, time, lat, N/S, lon, E/W, quality, sats, hdop, alt, M,
+     * geoid height, M, [age], [station id] */
+    field f[16];
+    size_t n = field_cursor(sentence.begin, sentence.end).split(f, 16);
+    if (n < 13 || n > 15) return;
+
+    /* Start with the latest date, speed, course and DOP */
+    gps_fix fix = _epoch;
+    double value;
+    int ivalue;
+
+    if (!to_decimal(f[1], value)) return;
+    fix.time_utc.assign(f[1].b, f[1].e);
+
+    if (!to_coordinate(f[2], f[3], 'N', 'S', fix.coordinates.latitude) ||
+            !to_coordinate(f[4], f[5], 'E', 'W', fix.coordinates.longitude))
         return;
 
-    gps_fix fix;
-    fix.valid = true;
-    fix.time_utc = m[1];
-    int deg = std::stoi(m[2]);
-    fix.coordinates.latitude = (deg + std::stof(m[3])/60.0) *
-        (m[4] == "N" ? 1.0 : m[4] == "S" ? -1.0 : fix.valid = false );
-    deg = std::stoi(m[5]);
-    fix.coordinates.longitude = (deg + std::stof(m[6])/60.0) *
-        (m[7] == "E" ? 1.0 : m[7] == "W" ? -1.0 : fix.valid = false );
-    fix.quality = static_cast<gps_fix_quality>(std::stoi(m[8]));
-    fix.satellites = std::stoi(m[9]);
-    fix.hdop = std::stof(m[10]);
-    fix.altitude_meters = std::stof(m[11]);
-    fix.geoid_height_meters = std::stof(m[12]);
-    fix.age_seconds = m[13].str().empty() ? 0.0 : std::stof(m[13]);
-    fix.station_id = m[14];
-    fix.chksum_match = std::stoi(m[15], nullptr, 16) == checksum(sentence);
-    fix.valid &= fix.chksum_match;
+    if (!to_int(f[6], ivalue)) return;
+    fix.quality = static_cast<gps_fix_quality>(ivalue);
+    if (!to_int(f[7], ivalue)) return;
+    fix.satellites = ivalue;
+    if (!to_decimal(f[8], value)) return;
+    fix.hdop = value;
+    if (!to_decimal(f[9], value, true) || !f[10].is('M')) return;
+    fix.altitude_meters = value;
+    if (!to_decimal(f[11], value, true) || !f[12].is('M')) return;
+    fix.geoid_height_meters = value;
+
+    /* Age of the differential correction and station ID are optional */
+    if ((n > 13) && !f[13].empty())
+    {
+        if (!to_decimal(f[13], value, true)) return;
+        fix.age_seconds = value;
+    }
+    if (n > 14) fix.station_id.assign(f[14].b, f[14].e);
+
+    fix.chksum_match = sentence.chksum_match;
+    fix.valid = fix.chksum_match;
 
-    /* Throw away oldest if full, push to queue */
-    _mtx_fix.lock();
-    if (_queue_fix.size() == _maxQueueDepth)
-        _queue_fix.pop();
-    _queue_fix.push(fix);
-    _mtx_fix.unlock();
+    /* Sentences without these fields (GLL, RMC) pick them up from here */
+    if (fix.valid)
+    {
+        _epoch.quality = fix.quality;
+        _epoch.satellites = fix.satellites;
+        _epoch.hdop = fix.hdop;
+        _epoch.altitude_meters = fix.altitude_meters;
+        _epoch.geoid_height_meters = fix.geoid_height_meters;
+    }
+
+    _push_fix(std::move(fix));
 }
 
-/* Regex for matching NMEA GSV satellite sentences
+/* Parse NMEA GSV satellite sentences
  * Unfortunately these sentences appear-non standard between the devices tested
  * so it can be expected that these would need updating to match additional
- * devices.
+ * devices.  Each constellation reports its own satellites, the talker ID
+ * is kept with each satellite.
  *
  * Example sentence:
  *
  * $GPGSV,3,3,12,28,75,028,20,30,55,116,28,48,37,194,41,51,35,159,32*7A
  */
-static std::regex rex_gsv_hdr(R"(^\$GPGSV,(\d+),(\d+),(\d\d),)");
-static std::regex rex_gsv_sat(R"((\d{2}),(\d{2}),(\d{3}),(\d+)?,?)");
-static std::regex rex_gsv_ftr("[*]([A-Z0-9]{2})$");
-void NMEAGPS::_parse_gpgsv(const std::string& sentence)
-{
-    /* Parse the GSV header message */
-    std::smatch mhdr;
-    std::smatch mftr;
-    /* No further parsing if this message doesn't match the header
-     * or footer or the checksum is bad */
-    if (!std::regex_search(sentence, mhdr, rex_gsv_hdr) ||
-            !std::regex_search(sentence, mftr, rex_gsv_ftr) ||
-            (std::stoi(mftr[1], nullptr, 16) != checksum(sentence)))
+void NMEAGPS::_parse_gsv(const nmea_view& sentence)
+{
+    /* No further parsing if the checksum is bad */
+    if (!sentence.chksum_match) return;
+
+    /* type, total messages, message number, total satellites */
+    field_cursor fc(sentence.begin, sentence.end);
+    field hdr[4];
+    int msgs, msg, total_svs;
+    if ((fc.split(hdr, 4) != 4) || !to_int(hdr[1], msgs) ||
+            !to_int(hdr[2], msg) || !to_int(hdr[3], total_svs))
         return;
 
-    size_t total_svs = std::stoi(mhdr[3]);
+    const char* talker = sentence.begin;
 
-    /* Match each satellite */
-    std::sregex_iterator next(sentence.begin(), sentence.end(), rex_gsv_sat);
-    std::sregex_iterator end;
-    while (next != end)
+    _mtx_satlist.lock();
+    /* Each satellite is a group of prn, elevation, azimuth, [snr] */
+    field sat_f[4];
+    size_t n;
+    while ((n = fc.split(sat_f, 4)) >= 3)
     {
-        std::smatch satmatches = *next++;
-
-        /* Add these satellites.  Only keep a max total_svs satellites at any
-         * one time.  The latest are the most current */
-        satellite sat = {
-            satmatches[1].str(),
-            std::stoi(satmatches[2].str()),
-            std::stoi(satmatches[3].str()),
-            satmatches[4].str().empty() ? 0 :
-            std::stoi(satmatches[4].str())
-        };
-
-        /* Add to the back of satmap, remove any matching prn */
-        _mtx_satlist.lock();
+        int elevation, azimuth, snr = 0;
+        if (!is_digits(sat_f[0].b, sat_f[0].e) ||
+                !to_int(sat_f[1], elevation) || !to_int(sat_f[2], azimuth) ||
+                ((n == 4) && !sat_f[3].empty() && !to_int(sat_f[3], snr)))
+            continue;
+
+        /* Remove any matching prn, the latest is the most current */
         auto sit = _satlist.begin();
         while(sit != _satlist.end())
         {
-            /* Remove */
-            if ((*sit).prn == sat.prn)
+            if (!(*sit).talker.compare(0, 2, talker, 2) &&
+                    ((*sit).prn.size() == sat_f[0].size()) &&
+                    !std::memcmp((*sit).prn.data(), sat_f[0].b, sat_f[0].size()))
             {
-                sit = _satlist.erase(sit);
+                _satlist.erase(sit);
                 break;
             }
             ++sit;
         }
-        /* Add satellite to the end */
-        _satlist.push_back(sat);
 
-        /* If more sats exist than current sat count, remove them */
-        while (_satlist.size() > total_svs) _satlist.pop_front();
-        _mtx_satlist.unlock();
+        /* Add satellite to the end */
+        _satlist.emplace_back(std::string(sat_f[0].b, sat_f[0].e),
+                elevation, azimuth, snr, std::string(talker, 2));
+
+        /* Only keep a max total_svs satellites for this constellation
+         * at any one time, dropping the oldest */
+        size_t count = 0;
+        for (const auto& sat : _satlist)
+            if (!sat.talker.compare(0, 2, talker, 2)) count++;
+        for (sit = _satlist.begin();
+                (count > static_cast<size_t>(total_svs)) && (sit != _satlist.end());)
+        {
+            if (!(*sit).talker.compare(0, 2, talker, 2))
+            {
+                sit = _satlist.erase(sit);
+                count--;
+            }
+            else
+                ++sit;
+        }
     }
+    _mtx_satlist.unlock();
 }
 
 /*
- * Regex for matching NMEA GLL coordinates
+ * Parse NMEA GLL coordinates
  * Unfortunately these sentences appear-non standard between the devices tested
  * so it can be expected that these would need updating to match additional
  * devices.
@@ -265,35 +534,137 @@ void NMEAGPS::_parse_gpgsv(const std::string& sentence)
  * with a duplicate ,A,A at the end :(
  *      "$GPGLL,4532.55107,N,12257.68422,W,170004.20,A,A*74"
  */
-static std::regex rex_gll(R"(^\$GPGLL,(\d+)(\d{2}\.\d+),([NS]),(\d+)(\d{2}.\d+),([WE]),(\d+\.\d+)(,A)?,A[*]([A-Z0-9]{2}))");
-void NMEAGPS::_parse_gpgll(const std::string& sentence)
+void NMEAGPS::_parse_gll(const nmea_view& sentence)
 {
-    /* Parse the GLL message */
-    std::smatch m;
-    if (!std::regex_search(sentence, m, rex_gll))
+    /* type, lat, N/S, lon, E/W, time, status, [mode] */
+    field f[9];
+    size_t n = field_cursor(sentence.begin, sentence.end).split(f, 9);
+    if (n < 7 || n > 8) return;
+
+    gps_fix fix = _epoch;
+    double utc;
+    if (!to_coordinate(f[1], f[2], 'N', 'S', fix.coordinates.latitude) ||
+            !to_coordinate(f[3], f[4], 'E', 'W', fix.coordinates.longitude) ||
+            !to_decimal(f[5], utc) || !f[6].is('A') ||
+            ((n == 8) && !f[7].is('A')))
         return;
+    fix.time_utc.assign(f[5].b, f[5].e);
+    fix.chksum_match = sentence.chksum_match;
+    fix.valid = fix.chksum_match;
 
-    gps_fix fix;
-    fix.valid = true;
-    fix.time_utc = m[7];
-    int deg = std::stoi(m[1]);
-    fix.coordinates.latitude = (deg + std::stof(m[2])/60.0) *
-        (m[3] == "N" ? 1.0 : m[3] == "S" ? -1.0 : fix.valid = false );
-    deg = std::stoi(m[4]);
-    fix.coordinates.longitude = (deg + std::stof(m[5])/60.0) *
-        (m[6] == "E" ? 1.0 : m[6] == "W" ? -1.0 : fix.valid = false );
-    fix.chksum_match = std::stoi(m[9], nullptr, 16) == checksum(sentence);
-    fix.valid &= fix.chksum_match;
+    _push_fix(std::move(fix));
+}
 
-    /* Throw away oldest if full, push to queue */
-    _mtx_fix.lock();
-    if (_queue_fix.size() == _maxQueueDepth) _queue_fix.pop();
-    _queue_fix.push(fix);
-    _mtx_fix.unlock();
+/*
+ * Parse NMEA RMC (recommended minimum) sentences
+ * Position, speed, course and date in a single sentence.  The status must
+ * be A (active), V (void) sentences are ignored.
+ *      $GNRMC,170000.00,A,4532.55136,N,12257.68454,W,0.267,,170218,,,A*78
+ */
+void NMEAGPS::_parse_rmc(const nmea_view& sentence)
+{
+    /* type, time, status, lat, N/S, lon, E/W, speed (knots), course,
+     * date, [magnetic variation, E/W], [mode], [navigational status] */
+    field f[15];
+    size_t n = field_cursor(sentence.begin, sentence.end).split(f, 15);
+    if (n < 10 || n > 14) return;
+
+    gps_fix fix = _epoch;
+    double value;
+    if (!to_decimal(f[1], value) || !f[2].is('A') ||
+            !to_coordinate(f[3], f[4], 'N', 'S', fix.coordinates.latitude) ||
+            !to_coordinate(f[5], f[6], 'E', 'W', fix.coordinates.longitude))
+        return;
+    fix.time_utc.assign(f[1].b, f[1].e);
+
+    /* Speed and course are empty on some devices when stationary */
+    if (!f[7].empty())
+    {
+        if (!to_number(f[7], value)) return;
+        fix.speed_knots = value;
+    }
+    if (!f[8].empty())
+    {
+        if (!to_number(f[8], value)) return;
+        fix.course_deg = value;
+    }
+    if ((f[9].size() != 6) || !is_digits(f[9].b, f[9].e)) return;
+    fix.date_utc.assign(f[9].b, f[9].e);
+
+    /* NMEA 2.3+ mode indicator, N is no fix */
+    if ((n > 12) && f[12].is('N')) return;
+
+    fix.chksum_match = sentence.chksum_match;
+    fix.valid = fix.chksum_match;
+
+    if (fix.valid)
+    {
+        _epoch.date_utc = fix.date_utc;
+        _epoch.speed_knots = fix.speed_knots;
+        _epoch.course_deg = fix.course_deg;
+    }
+
+    _push_fix(std::move(fix));
 }
 
 /*
- * Regex for matching NMEA TXT messages
+ * Parse NMEA VTG (track made good and ground speed) sentences
+ * Updates the speed and course used for subsequent fixes.
+ *      $GPVTG,054.7,T,034.4,M,005.5,N,010.2,K,A*2F
+ */
+void NMEAGPS::_parse_vtg(const nmea_view& sentence)
+{
+    if (!sentence.chksum_match) return;
+
+    /* type, course, T, course magnetic, M, speed, N, speed, K, [mode] */
+    field f[11];
+    size_t n = field_cursor(sentence.begin, sentence.end).split(f, 11);
+    if (n < 9 || n > 10 || !f[2].is('T') || !f[6].is('N')) return;
+
+    /* Mode indicator N is no fix */
+    if ((n == 10) && f[9].is('N')) return;
+
+    double course = _epoch.course_deg, speed;
+    if ((!f[1].empty() && !to_number(f[1], course)) ||
+            !to_number(f[5], speed))
+        return;
+
+    _epoch.course_deg = course;
+    _epoch.speed_knots = speed;
+}
+
+/*
+ * Parse NMEA GSA (DOP and active satellites) sentences
+ * Updates the dilution of precision used for subsequent fixes.  Multi
+ * constellation receivers send one GSA per constellation with the same
+ * combined DOP values.
+ *      $GNGSA,A,3,07,08,09,11,13,30,48,51,,,,,1.62,0.93,1.33*1D
+ */
+void NMEAGPS::_parse_gsa(const nmea_view& sentence)
+{
+    if (!sentence.chksum_match) return;
+
+    /* type, mode, fix type, 12 x prn, pdop, hdop, vdop, [system id] */
+    field f[20];
+    size_t n = field_cursor(sentence.begin, sentence.end).split(f, 20);
+    if (n < 18 || n > 19) return;
+
+    /* Fix type 1 is no fix, DOP values are meaningless */
+    int fix_type;
+    if (!to_int(f[2], fix_type) || fix_type < 2) return;
+
+    double pdop, hdop, vdop;
+    if (!to_number(f[15], pdop) || !to_number(f[16], hdop) ||
+            !to_number(f[17], vdop))
+        return;
+
+    _epoch.pdop = pdop;
+    _epoch.hdop = hdop;
+    _epoch.vdop = vdop;
+}
+
+/*
+ * Parse NMEA TXT messages
  * Grab-bag of messages coming from a GPS device.  Can basically be any
  * additional information that the manufacture wants to send out.
  *
@@ -306,37 +677,50 @@ void NMEAGPS::_parse_gpgll(const std::string& sentence)
  *      $GPTXT,01,01,02,ANTSUPERV=AC SD PDoS SR*20
  *      $GPTXT,01,01,02,ANTSTATUS=OK*3B
  */
-static std::regex rex_txt(R"(^\$GPTXT,(\d{2}),(\d{2}),(\d{2}),(.*)[*]([A-Z0-9]{2}))");
-void NMEAGPS::_parse_gptxt(const std::string& sentence)
+void NMEAGPS::_parse_txt(const nmea_view& sentence)
 {
-    /* Parse the GLL message */
-    std::smatch m;
-    if (!std::regex_search(sentence, m, rex_txt) ||
-            (std::stoi(m[5], nullptr, 16) != checksum(sentence)) )
+    if (!sentence.chksum_match) return;
+
+    /* type, total messages, message number, severity, text (may contain
+     * commas, so it is everything remaining) */
+    field_cursor fc(sentence.begin, sentence.end);
+    field f[4];
+    int severity;
+    if ((fc.split(f, 4) != 4) || (f[1].size() != 2) || (f[2].size() != 2) ||
+            (f[3].size() != 2) || !is_digits(f[1].b, f[1].e) ||
+            !is_digits(f[2].b, f[2].e) || !to_int(f[3], severity) ||
+            (f[3].e == sentence.end))
         return;
 
     /* Throw away oldest if full, push to queue */
-    _mtx_txt.lock();
-    if (_queue_txt.size() == _maxQueueDepth) _queue_txt.pop();
-    _queue_txt.push({std::stoi(m[3]), m[4]});
-    _mtx_txt.unlock();
+    _queue_txt.push(nmeatxt(severity, std::string(fc.rest(), sentence.end)));
 }
 
-void NMEAGPS::parseNMEASentence(const std::string& sentence)
+void NMEAGPS::_parse_sentence(const char* sentence, size_t size,
+        const char* star, bool chksum_match)
 {
-    /* Needs to start with $GP... and be (at least 6 characters
-     * long to call a parser.  Otherwise skip parsing and put into
+    /* Needs to start with $ and a two character talker ID (GP, GN, GL,
+     * GA, GB, ...) to call a parser.  Otherwise skip parsing and put into
      * raw sentence queue for debug */
-    size_t msgsz = sentence.size();
-    if ((sentence.find("$GP") == 0) &&
-            (msgsz >= 5) && (msgsz <=100))
+    if ((size >= 6) && (size <= _max_sentence) && (sentence[0] == '$') &&
+            is_talker(sentence + 1))
     {
-        auto cit = nmea_2_parser.find(sentence.substr(1, 5));
-        if (cit != nmea_2_parser.end())
+        /* Sentence type follows the talker ID, parsers are selected on
+         * the type alone so any constellation is handled */
+        if (star && (size >= 7) && (sentence[6] == ','))
         {
-            fp parser = cit->second;
-            /* Call the corresponding parser */
-            (this->*parser)(sentence);
+            nmea_view view = {sentence + 1, star, chksum_match};
+            switch (nmea_type(sentence[3], sentence[4], sentence[5]))
+            {
+                case nmea_type('G', 'G', 'A'): _parse_gga(view); break;
+                case nmea_type('G', 'S', 'V'): _parse_gsv(view); break;
+                case nmea_type('G', 'L', 'L'): _parse_gll(view); break;
+                case nmea_type('R', 'M', 'C'): _parse_rmc(view); break;
+                case nmea_type('V', 'T', 'G'): _parse_vtg(view); break;
+                case nmea_type('G', 'S', 'A'): _parse_gsa(view); break;
+                case nmea_type('T', 'X', 'T'): _parse_txt(view); break;
+                default: break;
+            }
         }
 
         /* Keep track of total number of sentences */
@@ -344,56 +728,149 @@ void NMEAGPS::parseNMEASentence(const std::string& sentence)
     }
 
     /* Throw away oldest if full, push to raw sentence queue */
-    _mtx_nmea_sentence.lock();
-    if (_queue_nmea_sentence.size() == _maxQueueDepth)
-        _queue_nmea_sentence.pop();
-    _queue_nmea_sentence.push(sentence);
-    _mtx_nmea_sentence.unlock();
+    _queue_nmea_sentence.push(std::string(sentence, size));
 }
 
-void NMEAGPS::_parse_thread()
+void NMEAGPS::_push_fix(gps_fix&& fix)
+{
+    /* Throw away oldest if full, push to queue */
+    _queue_fix.push(std::move(fix));
+
+    /* Only pay for the notify when a consumer is blocked in waitFix */
+    if (_fix_waiters)
+    {
+        std::lock_guard<std::mutex> lock(_mtx_fix_wait);
+        _cv_fix.notify_all();
+    }
+}
+
+void NMEAGPS::parseNMEASentence(const std::string& sentence)
+{
+    bool chksum_match = false;
+    const char* star = find_checksum(sentence.data(), sentence.size(),
+            chksum_match);
+    _parse_sentence(sentence.data(), sentence.size(), star, chksum_match);
+}
+
+void NMEAGPS::parseNMEAStream(const std::string& data)
+{
+    _parse_stream(data.data(), data.size());
+}
+
+void NMEAGPS::_parse_stream(const char* data, size_t size)
 {
     /* NMEA 0183 max sentence length is 82 characters.  There seems to be
-     * varying specs out there.  Using 94 characters between the $GP and
-     * the checksum as a max length for a basic max length sanity check.
+     * varying specs out there.  Using 94 characters between the $ plus
+     * talker ID and the checksum as a max length for a basic max length
+     * sanity check.
      *   $GP(94 chars max)*XX length = 100 characters total
+     *
+     * Sentences are framed one character at a time so that a sentence
+     * split across reads is picked up where the last read left off.  The
+     * checksum is accumulated while framing.
      */
-    std::regex rex(R"((\$GP.{5,94}\*[a-fA-F0-9][a-fA-F0-9])\r\n)");
+    for (const char* it = data; it != data + size; ++it)
+    {
+        const char c = *it;
+
+        /* A '$' always starts a new sentence */
+        if (c == '$')
+        {
+            _frm_buf[0] = c;
+            _frm_len = 1;
+            _frm_chksum = 0;
+            _frm_state = framer_state::body;
+            continue;
+        }
+
+        int nibble;
+        switch (_frm_state)
+        {
+            case framer_state::seek:
+                break;
+            case framer_state::body:
+                if (c == '\r' || c == '\n' ||
+                        (_frm_len == _max_sentence - 2))
+                    _frm_state = framer_state::seek;
+                else
+                {
+                    _frm_buf[_frm_len++] = c;
+                    if (c == '*')
+                        _frm_state = framer_state::chksum_hi;
+                    else
+                        _frm_chksum ^= c;
+                }
+                break;
+            case framer_state::chksum_hi:
+            case framer_state::chksum_lo:
+                if ((nibble = hexval(c)) < 0)
+                {
+                    _frm_state = framer_state::seek;
+                    break;
+                }
+                _frm_buf[_frm_len++] = c;
+                if (_frm_state == framer_state::chksum_hi)
+                {
+                    _frm_rx_chksum = nibble << 4;
+                    _frm_state = framer_state::chksum_lo;
+                }
+                else
+                {
+                    _frm_rx_chksum |= nibble;
+                    _frm_state = framer_state::cr;
+                }
+                break;
+            case framer_state::cr:
+                _frm_state = (c == '\r') ? framer_state::lf :
+                    framer_state::seek;
+                break;
+            case framer_state::lf:
+                _frm_state = framer_state::seek;
+                /* Require $ and a talker ID plus 5 to 94 characters
+                 * before the '*' */
+                if ((c == '\n') && (_frm_len >= 11) && is_talker(_frm_buf + 1))
+                    _parse_sentence(_frm_buf, _frm_len,
+                            _frm_buf + _frm_len - 3,
+                            _frm_chksum == _frm_rx_chksum);
+                break;
+        }
+    }
+}
+
+void NMEAGPS::_parse_thread()
+{
+    char buf[4095];
     while (_running)
     {
         /* While data is available, read from the GPS.  A 5s
          * timeout appears long, but UARTS can be slow with minimal
          * data getting returned, possible slow UART speeds, and it's
-         * better to maximize the UART buffer.  This currently
-         * assumes whole sentences are returned each read.
-         * TODO: Handle leftover uart data
+         * better to maximize the UART buffer.  Partial sentences are
+         * held by the framer until the next read completes them.
          */
         if (dataAvailable(5000))
         {
             /* Read a block */
-            std::string buf = readStr(4095);
+            int rv = _read(buf, sizeof(buf));
 
-            std::sregex_iterator next(buf.begin(), buf.end(), rex);
-            std::sregex_iterator end;
-            while (next != end)
-            {
-                std::smatch matches = *next++;
-                parseNMEASentence(matches[1].str());
-            }
+            _parse_stream(buf, rv);
 
-            /* Let this thread do other stuff */
-            upm_delay_us(100);
+            /* Let this thread do other stuff.  Replay sources are read as
+             * fast as possible. */
+            if (!_source)
+                upm_delay_us(100);
         }
     }
 }
 
 static double getTimeSinceEpoch_s()
 {
-    auto now = std::chrono::system_clock::now();
-    auto now_s = std::chrono::time_point_cast<std::chrono::seconds>(now);
-    auto epoch = now_s.time_since_epoch();
-    auto value = std::chrono::duration_cast<std::chrono::milliseconds>(epoch);
-    return value.count()/1000.0;
+    /* Monotonic with sub-second resolution, rates are measured over
+     * intervals which may be well under a second */
+    auto now = std::chrono::steady_clock::now();
+    auto epoch = now.time_since_epoch();
+    auto value = std::chrono::duration_cast<std::chrono::microseconds>(epoch);
+    return value.count()/1000000.0;
 }
 
 void NMEAGPS::parseStart()
@@ -430,68 +907,51 @@ void NMEAGPS::parseStop()
 
 gps_fix NMEAGPS::getFix()
 {
+    /* Get the oldest fix, or an invalid fix if the queue is empty */
     gps_fix x;
-    _mtx_fix.lock();
-    if (!_queue_fix.empty())
-    {
-        /* Get a copy of the structure, pop an element */
-        x = _queue_fix.front();
-        _queue_fix.pop();
-    }
-    _mtx_fix.unlock();
+    _queue_fix.pop(x);
     return x;
 }
 
+bool NMEAGPS::waitFix(unsigned int millis)
+{
+    if (!_queue_fix.empty()) return true;
+
+    std::unique_lock<std::mutex> lock(_mtx_fix_wait);
+    _fix_waiters++;
+    bool available = _cv_fix.wait_for(lock, std::chrono::milliseconds(millis),
+            [this] { return !_queue_fix.empty(); });
+    _fix_waiters--;
+    return available;
+}
+
 std::string NMEAGPS::getRawSentence()
 {
     std::string ret;
-    _mtx_nmea_sentence.lock();
-    if (!_queue_nmea_sentence.empty())
-    {
-        /* Get a copy of the sentence, pop an element */
-        ret = _queue_nmea_sentence.front();
-        _queue_nmea_sentence.pop();
-    }
-    _mtx_nmea_sentence.unlock();
+    _queue_nmea_sentence.pop(ret);
     return ret;
 }
 
 nmeatxt NMEAGPS::getTxtMessage()
 {
     nmeatxt ret;
-    _mtx_txt.lock();
-    if (!_queue_txt.empty())
-    {
-        /* Get a copy of the sentence, pop an element */
-        ret = _queue_txt.front();
-        _queue_txt.pop();
-    }
-    _mtx_txt.unlock();
+    _queue_txt.pop(ret);
     return ret;
 }
 
 size_t NMEAGPS::fixQueueSize()
 {
-    _mtx_fix.lock();
-    size_t x =_queue_fix.size();
-    _mtx_fix.unlock();
-    return x;
+    return _queue_fix.size();
 }
 
 size_t NMEAGPS::rawSentenceQueueSize()
 {
-    _mtx_nmea_sentence.lock();
-    size_t x =_queue_nmea_sentence.size();
-    _mtx_nmea_sentence.unlock();
-    return x;
+    return _queue_nmea_sentence.size();
 }
 
 size_t NMEAGPS::txtMessageQueueSize()
 {
-    _mtx_txt.lock();
-    size_t x =_queue_txt.size();
-    _mtx_txt.unlock();
-    return x;
+    return _queue_txt.size();
 }
 
 std::string gps_fix::__str__()
@@ -510,6 +970,11 @@ std::string gps_fix::__str__()
         << "geoid_ht (m): " << geoid_height_meters << ", "
         << "age (s): " << age_seconds << ", "
         << "dgps sid: " << station_id << ", "
+        << "date: " << (date_utc.empty() ? "UNKNOWN" : date_utc) << ", "
+        << "speed (kn): " << speed_knots << ", "
+        << "course (d): " << course_deg << ", "
+        << "pdop: " << pdop << ", "
+        << "vdop: " << vdop << ", "
         << "chksum match: " << (chksum_match ? "T" : "F");
     return oss.str();
 }
@@ -527,7 +992,7 @@ std::vector<satellite> NMEAGPS::satellites()
 std::string satellite::__str__()
 {
     std::ostringstream oss;
-    oss << "id:" << std::setw(3) << prn << ", "
+    oss << talker << " id:" << std::setw(3) << prn << ", "
         << "elevation (d):" << std::setw(3) << elevation_deg
         << ", " << "azimuth (d):" << std::setw(3) << azimuth_deg
         << ", " << "snr:" << std::setw(3) << snr;
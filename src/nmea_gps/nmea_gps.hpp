@@ -11,11 +11,11 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <iostream>
-#include <map>
 #include <list>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <cstdlib>
 #include <string>
 #include <thread>
@@ -24,6 +24,8 @@
 #include <vector>
 
 #include "nmea_gps.h"
+#include "nmea_ring.hpp"
+#include "nmea_source.hpp"
 #include <interfaces/iGps.hpp>
 
 namespace upm {
@@ -84,6 +86,8 @@ namespace upm {
         int azimuth_deg;
         /** Satellite signal-to-noise ratio */
         int snr;
+        /** Talker ID of the reporting constellation (GP, GL, GA, GB, ...) */
+        std::string talker;
         /** Default constructor */
         satellite():satellite("", 0, 0, 0){}
         /**
@@ -93,9 +97,12 @@ namespace upm {
          * @param azimuth Target azimuth angle in degrees
          * @param snr Target signal to noise ratio (usually in dB,
          * unfortunately non-standard)
+         * @param talker Talker ID of the reporting constellation
          */
-        satellite(const std::string& sprn, int elevation, int azimuth, int snr):
-            prn(sprn), elevation_deg(elevation), azimuth_deg(azimuth), snr(snr) {}
+        satellite(const std::string& sprn, int elevation, int azimuth, int snr,
+                const std::string& talker = "GP"):
+            prn(sprn), elevation_deg(elevation), azimuth_deg(azimuth), snr(snr),
+            talker(talker) {}
         /**
          * Provide a string representation of this structure.
          * @return String representing a satellite
@@ -169,6 +176,16 @@ namespace upm {
         float age_seconds = 0.0;
         /** Differential GPS station ID */
         std::string station_id = std::string("");
+        /** UTC date string as DDMMYY */
+        std::string date_utc = std::string("");
+        /** Speed over ground in knots */
+        float speed_knots = 0.0;
+        /** Course over ground in degrees from true north */
+        float course_deg = 0.0;
+        /** Position dilution of precision, unitless, lower is better */
+        float pdop = 0.0;
+        /** Vertical dilution of precision, unitless, lower is better */
+        float vdop = 0.0;
         /** True if this gps_fix structure is valid to use */
         bool valid = false;
         /** True if the checksum matched, valid is set to false on mismatch */
@@ -213,6 +230,16 @@ namespace upm {
              */
             NMEAGPS(unsigned int bus, uint8_t addr);
 
+            /**
+             * NMEAGPS object constructor for a replay/mock source.  The
+             * parsing thread reads the source as fast as it delivers data.
+             * enable and setBaudrate have no effect.
+             *
+             * @param source Source of raw NMEA data.  The source must
+             * outlive this object.
+             */
+            NMEAGPS(NMEASource& source);
+
             /**
              * NMEAGPS object destructor
              */
@@ -273,7 +300,9 @@ namespace upm {
             size_t getMaxQueueDepth();
 
             /**
-             * Set the current maximum queue depth.
+             * Set the current maximum queue depth.  If a queue holds more
+             * elements, the oldest are dropped.  This may be called while
+             * the parsing thread is running.
              * @param depth New target queue depth
              *      1 <= depth <= 1000
              * @return Actual maximum queue depth
@@ -282,7 +311,7 @@ namespace upm {
 
             /**
              * Start a NMEA parsing thread for reading/parsing NMEA sentences.  The
-             * thread calls the readStr method, parsing NMEA sentences as they are
+             * thread reads from the device, parsing NMEA sentences as they are
              * encountered.  Each sentence type is pushed into a corresponding queue
              * of size
              */
@@ -306,6 +335,14 @@ namespace upm {
              */
             gps_fix getFix();
 
+            /**
+             * Wait for a GPS fix to become available in the GPS fix queue.
+             * This can be used instead of polling fixQueueSize.
+             * @param millis The number of milliseconds to wait for a fix
+             * @return true if a GPS fix is available, false on timeout
+             */
+            bool waitFix(unsigned int millis);
+
             /**
              * Pop and return a raw NMEA sentence from the NMEA sentence queue.
              * If the queue contains no elements, an empty string is returned
@@ -346,6 +383,16 @@ namespace upm {
              */
             void parseNMEASentence(const std::string& sentence);
 
+            /**
+             * Parse a chunk of raw NMEA data as read from the device.
+             * Sentences are framed incrementally ($...*XX\r\n), so a
+             * sentence may span any number of calls.  Each complete sentence
+             * is handled as in parseNMEASentence.  This is the same path
+             * used by the parsing thread.
+             * @param data Raw character data read from the device
+             */
+            void parseNMEAStream(const std::string& data);
+
             /**
              * Return a vector of the current satellites
              * @return Current satellites
@@ -373,9 +420,12 @@ namespace upm {
              */
             std::string __str__();
         protected:
-            /** nmeaGPS device context */
+            /** nmeaGPS device context, NULL when reading from a source */
             nmea_gps_context m_nmea_gps;
 
+            /** Replay/mock source, NULL when reading from a device */
+            NMEASource* _source;
+
         private:
             /** Disable implicit copy and assignment operators */
             NMEAGPS(const NMEAGPS&) = delete;
@@ -387,40 +437,72 @@ namespace upm {
             /** Method runs in a spawned thread for parsing NMEA sentences */
             void _parse_thread();
 
+            /** Read from the device or source, counting bytes read */
+            int _read(char* buffer, size_t size);
+
             /** Helper for thread syncronization */
             std::atomic<bool> _running;
 
-            /** Parse GPGGA sentences, place in GPS fix queue */
-            void _parse_gpgga(const std::string& string);
-            /** Parse GPGSV sentences, place in satellite collection */
-            void _parse_gpgsv(const std::string& string);
-            /** Parse GPGLL sentences, place in satellite collection */
-            void _parse_gpgll(const std::string& string);
-            /** Parse GPTXT sentences, place in text collection */
-            void _parse_gptxt(const std::string& string);
-
-            /** Provide function pointer typedef for handling NMEA chunks */
-            using fp = void (NMEAGPS::*)(const std::string &);
-            /** Map of NMEA type to parser method */
-            const std::map<std::string, fp> nmea_2_parser =
-            {
-                {"GPGGA", &NMEAGPS::_parse_gpgga},
-                {"GPGSV", &NMEAGPS::_parse_gpgsv},
-                {"GPGLL", &NMEAGPS::_parse_gpgll},
-                {"GPTXT", &NMEAGPS::_parse_gptxt},
+            /** View of a framed NMEA sentence, references the caller's buffer */
+            struct nmea_view {
+                /** First character after the '$' */
+                const char* begin;
+                /** The '*' which terminates the sentence body */
+                const char* end;
+                /** True if the transmitted checksum matches the body */
+                bool chksum_match;
             };
 
+            /** Parse GGA sentences, place in GPS fix queue */
+            void _parse_gga(const nmea_view& sentence);
+            /** Parse GSV sentences, place in satellite collection */
+            void _parse_gsv(const nmea_view& sentence);
+            /** Parse GLL sentences, place in GPS fix queue */
+            void _parse_gll(const nmea_view& sentence);
+            /** Parse RMC sentences, place in GPS fix queue */
+            void _parse_rmc(const nmea_view& sentence);
+            /** Parse VTG sentences, update speed and course */
+            void _parse_vtg(const nmea_view& sentence);
+            /** Parse GSA sentences, update dilution of precision */
+            void _parse_gsa(const nmea_view& sentence);
+            /** Parse TXT sentences, place in text collection */
+            void _parse_txt(const nmea_view& sentence);
+
+            /**
+             * Dispatch a single sentence ($ through *XX) to its parser and
+             * place it in the raw sentence queue
+             */
+            void _parse_sentence(const char* sentence, size_t size,
+                    const char* star, bool chksum_match);
+
+            /** Feed raw device data through the sentence framer */
+            void _parse_stream(const char* data, size_t size);
+
+            /**
+             * Most recent date, speed, course and DOP reported by
+             * RMC/VTG/GSA.  These are merged into each fix so that a single
+             * sentence stream gives complete fixes.  Only used by the
+             * parsing thread.
+             */
+            gps_fix _epoch;
+
+            /** Push a GPS fix and wake any thread in waitFix */
+            void _push_fix(gps_fix&& fix);
+
             /** Raw NMEA sentence fix queue */
-            std::queue<std::string> _queue_nmea_sentence;
-            std::mutex _mtx_nmea_sentence;
+            nmea_ring<std::string> _queue_nmea_sentence;
 
             /** GPS fix queue */
-            std::queue<gps_fix> _queue_fix;
-            std::mutex _mtx_fix;
+            nmea_ring<gps_fix> _queue_fix;
 
             /** Message queue */
-            std::queue<nmeatxt> _queue_txt;
-            std::mutex _mtx_txt;
+            nmea_ring<nmeatxt> _queue_txt;
+
+            /** Number of threads blocked in waitFix */
+            std::atomic<int> _fix_waiters;
+            /** Only used to block in waitFix, not for queue access */
+            std::mutex _mtx_fix_wait;
+            std::condition_variable _cv_fix;
 
             /** Specify a queue size for parsed objects */
             std::atomic<size_t> _maxQueueDepth;
@@ -437,5 +519,35 @@ namespace upm {
             /** Set of current satellites */
             std::list<satellite> _satlist;
             std::mutex _mtx_satlist;
+
+            /** NMEA 0183 sentence framer states */
+            enum class framer_state {
+                /** Waiting for a '$' */
+                seek,
+                /** Accumulating the sentence body */
+                body,
+                /** Waiting for the checksum high nibble */
+                chksum_hi,
+                /** Waiting for the checksum low nibble */
+                chksum_lo,
+                /** Waiting for the terminating CR */
+                cr,
+                /** Waiting for the terminating LF */
+                lf
+            };
+
+            /** Maximum sentence length handled by the framer, $ through *XX */
+            static const size_t _max_sentence = 100;
+
+            /** Current framer state, persists across reads */
+            framer_state _frm_state;
+            /** Sentence currently being framed */
+            char _frm_buf[_max_sentence];
+            /** Number of characters in the framing buffer */
+            size_t _frm_len;
+            /** Running checksum of the sentence body */
+            uint8_t _frm_chksum;
+            /** Checksum transmitted with the sentence */
+            uint8_t _frm_rx_chksum;
     };
 }
@@ -24,5 +24,6 @@ JAVA_JNI_LOADLIBRARY(javaupm_nmea_gps)
 #include "nmea_gps.hpp"
 %}
 %template(satellitevec) std::vector<upm::satellite>;
+%include "nmea_source.hpp"
 %include "nmea_gps.hpp"
 /* END Common SWIG syntax */
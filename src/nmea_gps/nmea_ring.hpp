@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace upm {
+    /**
+     * Fixed capacity ring used to pass parsed NMEA data from the parsing
+     * thread to a consumer without locking.
+     *
+     * There is a single producer.  When the ring holds depth() elements
+     * the producer discards the oldest one before pushing, which matches
+     * the behavior of the std::queue this replaces.  The slots are
+     * allocated once for the largest depth, so the depth can be changed
+     * at any time without moving the elements.  Since the producer
+     * may dequeue as well as the consumer, each slot carries a sequence
+     * number (as in D. Vyukov's bounded queue) so that a slot is never
+     * rewritten while a consumer is still moving a value out of it.
+     */
+    template <typename T>
+    class nmea_ring {
+        public:
+            /**
+             * Create a ring which holds up to depth elements
+             * @param capacity Largest depth the ring can be set to, must
+             * be > 0
+             * @param depth Initial depth, 1 <= depth <= capacity
+             */
+            nmea_ring(size_t capacity, size_t depth) :
+                _depth(depth), _head(0), _tail(0)
+            {
+                /* Slots are a power of 2 so positions wrap with a mask */
+                _capacity = 1;
+                while (_capacity < capacity) _capacity <<= 1;
+                _mask = _capacity - 1;
+                _slots.reset(new slot[_capacity]);
+                for (size_t i = 0; i < _capacity; i++)
+                    _slots[i].seq.store(i, std::memory_order_relaxed);
+            }
+
+            /**
+             * Maximum number of elements held before the oldest is dropped
+             * @return Ring depth
+             */
+            size_t depth() const { return _depth; }
+
+            /**
+             * Set the maximum number of elements.  If the ring holds more,
+             * the oldest are dropped.
+             * @param depth New depth, 1 <= depth <= the capacity given to
+             * the constructor
+             */
+            void set_depth(size_t depth)
+            {
+                _depth = depth;
+                T discard;
+                while (size() > depth && pop(discard))
+                    ;
+            }
+
+            /**
+             * Number of elements currently in the ring
+             * @return Number of elements
+             */
+            size_t size() const
+            {
+                /* Load _head first, so a stale _tail can't count elements
+                 * that were already taken.  A consumer may take a slot
+                 * after it is published but before the producer advances
+                 * _head, so _tail can be ahead of it. */
+                size_t head = _head.load();
+                size_t tail = _tail.load();
+                return (head > tail) ? head - tail : 0;
+            }
+
+            /**
+             * Is the ring empty?
+             * @return True if empty
+             */
+            bool empty() const { return size() == 0; }
+
+            /**
+             * Push an element, dropping the oldest if the ring is full.
+             * Only one thread may push.
+             * @param value Element to push
+             */
+            void push(T&& value)
+            {
+                T discard;
+                while (size() >= _depth && pop(discard))
+                    ;
+
+                size_t pos = _head.load(std::memory_order_relaxed);
+                slot& s = _slots[pos & _mask];
+
+                /* Wait for a consumer to finish with a slot it claimed */
+                while (s.seq.load(std::memory_order_acquire) != pos)
+                    std::this_thread::yield();
+
+                s.value = std::move(value);
+                s.seq.store(pos + 1, std::memory_order_release);
+                _head.store(pos + 1);
+            }
+
+            /**
+             * Pop the oldest element
+             * @param value Receives the element
+             * @return False if the ring was empty
+             */
+            bool pop(T& value)
+            {
+                size_t pos = _tail.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    slot& s = _slots[pos & _mask];
+                    size_t seq = s.seq.load(std::memory_order_acquire);
+                    if (seq != pos + 1)
+                    {
+                        /* Nothing published at this position */
+                        if (seq <= pos) return false;
+                        /* Another thread took it, try the next */
+                        pos = _tail.load(std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    if (_tail.compare_exchange_weak(pos, pos + 1))
+                    {
+                        value = std::move(s.value);
+                        s.seq.store(pos + _capacity, std::memory_order_release);
+                        return true;
+                    }
+                }
+            }
+
+        private:
+            /** Disable implicit copy and assignment operators */
+            nmea_ring(const nmea_ring&) = delete;
+            nmea_ring &operator=(const nmea_ring&) = delete;
+
+            struct slot {
+                std::atomic<size_t> seq;
+                T value;
+            };
+
+            std::unique_ptr<slot[]> _slots;
+            std::atomic<size_t> _depth;
+            size_t _capacity;
+            size_t _mask;
+
+            /** Next position to write */
+            std::atomic<size_t> _head;
+            /** Next position to read */
+            std::atomic<size_t> _tail;
+    };
+}
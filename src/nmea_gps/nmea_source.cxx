@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "nmea_source.hpp"
+
+using namespace upm;
+using namespace std;
+
+/* Once a source is exhausted, only wait briefly so a parsing thread
+ * polling it can be stopped promptly */
+static void idle(unsigned int millis)
+{
+    std::this_thread::sleep_for(
+            std::chrono::milliseconds(std::min(millis, 10u)));
+}
+
+NMEAMemorySource::NMEAMemorySource(const std::string& data, size_t repeat) :
+    _data(data), _repeat(repeat), _pos(0), _eof(data.empty() || !repeat)
+{
+}
+
+int NMEAMemorySource::read(char* buffer, size_t size)
+{
+    if (_eof) return 0;
+
+    size_t count = std::min(size, _data.size() - _pos);
+    std::memcpy(buffer, _data.data() + _pos, count);
+    _pos += count;
+
+    /* Wrap around for the next pass */
+    if (_pos == _data.size())
+    {
+        _pos = 0;
+        if (--_repeat == 0) _eof = true;
+    }
+
+    return count;
+}
+
+bool NMEAMemorySource::dataAvailable(unsigned int millis)
+{
+    if (!_eof) return true;
+
+    idle(millis);
+    return false;
+}
+
+NMEAPipeSource::NMEAPipeSource(int fd, bool close_fd) :
+    _fd(fd), _close_fd(close_fd), _eof(false)
+{
+    if (_fd < 0)
+        throw std::invalid_argument(string(__FUNCTION__)
+                                    + ": invalid file descriptor");
+}
+
+NMEAPipeSource::~NMEAPipeSource()
+{
+    if (_close_fd)
+        close(_fd);
+}
+
+int NMEAPipeSource::read(char* buffer, size_t size)
+{
+    ssize_t rv;
+    do
+    {
+        rv = ::read(_fd, buffer, size);
+    } while ((rv < 0) && (errno == EINTR));
+
+    if (rv == 0) _eof = true;
+    return rv;
+}
+
+bool NMEAPipeSource::dataAvailable(unsigned int millis)
+{
+    if (_eof)
+    {
+        idle(millis);
+        return false;
+    }
+
+    /* A hangup is reported as available so that the next read sees the
+     * end of file */
+    struct pollfd pfd = {_fd, POLLIN, 0};
+    return poll(&pfd, 1, millis) > 0;
+}
+
+int NMEAPipeSource::write(const char* buffer, size_t size)
+{
+    return ::write(_fd, buffer, size);
+}
+
+static int open_capture(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error(string(__FUNCTION__) + ": open() failed: "
+                                 + path + ": " + strerror(errno));
+    return fd;
+}
+
+NMEAFileSource::NMEAFileSource(const std::string& path, size_t repeat) :
+    NMEAPipeSource(open_capture(path), true), _repeat(repeat)
+{
+    if (!_repeat) _eof = true;
+}
+
+int NMEAFileSource::read(char* buffer, size_t size)
+{
+    int rv = NMEAPipeSource::read(buffer, size);
+
+    /* Rewind for the next pass */
+    if ((rv == 0) && (_repeat > 1))
+    {
+        _repeat--;
+        if (lseek(_fd, 0, SEEK_SET) < 0) return -1;
+        _eof = false;
+        rv = NMEAPipeSource::read(buffer, size);
+    }
+
+    return rv;
+}
+
+bool NMEAFileSource::dataAvailable(unsigned int millis)
+{
+    /* Regular files are always readable until the end */
+    if (!_eof) return true;
+
+    idle(millis);
+    return false;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace upm {
+    /**
+     * @brief Source of raw NMEA data for NMEAGPS
+     *
+     * By default NMEAGPS reads from a UART or I2C device.  A source lets
+     * the NMEA data come from somewhere else, for instance a recorded
+     * capture, so that the parsing thread, throughput counters and queues
+     * can be exercised without hardware.
+     */
+    class NMEASource {
+        public:
+            virtual ~NMEASource() {}
+
+            /**
+             * Read raw NMEA data.
+             *
+             * @param buffer Buffer to read into
+             * @param size The maximum number of bytes to read
+             * @return The number of bytes read, 0 when no data is available,
+             * -1 on error
+             */
+            virtual int read(char* buffer, size_t size) = 0;
+
+            /**
+             * Determine whether there is data available to be read, waiting
+             * up to "millis" milliseconds for it.
+             *
+             * @param millis The number of milliseconds to wait for data
+             * @return true if data is available to be read, false otherwise
+             */
+            virtual bool dataAvailable(unsigned int millis) = 0;
+
+            /**
+             * Write data to the source.  Sources which can't be written
+             * discard the data.
+             *
+             * @param buffer Data to write
+             * @param size Number of bytes to write
+             * @return The number of bytes written, -1 on error
+             */
+            virtual int write(const char* buffer, size_t size)
+            { (void)buffer; return size; }
+
+            /**
+             * Has all of the data been read?  A live device never ends.
+             *
+             * @return true once no more data will become available
+             */
+            virtual bool eof() { return false; }
+    };
+
+    /**
+     * @brief NMEA source replaying a buffer held in memory
+     */
+    class NMEAMemorySource : public NMEASource {
+        public:
+            /**
+             * NMEAMemorySource constructor
+             *
+             * @param data Raw NMEA data to replay
+             * @param repeat Number of times to replay the data
+             */
+            NMEAMemorySource(const std::string& data, size_t repeat = 1);
+
+            int read(char* buffer, size_t size);
+            bool dataAvailable(unsigned int millis);
+            bool eof() { return _eof; }
+
+        private:
+            std::string _data;
+            size_t _repeat;
+            size_t _pos;
+            std::atomic<bool> _eof;
+    };
+
+    /**
+     * @brief NMEA source reading from a file descriptor
+     *
+     * Suitable for pipes, FIFOs, pseudo terminals and sockets.  The end
+     * is reached when the writer closes its end.
+     */
+    class NMEAPipeSource : public NMEASource {
+        public:
+            /**
+             * NMEAPipeSource constructor
+             *
+             * @param fd File descriptor to read from
+             * @param close_fd Close the file descriptor on destruction
+             */
+            NMEAPipeSource(int fd, bool close_fd = false);
+
+            /**
+             * NMEAPipeSource destructor
+             */
+            ~NMEAPipeSource();
+
+            int read(char* buffer, size_t size);
+            bool dataAvailable(unsigned int millis);
+            int write(const char* buffer, size_t size);
+            bool eof() { return _eof; }
+
+        protected:
+            /** File descriptor to read from */
+            int _fd;
+            /** Close the file descriptor on destruction */
+            bool _close_fd;
+            /** Set once a read returns end of file */
+            std::atomic<bool> _eof;
+
+        private:
+            /** Disable implicit copy and assignment operators */
+            NMEAPipeSource(const NMEAPipeSource&) = delete;
+            NMEAPipeSource &operator=(const NMEAPipeSource&) = delete;
+    };
+
+    /**
+     * @brief NMEA source replaying a recorded capture file
+     */
+    class NMEAFileSource : public NMEAPipeSource {
+        public:
+            /**
+             * NMEAFileSource constructor
+             *
+             * @param path Path to the capture file
+             * @param repeat Number of times to replay the file
+             */
+            NMEAFileSource(const std::string& path, size_t repeat = 1);
+
+            int read(char* buffer, size_t size);
+            bool dataAvailable(unsigned int millis);
+
+        private:
+            size_t _repeat;
+    };
+}
@@ -35,18 +35,23 @@ OZW::OZW()
   m_driverFailed = false;
   m_homeId = 0;
 
-  pthread_mutexattr_t mutexAttrib;
-  pthread_mutexattr_init(&mutexAttrib);
-  pthread_mutexattr_settype(&mutexAttrib, PTHREAD_MUTEX_RECURSIVE);
-
-  if (pthread_mutex_init(&m_nodeLock, &mutexAttrib))
+  pthread_rwlockattr_t rwlockAttrib;
+  pthread_rwlockattr_init(&rwlockAttrib);
+#if defined(__GLIBC__)
+  // don't let a steady stream of readers starve the notification
+  // handler
+  pthread_rwlockattr_setkind_np(&rwlockAttrib,
+                                PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+
+  if (pthread_rwlock_init(&m_nodeLock, &rwlockAttrib))
     {
-      pthread_mutexattr_destroy(&mutexAttrib);
+      pthread_rwlockattr_destroy(&rwlockAttrib);
       throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": pthread_mutex_init(nodeLock) failed");
+                               ": pthread_rwlock_init(nodeLock) failed");
     }
 
-  pthread_mutexattr_destroy(&mutexAttrib);
+  pthread_rwlockattr_destroy(&rwlockAttrib);
 
   if (pthread_mutex_init(&m_initLock, NULL))
     {
@@ -83,7 +88,7 @@ OZW::~OZW()
       Options::Destroy();
     }
 
-  pthread_mutex_destroy(&m_nodeLock);
+  pthread_rwlock_destroy(&m_nodeLock);
   pthread_mutex_destroy(&m_initLock);
   pthread_cond_destroy(&m_initCond);
 
@@ -195,6 +200,7 @@ bool OZW::init(string devicePath, bool isHID)
     {
       (*it).second->updateVIDMap();
       (*it).second->setAutoUpdate(true);
+      cacheNodeValues((*it).second);
     }
   unlockNodes();
 
@@ -241,6 +247,7 @@ void OZW::notificationHandler(Notification const* notification, void *ctx)
             delete This->m_zwNodeMap[nodeId];
             This->m_zwNodeMap.erase(nodeId);
           }
+        This->uncacheNodeValues(nodeId);
 
         break;
       }
@@ -250,6 +257,8 @@ void OZW::notificationHandler(Notification const* notification, void *ctx)
         if (This->m_debugging)
           cerr << "### ### VALUE ADDED " << endl;
         This->m_zwNodeMap[nodeId]->addValueID(notification->GetValueID());
+        // the indexes may have changed
+        This->cacheNodeValues(This->m_zwNodeMap[nodeId]);
 
         break;
       }
@@ -259,13 +268,17 @@ void OZW::notificationHandler(Notification const* notification, void *ctx)
         if (This->m_debugging)
           cerr << "### ### VALUE DELETED " << endl;
         This->m_zwNodeMap[nodeId]->removeValueID(notification->GetValueID());
+        This->cacheNodeValues(This->m_zwNodeMap[nodeId]);
 
         break;
       }
 
     case Notification::Type_ValueChanged:
+    case Notification::Type_ValueRefreshed:
       {
-        // might be able to do something with this someday...
+        if (This->m_zwNodeMap.count(nodeId) != 0)
+          This->cacheValue(This->m_zwNodeMap[nodeId],
+                           notification->GetValueID());
         break;
       }
 
@@ -283,6 +296,9 @@ void OZW::notificationHandler(Notification const* notification, void *ctx)
         // empty the map
         This->m_zwNodeMap.clear();
 
+        for (int i = 0; i < 256; i++)
+          This->uncacheNodeValues(i);
+
         break;
       }
 
@@ -337,7 +353,7 @@ void OZW::dumpNodes(bool all)
 {
   // iterate through all the nodes and dump various info on them
 
-  lockNodes();
+  lockNodesShared();
 
   for (auto it = m_zwNodeMap.cbegin();
        it != m_zwNodeMap.cend(); ++it)
@@ -398,7 +414,7 @@ bool OZW::getValueID(int nodeId, int index, ValueID *vid)
   // everything except the first byte.
   nodeId &= 0xff;
 
-  lockNodes();
+  lockNodesShared();
 
   zwNodeMap_t::iterator it;
 
@@ -426,35 +442,136 @@ bool OZW::getValueID(int nodeId, int index, ValueID *vid)
   return true;
 }
 
+void OZW::readValue(ValueID vid, cachedValue_t *value)
+{
+  value->type = vid.GetType();
+  value->readOnly = Manager::Get()->IsValueReadOnly(vid);
+  value->writeOnly = Manager::Get()->IsValueWriteOnly(vid);
+  value->isSet = Manager::Get()->IsValueSet(vid);
+
+  value->boolVal = false;
+  value->byteVal = 0;
+  value->floatVal = 0.0;
+  value->int32Val = 0;
+  value->int16Val = 0;
+
+  switch (value->type)
+    {
+    case ValueID::ValueType_Bool:
+      Manager::Get()->GetValueAsBool(vid, &value->boolVal);
+      break;
+
+    case ValueID::ValueType_Byte:
+      Manager::Get()->GetValueAsByte(vid, &value->byteVal);
+      break;
+
+    case ValueID::ValueType_Decimal:
+      Manager::Get()->GetValueAsFloat(vid, &value->floatVal);
+      break;
+
+    case ValueID::ValueType_Int:
+      Manager::Get()->GetValueAsInt(vid, &value->int32Val);
+      break;
+
+    case ValueID::ValueType_Short:
+      Manager::Get()->GetValueAsShort(vid, &value->int16Val);
+      break;
+
+    default:
+      break;
+    }
+
+  value->stringVal.clear();
+  Manager::Get()->GetValueAsString(vid, &value->stringVal);
+  value->units = Manager::Get()->GetValueUnits(vid);
+}
+
+void OZW::cacheNodeValues(zwNode *node)
+{
+  std::shared_ptr<nodeValues_t> values = std::make_shared<nodeValues_t>();
+  ValueID vid(m_homeId, (uint64)0);
+
+  values->resize(node->valueCount());
+  for (int i = 0; i < node->valueCount(); i++)
+    {
+      if (node->indexToValueID(i, &vid))
+        readValue(vid, &(*values)[i]);
+    }
+
+  std::atomic_store(&m_valueCache[node->nodeId()],
+                    std::shared_ptr<const nodeValues_t>(values));
+}
+
+void OZW::cacheValue(zwNode *node, ValueID vid)
+{
+  std::shared_ptr<const nodeValues_t> old =
+    std::atomic_load(&m_valueCache[node->nodeId()]);
+  int index;
+
+  if (!old || !node->valueIDToIndex(vid, &index)
+      || index >= int(old->size()))
+    return;
+
+  // readers may still be using the old snapshot, so update a copy
+  std::shared_ptr<nodeValues_t> values = std::make_shared<nodeValues_t>(*old);
+
+  readValue(vid, &(*values)[index]);
+
+  std::atomic_store(&m_valueCache[node->nodeId()],
+                    std::shared_ptr<const nodeValues_t>(values));
+}
+
+void OZW::uncacheNodeValues(uint8_t nodeId)
+{
+  std::atomic_store(&m_valueCache[nodeId],
+                    std::shared_ptr<const nodeValues_t>());
+}
+
+const OZW::cachedValue_t *
+OZW::getCachedValue(int nodeId, int index,
+                    std::shared_ptr<const nodeValues_t>& values)
+{
+  values = std::atomic_load(&m_valueCache[nodeId & 0xff]);
+
+  if (!values || index < 0 || index >= int(values->size()))
+    return 0;
+
+  return &(*values)[index];
+}
+
 string OZW::getValueAsString(int nodeId, int index)
 {
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
+
+  if (value)
+    return value->stringVal;
+
   // we have to play this game since there is no default ctor for ValueID
   ValueID vid(m_homeId, (uint64)0);
 
   string rv;
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     Manager::Get()->GetValueAsString(vid, &rv);
 
-  unlockNodes();
-
   return rv;
 }
 
 string OZW::getValueUnits(int nodeId, int index)
 {
-  ValueID vid(m_homeId, (uint64)0);
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
 
-  lockNodes();
+  if (value)
+    return value->units;
+
+  ValueID vid(m_homeId, (uint64)0);
 
   string rv;
   if (getValueID(nodeId, index, &vid))
     rv = Manager::Get()->GetValueUnits(vid);
 
-  unlockNodes();
-
   return rv;
 }
 
@@ -462,26 +579,26 @@ void OZW::setValueUnits(int nodeId, int index, string text)
 {
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
-    Manager::Get()->SetValueUnits(vid, text);
+    {
+      Manager::Get()->SetValueUnits(vid, text);
 
-  unlockNodes();
+      // there is no notification for this, so update the cache here
+      lockNodes();
+      if (m_zwNodeMap.count(nodeId & 0xff) != 0)
+        cacheValue(m_zwNodeMap[nodeId & 0xff], vid);
+      unlockNodes();
+    }
 }
 
 string OZW::getValueLabel(int nodeId, int index)
 {
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   string rv;
   if (getValueID(nodeId, index, &vid))
     rv = Manager::Get()->GetValueLabel(vid);
 
-  unlockNodes();
-
   return rv;
 }
 
@@ -489,26 +606,18 @@ void OZW::setValueLabel(int nodeId, int index, string text)
 {
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     Manager::Get()->SetValueLabel(vid, text);
-
-  unlockNodes();
 }
 
 string OZW::getValueHelp(int nodeId, int index)
 {
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   string rv;
   if (getValueID(nodeId, index, &vid))
     rv = Manager::Get()->GetValueHelp(vid);
 
-  unlockNodes();
-
   return rv;
 }
 
@@ -516,12 +625,8 @@ void OZW::setValueHelp(int nodeId, int index, string text)
 {
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     Manager::Get()->SetValueHelp(vid, text);
-
-  unlockNodes();
 }
 
 void OZW::setValueAsBool(int nodeId, int index, bool val)
@@ -535,8 +640,6 @@ void OZW::setValueAsBool(int nodeId, int index, bool val)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     {
       if (!Manager::Get()->SetValue(vid, val))
@@ -544,8 +647,6 @@ void OZW::setValueAsBool(int nodeId, int index, bool val)
           cerr << __FUNCTION__ << ": Value is not a bool type" << endl;
         }
     }
-
-  unlockNodes();
 }
 
 void OZW::setValueAsByte(int nodeId, int index, uint8_t val)
@@ -559,8 +660,6 @@ void OZW::setValueAsByte(int nodeId, int index, uint8_t val)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     {
       if (!Manager::Get()->SetValue(vid, val))
@@ -568,8 +667,6 @@ void OZW::setValueAsByte(int nodeId, int index, uint8_t val)
           cerr << __FUNCTION__ << ": Value is not a byte type" << endl;
         }
     }
-
-  unlockNodes();
 }
 
 void OZW::setValueAsFloat(int nodeId, int index, float val)
@@ -583,8 +680,6 @@ void OZW::setValueAsFloat(int nodeId, int index, float val)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     {
       if (!Manager::Get()->SetValue(vid, val))
@@ -592,8 +687,6 @@ void OZW::setValueAsFloat(int nodeId, int index, float val)
           cerr << __FUNCTION__ << ": Value is not a float type" << endl;
         }
     }
-
-  unlockNodes();
 }
 
 void OZW::setValueAsInt32(int nodeId, int index, int32_t val)
@@ -607,8 +700,6 @@ void OZW::setValueAsInt32(int nodeId, int index, int32_t val)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     {
       if (!Manager::Get()->SetValue(vid, val))
@@ -616,8 +707,6 @@ void OZW::setValueAsInt32(int nodeId, int index, int32_t val)
           cerr << __FUNCTION__ << ": Value is not a int32 type" << endl;
         }
     }
-
-  unlockNodes();
 }
 
 void OZW::setValueAsInt16(int nodeId, int index, int16_t val)
@@ -631,8 +720,6 @@ void OZW::setValueAsInt16(int nodeId, int index, int16_t val)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     {
       if (!Manager::Get()->SetValue(vid, val))
@@ -640,8 +727,6 @@ void OZW::setValueAsInt16(int nodeId, int index, int16_t val)
           cerr << __FUNCTION__ << ": Value is not a int16 type" << endl;
         }
     }
-
-  unlockNodes();
 }
 
 void OZW::setValueAsBytes(int nodeId, int index, uint8_t *val, uint8_t len)
@@ -655,8 +740,6 @@ void OZW::setValueAsBytes(int nodeId, int index, uint8_t *val, uint8_t len)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     {
       if (!Manager::Get()->SetValue(vid, val, len))
@@ -664,8 +747,6 @@ void OZW::setValueAsBytes(int nodeId, int index, uint8_t *val, uint8_t len)
           cerr << __FUNCTION__ << ": Value is not a bytes type" << endl;
         }
     }
-
-  unlockNodes();
 }
 
 void OZW::setValueAsString(int nodeId, int index, string val)
@@ -679,8 +760,6 @@ void OZW::setValueAsString(int nodeId, int index, string val)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     {
       if (!Manager::Get()->SetValue(vid, val))
@@ -689,33 +768,24 @@ void OZW::setValueAsString(int nodeId, int index, string val)
           cerr << __FUNCTION__ << ": Value is not a string type" << endl;
         }
     }
-
-  unlockNodes();
 }
 
 void OZW::refreshValue(int nodeId, int index)
 {
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   if (getValueID(nodeId, index, &vid))
     Manager::Get()->RefreshValue(vid);
-
-  unlockNodes();
 }
 
 int OZW::getValueMin(int nodeId, int index)
 {
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   int rv = 0;
   if (getValueID(nodeId, index, &vid))
     rv = Manager::Get()->GetValueMin(vid);
 
-  unlockNodes();
   return rv;
 }
 
@@ -723,55 +793,61 @@ int OZW::getValueMax(int nodeId, int index)
 {
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   int rv = 0;
   if (getValueID(nodeId, index, &vid))
     rv = Manager::Get()->GetValueMax(vid);
 
-  unlockNodes();
   return rv;
 }
 
 bool OZW::isValueReadOnly(int nodeId, int index)
 {
-  ValueID vid(m_homeId, (uint64)0);
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
 
-  lockNodes();
+  if (value)
+    return value->readOnly;
+
+  ValueID vid(m_homeId, (uint64)0);
 
   bool rv = false;
   if (getValueID(nodeId, index, &vid))
     rv = Manager::Get()->IsValueReadOnly(vid);
 
-  unlockNodes();
   return rv;
 }
 
 bool OZW::isValueWriteOnly(int nodeId, int index)
 {
-  ValueID vid(m_homeId, (uint64)0);
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
 
-  lockNodes();
+  if (value)
+    return value->writeOnly;
+
+  ValueID vid(m_homeId, (uint64)0);
 
   bool rv = false;
   if (getValueID(nodeId, index, &vid))
     rv = Manager::Get()->IsValueWriteOnly(vid);
 
-  unlockNodes();
   return rv;
 }
 
 bool OZW::isValueSet(int nodeId, int index)
 {
-  ValueID vid(m_homeId, (uint64)0);
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
 
-  lockNodes();
+  if (value)
+    return value->isSet;
+
+  ValueID vid(m_homeId, (uint64)0);
 
   bool rv = false;
   if (getValueID(nodeId, index, &vid))
     rv = Manager::Get()->IsValueSet(vid);
 
-  unlockNodes();
   return rv;
 }
 
@@ -779,18 +855,22 @@ bool OZW::isValuePolled(int nodeId, int index)
 {
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   bool rv = false;
   if (getValueID(nodeId, index, &vid))
     rv = Manager::Get()->IsValuePolled(vid);
 
-  unlockNodes();
   return rv;
 }
 
 bool OZW::getValueAsBool(int nodeId, int index)
 {
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
+
+  // anything else is handled (and reported) by OpenZWave
+  if (value && value->type == ValueID::ValueType_Bool && !value->writeOnly)
+    return value->boolVal;
+
   if (isValueWriteOnly(nodeId, index))
     {
       cerr << __FUNCTION__ << ": Node " << nodeId << " index " << index
@@ -800,8 +880,6 @@ bool OZW::getValueAsBool(int nodeId, int index)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   bool rv = false;
   if (getValueID(nodeId, index, &vid))
     {
@@ -812,12 +890,17 @@ bool OZW::getValueAsBool(int nodeId, int index)
         }
     }
 
-  unlockNodes();
   return rv;
 }
 
 uint8_t OZW::getValueAsByte(int nodeId, int index)
 {
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
+
+  if (value && value->type == ValueID::ValueType_Byte && !value->writeOnly)
+    return value->byteVal;
+
   if (isValueWriteOnly(nodeId, index))
     {
       cerr << __FUNCTION__ << ": Node " << nodeId << " index " << index
@@ -827,8 +910,6 @@ uint8_t OZW::getValueAsByte(int nodeId, int index)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   uint8_t rv = false;
   if (getValueID(nodeId, index, &vid))
     {
@@ -839,12 +920,17 @@ uint8_t OZW::getValueAsByte(int nodeId, int index)
         }
     }
 
-  unlockNodes();
   return rv;
 }
 
 float OZW::getValueAsFloat(int nodeId, int index)
 {
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
+
+  if (value && value->type == ValueID::ValueType_Decimal && !value->writeOnly)
+    return value->floatVal;
+
   if (isValueWriteOnly(nodeId, index))
     {
       cerr << __FUNCTION__ << ": Node " << nodeId << " index " << index
@@ -854,8 +940,6 @@ float OZW::getValueAsFloat(int nodeId, int index)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   float rv = 0.0;
   if (getValueID(nodeId, index, &vid))
     {
@@ -866,12 +950,17 @@ float OZW::getValueAsFloat(int nodeId, int index)
         }
     }
 
-  unlockNodes();
   return rv;
 }
 
 int OZW::getValueAsInt32(int nodeId, int index)
 {
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
+
+  if (value && value->type == ValueID::ValueType_Int && !value->writeOnly)
+    return int(value->int32Val);
+
   if (isValueWriteOnly(nodeId, index))
     {
       cerr << __FUNCTION__ << ": Node " << nodeId << " index " << index
@@ -881,8 +970,6 @@ int OZW::getValueAsInt32(int nodeId, int index)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   int32_t rv = 0;
   if (getValueID(nodeId, index, &vid))
     {
@@ -893,12 +980,17 @@ int OZW::getValueAsInt32(int nodeId, int index)
         }
     }
 
-  unlockNodes();
   return int(rv);
 }
 
 int OZW::getValueAsInt16(int nodeId, int index)
 {
+  std::shared_ptr<const nodeValues_t> values;
+  const cachedValue_t *value = getCachedValue(nodeId, index, values);
+
+  if (value && value->type == ValueID::ValueType_Short && !value->writeOnly)
+    return int(value->int16Val);
+
   if (isValueWriteOnly(nodeId, index))
     {
       cerr << __FUNCTION__ << ": Node " << nodeId << " index " << index
@@ -908,8 +1000,6 @@ int OZW::getValueAsInt16(int nodeId, int index)
 
   ValueID vid(m_homeId, (uint64)0);
 
-  lockNodes();
-
   int16_t rv = 0;
   if (getValueID(nodeId, index, &vid))
     {
@@ -920,7 +1010,6 @@ int OZW::getValueAsInt16(int nodeId, int index)
         }
     }
 
-  unlockNodes();
   return int(rv);
 }
 
@@ -928,11 +1017,8 @@ bool OZW::isNodeListeningDevice(int nodeId)
 {
   nodeId &= 0xff;
 
-  lockNodes();
-
   bool rv = Manager::Get()->IsNodeListeningDevice(m_homeId, nodeId);
 
-  unlockNodes();
   return rv;
 }
 
@@ -940,11 +1026,8 @@ bool OZW::isNodeFrequentListeningDevice(int nodeId)
 {
   nodeId &= 0xff;
 
-  lockNodes();
-
   bool rv = Manager::Get()->IsNodeFrequentListeningDevice(m_homeId, nodeId);
 
-  unlockNodes();
   return rv;
 }
 
@@ -952,11 +1035,8 @@ bool OZW::isNodeAwake(int nodeId)
 {
   nodeId &= 0xff;
 
-  lockNodes();
-
   bool rv = Manager::Get()->IsNodeAwake(m_homeId, nodeId);
 
-  unlockNodes();
   return rv;
 }
 
@@ -964,11 +1044,8 @@ bool OZW::isNodeInfoReceived(int nodeId)
 {
   nodeId &= 0xff;
 
-  lockNodes();
-
   bool rv = Manager::Get()->IsNodeInfoReceived(m_homeId, nodeId);
 
-  unlockNodes();
   return rv;
 }
 
@@ -12,6 +12,9 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <vector>
+#include <pthread.h>
 
 #include "Manager.h"
 #include "Notification.h"
@@ -69,6 +72,13 @@ namespace upm {
    * ozwInterface class.  It is that class that drivers use for access
    * to ozw, and therefore the Z-Wave network.
    *
+   * The current contents of every value are cached, and the cache is
+   * kept up to date by OpenZWave's value notifications.  The
+   * getValueAs*() methods, getValueUnits() and the isValue*() checks
+   * are answered from this cache without locking, falling back to
+   * OpenZWave when a value isn't cached or is read as a different type
+   * than it has.
+   *
    * This class is not intended to be used directly by end users.
    * When writing an OZW driver, the ozwInterface class should be used
    * (inherited) by your driver, and your driver should wrap and
@@ -550,16 +560,24 @@ namespace upm {
     }
 
     /**
-     * Lock the m_zwNodeMap mutex to protect against changes made to
-     * the the the map by the OpenZWave notification handler.  Always
-     * lock this mutex when acessing anything in the zwNodeMap map.
+     * Lock the m_zwNodeMap lock for writing, to change the map or the
+     * nodes in it.  This is done by the OpenZWave notification
+     * handler.  The lock is not recursive.
+     */
+    void lockNodes() { pthread_rwlock_wrlock(&m_nodeLock); };
+
+    /**
+     * Lock the m_zwNodeMap lock for reading.  Always lock this (or
+     * lockNodes()) when accessing anything in the zwNodeMap map.  Do
+     * not hold it while calling into the OpenZWave Manager.
      */
-    void lockNodes() { pthread_mutex_lock(&m_nodeLock); };
+    void lockNodesShared() { pthread_rwlock_rdlock(&m_nodeLock); };
 
     /**
-     * Unlock the m_zwNodeMap mutex after lockNodes() has been called.
+     * Unlock the m_zwNodeMap lock after lockNodes() or
+     * lockNodesShared() has been called.
      */
-    void unlockNodes() { pthread_mutex_unlock(&m_nodeLock); };
+    void unlockNodes() { pthread_rwlock_unlock(&m_nodeLock); };
 
   private:
     // prevent copying and assignment
@@ -588,7 +606,46 @@ namespace upm {
     zwNodeMap_t m_zwNodeMap;
 
     // for coordinating access to the node list
-    pthread_mutex_t m_nodeLock;
+    pthread_rwlock_t m_nodeLock;
+
+    // a cached value, as of the last notification for it
+    typedef struct {
+      OpenZWave::ValueID::ValueType type;
+      bool readOnly;
+      bool writeOnly;
+      bool isSet;
+
+      bool boolVal;
+      uint8_t byteVal;
+      float floatVal;
+      int32_t int32Val;
+      int16_t int16Val;
+      std::string stringVal;
+      std::string units;
+    } cachedValue_t;
+
+    // the cached values of a node, by value index.  A snapshot is
+    // never modified once published; updates replace it.
+    typedef std::vector<cachedValue_t> nodeValues_t;
+
+    // one snapshot per possible nodeId, accessed with std::atomic_load()
+    // and std::atomic_store()
+    std::shared_ptr<const nodeValues_t> m_valueCache[256];
+
+    // read a value from OpenZWave into a cache entry
+    static void readValue(OpenZWave::ValueID vid, cachedValue_t *value);
+
+    // rebuild the cache for a node, or update a single value.  These
+    // are called with the node lock held for writing.
+    void cacheNodeValues(zwNode *node);
+    void cacheValue(zwNode *node, OpenZWave::ValueID vid);
+    void uncacheNodeValues(uint8_t nodeId);
+
+    // return the cached value, or NULL if not cached.  values keeps the
+    // snapshot alive while the value is used.
+    const cachedValue_t *getCachedValue(int nodeId, int index,
+                                        std::shared_ptr<const nodeValues_t>&
+                                        values);
 
     // We use these to determine init failure or success (if OpenZWave
     // has successfully queried essential data about the network).
@@ -94,6 +94,21 @@ bool zwNode::indexToValueID(int index, ValueID *vid)
   return true;
 }
 
+bool zwNode::valueIDToIndex(ValueID vid, int *index)
+{
+  for (auto it = m_values.cbegin(); it != m_values.cend(); ++it)
+    {
+      if ((*it).second == vid)
+        {
+          *index = (*it).first;
+          return true;
+        }
+    }
+
+  // not found
+  return false;
+}
+
 void zwNode::dumpNode(bool all)
 {
   for (auto it = m_values.cbegin();
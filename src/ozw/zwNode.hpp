@@ -82,6 +82,25 @@ namespace upm {
      */
     bool indexToValueID(int index, OpenZWave::ValueID *vid);
 
+    /**
+     * Lookup and return the index corresponding to a ValueID.
+     *
+     * @param vid The OpenZWave ValueID to look up
+     * @param index The pointer to the returned index, if it exists
+     * @return true if the ValueID was found, false otherwise
+     */
+    bool valueIDToIndex(OpenZWave::ValueID vid, int *index);
+
+    /**
+     * Return the number of ValueIDs in the value map.
+     *
+     * @return The number of indexed ValueIDs
+     */
+    int valueCount()
+    {
+      return m_values.size();
+    }
+
     /**
      * Dump various information about the ValueIDs stored in this
      * node.
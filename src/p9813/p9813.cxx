@@ -21,7 +21,7 @@
 using namespace upm;
 
 P9813::P9813(uint16_t ledCount, uint16_t clkPin, uint16_t dataPin, bool batchMode)
-        : m_leds(ledCount), m_clkGpio(clkPin), m_dataGpio(dataPin), m_batchMode(batchMode)
+        : m_clkGpio(clkPin), m_dataGpio(dataPin), m_batchMode(batchMode)
 {
     mraa::Result res = mraa::SUCCESS;
 
@@ -36,6 +36,14 @@ P9813::P9813(uint16_t ledCount, uint16_t clkPin, uint16_t dataPin, bool batchMod
         throw std::invalid_argument(std::string(__FUNCTION__) +
                                     ": GPIO failed to set direction");
     }
+
+    // start and end frames of 4 bytes, 4 bytes per LED
+    initStrip(ledCount, 8 + 4 * ledCount);
+}
+
+P9813::~P9813()
+{
+    stopPushThread();
 }
 
 void
@@ -47,17 +55,13 @@ P9813::setLed(uint16_t ledIdx, uint8_t r, uint8_t g, uint8_t b)
 void
 P9813::setAllLeds(uint8_t r, uint8_t g, uint8_t b)
 {
-    setLeds(0, m_leds.size() - 1, r, g, b);
+    setLeds(0, m_ledCount - 1, r, g, b);
 }
 
 void
 P9813::setLeds(uint16_t startIdx, uint16_t endIdx, uint8_t r, uint8_t g, uint8_t b)
 {
-    for (uint16_t i = startIdx; i <= endIdx; i++) {
-	m_leds[i].red = r;
-	m_leds[i].green = g;
-	m_leds[i].blue = b;
-    }
+    setPixels(startIdx, endIdx, r, g, b);
 
     if (!m_batchMode) {
         pushState();
@@ -67,10 +71,8 @@ P9813::setLeds(uint16_t startIdx, uint16_t endIdx, uint8_t r, uint8_t g, uint8_t
 void
 P9813::setLeds(uint16_t startIdx, uint16_t endIdx, std::vector<RgbColor> colors)
 {
-    for (uint16_t i = startIdx, j = 0; i <= endIdx; i++) {
-	m_leds[i].red = colors[j].red;
-	m_leds[i].green = colors[j].green;
-	m_leds[i].blue = colors[j].blue;
+    for (uint16_t i = startIdx, j = 0; i <= endIdx; i++, j++) {
+        setPixel(i, colors[j].red, colors[j].green, colors[j].blue);
     }
 
     if (!m_batchMode) {
@@ -81,32 +83,49 @@ P9813::setLeds(uint16_t startIdx, uint16_t endIdx, std::vector<RgbColor> colors)
 void
 P9813::pushState(void)
 {
+    show();
+}
+
+/*
+ * ****************
+ *  protected area
+ * ****************
+*/
+
+void
+P9813::encodeFrame(uint8_t *frame)
+{
+    const uint8_t *rgb = m_rgb.data();
+
     // Begin data frame
-    sendByte(0x00);
-    sendByte(0x00);
-    sendByte(0x00);
-    sendByte(0x00);
-
-    for (uint16_t i = 0; i < m_leds.size(); i++) {
-	uint8_t red = m_leds[i].red;
-        uint8_t green = m_leds[i].green;
-        uint8_t blue = m_leds[i].blue;
+    memset(frame, 0, 4);
+    frame += 4;
+
+    for (int i = 0; i < m_ledCount; i++, rgb += 3) {
+        uint8_t red = m_wire[rgb[0]];
+        uint8_t green = m_wire[rgb[1]];
+        uint8_t blue = m_wire[rgb[2]];
         // The first byte is 11 followed by inverted bits 7 and 6 of blue, green, and red
         uint8_t byte0 = 0xFF;
         byte0 ^= (blue >> 2) & 0x30; // XOR bits 4-5
         byte0 ^= (green >> 4) & 0x0C; // XOR bits 2-3
         byte0 ^= (red >> 6) & 0x03; // XOR bits 0-1
-	sendByte(byte0);
-        sendByte(blue);
-        sendByte(green);
-        sendByte(red);
+        *frame++ = byte0;
+        *frame++ = blue;
+        *frame++ = green;
+        *frame++ = red;
     }
 
     // End data frame
-    sendByte(0x00);
-    sendByte(0x00);
-    sendByte(0x00);
-    sendByte(0x00);
+    memset(frame, 0, 4);
+}
+
+void
+P9813::writeFrame(const uint8_t *frame, int len)
+{
+    for (int i = 0; i < len; i++) {
+        sendByte(frame[i]);
+    }
 }
 
 /*
@@ -118,16 +137,16 @@ P9813::pushState(void)
 void
 P9813::sendByte(uint8_t data)
 {
+    // The GPIO writes alone take longer than the minimum clock period,
+    // so the clock isn't slowed down any further
     for (uint16_t i = 0; i < 8; i++) {
         // Write the data bit
         m_dataGpio.write((data & 0x80) >> 7);
-	// Pulse the clock
+        // Pulse the clock
         m_clkGpio.write(1);
-        usleep(20);
         m_clkGpio.write(0);
-        usleep(20);
 
-	// Shift to the next data bit
+        // Shift to the next data bit
         data <<= 1;
     }
 }
@@ -14,6 +14,8 @@
 #include <mraa/gpio.hpp>
 #include <vector>
 
+#include "ledstrip.hpp"
+
 namespace upm
 {
 /**
@@ -40,10 +42,13 @@ typedef struct {
  * P9813 LED controller provides individually controllable LEDs through a two pin protocol
  * For each LED, an RGB (0-255) value can be set.
  *
+ * The chain is driven through GPIOs, so frames are slow to send; the
+ * push thread of LEDStrip keeps that off the caller's path.
+ *
  * @image html p9813.jpg
  * @snippet p9813.cxx Interesting
  */
-class P9813
+class P9813 : public LEDStrip
 {
   public:
     /**
@@ -60,7 +65,7 @@ class P9813
     /**
      * P9813 destructor
      */
-    virtual ~P9813() {};
+    virtual ~P9813();
 
     /**
      * Set the color for a single LED
@@ -111,8 +116,11 @@ class P9813
      */
     void pushState();
 
+  protected:
+    void encodeFrame(uint8_t *frame);
+    void writeFrame(const uint8_t *frame, int len);
+
   private:
-    std::vector<RgbColor> m_leds;
     mraa::Gpio m_clkGpio;
     mraa::Gpio m_dataGpio;
     bool m_batchMode;
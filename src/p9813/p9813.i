@@ -8,7 +8,9 @@ JAVA_JNI_LOADLIBRARY(javaupm_p9813)
 
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
 %{
+#include "ledstrip.hpp"
 #include "p9813.hpp"
 %}
+%include "ledstrip.hpp"
 %include "p9813.hpp"
 /* END Common SWIG syntax */
@@ -11,6 +11,7 @@
 
 #include <unistd.h>
 #include <math.h>
+#include <string.h>
 #include <iostream>
 #include <string>
 #include <stdexcept>
@@ -55,6 +56,9 @@ PCA9685::PCA9685(int bus, uint8_t address, bool raw)
   // enable auto-increment mode by default
   enableAutoIncrement(true);
 
+  // start staging from the current LED settings
+  readLedRegs();
+
   // enable restart by default.
   enableRestart(true);
 }
@@ -86,6 +90,9 @@ PCA9685::PCA9685(std::string initStr) : mraaIo(initStr)
   // enable auto-increment mode by default
   enableAutoIncrement(true);
 
+  // start staging from the current LED settings
+  readLedRegs();
+
   // enable restart by default.
   enableRestart(true);
 
@@ -269,7 +276,10 @@ bool PCA9685::ledFullOn(uint8_t led, bool val)
   else
     bits &= ~0x10;
 
-  return writeByte(regoff, bits);
+  writeByte(regoff, bits);
+  shadowLedRegs(led, 1, &bits, 1);
+
+  return true;
 }
 
 bool PCA9685::ledFullOff(uint8_t led, bool val)
@@ -297,7 +307,10 @@ bool PCA9685::ledFullOff(uint8_t led, bool val)
   else
     bits &= ~0x10;
 
-  return writeByte(regoff, bits);
+  writeByte(regoff, bits);
+  shadowLedRegs(led, 3, &bits, 1);
+
+  return true;
 }
 
 bool PCA9685::ledOnTime(uint8_t led, uint16_t time)
@@ -330,7 +343,12 @@ bool PCA9685::ledOnTime(uint8_t led, uint16_t time)
 
   time = (time & 0x0fff) | (onbit << 8);
 
-  return writeWord(regoff, time);
+  writeWord(regoff, time);
+
+  uint8_t bytes[2] = { uint8_t(time & 0xff), uint8_t(time >> 8) };
+  shadowLedRegs(led, 0, bytes, 2);
+
+  return true;
 }
 
 bool PCA9685::ledOffTime(uint8_t led, uint16_t time)
@@ -363,7 +381,12 @@ bool PCA9685::ledOffTime(uint8_t led, uint16_t time)
 
   time = (time & 0x0fff) | (offbit << 8);
 
-  return writeWord(regoff, time);
+  writeWord(regoff, time);
+
+  uint8_t bytes[2] = { uint8_t(time & 0xff), uint8_t(time >> 8) };
+  shadowLedRegs(led, 2, bytes, 2);
+
+  return true;
 }
 
 bool PCA9685::setPrescale(uint8_t prescale)
@@ -378,3 +401,170 @@ bool PCA9685::setPrescaleFromHz(float hz, float oscFreq)
 
   return setPrescale(uint8_t(prescale));
 }
+
+void PCA9685::stageLedTimes(uint8_t led, uint16_t onTime, uint16_t offTime)
+{
+  if (led > 15 && (led != PCA9685_ALL_LED))
+    {
+      throw std::out_of_range(std::string(__FUNCTION__) +
+                              ": led value must be between 0-15 or " +
+                              "PCA9685_ALL_LED (255)");
+    }
+
+  if (onTime > 4095 || offTime > 4095)
+    {
+      throw std::out_of_range(std::string(__FUNCTION__) +
+                              ": time values must be between 0-4095");
+    }
+
+  // the high bytes include the FULL ON/OFF bits, which are cleared
+  stageLedReg(led, 0, 0xff, onTime & 0xff);
+  stageLedReg(led, 1, 0x1f, onTime >> 8);
+  stageLedReg(led, 2, 0xff, offTime & 0xff);
+  stageLedReg(led, 3, 0x1f, offTime >> 8);
+}
+
+void PCA9685::stageLedFullOn(uint8_t led, bool val)
+{
+  if (led > 15 && (led != PCA9685_ALL_LED))
+    {
+      throw std::out_of_range(std::string(__FUNCTION__) +
+                              ": led value must be between 0-15 or " +
+                              "PCA9685_ALL_LED (255)");
+    }
+
+  stageLedReg(led, 1, 0x10, val ? 0x10 : 0x00);
+}
+
+void PCA9685::stageLedFullOff(uint8_t led, bool val)
+{
+  if (led > 15 && (led != PCA9685_ALL_LED))
+    {
+      throw std::out_of_range(std::string(__FUNCTION__) +
+                              ": led value must be between 0-15 or " +
+                              "PCA9685_ALL_LED (255)");
+    }
+
+  stageLedReg(led, 3, 0x10, val ? 0x10 : 0x00);
+}
+
+bool PCA9685::writeStagedLeds()
+{
+  return sendStagedLeds(prepareStagedLeds());
+}
+
+bool PCA9685::writeStagedLeds(std::vector<PCA9685*> boards)
+{
+  std::vector<int> lens(boards.size());
+
+  for (size_t i = 0; i < boards.size(); i++)
+    lens[i] = boards[i]->prepareStagedLeds();
+
+  for (size_t i = 0; i < boards.size(); i++)
+    boards[i]->sendStagedLeds(lens[i]);
+
+  return true;
+}
+
+bool PCA9685::writeAllLeds(uint16_t onTime, uint16_t offTime)
+{
+  if (onTime > 4095 || offTime > 4095)
+    {
+      throw std::out_of_range(std::string(__FUNCTION__) +
+                              ": time values must be between 0-4095");
+      return false;
+    }
+
+  uint8_t buf[5] = { REG_ALL_LED_ON_L,
+                     uint8_t(onTime & 0xff), uint8_t(onTime >> 8),
+                     uint8_t(offTime & 0xff), uint8_t(offTime >> 8) };
+
+  if (mraa_i2c_write(m_i2c, buf, 5) != MRAA_SUCCESS)
+    {
+      throw std::runtime_error(std::string(__FUNCTION__) +
+                               ": mraa_i2c_write() failed");
+      return false;
+    }
+
+  // the ALL_LED registers load every LED's registers
+  shadowLedRegs(PCA9685_ALL_LED, 0, &buf[1], 4);
+  m_stagedFirst = 16;
+  m_stagedLast = -1;
+
+  return true;
+}
+
+void PCA9685::readLedRegs()
+{
+  if (mraa_i2c_read_bytes_data(m_i2c, REG_LED0_ON_L, m_ledRegs, 64) != 64)
+    {
+      throw std::runtime_error(std::string(__FUNCTION__) +
+                               ": mraa_i2c_read_bytes_data() failed");
+    }
+
+  m_stagedFirst = 16;
+  m_stagedLast = -1;
+}
+
+void PCA9685::shadowLedRegs(uint8_t led, int offset, const uint8_t *bytes,
+                            int len)
+{
+  int first = (led == PCA9685_ALL_LED) ? 0 : led;
+  int last = (led == PCA9685_ALL_LED) ? 15 : led;
+
+  for (int i = first; i <= last; i++)
+    memcpy(&m_ledRegs[i * 4 + offset], bytes, len);
+}
+
+void PCA9685::stageLedReg(uint8_t led, int offset, uint8_t mask, uint8_t bits)
+{
+  int first = (led == PCA9685_ALL_LED) ? 0 : led;
+  int last = (led == PCA9685_ALL_LED) ? 15 : led;
+
+  for (int i = first; i <= last; i++)
+    {
+      uint8_t& reg = m_ledRegs[i * 4 + offset];
+      uint8_t value = (reg & ~mask) | (bits & mask);
+
+      if (value == reg)
+        continue;
+
+      reg = value;
+
+      if (i < m_stagedFirst)
+        m_stagedFirst = i;
+      if (i > m_stagedLast)
+        m_stagedLast = i;
+    }
+}
+
+int PCA9685::prepareStagedLeds()
+{
+  if (m_stagedFirst > m_stagedLast)
+    return 0;
+
+  int len = (m_stagedLast - m_stagedFirst + 1) * 4;
+
+  m_burst[0] = REG_LED0_ON_L + m_stagedFirst * 4;
+  memcpy(&m_burst[1], &m_ledRegs[m_stagedFirst * 4], len);
+
+  return len + 1;
+}
+
+bool PCA9685::sendStagedLeds(int len)
+{
+  if (!len)
+    return true;
+
+  if (mraa_i2c_write(m_i2c, m_burst, len) != MRAA_SUCCESS)
+    {
+      throw std::runtime_error(std::string(__FUNCTION__) +
+                               ": mraa_i2c_write() failed");
+      return false;
+    }
+
+  m_stagedFirst = 16;
+  m_stagedLast = -1;
+
+  return true;
+}
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <mraa/i2c.h>
 #include <mraa/gpio.h>
 #include <mraa/initio.hpp>
@@ -48,8 +49,17 @@ namespace upm {
    *
    * This module was tested with the Adafruit Motor Shield v2.3
    *
+   * To move several outputs at once, stage the new values with
+   * stageLedTimes(), stageLedFullOn() and stageLedFullOff(), then
+   * call writeStagedLeds().  All the changed channels are written in a
+   * single auto-increment transfer, and since the outputs change on
+   * the I2C STOP (unless MODE2_OCH is set), they all switch in the
+   * same PWM cycle.  For chained boards, the static writeStagedLeds()
+   * sends the transfers for every board back to back.
+   *
    * @image html pca9685.jpg
    * @snippet pca9685.cxx Interesting
+   * @snippet pca9685-servos.cxx Interesting
    */
   class PCA9685 {
   public:
@@ -288,6 +298,68 @@ namespace upm {
     bool setPrescaleFromHz(float hz,
                            float oscFreq=PCA9685_INTERNAL_OSC);
 
+    /**
+     * Stages the 'LED on' and 'LED off' times (0-4,095) of a given
+     * LED, clearing its FULL ON and FULL OFF bits.  Nothing is written
+     * to the device until writeStagedLeds() is called.
+     *
+     * @param led LED number; valid values are 0-15, PCA9685_ALL_LED
+     * @param onTime 12-bit value at which point the LED turns on
+     * @param offTime 12-bit value at which point the LED turns off
+     */
+    void stageLedTimes(uint8_t led, uint16_t onTime, uint16_t offTime);
+
+    /**
+     * Stages the FULL ON bit for a given LED, to be written by
+     * writeStagedLeds()
+     *
+     * @param led LED number; valid values are 0-15, PCA9685_ALL_LED
+     * @param val True to set the bit, false to clear it
+     */
+    void stageLedFullOn(uint8_t led, bool val);
+
+    /**
+     * Stages the FULL OFF bit for a given LED, to be written by
+     * writeStagedLeds().  If the FULL ON bit is also set, FULL OFF has
+     * precedence.
+     *
+     * @param led LED number; valid values are 0-15, PCA9685_ALL_LED
+     * @param val True to set the bit, false to clear it
+     */
+    void stageLedFullOff(uint8_t led, bool val);
+
+    /**
+     * Writes the LED registers changed by the stage functions, from
+     * the first to the last changed LED, in a single I2C transfer.
+     * Note: the device must have the auto-increment bit set in the
+     * MODE1 register to work.
+     *
+     * @return True if successful
+     */
+    bool writeStagedLeds();
+
+    /**
+     * Writes the staged LED registers of several boards on the same
+     * bus.  The transfers are all built first, then sent back to back,
+     * so the boards update within a few transfer times of each other.
+     *
+     * @param boards The boards to update
+     * @return True if successful
+     */
+    static bool writeStagedLeds(std::vector<PCA9685*> boards);
+
+    /**
+     * Sets the 'LED on' and 'LED off' times (0-4,095) of all the LEDs
+     * at once, through the ALL_LED registers, in a single I2C
+     * transfer.  This clears the FULL ON and FULL OFF bits of all the
+     * LEDs, and replaces any values still staged.
+     *
+     * @param onTime 12-bit value at which point the LEDs turn on
+     * @param offTime 12-bit value at which point the LEDs turn off
+     * @return True if successful
+     */
+    bool writeAllLeds(uint16_t onTime, uint16_t offTime);
+
     /**
      * Enables or disables the restart capability of the controller
      *
@@ -306,10 +378,35 @@ namespace upm {
      */
     bool enableAutoIncrement(bool ai);
 
+    // read the LED registers into m_ledRegs
+    void readLedRegs();
+
+    // update m_ledRegs after a direct write of len bytes at offset
+    // in the registers of an LED (or all of them)
+    void shadowLedRegs(uint8_t led, int offset, const uint8_t *bytes,
+                       int len);
+
+    // change a staged LED register byte
+    void stageLedReg(uint8_t led, int offset, uint8_t mask, uint8_t bits);
+
+    // build the transfer for the staged LEDs into m_burst, returning
+    // its length, 0 if nothing changed
+    int prepareStagedLeds();
+    bool sendStagedLeds(int len);
+
     bool m_restartEnabled;
     mraa::MraaIo mraaIo;
     mraa_i2c_context m_i2c;
     uint8_t m_addr;
+
+    // copy of the LED0_ON_L-LED15_OFF_H registers, including staged
+    // values
+    uint8_t m_ledRegs[64];
+    // first and last staged LED, first > last when none
+    int m_stagedFirst;
+    int m_stagedLast;
+    // register address followed by the LED registers
+    uint8_t m_burst[65];
   };
 }
 
@@ -16,18 +16,32 @@
 #include <stdexcept>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 
 #include "ssd1351.hpp"
 
 using namespace upm;
 using namespace std;
 
+// Cost of setting up a window, as a number of pixel data bytes.  Rows
+// are merged into a window as long as the unchanged pixels this sends
+// cost less than starting a new window.
+#define WINDOW_COST 128
+
 SSD1351::SSD1351 (int oc, int dc, int rst) :
         GFX(SSD1351WIDTH, SSD1351HEIGHT),
-        m_spi(0), m_oc(oc), m_dc(dc), m_rst(rst) {
+        m_spi(0), m_frontValid(false), m_oc(oc), m_dc(dc), m_rst(rst),
+        m_burst(SSD1351HEIGHT * SSD1351WIDTH * 2 / BLOCKS) {
 
     m_name = "SSD1351";
     m_usemap = true;
+    m_refreshBytes = 0;
+
+    for (int16_t y = 0; y < SSD1351HEIGHT; y++) {
+        m_dirtyX0[y] = SSD1351WIDTH;
+        m_dirtyX1[y] = -1;
+    }
 
     // Setup SPI bus
     m_spi.frequency(8 * 1000000);
@@ -130,18 +144,20 @@ SSD1351::SSD1351 (int oc, int dc, int rst) :
 }
 
 SSD1351::~SSD1351() {
+    if (m_refreshThread.joinable())
+        m_refreshThread.join();
 }
 
 void
 SSD1351::writeCommand (uint8_t value) {
-    dcLow();
-    m_spi.writeByte(value);
+    waitRefresh();
+    sendCommand(value);
 }
 
 void
 SSD1351::writeData (uint8_t value) {
-    dcHigh ();
-    m_spi.writeByte(value);
+    waitRefresh();
+    sendData(value);
 }
 
 void
@@ -153,31 +169,314 @@ SSD1351::drawPixel(int16_t x, int16_t y, uint16_t color) {
           int index = (y * SSD1351WIDTH + x) * 2;
           m_map[index] = color >> 8;
           m_map[index + 1] = color;
+          markDirty(x, y, x, y);
       } else {
-          writeCommand(SSD1351_CMD_SETCOLUMN);
-          writeData(x);
-          writeData(SSD1351WIDTH-1);
+          uint8_t data[2] = { (uint8_t)(color >> 8), (uint8_t)color };
+          waitRefresh();
+          m_frontValid = false;
+          setWindow(x, y, x, y);
+          writeBurst(data, 2);
+      }
+}
 
-          writeCommand(SSD1351_CMD_SETROW);
-          writeData(y);
-          writeData(SSD1351HEIGHT-1);
+void
+SSD1351::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (!clipRect(x, y, w, h))
+        return;
 
-          writeCommand(SSD1351_CMD_WRITERAM);
-          writeData(color >> 8);
-          writeData(color);
-      }
+    if (m_usemap) {
+        // Build the first row, then copy it to the others
+        uint8_t *row = &m_map[(y * SSD1351WIDTH + x) * 2];
+        for (int16_t i = 0; i < w; i++) {
+            row[i * 2] = color >> 8;
+            row[i * 2 + 1] = color;
+        }
+        for (int16_t j = 1; j < h; j++) {
+            memcpy(row + j * SSD1351WIDTH * 2, row, w * 2);
+        }
+        markDirty(x, y, x + w - 1, y + h - 1);
+        return;
+    }
+
+    waitRefresh();
+    m_frontValid = false;
+
+    int count = w * h;
+    int chunk = std::min<int>(count, m_burst.size() / 2);
+    for (int i = 0; i < chunk; i++) {
+        m_burst[i * 2] = color >> 8;
+        m_burst[i * 2 + 1] = color;
+    }
+
+    setWindow(x, y, x + w - 1, y + h - 1);
+    while (count) {
+        int n = std::min(count, chunk);
+        writeBurst(m_burst.data(), n * 2);
+        count -= n;
+    }
+}
+
+void
+SSD1351::pushColors(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t *colors) {
+    int16_t stride = w, skipX, skipY;
+    if (!clipRect(x, y, w, h, &skipX, &skipY))
+        return;
+    colors += skipY * stride + skipX;
+
+    if (m_usemap) {
+        for (int16_t j = 0; j < h; j++, colors += stride) {
+            uint8_t *row = &m_map[((y + j) * SSD1351WIDTH + x) * 2];
+            for (int16_t i = 0; i < w; i++) {
+                row[i * 2] = colors[i] >> 8;
+                row[i * 2 + 1] = colors[i];
+            }
+        }
+        markDirty(x, y, x + w - 1, y + h - 1);
+        return;
+    }
+
+    waitRefresh();
+    m_frontValid = false;
+
+    setWindow(x, y, x + w - 1, y + h - 1);
+
+    // Pack the rows into bursts in SPI byte order
+    int fill = 0;
+    for (int16_t j = 0; j < h; j++, colors += stride) {
+        for (int16_t i = 0; i < w; i++) {
+            if (fill == (int)m_burst.size()) {
+                writeBurst(m_burst.data(), fill);
+                fill = 0;
+            }
+            m_burst[fill++] = colors[i] >> 8;
+            m_burst[fill++] = colors[i];
+        }
+    }
+    writeBurst(m_burst.data(), fill);
 }
+
 void
 SSD1351::refresh () {
-    writeCommand(SSD1351_CMD_WRITERAM);
+    waitRefresh();
+    prepareRefresh();
+
+    try {
+        sendWindows();
+    } catch (...) {
+        // the display contents are unknown now
+        m_frontValid = false;
+        throw;
+    }
+}
+
+void
+SSD1351::refreshAsync () {
+    waitRefresh();
+    prepareRefresh();
+
+    if (!m_windows.empty())
+        m_refreshThread = std::thread(&SSD1351::refreshThread, this);
+}
+
+void
+SSD1351::waitRefresh () {
+    if (m_refreshThread.joinable())
+        m_refreshThread.join();
+
+    if (m_refreshError) {
+        std::exception_ptr error = m_refreshError;
+        m_refreshError = nullptr;
+        m_frontValid = false;
+        std::rethrow_exception(error);
+    }
+}
+
+void
+SSD1351::invalidate () {
+    m_frontValid = false;
+}
+
+int
+SSD1351::getRefreshBytes () {
+    return m_refreshBytes;
+}
+
+void
+SSD1351::markDirty(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    for (int16_t y = y0; y <= y1; y++) {
+        if (x0 < m_dirtyX0[y])
+            m_dirtyX0[y] = x0;
+        if (x1 > m_dirtyX1[y])
+            m_dirtyX1[y] = x1;
+    }
+}
+
+void
+SSD1351::prepareRefresh () {
+    m_windows.clear();
+    m_refreshBytes = 0;
+
+    if (!m_frontValid) {
+        for (int16_t y = 0; y < SSD1351HEIGHT; y++) {
+            m_dirtyX0[y] = SSD1351WIDTH;
+            m_dirtyX1[y] = -1;
+        }
+
+        memcpy(m_front, m_map, sizeof(m_front));
+        m_frontValid = true;
+
+        window_t all = { 0, 0, SSD1351WIDTH - 1, SSD1351HEIGHT - 1 };
+        m_windows.push_back(all);
+        m_refreshBytes = sizeof(m_front);
+        return;
+    }
+
+    window_t win = { 0, 0, -1, -1 };
+    int changed = 0; // bytes of win that actually changed
+
+    for (int16_t y = 0; y < SSD1351HEIGHT; y++) {
+        int16_t x0 = m_dirtyX0[y];
+        int16_t x1 = m_dirtyX1[y];
+
+        m_dirtyX0[y] = SSD1351WIDTH;
+        m_dirtyX1[y] = -1;
+
+        // Trim the span to the pixels that differ from the display, so
+        // that redrawing something unchanged costs nothing
+        uint8_t *map = &m_map[y * SSD1351WIDTH * 2];
+        uint8_t *front = &m_front[y * SSD1351WIDTH * 2];
+        while (x0 <= x1 && !memcmp(map + x0 * 2, front + x0 * 2, 2))
+            x0++;
+        while (x1 >= x0 && !memcmp(map + x1 * 2, front + x1 * 2, 2))
+            x1--;
+        if (x0 > x1)
+            continue;
+
+        memcpy(front + x0 * 2, map + x0 * 2, (x1 - x0 + 1) * 2);
+
+        int span = (x1 - x0 + 1) * 2;
+
+        if (win.x0 <= win.x1) {
+            int16_t ux0 = std::min(win.x0, x0);
+            int16_t ux1 = std::max(win.x1, x1);
+            int area = (ux1 - ux0 + 1) * (y - win.y0 + 1) * 2;
+
+            if (area - changed - span <= WINDOW_COST) {
+                win.x0 = ux0;
+                win.x1 = ux1;
+                win.y1 = y;
+                changed += span;
+                continue;
+            }
+
+            m_windows.push_back(win);
+        }
+
+        win.x0 = x0;
+        win.y0 = y;
+        win.x1 = x1;
+        win.y1 = y;
+        changed = span;
+    }
+
+    if (win.x0 <= win.x1)
+        m_windows.push_back(win);
+
+    for (size_t i = 0; i < m_windows.size(); i++) {
+        m_refreshBytes += (m_windows[i].x1 - m_windows[i].x0 + 1)
+            * (m_windows[i].y1 - m_windows[i].y0 + 1) * 2;
+    }
+}
+
+void
+SSD1351::sendWindows () {
+    for (size_t i = 0; i < m_windows.size(); i++) {
+        const window_t& win = m_windows[i];
+        int rowBytes = (win.x1 - win.x0 + 1) * 2;
+        const uint8_t *row = &m_front[(win.y0 * SSD1351WIDTH + win.x0) * 2];
+
+        setWindow(win.x0, win.y0, win.x1, win.y1);
+
+        // Full rows are contiguous in m_front
+        if (rowBytes == SSD1351WIDTH * 2) {
+            writeBurst(row, rowBytes * (win.y1 - win.y0 + 1));
+            continue;
+        }
+
+        // Otherwise pack the rows into bursts
+        int fill = 0;
+        for (int16_t y = win.y0; y <= win.y1; y++, row += SSD1351WIDTH * 2) {
+            if (fill + rowBytes > (int)m_burst.size()) {
+                writeBurst(m_burst.data(), fill);
+                fill = 0;
+            }
+            memcpy(&m_burst[fill], row, rowBytes);
+            fill += rowBytes;
+        }
+        writeBurst(m_burst.data(), fill);
+    }
+}
+
+void
+SSD1351::refreshThread () {
+    try {
+        sendWindows();
+    } catch (...) {
+        m_refreshError = std::current_exception();
+    }
+}
+
+void
+SSD1351::setWindow(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    sendCommand(SSD1351_CMD_SETCOLUMN);
+    sendData(x0);
+    sendData(x1);
+
+    sendCommand(SSD1351_CMD_SETROW);
+    sendData(y0);
+    sendData(y1);
+
+    sendCommand(SSD1351_CMD_WRITERAM);
+    writeDC(HIGH);
+}
+
+void
+SSD1351::sendCommand (uint8_t value) {
+    writeDC(LOW);
+    m_spi.writeByte(value);
+}
+
+void
+SSD1351::sendData (uint8_t value) {
+    writeDC(HIGH);
+    m_spi.writeByte(value);
+}
+
+void
+SSD1351::writeDC (int level) {
+    if (m_dc.write(level) != mraa::SUCCESS) {
+        throw std::runtime_error(string(__FUNCTION__) +
+                               ": Failed to write data/cmd pin");
+    }
+}
+
+void
+SSD1351::writeBurst(const uint8_t *data, int len) {
     int blockSize = SSD1351HEIGHT * SSD1351WIDTH * 2 / BLOCKS;
-    dcHigh();
-    for (int block = 0; block < BLOCKS; block++) {
-        m_spi.write(&m_map[block * blockSize], blockSize);
+    while (len > 0) {
+        int n = std::min(len, blockSize);
+        if (m_spi.transfer(const_cast<uint8_t *>(data), NULL, n) != mraa::SUCCESS) {
+            throw std::runtime_error(string(__FUNCTION__) +
+                                   ": SPI transfer failed");
+        }
+        data += n;
+        len -= n;
     }
 }
+
 void
 SSD1351::ocLow() {
+    waitRefresh();
     if (m_oc.write(LOW) != mraa::SUCCESS) {
         throw std::runtime_error(string(__FUNCTION__) +
                                ": Failed to write CS pin");
@@ -185,6 +484,7 @@ SSD1351::ocLow() {
 }
 void
 SSD1351::ocHigh() {
+    waitRefresh();
     if (m_oc.write(HIGH) != mraa::SUCCESS) {
         throw std::runtime_error(string(__FUNCTION__) +
                                ": Failed to write CS pin");
@@ -192,17 +492,13 @@ SSD1351::ocHigh() {
 }
 void
 SSD1351::dcLow() {
-    if (m_dc.write(LOW) != mraa::SUCCESS) {
-        throw std::runtime_error(string(__FUNCTION__) +
-                               ": Failed to write data/cmd pin");
-    }
+    waitRefresh();
+    writeDC(LOW);
 }
 void
 SSD1351::dcHigh() {
-    if (m_dc.write(HIGH) != mraa::SUCCESS) {
-        throw std::runtime_error(string(__FUNCTION__) +
-                               ": Failed to write data/cmd pin");
-    }
+    waitRefresh();
+    writeDC(HIGH);
 }
 void
 upm::SSD1351::useMemoryMap(bool var) {
@@ -12,11 +12,14 @@
  */
 #pragma once
 
+#include <exception>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <mraa/gpio.hpp>
 #include <mraa/spi.hpp>
-#include "ssd1351_gfx.hpp"
+#include "gfx.hpp"
 
 // Display Size
 #define SSD1351WIDTH 128
@@ -86,8 +89,16 @@ namespace upm {
  * this driver to work, you can find more details on this topic here:
  * http://iotdk.intel.com/docs/master/mraa/edison.html
  *
+ * With the memory map in use (the default), the rows and columns
+ * changed by drawing are tracked, and refresh() only sends the parts
+ * of the screen buffer that differ from what the display already
+ * shows, each as a single column/row window.  refreshAsync() does the
+ * same from a background thread, so that the next frame can be drawn
+ * while the previous one is being sent.
+ *
  * @image html ssd1351.jpg
  * @snippet ssd1351.cxx Interesting
+ * @snippet ssd1351-gauge.cxx Interesting
  */
 class SSD1351 : public GFX{
     public:
@@ -114,14 +125,16 @@ class SSD1351 : public GFX{
         }
 
         /**
-         * Sends a command to an SPI bus
+         * Sends a command to an SPI bus, once a refresh started by
+         * refreshAsync() is done
          *
          * @param value Command
          */
         void writeCommand (uint8_t value);
 
         /**
-         * Sends data to an SPI bus
+         * Sends data to an SPI bus, once a refresh started by
+         * refreshAsync() is done
          *
          * @param value Data
          */
@@ -136,27 +149,84 @@ class SSD1351 : public GFX{
         void drawPixel (int16_t x, int16_t y, uint16_t color);
 
         /**
-         * Copies the buffer to the chip via the SPI bus
+         * Fills a rectangle in the display buffer, or sends it to the chip
+         * as a single window
+         *
+         * @param x Axis on the horizontal scale of upper-left corner
+         * @param y Axis on the vertical scale of upper-left corner
+         * @param w Width of rectangle in pixels
+         * @param h Height of rectangle in pixels
+         * @param color RGB (16-bit) color (R[0-4], G[5-10], B[11-15])
+         */
+        void fillRect (int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+        /**
+         * Copies a block of pixels to the display buffer, or sends it to
+         * the chip as a single window
+         *
+         * @param x Axis on the horizontal scale of upper-left corner
+         * @param y Axis on the vertical scale of upper-left corner
+         * @param w Width of the block in pixels
+         * @param h Height of the block in pixels
+         * @param colors w * h RGB (16-bit) colors, row by row
+         */
+        void pushColors (int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t *colors);
+
+        /**
+         * Sends the parts of the buffer that changed since the last
+         * refresh to the chip via the SPI bus
          */
         void refresh ();
 
         /**
-         * Set OLED chip select LOW
+         * Like refresh(), but sends the changes from a background thread
+         * and returns right away.  The changes are copied first, so the
+         * buffer can be drawn on while they are sent.  Any refresh still
+         * running is waited for first.
+         */
+        void refreshAsync ();
+
+        /**
+         * Waits for a refresh started by refreshAsync() to complete.  If
+         * it failed, the exception it raised is thrown here.
+         */
+        void waitRefresh ();
+
+        /**
+         * Marks the whole buffer as changed, so that the next refresh
+         * sends all of it
+         */
+        void invalidate ();
+
+        /**
+         * Returns the number of pixel data bytes sent by the last
+         * refresh
+         *
+         * @return The number of bytes
+         */
+        int getRefreshBytes ();
+
+        /**
+         * Set OLED chip select LOW, once a refresh started by
+         * refreshAsync() is done
          */
         void ocLow ();
 
         /**
-         * Set OLED chip select HIGH
+         * Set OLED chip select HIGH, once a refresh started by
+         * refreshAsync() is done
          */
         void ocHigh ();
 
         /**
-         * Data select LOW
+         * Data select LOW, once a refresh started by
+         * refreshAsync() is done
          */
         void dcLow ();
 
         /**
-         * Data select HIGH
+         * Data select HIGH, once a refresh started by
+         * refreshAsync() is done
          */
         void dcHigh ();
 
@@ -167,14 +237,54 @@ class SSD1351 : public GFX{
          */
         void useMemoryMap (bool var);
     private:
+        // A window of the display to send
+        typedef struct {
+            int16_t x0;
+            int16_t y0;
+            int16_t x1;
+            int16_t y1;
+        } window_t;
+
         mraa::Spi       m_spi;
         uint8_t         m_map[SSD1351HEIGHT * SSD1351WIDTH * 2]; /**< Screen buffer */
         bool            m_usemap;
 
+        // What the display shows, once m_frontValid.  Refreshes are
+        // sent from here.
+        uint8_t         m_front[SSD1351HEIGHT * SSD1351WIDTH * 2];
+        bool            m_frontValid;
+
+        // First and last changed column of each row of m_map, first >
+        // last when unchanged
+        int16_t         m_dirtyX0[SSD1351HEIGHT];
+        int16_t         m_dirtyX1[SSD1351HEIGHT];
+
+        // Windows of m_front to send, and the refresh thread sending them
+        std::vector<window_t> m_windows;
+        std::thread     m_refreshThread;
+        std::exception_ptr m_refreshError;
+        int             m_refreshBytes;
+
         mraa::Gpio      m_oc;
         mraa::Gpio      m_dc;
         mraa::Gpio      m_rst;
 
         std::string     m_name;
+
+        // Staging buffer for SPI bursts in direct mode
+        std::vector<uint8_t> m_burst;
+
+        void setWindow (int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+        // writeCommand(), writeData() and dcLow()/dcHigh() without
+        // waiting for a refresh, used by the refresh itself
+        void sendCommand (uint8_t value);
+        void sendData (uint8_t value);
+        void writeDC (int level);
+        void writeBurst (const uint8_t *data, int len);
+        void markDirty (int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+        // copy the changes to m_front and plan the windows to send
+        void prepareRefresh ();
+        void sendWindows ();
+        void refreshThread ();
 };
 }
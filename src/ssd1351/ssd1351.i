@@ -12,8 +12,8 @@ JAVA_JNI_LOADLIBRARY(javaupm_ssd1351)
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
 %{
 #include "ssd1351.hpp"
-#include "ssd1351_gfx.hpp"
+#include "gfx.hpp"
 %}
-%include "ssd1351_gfx.hpp"
+%include "gfx.hpp"
 %include "ssd1351.hpp"
 /* END Common SWIG syntax */
@@ -22,7 +22,7 @@
 using namespace upm;
 
 ST7735::ST7735 (int csLCD, int cSD, int rs, int rst)
-    : GFX (160, 128, m_map, font), m_spi(0), m_csLCDPinCtx(csLCD), m_cSDPinCtx(cSD),
+    : GFX (ST7735_TFTWIDTH, ST7735_TFTHEIGHT), m_spi(0), m_csLCDPinCtx(csLCD), m_cSDPinCtx(cSD),
       m_rSTPinCtx(rst), m_rSPinCtx(rs) {
 
       initModule ();
@@ -33,9 +33,6 @@ void
 ST7735::initModule () {
     mraa::Result error = mraa::SUCCESS;
 
-    m_height = 160;
-    m_width  = 128;
-
     m_spi.frequency(15 * 1000000);
 
     error = m_csLCDPinCtx.dir(mraa::DIR_OUT);
@@ -129,22 +126,68 @@ ST7735::setAddrWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
     write (ST7735_RAMWR);                       // write to RAM
 }
 
+mraa::Result
+ST7735::setPixel (int x, int y, uint16_t color) {
+    if((x < 0) ||(x >= _width) || (y < 0) || (y >= _height)) {
+        return mraa::ERROR_UNSPECIFIED;
+    }
+
+    int index = ((y * _width) + x) * sizeof(uint16_t);
+    m_map[index] = (uint8_t) (color >> 8);
+    m_map[++index] = (uint8_t)(color);
+
+    return mraa::SUCCESS;
+}
+
 void
 ST7735::drawPixel(int16_t x, int16_t y, uint16_t color) {
-    if (mraa::SUCCESS != setPixel (x, y, color)) {
+    setPixel (x, y, color);
+}
+
+void
+ST7735::fillRect (int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (!clipRect (x, y, w, h)) {
         return;
     }
 
-    refresh ();
+    // Build the first row, then copy it to the others
+    uint8_t *row = &m_map[(y * _width + x) * 2];
+    for (int16_t i = 0; i < w; i++) {
+        row[i * 2] = (uint8_t) (color >> 8);
+        row[i * 2 + 1] = (uint8_t)(color);
+    }
+    for (int16_t j = 1; j < h; j++) {
+        memcpy (row + j * _width * 2, row, w * 2);
+    }
+}
+
+void
+ST7735::pushColors (int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t *colors) {
+    int16_t stride = w, skipX, skipY;
+    if (!clipRect (x, y, w, h, &skipX, &skipY)) {
+        return;
+    }
+    colors += skipY * stride + skipX;
+
+    for (int16_t j = 0; j < h; j++, colors += stride) {
+        uint8_t *row = &m_map[((y + j) * _width + x) * 2];
+        for (int16_t i = 0; i < w; i++) {
+            row[i * 2] = (uint8_t) (colors[i] >> 8);
+            row[i * 2 + 1] = (uint8_t)(colors[i]);
+        }
+    }
 }
 
 void
 ST7735::refresh () {
     rsHIGH ();
 
-    int fragmentSize = m_height * m_width * 2 / 20;
+    int fragmentSize = _height * _width * 2 / 20;
     for (int fragment = 0; fragment < 20; fragment++) {
-        free(m_spi.write(&m_map[fragment * fragmentSize], fragmentSize));
+        mraa::Result error = m_spi.transfer(&m_map[fragment * fragmentSize], NULL, fragmentSize);
+        if (error != mraa::SUCCESS) {
+            mraa::printError (error);
+        }
     }
 }
 
@@ -168,7 +211,7 @@ ST7735::configModule() {
     write (ST7735_MADCTL);
     data (0xC0);
 
-    setAddrWindow (0, 0, m_width - 1, m_height - 1);
+    setAddrWindow (0, 0, _width - 1, _height - 1);
 
     fillScreen (ST7735_BLACK);
     refresh ();
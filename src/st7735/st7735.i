@@ -5,7 +5,6 @@
 %include "arrays_java.i"
 %ignore m_map;
 %ignore Bcmd;
-%ignore font;
 %ignore Rcmd1;
 %ignore Rcmd2green;
 %ignore Rcmd2red;
@@ -51,9 +50,9 @@ JAVA_JNI_LOADLIBRARY(javaupm_st7735)
 
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
 %{
-#include "st7735_gfx.hpp"
+#include "gfx.hpp"
 #include "st7735.hpp"
 %}
-%include "st7735_gfx.hpp"
+%include "gfx.hpp"
 %include "st7735.hpp"
 /* END Common SWIG syntax */
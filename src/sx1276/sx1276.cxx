@@ -10,6 +10,10 @@
  */
 
 #include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/eventfd.h>
 #include <iostream>
 #include <stdexcept>
 #include <sstream>
@@ -56,6 +60,20 @@ static const FskBandwidth_t FskBandwidths[] =
   { 300000, 0x00 }, // Invalid Badwidth
 };
 
+// compute a CLOCK_MONOTONIC deadline timeout milliseconds from now
+static void deadlineFromNow(struct timespec *ts, uint32_t timeout)
+{
+  clock_gettime(CLOCK_MONOTONIC, ts);
+
+  ts->tv_sec += timeout / 1000;
+  ts->tv_nsec += (timeout % 1000) * 1000000;
+  if (ts->tv_nsec >= 1000000000)
+    {
+      ts->tv_sec++;
+      ts->tv_nsec -= 1000000000;
+    }
+}
+
 
 SX1276::SX1276(uint8_t chipRev, int bus, int cs, int resetPin, int dio0, 
                int dio1, int dio2, int dio3, int dio4, int dio5) :
@@ -74,6 +92,58 @@ SX1276::SX1276(uint8_t chipRev, int bus, int cs, int resetPin, int dio0,
   // 10ms for POR
   usleep(10000);
 
+  m_radioEvent = REVENT_DONE;
+  m_settings.state = STATE_IDLE;
+  m_engineRunning = false;
+  m_txActive = false;
+  m_savedFskRxContinuous = false;
+  m_savedLoraRxContinuous = false;
+  memset(m_rxBuffer, 0, FIFO_SIZE);
+  memset(&m_rxPacket, 0, sizeof(m_rxPacket));
+  m_rxHead = 0;
+  m_rxTail = 0;
+  m_rxDropped = 0;
+  m_rxSNR = 0;
+  m_rxRSSI = 0;
+  m_rxLen = 0;
+
+  // the interrupt handlers use these, so set them up first
+  pthread_mutexattr_t mutexAttrib;
+  pthread_mutexattr_init(&mutexAttrib);
+  //  pthread_mutexattr_settype(&mutexAttrib, PTHREAD_MUTEX_RECURSIVE);
+  
+  if (pthread_mutex_init(&m_intrLock, &mutexAttrib))
+    {
+      pthread_mutexattr_destroy(&mutexAttrib);
+      throw std::runtime_error(std::string(__FUNCTION__) +
+                               ": pthread_mutex_init(intrLock) failed");
+    }
+
+  pthread_mutexattr_destroy(&mutexAttrib);
+
+  // timeouts are measured on the monotonic clock
+  pthread_condattr_t condAttrib;
+  pthread_condattr_init(&condAttrib);
+  pthread_condattr_setclock(&condAttrib, CLOCK_MONOTONIC);
+
+  if (pthread_cond_init(&m_eventCond, &condAttrib))
+    {
+      pthread_condattr_destroy(&condAttrib);
+      pthread_mutex_destroy(&m_intrLock);
+      throw std::runtime_error(std::string(__FUNCTION__) +
+                               ": pthread_cond_init(eventCond) failed");
+    }
+
+  pthread_condattr_destroy(&condAttrib);
+
+  if ((m_rxEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    {
+      pthread_cond_destroy(&m_eventCond);
+      pthread_mutex_destroy(&m_intrLock);
+      throw std::runtime_error(std::string(__FUNCTION__) +
+                               ": eventfd() failed");
+    }
+
   // setup the interrupt handlers.  All 6 of them.
   m_gpioDIO0.dir(mraa::DIR_IN);
   if (m_gpioDIO0.isr(mraa::EDGE_RISING, onDio0Irq, this))
@@ -107,11 +177,6 @@ SX1276::SX1276(uint8_t chipRev, int bus, int cs, int resetPin, int dio0,
     cerr << __FUNCTION__ << ": Gpio.isr(dio5) failed" << endl;
 
   initClock();
-  m_radioEvent = REVENT_DONE;
-  m_settings.state = STATE_IDLE;
-  memset(m_rxBuffer, 0, FIFO_SIZE);
-  m_rxSNR = 0;
-  m_rxRSSI = 0;
 
   // check the chip revision (to make sure we can read the regs properly)
   uint8_t cRev = getChipVersion();
@@ -127,24 +192,22 @@ SX1276::SX1276(uint8_t chipRev, int bus, int cs, int resetPin, int dio0,
                                str2.str() + ", got 0x" + str.str());
     }
 
-  pthread_mutexattr_t mutexAttrib;
-  pthread_mutexattr_init(&mutexAttrib);
-  //  pthread_mutexattr_settype(&mutexAttrib, PTHREAD_MUTEX_RECURSIVE);
-  
-  if (pthread_mutex_init(&m_intrLock, &mutexAttrib))
-    {
-      pthread_mutexattr_destroy(&mutexAttrib);
-      throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": pthread_mutex_init(intrLock) failed");
-    }
-
-  pthread_mutexattr_destroy(&mutexAttrib);
-
   init();
 }
 
 SX1276::~SX1276()
 {
+  // make sure no handler is still running before tearing down what
+  // they use
+  m_gpioDIO0.isrExit();
+  m_gpioDIO1.isrExit();
+  m_gpioDIO2.isrExit();
+  m_gpioDIO3.isrExit();
+  m_gpioDIO4.isrExit();
+  m_gpioDIO5.isrExit();
+
+  close(m_rxEventFd);
+  pthread_cond_destroy(&m_eventCond);
   pthread_mutex_destroy(&m_intrLock);
 }
 
@@ -534,6 +597,27 @@ SX1276::RADIO_EVENT_T SX1276::sendStr(string buffer, int timeout)
 SX1276::RADIO_EVENT_T SX1276::send(uint8_t *buffer, uint8_t size, 
                                    int txTimeout)
 {
+  lockIntrs();
+
+  if (m_engineRunning)
+    {
+      unlockIntrs();
+      throw std::logic_error(string(__FUNCTION__) +
+                             ": cannot be used while the engine is running");
+    }
+
+  loadTx(buffer, size);
+  unlockIntrs();
+
+  return setTx(txTimeout);
+}
+
+void SX1276::loadTx(uint8_t *buffer, uint8_t size)
+{
+  // keep a copy, the DIO1 handler writes the rest of large FSK
+  // packets from it
+  memcpy(m_txBuffer, buffer, size);
+
   switch (m_settings.modem)
     {
     case MODEM_FSK:
@@ -560,7 +644,7 @@ SX1276::RADIO_EVENT_T SX1276::send(uint8_t *buffer, uint8_t size,
           }
 
         // Write payload buffer
-        writeFifo(buffer, m_settings.fskPacketHandler.ChunkSize);
+        writeFifo(m_txBuffer, m_settings.fskPacketHandler.ChunkSize);
         m_settings.fskPacketHandler.NbBytes += 
           m_settings.fskPacketHandler.ChunkSize;
       }
@@ -610,13 +694,11 @@ SX1276::RADIO_EVENT_T SX1276::send(uint8_t *buffer, uint8_t size,
           }
 
         // Write payload buffer
-        writeFifo(buffer, size);
+        writeFifo(m_txBuffer, size);
       }
 
       break;
     }
-
-  return setTx(txTimeout);
 }
 
 
@@ -1152,6 +1234,15 @@ void SX1276::setTxConfig(RADIO_MODEM_T modem, int8_t power,
 }
 
 SX1276::RADIO_EVENT_T SX1276::setTx(int timeout)
+{
+  lockIntrs();
+  startTx();
+  unlockIntrs();
+
+  return waitEvent(timeout);
+}
+
+void SX1276::startTx()
 {
   uint8_t reg = 0;
 
@@ -1243,21 +1334,36 @@ SX1276::RADIO_EVENT_T SX1276::setTx(int timeout)
   m_radioEvent = REVENT_EXEC;
 
   setOpMode(MODE_TxMode);
+}
 
-  initClock();
-  while ((getMillis() < static_cast<uint32_t>(timeout)) && m_radioEvent == REVENT_EXEC)
-    usleep(100);
+SX1276::RADIO_EVENT_T SX1276::setRx(uint32_t timeout)
+{
+  lockIntrs();
 
-  if (m_radioEvent == REVENT_EXEC)
+  if (m_engineRunning)
     {
-      // timeout
-      m_radioEvent = REVENT_TIMEOUT;
+      unlockIntrs();
+      throw std::logic_error(string(__FUNCTION__) +
+                             ": cannot be used while the engine is running");
     }
 
-  return m_radioEvent;
+  // drop anything left over from a previous continuous receive
+  m_rxTail.store(m_rxHead.load(std::memory_order_acquire),
+                 std::memory_order_release);
+  clearRxEvent();
+
+  startRx();
+  unlockIntrs();
+
+  RADIO_EVENT_T event = waitEvent(timeout);
+
+  if (event == REVENT_DONE)
+    readRxPacket();
+
+  return event;
 }
 
-SX1276::RADIO_EVENT_T SX1276::setRx(uint32_t timeout)
+void SX1276::startRx()
 {
   bool rxContinuous = false;
   uint8_t reg = 0;
@@ -1481,18 +1587,6 @@ SX1276::RADIO_EVENT_T SX1276::setRx(uint32_t timeout)
           setOpMode(MODE_LOR_RxSingle);
         }
     }
-
-  initClock();
-  while ((getMillis() < timeout) && m_radioEvent == REVENT_EXEC)
-    usleep(100);
-
-  if (m_radioEvent == REVENT_EXEC)
-    {
-      // timeout
-      m_radioEvent = REVENT_TIMEOUT;
-    }
-
-  return m_radioEvent;
 }
 
 
@@ -1603,7 +1697,7 @@ void SX1276::onDio0Irq(void *ctx)
 
                   // RxError radio event
                   //                  cerr << __FUNCTION__ << ": RxError crc/sync timeout" << endl;
-                  This->m_radioEvent = REVENT_ERROR;
+                  This->signalEvent(REVENT_ERROR);
 
                   This->m_settings.fskPacketHandler.PreambleDetected = false;
                   This->m_settings.fskPacketHandler.SyncWordDetected = false;
@@ -1664,7 +1758,8 @@ void SX1276::onDio0Irq(void *ctx)
           // RxDone radio event
           This->m_rxRSSI = This->m_settings.fskPacketHandler.RssiValue;
           This->m_rxLen = This->m_settings.fskPacketHandler.Size;
-          This->m_radioEvent = REVENT_DONE;
+          This->pushRxPacket();
+          This->signalEvent(REVENT_DONE);
           // cerr << __FUNCTION__ << ": FSK RxDone" << endl;
           // fprintf(stderr, "### %s: RX(%d): %s\n", 
           //         __FUNCTION__, 
@@ -1699,7 +1794,7 @@ void SX1276::onDio0Irq(void *ctx)
                   }
                 // RxError radio event
                 // cerr << __FUNCTION__ << ": RxError (payload crc error)" << endl;
-                This->m_radioEvent = REVENT_ERROR;
+                This->signalEvent(REVENT_ERROR);
 
                 break;
               }
@@ -1776,7 +1871,8 @@ void SX1276::onDio0Irq(void *ctx)
             This->m_rxRSSI = (int)rssi;
             This->m_rxSNR = (int)snr;
             This->m_rxLen = This->m_settings.loraPacketHandler.Size;
-            This->m_radioEvent = REVENT_DONE;
+            This->pushRxPacket();
+            This->signalEvent(REVENT_DONE);
             // if (This->m_settings.state == STATE_RX_RUNNING)
             //   fprintf(stderr, "### %s: snr = %d rssi = %d RX(%d): %s\n", 
             //           __FUNCTION__, 
@@ -1813,9 +1909,10 @@ void SX1276::onDio0Irq(void *ctx)
         case MODEM_FSK:
         default:
           This->m_settings.state = STATE_IDLE;
+          This->m_txActive = false;
 
           // TxDone radio event
-          This->m_radioEvent = REVENT_DONE;
+          This->signalEvent(REVENT_DONE);
           //          cerr << __FUNCTION__ << ": TxDone" << endl;
 
           break;
@@ -1826,6 +1923,10 @@ void SX1276::onDio0Irq(void *ctx)
       break;
     }
 
+  // a packet was received or sent, see if the engine has more to do
+  if (This->m_engineRunning)
+    This->engineNext();
+
   This->unlockIntrs();
 }
 
@@ -1889,7 +1990,7 @@ void SX1276::onDio1Irq(void *ctx)
           This->m_settings.state = STATE_IDLE;
           // RxError (LORA timeout) radio events
           //          cerr << __FUNCTION__ << ": RxTimeout (LORA)" << endl;
-          This->m_radioEvent = REVENT_TIMEOUT;
+          This->signalEvent(REVENT_TIMEOUT);
 
           break;
 
@@ -1909,7 +2010,7 @@ void SX1276::onDio1Irq(void *ctx)
                 This->m_settings.fskPacketHandler.NbBytes) > 
                This->m_settings.fskPacketHandler.ChunkSize)
             {
-              This->writeFifo((This->m_rxBuffer + 
+              This->writeFifo((This->m_txBuffer + 
                                This->m_settings.fskPacketHandler.NbBytes), 
                               This->m_settings.fskPacketHandler.ChunkSize);
               This->m_settings.fskPacketHandler.NbBytes += 
@@ -1918,7 +2019,7 @@ void SX1276::onDio1Irq(void *ctx)
           else 
             {
               // Write the last chunk of data
-              This->writeFifo((This->m_rxBuffer +
+              This->writeFifo((This->m_txBuffer +
                                This->m_settings.fskPacketHandler.NbBytes),
                               This->m_settings.fskPacketHandler.Size - 
                               This->m_settings.fskPacketHandler.NbBytes);
@@ -2111,6 +2212,289 @@ void SX1276::onDio5Irq(void *ctx)
   This->unlockIntrs();
 }
 
+void SX1276::signalEvent(RADIO_EVENT_T event)
+{
+  m_radioEvent = event;
+  pthread_cond_broadcast(&m_eventCond);
+}
+
+SX1276::RADIO_EVENT_T SX1276::waitEvent(uint32_t timeout)
+{
+  struct timespec deadline;
+  deadlineFromNow(&deadline, timeout);
+
+  lockIntrs();
+
+  while (m_radioEvent == REVENT_EXEC)
+    {
+      if (pthread_cond_timedwait(&m_eventCond, &m_intrLock, &deadline)
+          == ETIMEDOUT)
+        break;
+    }
+
+  if (m_radioEvent == REVENT_EXEC)
+    {
+      // timeout
+      m_radioEvent = REVENT_TIMEOUT;
+    }
+
+  RADIO_EVENT_T event = m_radioEvent;
+
+  unlockIntrs();
+
+  return event;
+}
+
+void SX1276::pushRxPacket()
+{
+  unsigned int head = m_rxHead.load(std::memory_order_relaxed);
+
+  if (head - m_rxTail.load(std::memory_order_acquire) >=
+      static_cast<unsigned int>(RX_RING_SIZE))
+    {
+      // the reader isn't keeping up
+      m_rxDropped++;
+      return;
+    }
+
+  rxPacket_t *pkt = &m_rxRing[head & (RX_RING_SIZE - 1)];
+  int len = m_rxLen;
+
+  if (len > FIFO_SIZE)
+    len = FIFO_SIZE;
+
+  memcpy(pkt->data, m_rxBuffer, len);
+  pkt->len = len;
+  pkt->rssi = m_rxRSSI;
+  pkt->snr = m_rxSNR;
+
+  m_rxHead.store(head + 1, std::memory_order_release);
+
+  // this can only fail if the counter would overflow, in which case
+  // the reader has plenty to wake up to already
+  uint64_t one = 1;
+  ssize_t rv = write(m_rxEventFd, &one, sizeof(one));
+  (void)rv;
+}
+
+void SX1276::clearRxEvent()
+{
+  uint64_t count;
+  ssize_t rv = read(m_rxEventFd, &count, sizeof(count));
+  (void)rv;
+}
+
+bool SX1276::readRxPacket()
+{
+  if (rxRingEmpty())
+    {
+      // clear the event before checking again, so that a packet
+      // pushed in between still leaves the descriptor readable
+      clearRxEvent();
+
+      if (rxRingEmpty())
+        return false;
+    }
+
+  unsigned int tail = m_rxTail.load(std::memory_order_relaxed);
+
+  m_rxPacket = m_rxRing[tail & (RX_RING_SIZE - 1)];
+  m_rxTail.store(tail + 1, std::memory_order_release);
+
+  return true;
+}
+
+bool SX1276::waitRxPacket(int timeout)
+{
+  if (!rxRingEmpty())
+    return true;
+
+  clearRxEvent();
+
+  if (rxRingEmpty())
+    {
+      struct pollfd pfd;
+      pfd.fd = m_rxEventFd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+
+      while (poll(&pfd, 1, timeout) < 0 && errno == EINTR)
+        ;
+    }
+
+  return !rxRingEmpty();
+}
+
+void SX1276::startEngine()
+{
+  lockIntrs();
+
+  if (m_engineRunning)
+    {
+      unlockIntrs();
+      return;
+    }
+
+  // the engine always listens between transmissions, the receive
+  // mode is restored by stopEngine()
+  m_savedFskRxContinuous = m_settings.fskSettings.RxContinuous;
+  m_savedLoraRxContinuous = m_settings.loraSettings.RxContinuous;
+  m_settings.fskSettings.RxContinuous = true;
+  m_settings.loraSettings.RxContinuous = true;
+
+  m_engineRunning = true;
+  m_txActive = false;
+
+  startRx();
+
+  unlockIntrs();
+}
+
+void SX1276::stopEngine()
+{
+  lockIntrs();
+
+  if (!m_engineRunning)
+    {
+      unlockIntrs();
+      return;
+    }
+
+  m_engineRunning = false;
+  m_txActive = false;
+  m_txQueue.clear();
+
+  setStandby();
+  m_settings.state = STATE_IDLE;
+
+  m_settings.fskSettings.RxContinuous = m_savedFskRxContinuous;
+  m_settings.loraSettings.RxContinuous = m_savedLoraRxContinuous;
+
+  // wake up anyone in flushTx()
+  signalEvent(REVENT_DONE);
+
+  unlockIntrs();
+}
+
+bool SX1276::queueSend(uint8_t *buffer, uint8_t size)
+{
+  lockIntrs();
+
+  if (!m_engineRunning)
+    {
+      unlockIntrs();
+      throw std::logic_error(string(__FUNCTION__) +
+                             ": the engine is not running");
+    }
+
+  if (m_txQueue.size() >= static_cast<size_t>(TX_QUEUE_DEPTH))
+    {
+      unlockIntrs();
+      return false;
+    }
+
+  m_txQueue.push_back(std::vector<uint8_t>(buffer, buffer + size));
+
+  if (!m_txActive)
+    engineNext();
+
+  unlockIntrs();
+
+  return true;
+}
+
+bool SX1276::queueSendStr(string buffer)
+{
+  if (buffer.size() > (FIFO_SIZE - 1))
+    throw std::range_error(string(__FUNCTION__) +
+                           ": buffer size must be less than 256");
+
+  // pad to 64 bytes, see sendStr()
+  while (buffer.size() < 64)
+    buffer.push_back(0);
+
+  return queueSend((uint8_t *)buffer.c_str(), buffer.size());
+}
+
+SX1276::RADIO_EVENT_T SX1276::flushTx(int timeout)
+{
+  struct timespec deadline;
+  deadlineFromNow(&deadline, timeout);
+
+  lockIntrs();
+
+  while (m_engineRunning && (m_txActive || !m_txQueue.empty()))
+    {
+      if (pthread_cond_timedwait(&m_eventCond, &m_intrLock, &deadline)
+          == ETIMEDOUT)
+        break;
+    }
+
+  RADIO_EVENT_T event = REVENT_DONE;
+
+  if (m_engineRunning && (m_txActive || !m_txQueue.empty()))
+    {
+      // give up on the rest, and go back to listening
+      m_txQueue.clear();
+      m_txActive = false;
+      startRx();
+
+      event = REVENT_TIMEOUT;
+    }
+
+  unlockIntrs();
+
+  return event;
+}
+
+int SX1276::getTxQueueSize()
+{
+  lockIntrs();
+  int size = m_txQueue.size() + (m_txActive ? 1 : 0);
+  unlockIntrs();
+
+  return size;
+}
+
+void SX1276::engineNext()
+{
+  if (m_txActive)
+    return;
+
+  if (m_txQueue.empty())
+    {
+      // back to listening after a transmission
+      if (m_settings.state != STATE_RX_RUNNING)
+        startRx();
+
+      return;
+    }
+
+  // don't cut off a packet that is being received.  The DIO0
+  // handler will call us again once it is done.
+  if (m_settings.state == STATE_RX_RUNNING)
+    {
+      if (m_settings.modem == MODEM_LORA)
+        {
+          if (readReg(LOR_RegModemStat) & MODEMSTAT_HeaderInfoValid)
+            return;
+        }
+      else if (m_settings.fskPacketHandler.SyncWordDetected)
+        return;
+    }
+
+  std::vector<uint8_t> pkt;
+  pkt.swap(m_txQueue.front());
+  m_txQueue.pop_front();
+
+  // FIFO access while receiving would clobber the packet
+  setStandby();
+
+  loadTx(pkt.data(), pkt.size());
+  m_txActive = true;
+  startTx();
+}
+
 void SX1276::initClock()
 {
   gettimeofday(&m_startTime, NULL);
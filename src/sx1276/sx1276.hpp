@@ -17,7 +17,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <string>
+#include <vector>
 
 #include <sys/time.h>
 #include <sys/select.h>
@@ -68,10 +71,21 @@ namespace upm {
    * should allow an end user to implement whatever features are
    * required.
    *
+   * send() and setRx() block the calling thread until the operation
+   * completes.  For sustained traffic, like a gateway, use the radio
+   * engine instead: startEngine() keeps the radio in continuous
+   * receive mode, received packets are queued from the interrupt
+   * handler into a ring buffer (see waitRxPacket() and
+   * readRxPacket()), and packets passed to queueSend() are sent back
+   * to back as soon as the radio is free, after which it returns to
+   * receive mode.
+   *
    * FSK send/receive example
    * @snippet sx1276-fsk.cxx Interesting
    * LORA send/receive example
    * @snippet sx1276-lora.cxx Interesting
+   * LORA radio engine example
+   * @snippet sx1276-lora-gateway.cxx Interesting
    */
 
   class SX1276 {
@@ -84,6 +98,13 @@ namespace upm {
     // total FIFO size
     static const int FIFO_SIZE = 256;
 
+    // number of received packets the radio engine can hold, must be a
+    // power of 2
+    static const int RX_RING_SIZE = 16;
+
+    // maximum number of packets waiting in the radio engine TX queue
+    static const int TX_QUEUE_DEPTH = 32;
+
     // differentiator between high and low bands
     static const int RF_MID_BAND_THRESH = 525000000;
 
@@ -1812,7 +1833,7 @@ namespace upm {
      */
     std::string getRxBufferStr()
     {
-      std::string rBuffer((char *)m_rxBuffer, getRxLen());
+      std::string rBuffer((char *)m_rxPacket.data, getRxLen());
       return rBuffer;
     };
 
@@ -1825,7 +1846,7 @@ namespace upm {
      */
     uint8_t *getRxBuffer()
     {
-      return (uint8_t*)m_rxBuffer;
+      return (uint8_t*)m_rxPacket.data;
     };
 
     /**
@@ -1837,7 +1858,7 @@ namespace upm {
      */
     int getRxRSSI()
     {
-      return m_rxRSSI;
+      return m_rxPacket.rssi;
     };
 
     /**
@@ -1848,7 +1869,7 @@ namespace upm {
      */
     int getRxSNR()
     {
-      return m_rxSNR;
+      return m_rxPacket.snr;
     };
 
     /**
@@ -1859,7 +1880,111 @@ namespace upm {
      */
     int getRxLen()
     {
-      return m_rxLen;
+      return m_rxPacket.len;
+    };
+
+    /**
+     * Start the radio engine.  The radio is placed in continuous
+     * receive mode using the current receive configuration.  Received
+     * packets are stored in a ring buffer of RX_RING_SIZE packets,
+     * to be retrieved with readRxPacket().  Packets queued with
+     * queueSend() are transmitted as soon as the radio is not in the
+     * middle of receiving a packet.
+     *
+     * While the engine is running, send(), sendStr() and setRx() must
+     * not be used.
+     */
+    void startEngine();
+
+    /**
+     * Stop the radio engine.  Any packets waiting to be sent are
+     * discarded and the radio is placed in standby mode.  The receive
+     * mode (continuous or single) in use before startEngine() is
+     * restored.  Packets already received can still be read with
+     * readRxPacket().
+     */
+    void stopEngine();
+
+    /**
+     * Queue a buffer to be sent by the radio engine.  This returns
+     * immediately.
+     *
+     * @param buffer The buffer to send
+     * @param size The size of the buffer
+     * @return true if the buffer was queued, false if the TX queue is
+     * full
+     */
+    bool queueSend(uint8_t *buffer, uint8_t size);
+
+    /**
+     * Queue a string to be sent by the radio engine.  Like sendStr(),
+     * the string is padded out to 64 bytes.
+     *
+     * @param buffer The string to send
+     * @return true if the string was queued, false if the TX queue is
+     * full
+     */
+    bool queueSendStr(std::string buffer);
+
+    /**
+     * Wait for the radio engine to send all queued packets.  If this
+     * times out, the packet being sent and the rest of the queue are
+     * discarded, and the radio returns to receive mode.
+     *
+     * @param timeout The timeout in milliseconds
+     * @return REVENT_DONE, or REVENT_TIMEOUT
+     */
+    RADIO_EVENT_T flushTx(int timeout);
+
+    /**
+     * Return the number of packets waiting to be sent by the radio
+     * engine, including the one being sent.
+     *
+     * @return The number of packets waiting to be sent
+     */
+    int getTxQueueSize();
+
+    /**
+     * Wait for a received packet to be available from the radio
+     * engine.
+     *
+     * @param timeout The timeout in milliseconds, or -1 to wait
+     * forever
+     * @return true if a packet is available, false on timeout
+     */
+    bool waitRxPacket(int timeout);
+
+    /**
+     * Retrieve the next received packet from the radio engine.  The
+     * packet is then available via getRxBuffer(), getRxBufferStr(),
+     * getRxLen(), getRxRSSI() and getRxSNR().  Only one thread should
+     * read packets.
+     *
+     * @return true if a packet was retrieved, false if there are none
+     */
+    bool readRxPacket();
+
+    /**
+     * Return a file descriptor that becomes readable when the radio
+     * engine has received packets, for use with select() or poll().
+     * Call readRxPacket() until it returns false to clear it.
+     *
+     * @return The file descriptor
+     */
+    int getRxEventFd()
+    {
+      return m_rxEventFd;
+    };
+
+    /**
+     * Return the number of packets the radio engine had to drop
+     * because the ring buffer was full.
+     *
+     * @return The number of dropped packets
+     */
+    unsigned int getRxDropped()
+    {
+      return m_rxDropped;
     };
 
 
@@ -1907,6 +2032,13 @@ namespace upm {
     // rather than call this function directly.
     RADIO_EVENT_T setTx(int timeout);
 
+    // these are called with the interrupt lock held.  Write a packet
+    // into the FIFO
+    void loadTx(uint8_t *buffer, uint8_t size);
+    // switch to transmit, or receive, without waiting for the result
+    void startTx();
+    void startRx();
+
     void startCAD(); // non-functional/non-tested
 
     // not really used, maybe it should be
@@ -1998,21 +2130,76 @@ namespace upm {
 
     uint8_t lookupFSKBandWidth(uint32_t bw);
 
-    // received data (on successful completion)
+    // received data, assembled by the interrupt handlers
     volatile int m_rxRSSI;
     volatile int m_rxSNR;
     volatile int m_rxLen;
     uint8_t m_rxBuffer[FIFO_SIZE];
 
+    // data being sent
+    uint8_t m_txBuffer[FIFO_SIZE];
+
+    // a received packet
+    typedef struct {
+      uint8_t data[FIFO_SIZE];
+      int len;
+      int rssi;
+      int snr;
+    } rxPacket_t;
+
+    // the packet returned by the getRx*() methods
+    rxPacket_t m_rxPacket;
+
+    // received packets.  This is a single producer (the DIO0
+    // handler), single consumer (readRxPacket()) ring, so it needs no
+    // locking.
+    rxPacket_t m_rxRing[RX_RING_SIZE];
+    std::atomic<unsigned int> m_rxHead;
+    std::atomic<unsigned int> m_rxTail;
+    std::atomic<unsigned int> m_rxDropped;
+    // eventfd signalled when a packet is added to the ring
+    int m_rxEventFd;
+
+    // queue a received packet and signal the reader
+    void pushRxPacket();
+    bool rxRingEmpty()
+    {
+      return m_rxTail.load(std::memory_order_relaxed) ==
+        m_rxHead.load(std::memory_order_acquire);
+    };
+    void clearRxEvent();
+
+    // radio engine state, protected by the interrupt lock
+    bool m_engineRunning;
+    bool m_txActive;
+    std::deque<std::vector<uint8_t> > m_txQueue;
+    // the receive modes in use before startEngine()
+    bool m_savedFskRxContinuous;
+    bool m_savedLoraRxContinuous;
+
+    // start the next transmission if the radio is free, or go back
+    // to receiving.  Called with the interrupt lock held.
+    void engineNext();
+
     // for coordinating interrupt access
     pthread_mutex_t m_intrLock;
 
     void lockIntrs() { pthread_mutex_lock(&m_intrLock); };
     void unlockIntrs() { pthread_mutex_unlock(&m_intrLock); };
 
+    // signalled, with m_intrLock held, whenever m_radioEvent changes
+    // or a transmission completes
+    pthread_cond_t m_eventCond;
+
     // current radio event status
     volatile RADIO_EVENT_T m_radioEvent;
 
+    // set the radio event and wake up waiters.  Called with the
+    // interrupt lock held.
+    void signalEvent(RADIO_EVENT_T event);
+    // wait for the current operation to complete
+    RADIO_EVENT_T waitEvent(uint32_t timeout);
+
     // timer support
     struct timeval m_startTime;
     void initClock();
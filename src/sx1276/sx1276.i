@@ -7,6 +7,7 @@
 
 %ignore getRxBuffer();
 %ignore send(uint8_t *buffer, uint8_t size, int txTimeout);
+%ignore queueSend(uint8_t *buffer, uint8_t size);
 
 JAVA_JNI_LOADLIBRARY(javaupm_sx1276)
 #endif
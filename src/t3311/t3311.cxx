@@ -10,6 +10,7 @@
  */
 
 #include <unistd.h>
+#include <errno.h>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -40,27 +41,8 @@ static uint8_t bcd2dec(uint8_t bcd)
 
 T3311::T3311(std::string device, int address, int baud, int bits, char parity,
              int stopBits) :
-  m_mbContext(0)
+  m_address(address & 0xff), m_pollID(0)
 {
-  // check some of the parameters
-  if (!(bits == 7 || bits == 8))
-    {
-      throw std::out_of_range(std::string(__FUNCTION__) +
-                              ": bits must be 7 or 8");
-    }
-
-  if (!(parity == 'N' || parity == 'E' || parity == 'O'))
-    {
-      throw std::out_of_range(std::string(__FUNCTION__) +
-                              ": parity must be 'N', 'O', or 'E'");
-    }
-
-  if (!(stopBits == 1 || stopBits == 2))
-    {
-      throw std::out_of_range(std::string(__FUNCTION__) +
-                              ": stopBits must be 1 or 2");
-    }
-
   m_temperature = 0.0;
   m_humidity = 0.0;
   m_computedValue = 0.0;
@@ -70,34 +52,8 @@ T3311::T3311(std::string device, int address, int baud, int bits, char parity,
   m_mixingRatio = 0.0;
   m_specificEnthalpy = 0.0;
 
-  // addresses are only 8bits wide
-  address &= 0xff;
-
-  // now, open/init the device and modbus context
-
-  if (!(m_mbContext = modbus_new_rtu(device.c_str(), baud, parity, bits,
-                                     stopBits)))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": modbus_new_rtu() failed");
-    }
-
-  // set the slave address of the device we want to talk to
-  if (modbus_set_slave(m_mbContext, address))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": modbus_set_slave() failed");
-    }
-
-  // set the serial mode
-  modbus_rtu_set_serial_mode(m_mbContext, MODBUS_RTU_RS232);
-
-  // now connect..
-  if (modbus_connect(m_mbContext))
-    {
-      throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": modbus_connect() failed");
-    }
+  // open (or share) the bus, this checks the line parameters
+  m_bus = MODBUSRTU::instance(device, baud, bits, parity, stopBits);
 
   // This is a bit of a hack.  The device uses bus power, which isn't
   // provided unless the device has been opened and accessed.  As a
@@ -107,7 +63,8 @@ T3311::T3311(std::string device, int address, int baud, int bits, char parity,
   // allowing the sensor to "boot".  The datasheet says it takes at
   // about 2 seconds to boot, we will wait for 5.
   uint16_t tmp;
-  modbus_read_input_registers(m_mbContext, REG_TEMPERATURE, 1, &tmp);
+  m_bus->readRegs(m_address, MODBUSRTU::TABLE_INPUT_REGS, REG_TEMPERATURE, 1,
+                  &tmp);
 
   // sleep for 5 seconds to give time for device to powerup and boot
   sleep(5);
@@ -160,22 +117,27 @@ T3311::T3311(std::string device, int address, int baud, int bits, char parity,
   preformat << int(b);
 
   m_serialNumber = preformat.str();
+
+  // the 9 registers starting at the temperature
+  m_pollID = m_bus->addPoll(m_address, MODBUSRTU::TABLE_INPUT_REGS,
+                            REG_TEMPERATURE, 9,
+                            [this](const uint16_t *buf, int) {
+                              decodeRegs(buf);
+                            });
 }
 
 T3311::~T3311()
 {
-  if (m_mbContext)
-    {
-      modbus_close(m_mbContext);
-      modbus_free(m_mbContext);
-    }
+  if (m_pollID)
+    m_bus->removePoll(m_pollID);
 }
 
 uint16_t T3311::readInputReg(int reg)
 {
   uint16_t val;
 
-  if (modbus_read_input_registers(m_mbContext, reg, 1, &val) <= 0)
+  if (m_bus->readRegs(m_address, MODBUSRTU::TABLE_INPUT_REGS, reg, 1,
+                      &val) <= 0)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
                                ": modbus_read_input_registers() failed");
@@ -188,7 +150,8 @@ int T3311::readInputRegs(int reg, int len, uint16_t *buf)
 {
   int rv;
 
-  if ((rv = modbus_read_input_registers(m_mbContext, reg, len, buf)) < 0)
+  if ((rv = m_bus->readRegs(m_address, MODBUSRTU::TABLE_INPUT_REGS, reg, len,
+                            buf)) < 0)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
                                ": modbus_read_input_registers() failed");
@@ -199,16 +162,16 @@ int T3311::readInputRegs(int reg, int len, uint16_t *buf)
 
 void T3311::update()
 {
-  static const int dataLen = 9;
-  uint16_t data[dataLen];
-
-  // we read the 9 registers starting at the temperature
-  if (readInputRegs(REG_TEMPERATURE, dataLen, data) != dataLen)
+  if (m_bus->poll(m_address) < 0)
     {
       throw std::runtime_error(std::string(__FUNCTION__) +
-                               ": read less than the expected 9 registers");
+                               ": poll() failed: "
+                               + modbus_strerror(errno));
     }
+}
 
+void T3311::decodeRegs(const uint16_t *data)
+{
   // temperature first, we always store as C
   float tmpF = float((int16_t)data[0]) / 10.0;
   if (m_isCelsius)
@@ -293,8 +256,5 @@ void T3311::setDebug(bool enable)
 {
   m_debugging = enable;
 
-  if (enable)
-    modbus_set_debug(m_mbContext, 1);
-  else
-    modbus_set_debug(m_mbContext, 0);
+  m_bus->setDebug(enable);
 }
@@ -12,7 +12,9 @@
 
 #include <string>
 
-#include <modbus/modbus.h>
+#include <memory>
+
+#include "modbusrtu.hpp"
 #include <interfaces/iHumidity.hpp>
 #include <interfaces/iTemperature.hpp>
 
@@ -46,6 +48,10 @@ namespace upm {
    * accessing this device -- you must use a full serial RS232
    * interface connected via USB.
    *
+   * Devices on the same serial port share one MODBUSRTU bus.  Besides
+   * update(), the values of every device on the bus can be refreshed
+   * together with MODBUSRTU::instance(device)->poll().
+   *
    * @snippet t3311.cxx Interesting
    */
 
@@ -274,8 +280,13 @@ namespace upm {
     uint16_t readInputReg(int reg);
     int readInputRegs(int reg, int len, uint16_t *buf);
 
-    // MODBUS context
-    modbus_t *m_mbContext;
+    // decode the polled data registers
+    void decodeRegs(const uint16_t *buf);
+
+    // shared MODBUS bus
+    std::shared_ptr<MODBUSRTU> m_bus;
+    int m_address;
+    int m_pollID;
 
     // is the device reporting in C or F?
     bool m_isCelsius;
@@ -49,6 +49,13 @@ T8100::T8100(uint32_t targetDeviceObjectID) :
   m_temperature = 0.0;
   m_co2 = 0.0;
   m_relayState = false;
+
+  // read by update()
+  addPollObject(OBJECT_ANALOG_INPUT, AI_Temperature_Thermistor);
+  addPollObject(OBJECT_ANALOG_INPUT, AI_Relative_Humidity);
+  addPollObject(OBJECT_ANALOG_INPUT, AI_CO2);
+  addPollObject(OBJECT_BINARY_INPUT, BI_Relay_State);
+  addPollObject(OBJECT_BINARY_VALUE, BV_Temperature_Units);
 }
 
 T8100::~T8100()
@@ -57,11 +64,11 @@ T8100::~T8100()
 
 void T8100::update()
 {
-  if (!m_isTempInitialized)
-    {
-      // this will update internals so conversions work properly
-      getTemperatureScale();
-    }
+  // read everything with one request
+  poll();
+
+  // this will update internals so conversions work properly
+  getTemperatureScale();
 
   float tmpF = getAnalogInput(AI_Temperature_Thermistor);
 
@@ -123,7 +123,8 @@ namespace upm {
      * Read current values from the sensor and update internal stored
      * values for temperature, humidity, CO2 concentration and relay
      * state.  This method must be called prior to querying any
-     * of the aforementioned values.
+     * of the aforementioned values.  They are all read, along with
+     * the temperature scale, with a single request.
      */
     void update();
 
@@ -7,6 +7,8 @@ JAVA_JNI_LOADLIBRARY(javaupm_t8100)
 /* END Java syntax */
 
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
+%include "../bacnetmstp/bacnetmstp_ignores.i"
+
 %{
 #include "bacnetmstp.hpp"
 #include "bacnetutil.hpp"
@@ -46,6 +46,10 @@ TB7300::TB7300(uint32_t targetDeviceObjectID) :
 
   // room temperature only
   m_temperature = 0.0;
+
+  // read by update()
+  addPollObject(OBJECT_ANALOG_VALUE, AV_Room_Temperature);
+  addPollObject(OBJECT_BINARY_VALUE, BV_Temperature_Scale);
 }
 
 TB7300::~TB7300()
@@ -54,11 +58,11 @@ TB7300::~TB7300()
 
 void TB7300::update()
 {
-  if (!m_isTempInitialized)
-    {
-      // this will update internals so conversions work properly
-      getTemperatureScale();
-    }
+  // read both with one request
+  poll();
+
+  // this will update internals so conversions work properly
+  getTemperatureScale();
 
   float tmpF = getAnalogValue(AV_Room_Temperature);
 
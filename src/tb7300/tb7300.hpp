@@ -198,8 +198,9 @@ namespace upm {
     /**
      * Read current temperature from the sensor and update internal
      * stored value.  This method must be called prior to querying the
-     * temperature.  All other values in the device must be queried
-     * directly via the appropriate BACNETUTIL::get*() methods
+     * temperature.  The temperature and the scale it is in are read
+     * with a single request.  All other values in the device must be
+     * queried directly via the appropriate BACNETUTIL::get*() methods
      * depending on the object of interest.
      */
     void update();
@@ -18,6 +18,8 @@ JAVA_JNI_LOADLIBRARY(javaupm_tb7300)
 /* END Java syntax */
 
 /* BEGIN Common SWIG syntax ------------------------------------------------- */
+%include "../bacnetmstp/bacnetmstp_ignores.i"
+
 %{
 #include "bacnetmstp.hpp"
 #include "bacnetutil.hpp"
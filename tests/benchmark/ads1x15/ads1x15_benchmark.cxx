@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "benchmark/benchmark.h"
+#include "ads1015.hpp"
+#include "ads1115.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+
+/* Compares the effective sample rate of getSample() with the continuous
+ * mode scan engine, round-robin over the four single-ended inputs at the
+ * highest data rate.  This needs the hardware, described by environment
+ * variables:
+ *   ADS1X15_MODEL     1015 or 1115 (default 1115)
+ *   ADS1X15_BUS       I2C bus (default 0)
+ *   ADS1X15_ADDRESS   I2C address (default 0x48)
+ *   ADS1X15_READY_PIN GPIO connected to ALERT/RDY (default none)
+ * The benchmarks are skipped when the device can't be opened. */
+namespace
+{
+    int env(const char* name, int dflt)
+    {
+        const char* value = std::getenv(name);
+        return value ? std::stoi(value, nullptr, 0) : dflt;
+    }
+
+    std::unique_ptr<upm::ADS1X15> open_adc()
+    {
+        int bus = env("ADS1X15_BUS", 0);
+        uint8_t address = env("ADS1X15_ADDRESS", ADS1X15_ADDRESS);
+        if (env("ADS1X15_MODEL", 1115) == 1015)
+        {
+            upm::ADS1015* adc = new upm::ADS1015(bus, address);
+            adc->setSPS(upm::ADS1015::SPS_3300);
+            return std::unique_ptr<upm::ADS1X15>(adc);
+        }
+        upm::ADS1115* adc = new upm::ADS1115(bus, address);
+        adc->setSPS(upm::ADS1115::SPS_860);
+        return std::unique_ptr<upm::ADS1X15>(adc);
+    }
+
+    const upm::ADS1X15::ADSMUXMODE inputs[] = {
+        upm::ADS1X15::SINGLE_0, upm::ADS1X15::SINGLE_1,
+        upm::ADS1X15::SINGLE_2, upm::ADS1X15::SINGLE_3};
+}
+
+static void BM_ads1x15_getsample(benchmark::State& state)
+{
+    std::unique_ptr<upm::ADS1X15> adc;
+    try { adc = open_adc(); }
+    catch (std::exception& e) { state.SkipWithError(e.what()); return; }
+
+    size_t samples = 0;
+    for (auto _ : state)
+        for (auto input : inputs)
+        {
+            benchmark::DoNotOptimize(adc->getSample(input));
+            samples++;
+        }
+
+    state.counters["SPS"] = benchmark::Counter(samples,
+            benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ads1x15_getsample)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/* Each iteration collects state.range(0) samples from the ring */
+static void BM_ads1x15_scan(benchmark::State& state)
+{
+    std::unique_ptr<upm::ADS1X15> adc;
+    try { adc = open_adc(); }
+    catch (std::exception& e) { state.SkipWithError(e.what()); return; }
+
+    for (auto input : inputs)
+        adc->addScanChannel(input, adc->getGain());
+    adc->scanStart(env("ADS1X15_READY_PIN", -1), 4096);
+
+    upm::ads1x15_sample sample;
+    size_t samples = 0;
+    for (auto _ : state)
+        for (int64_t i = 0; i < state.range(0); )
+            if (adc->getScanSample(sample))
+            {
+                i++;
+                samples++;
+            }
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+
+    state.counters["SPS"] = benchmark::Counter(samples,
+            benchmark::Counter::kIsRate);
+    state.counters["SPS (adc)"] = adc->getScanSamplesPerSecond();
+    state.counters["lost"] = adc->getScanOverruns();
+    adc->scanStop();
+}
+BENCHMARK(BM_ads1x15_scan)->Arg(256)->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
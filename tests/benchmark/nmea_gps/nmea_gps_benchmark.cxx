@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the The MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "benchmark/benchmark.h"
+#include "nmea_gps.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <queue>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+/* Replays a recorded NMEA capture through the NMEAGPS streaming parser and
+ * through the std::regex based parser it replaced, and through the parsing
+ * thread via a replay source.  The capture can be overridden with the
+ * NMEA_LOG environment variable. */
+namespace
+{
+    const std::string& capture()
+    {
+        static std::string data;
+        if (data.empty())
+        {
+            const char* path = std::getenv("NMEA_LOG");
+            std::ifstream f(path ? path : NMEA_GPS_SAMPLE_LOG, std::ios::binary);
+            if (!f)
+                throw std::runtime_error("Unable to open NMEA capture");
+            std::ostringstream oss;
+            oss << f.rdbuf();
+            data = oss.str();
+        }
+        return data;
+    }
+
+    /* The previous regex based parser, kept here as the baseline */
+    class regex_reference
+    {
+        public:
+            void parse(const std::string& buf)
+            {
+                std::sregex_iterator next(buf.begin(), buf.end(), rex);
+                std::sregex_iterator end;
+                while (next != end)
+                {
+                    std::smatch matches = *next++;
+                    sentence(matches[1].str());
+                }
+            }
+
+            size_t fixes = 0;
+            size_t sats = 0;
+            size_t txts = 0;
+        private:
+            void sentence(const std::string& s)
+            {
+                std::smatch m;
+                std::string type = s.substr(1, 5);
+                if (type == "GPGGA" && std::regex_search(s, m, rex_gga))
+                {
+                    upm::gps_fix fix;
+                    fix.time_utc = m[1];
+                    fix.coordinates.latitude = std::stoi(m[2]) + std::stof(m[3])/60.0;
+                    fix.coordinates.longitude = std::stoi(m[5]) + std::stof(m[6])/60.0;
+                    fix.quality = static_cast<upm::gps_fix_quality>(std::stoi(m[8]));
+                    fix.satellites = std::stoi(m[9]);
+                    fix.hdop = std::stof(m[10]);
+                    fix.altitude_meters = std::stof(m[11]);
+                    fix.geoid_height_meters = std::stof(m[12]);
+                    fix.station_id = m[14];
+                    q_fix.push(fix);
+                    fixes++;
+                }
+                else if (type == "GPGLL" && std::regex_search(s, m, rex_gll))
+                {
+                    upm::gps_fix fix;
+                    fix.time_utc = m[7];
+                    fix.coordinates.latitude = std::stoi(m[1]) + std::stof(m[2])/60.0;
+                    fix.coordinates.longitude = std::stoi(m[4]) + std::stof(m[5])/60.0;
+                    q_fix.push(fix);
+                    fixes++;
+                }
+                else if (type == "GPGSV" && std::regex_search(s, m, rex_gsv_hdr))
+                {
+                    std::sregex_iterator next(s.begin(), s.end(), rex_gsv_sat);
+                    std::sregex_iterator end;
+                    while (next != end)
+                    {
+                        std::smatch sm = *next++;
+                        upm::satellite sat(sm[1].str(), std::stoi(sm[2].str()),
+                                std::stoi(sm[3].str()),
+                                sm[4].str().empty() ? 0 : std::stoi(sm[4].str()));
+                        sats++;
+                    }
+                }
+                else if (type == "GPTXT" && std::regex_search(s, m, rex_txt))
+                {
+                    q_txt.push({std::stoi(m[3]), m[4]});
+                    txts++;
+                }
+                q_raw.push(s);
+
+                while (q_fix.size() > 10) q_fix.pop();
+                while (q_txt.size() > 10) q_txt.pop();
+                while (q_raw.size() > 10) q_raw.pop();
+            }
+
+            std::queue<upm::gps_fix> q_fix;
+            std::queue<upm::nmeatxt> q_txt;
+            std::queue<std::string> q_raw;
+
+            const std::regex rex{R"((\$GP.{5,94}\*[a-fA-F0-9][a-fA-F0-9])\r\n)"};
+            const std::regex rex_gga{R"(^\$GPGGA,(\d+\.\d+),(\d+)(\d{2}\.\d+),([NS]),(\d+)(\d{2}.\d+),([WE]),(\d+),(\d+),(\d+\.\d+),(\d+\.\d+),M,([+-]?\d+\.\d+),M,([+-]?\d+\.\d+)?,?(\S+)?[*]([A-Z0-9]{2}))"};
+            const std::regex rex_gsv_hdr{R"(^\$GPGSV,(\d+),(\d+),(\d\d),)"};
+            const std::regex rex_gsv_sat{R"((\d{2}),(\d{2}),(\d{3}),(\d+)?,?)"};
+            const std::regex rex_gll{R"(^\$GPGLL,(\d+)(\d{2}\.\d+),([NS]),(\d+)(\d{2}.\d+),([WE]),(\d+\.\d+)(,A)?,A[*]([A-Z0-9]{2}))"};
+            const std::regex rex_txt{R"(^\$GPTXT,(\d{2}),(\d{2}),(\d{2}),(.*)[*]([A-Z0-9]{2}))"};
+    };
+
+    /* Split the capture into reads the size the parsing thread uses */
+    const size_t read_size = 4095;
+}
+
+static void BM_nmea_regex(benchmark::State& state)
+{
+    const std::string& data = capture();
+    regex_reference ref;
+    for (auto _ : state)
+        for (size_t i = 0; i < data.size(); i += read_size)
+            ref.parse(data.substr(i, read_size));
+
+    state.SetBytesProcessed(state.iterations() * data.size());
+    state.counters["fixes"] = ref.fixes / state.iterations();
+}
+BENCHMARK(BM_nmea_regex)->Unit(benchmark::kMicrosecond);
+
+static void BM_nmea_stream(benchmark::State& state)
+{
+    const std::string& data = capture();
+    upm::NMEAGPS gps(0, 115200, -1);
+    gps.setMaxQueueDepth(1000);
+    size_t fixes = 0;
+    for (auto _ : state)
+        for (size_t i = 0; i < data.size(); i += read_size)
+        {
+            gps.parseNMEAStream(data.substr(i, read_size));
+            while (gps.fixQueueSize())
+            {
+                gps.getFix();
+                fixes++;
+            }
+        }
+
+    state.SetBytesProcessed(state.iterations() * data.size());
+    state.counters["fixes"] = fixes / state.iterations();
+}
+BENCHMARK(BM_nmea_stream)->Unit(benchmark::kMicrosecond);
+
+/* Replay a multi-megabyte capture through the parsing thread at unlimited
+ * speed while a consumer drains the fix queue.  The consumed count shows
+ * how many fixes survive queue pressure. */
+static void BM_nmea_replay(benchmark::State& state)
+{
+    const std::string& data = capture();
+    size_t repeat = (state.range(0) << 20) / data.size() + 1;
+    double bps = 0, sps = 0;
+    size_t consumed = 0;
+    for (auto _ : state)
+    {
+        upm::NMEAMemorySource source(data, repeat);
+        upm::NMEAGPS gps(source);
+        gps.setMaxQueueDepth(100);
+        gps.parseStart();
+
+        while (!source.eof() || gps.fixQueueSize())
+            if (gps.waitFix(10))
+            {
+                gps.getFix();
+                consumed++;
+            }
+
+        bps = gps.bytesPerSecond();
+        sps = gps.sentencesPerSecond();
+        gps.parseStop();
+    }
+
+    state.SetBytesProcessed(state.iterations() * repeat * data.size());
+    state.counters["bytes/s (gps)"] = bps;
+    state.counters["sentences/s (gps)"] = sps;
+    state.counters["fixes consumed"] = consumed / state.iterations();
+}
+BENCHMARK(BM_nmea_replay)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
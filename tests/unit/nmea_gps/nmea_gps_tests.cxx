@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <random>
+#include <thread>
 
 /* NMEA GPS test fixture */
 class nmea_gps_unit : public ::testing::Test
@@ -286,3 +287,248 @@ TEST_F(nmea_gps_unit, parse_txt_valid)
     /* Should have 5 GPS fixes */
     ASSERT_EQ(gps.txtMessageQueueSize(), 7);
 }
+
+/* Parse sentences split across multiple reads */
+TEST_F(nmea_gps_unit, parse_stream_partial)
+{
+    upm::NMEAGPS gps(0, 115200, -1);
+    std::string data =
+        "$GPGLL,4532.55107,N,12257.68422,W,170004.20,A,A*74\r\n"
+        "$GPTXT,01,01,02,ANTSTATUS=OK*3B\r\n"
+        "$GPGGA,172814.0,3723.46587704,N,12202.26957864,W,"
+        "2,6,1.2,18.893,M,-25.669,M,2.0,0031*4F\r\n";
+
+    /* Feed one character at a time */
+    for (const auto& c : data)
+        gps.parseNMEAStream(std::string(1, c));
+
+    ASSERT_EQ(gps.rawSentenceQueueSize(), 3);
+    ASSERT_EQ(gps.txtMessageQueueSize(), 1);
+    ASSERT_EQ(gps.fixQueueSize(), 2);
+
+    upm::gps_fix f = gps.getFix();
+    ASSERT_EQ(f.valid, true) << f.__str__();
+    ASSERT_FLOAT_EQ(f.coordinates.latitude, 45.542517833333335) << f.__str__();
+
+    f = gps.getFix();
+    ASSERT_EQ(f.valid, true) << f.__str__();
+    ASSERT_EQ(f.time_utc, "172814.0") << f.__str__();
+    ASSERT_FLOAT_EQ(f.altitude_meters, 18.893) << f.__str__();
+    ASSERT_FLOAT_EQ(f.geoid_height_meters, -25.669) << f.__str__();
+    ASSERT_EQ(f.station_id, "0031") << f.__str__();
+
+    /* Raw sentences do not include the line ending */
+    ASSERT_EQ(gps.getRawSentence(),
+            "$GPGLL,4532.55107,N,12257.68422,W,170004.20,A,A*74");
+}
+
+/* Frame sentences out of noisy reads */
+TEST_F(nmea_gps_unit, parse_stream_noise)
+{
+    upm::NMEAGPS gps(0, 115200, -1);
+
+    /* Leading partial sentence, garbage, unterminated sentence, a
+     * sentence with a bad checksum and finally a good sentence */
+    gps.parseNMEAStream("55107,N,12257.68422,W,170004.20,A,A*74\r\n"
+            "\x01\xff garbage $$ $GPGLL,4532.55107,N,12257.6"
+            "$GPGLL,4532.55107,N,12257.68422,W,170004.20,A,A*75\r\n"
+            "$GPGLL,4532.55008,N,12257.68195,W,170005.00,A,A*70\r\n");
+
+    ASSERT_EQ(gps.rawSentenceQueueSize(), 2);
+    ASSERT_EQ(gps.fixQueueSize(), 2);
+
+    /* Checksum mismatch is reported, but still queued */
+    upm::gps_fix f = gps.getFix();
+    ASSERT_EQ(f.valid, false) << f.__str__();
+    ASSERT_EQ(f.chksum_match, false) << f.__str__();
+
+    f = gps.getFix();
+    ASSERT_EQ(f.valid, true) << f.__str__();
+    ASSERT_EQ(f.time_utc, "170005.00") << f.__str__();
+}
+
+/* Queues keep the newest entries when full */
+TEST_F(nmea_gps_unit, queue_drop_oldest)
+{
+    upm::NMEAGPS gps(0, 115200, -1);
+    std::vector<std::string> snts =
+    {
+      "$GPGLL,4532.55107,N,12257.68422,W,170004.20,A,A*74",
+      "$GPGLL,4532.55008,N,12257.68195,W,170005.00,A,A*70",
+      "$GPGLL,4532.55027,N,12257.68252,W,170006.10,A,A*77",
+      "$GPGLL,4532.54370,N,12257.65873,W,170006.90,A,A*7B",
+      "$GPGLL,4532.54230,N,12257.65302,W,170008.00,A,A*74"
+    };
+
+    gps.setMaxQueueDepth(3);
+    for(const auto& sentence : snts)
+        gps.parseNMEASentence(sentence);
+
+    ASSERT_EQ(gps.fixQueueSize(), 3);
+    ASSERT_EQ(gps.rawSentenceQueueSize(), 3);
+    ASSERT_EQ(gps.getFix().time_utc, "170006.10");
+
+    /* Shrinking the queue keeps the newest entries */
+    gps.setMaxQueueDepth(1);
+    ASSERT_EQ(gps.fixQueueSize(), 1);
+    ASSERT_EQ(gps.getFix().time_utc, "170008.00");
+
+    /* Empty queue returns an invalid fix */
+    ASSERT_EQ(gps.getFix().valid, false);
+}
+
+/* Wait for a fix from another thread */
+TEST_F(nmea_gps_unit, wait_fix)
+{
+    upm::NMEAGPS gps(0, 115200, -1);
+
+    /* Nothing to wait for */
+    ASSERT_EQ(gps.waitFix(10), false);
+
+    std::thread producer([&gps] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        gps.parseNMEASentence("$GPGLL,4532.55107,N,12257.68422,W,170004.20,A,A*74");
+    });
+
+    ASSERT_EQ(gps.waitFix(5000), true);
+    producer.join();
+    ASSERT_EQ(gps.getFix().valid, true);
+}
+
+/* Parse a multi-constellation epoch with RMC/VTG/GSA */
+TEST_F(nmea_gps_unit, parse_gnss_epoch)
+{
+    upm::NMEAGPS gps(0, 115200, -1);
+    gps.parseNMEAStream(
+        "$GNRMC,170000.00,A,4532.55136,N,12257.68454,W,0.267,45.5,170218,,,A*62\r\n"
+        "$GNVTG,46.0,T,,M,0.300,N,0.556,K,A*24\r\n"
+        "$GNGGA,170000.00,4532.55136,N,12257.68454,W,1,12,0.80,73.3,M,-21.3,M,,*4B\r\n"
+        "$GNGSA,A,3,07,08,09,11,13,30,,,,,,,1.50,0.80,1.27,1*0E\r\n"
+        "$GNGLL,4532.55136,N,12257.68454,W,170000.00,A,A*6F\r\n"
+        "$GPGSV,1,1,02,07,64,079,30,08,39,066,*71\r\n"
+        "$GLGSV,1,1,02,65,40,100,30,72,20,200,*67\r\n"
+        "$GNRMC,170001.00,V,,,,,,,170218,,,N*69\r\n");
+
+    /* RMC, GGA and GLL fixes, the void RMC is ignored */
+    ASSERT_EQ(gps.rawSentenceQueueSize(), 8);
+    ASSERT_EQ(gps.fixQueueSize(), 3);
+
+    /* RMC carries speed, course and date */
+    upm::gps_fix f = gps.getFix();
+    ASSERT_EQ(f.valid, true) << f.__str__();
+    ASSERT_FLOAT_EQ(f.speed_knots, 0.267) << f.__str__();
+    ASSERT_FLOAT_EQ(f.course_deg, 45.5) << f.__str__();
+    ASSERT_EQ(f.date_utc, "170218") << f.__str__();
+
+    /* GGA picks up the date from RMC and speed/course from VTG */
+    f = gps.getFix();
+    ASSERT_EQ(f.valid, true) << f.__str__();
+    ASSERT_EQ(f.satellites, 12) << f.__str__();
+    ASSERT_EQ(f.date_utc, "170218") << f.__str__();
+    ASSERT_FLOAT_EQ(f.speed_knots, 0.3) << f.__str__();
+    ASSERT_FLOAT_EQ(f.course_deg, 46.0) << f.__str__();
+
+    /* GLL picks up DOP from GSA and altitude from GGA */
+    f = gps.getFix();
+    ASSERT_EQ(f.valid, true) << f.__str__();
+    ASSERT_FLOAT_EQ(f.pdop, 1.5) << f.__str__();
+    ASSERT_FLOAT_EQ(f.hdop, 0.8) << f.__str__();
+    ASSERT_FLOAT_EQ(f.vdop, 1.27) << f.__str__();
+    ASSERT_FLOAT_EQ(f.altitude_meters, 73.3) << f.__str__();
+    ASSERT_EQ(f.quality, upm::gps_fix_quality::fix_sp) << f.__str__();
+
+    /* Satellites from each constellation are kept */
+    auto sats = gps.satellites();
+    ASSERT_EQ(sats.size(), 4);
+    ASSERT_EQ(sats[0].talker, "GP");
+    ASSERT_EQ(sats[0].prn, "07");
+    ASSERT_EQ(sats[0].snr, 30);
+    ASSERT_EQ(sats[3].talker, "GL");
+    ASSERT_EQ(sats[3].prn, "72");
+    ASSERT_EQ(sats[3].azimuth_deg, 200);
+}
+
+/* Run the parsing thread against an in-memory replay */
+TEST_F(nmea_gps_unit, replay_memory)
+{
+    std::string epoch =
+        "$GPTXT,01,01,02,ANTSTATUS=OK*3B\r\n"
+        "$GPGGA,172814.0,3723.46587704,N,12202.26957864,W,"
+        "2,6,1.2,18.893,M,-25.669,M,2.0,0031*4F\r\n"
+        "$GPGLL,4532.55107,N,12257.68422,W,170004.20,A,A*74\r\n";
+    upm::NMEAMemorySource source(epoch, 100);
+    upm::NMEAGPS gps(source);
+
+    /* Device only operations are no-ops */
+    gps.enable(true);
+    gps.setBaudrate(9600);
+
+    gps.setMaxQueueDepth(1000);
+    gps.parseStart();
+
+    size_t fixes = 0;
+    while (gps.waitFix(200))
+        if (gps.getFix().valid) fixes++;
+
+    ASSERT_TRUE(source.eof());
+    ASSERT_GT(gps.bytesPerSecond(), 0);
+    ASSERT_GT(gps.sentencesPerSecond(), 0);
+    gps.parseStop();
+
+    ASSERT_EQ(fixes, 200);
+    ASSERT_EQ(gps.txtMessageQueueSize(), 100);
+}
+
+/* Run the parsing thread against a pipe written in small pieces */
+TEST_F(nmea_gps_unit, replay_pipe)
+{
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    upm::NMEAPipeSource source(fds[0], true);
+    upm::NMEAGPS gps(source);
+    gps.parseStart();
+
+    std::string snt = "$GPGLL,4532.55107,N,12257.68422,W,170004.20,A,A*74\r\n";
+    for (size_t i = 0; i < snt.size(); i += 7)
+    {
+        std::string piece = snt.substr(i, 7);
+        ASSERT_EQ(write(fds[1], piece.data(), piece.size()), (int)piece.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ASSERT_TRUE(gps.waitFix(5000));
+    ASSERT_EQ(gps.getFix().time_utc, "170004.20");
+
+    /* Closing the writer ends the source */
+    close(fds[1]);
+    while (!source.eof())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    gps.parseStop();
+}
+
+/* Replay a capture file */
+TEST_F(nmea_gps_unit, replay_file)
+{
+    char path[] = "/tmp/nmea_gps_unitXXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    std::string snt = "$GPGLL,4532.55107,N,12257.68422,W,170004.20,A,A*74\r\n";
+    ASSERT_EQ(write(fd, snt.data(), snt.size()), (int)snt.size());
+    close(fd);
+
+    upm::NMEAFileSource source(path, 3);
+    upm::NMEAGPS gps(source);
+
+    /* Read the file three times over, then the end is reached */
+    std::string data;
+    while (gps.dataAvailable(0))
+        data += gps.readStr(16);
+    unlink(path);
+
+    ASSERT_TRUE(source.eof());
+    gps.parseNMEAStream(data);
+    ASSERT_EQ(gps.fixQueueSize(), 3);
+
+    ASSERT_THROW(upm::NMEAFileSource("/nonexistent/capture.nmea"),
+            std::runtime_error);
+}